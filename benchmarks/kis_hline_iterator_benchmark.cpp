@@ -16,6 +16,7 @@
 #include <simpletest.h>
 
 #include "kis_iterator_ng.h"
+#include "testing_timed_default_bounds.h"
 
 void KisHLineIteratorBenchmark::initTestCase()
 {
@@ -177,6 +178,46 @@ void KisHLineIteratorBenchmark::benchmarkTwoIteratorsNoMemCpy(){
     
 }
 
+void KisHLineIteratorBenchmark::benchmarkWrapAround_data()
+{
+    QTest::addColumn<QRect>("wrapRect");
+    QTest::addColumn<bool>("writable");
+
+    // the tile-aligned rect is wrapped on the level of tiles
+    QTest::newRow("aligned-read") << QRect(0, 0, 1024, 1024) << false;
+    QTest::newRow("aligned-write") << QRect(0, 0, 1024, 1024) << true;
+    QTest::newRow("unaligned-read") << QRect(0, 0, NO_TILE_EXACT_BOUNDARY_WIDTH, NO_TILE_EXACT_BOUNDARY_HEIGHT) << false;
+    QTest::newRow("unaligned-write") << QRect(0, 0, NO_TILE_EXACT_BOUNDARY_WIDTH, NO_TILE_EXACT_BOUNDARY_HEIGHT) << true;
+}
+
+void KisHLineIteratorBenchmark::benchmarkWrapAround()
+{
+    QFETCH(QRect, wrapRect);
+    QFETCH(bool, writable);
+
+    KisPaintDeviceSP dev = TestUtil::createWrapAroundDevice(m_colorSpace, wrapRect, *m_color);
+    const QRect rc(-TEST_IMAGE_WIDTH / 2, -TEST_IMAGE_HEIGHT / 2, TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT);
+    const int pixelSize = m_colorSpace->pixelSize();
 
+    QBENCHMARK{
+        if (writable) {
+            KisHLineIteratorSP it = dev->createHLineIteratorNG(rc.x(), rc.y(), rc.width());
+            for (int j = 0; j < rc.height(); j++) {
+                do {
+                    memcpy(it->rawData(), m_color->data(), pixelSize);
+                } while (it->nextPixel());
+                it->nextRow();
+            }
+        } else {
+            KisHLineConstIteratorSP it = dev->createHLineConstIteratorNG(rc.x(), rc.y(), rc.width());
+            for (int j = 0; j < rc.height(); j++) {
+                do {
+                    memcpy(m_color->data(), it->rawDataConst(), pixelSize);
+                } while (it->nextPixel());
+                it->nextRow();
+            }
+        }
+    }
+}
 
 SIMPLE_TEST_MAIN(KisHLineIteratorBenchmark)
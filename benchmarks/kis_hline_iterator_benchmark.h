@@ -44,7 +44,11 @@ private Q_SLOTS:
     void benchmarkConstNoMemCpy();
     // copy from one device to another
     void benchmarkTwoIteratorsNoMemCpy();
-    
+
+    // iterate over a device in wraparound mode, crossing the wrap borders
+    void benchmarkWrapAround_data();
+    void benchmarkWrapAround();
+
 
     
     
@@ -10,6 +10,10 @@
 
 #include "kis_circle_mask_generator.h"
 #include "kis_rect_mask_generator.h"
+#include "kis_curve_circle_mask_generator.h"
+#include "kis_curve_rect_mask_generator.h"
+#include "kis_gauss_circle_mask_generator.h"
+#include "kis_cubic_curve.h"
 
 void KisMaskGeneratorBenchmark::benchmarkCircle()
 {
@@ -33,7 +37,8 @@ void KisMaskGeneratorBenchmark::benchmarkCircle()
 #include "krita_utils.h"
 
 
-void benchmarkSIMD(qreal fade) {
+template <class MaskGenerator>
+void benchmarkSIMD(MaskGenerator &gen) {
     const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
     KisFixedPaintDeviceSP dev = new KisFixedPaintDevice(cs);
     dev->setRect(QRect(0, 0, 1000, 1000));
@@ -43,8 +48,6 @@ void benchmarkSIMD(qreal fade) {
                             0.0, 1.0,
                             500, 500, 0);
 
-    KisCircleMaskGenerator gen(1000, 1.0, fade, fade, 2, false);
-
     KisBrushMaskApplicatorBase *applicator = gen.applicator();
     applicator->initializeData(&data);
 
@@ -57,6 +60,11 @@ void benchmarkSIMD(qreal fade) {
     }
 }
 
+void benchmarkSIMD(qreal fade) {
+    KisCircleMaskGenerator gen(1000, 1.0, fade, fade, 2, false);
+    benchmarkSIMD(gen);
+}
+
 void KisMaskGeneratorBenchmark::benchmarkSIMD_SharpBrush()
 {
     benchmarkSIMD(1.0);
@@ -67,6 +75,46 @@ void KisMaskGeneratorBenchmark::benchmarkSIMD_FadedBrush()
     benchmarkSIMD(0.5);
 }
 
+template <class MaskGenerator>
+void benchmarkSoftBrush(bool useApproximation) {
+    const KisCubicCurve curve(QString("0,1;0.3,0.7;0.6,0.1;1,0"));
+    MaskGenerator gen(1000, 1.0, 0.5, 0.5, 2, curve, true);
+
+    if (useApproximation) {
+        QVERIFY(gen.isCurveApproximated());
+    } else {
+        gen.disableCurveApproximation();
+    }
+
+    benchmarkSIMD(gen);
+}
+
+void KisMaskGeneratorBenchmark::benchmarkSIMD_SoftCircleBrushGather()
+{
+    benchmarkSoftBrush<KisCurveCircleMaskGenerator>(false);
+}
+
+void KisMaskGeneratorBenchmark::benchmarkSIMD_SoftCircleBrushApproximation()
+{
+    benchmarkSoftBrush<KisCurveCircleMaskGenerator>(true);
+}
+
+void KisMaskGeneratorBenchmark::benchmarkSIMD_SoftRectBrushGather()
+{
+    benchmarkSoftBrush<KisCurveRectangleMaskGenerator>(false);
+}
+
+void KisMaskGeneratorBenchmark::benchmarkSIMD_SoftRectBrushApproximation()
+{
+    benchmarkSoftBrush<KisCurveRectangleMaskGenerator>(true);
+}
+
+void KisMaskGeneratorBenchmark::benchmarkSIMD_GaussCircleBrush()
+{
+    KisGaussCircleMaskGenerator gen(1000, 1.0, 0.5, 0.5, 2, true);
+    benchmarkSIMD(gen);
+}
+
 void KisMaskGeneratorBenchmark::benchmarkSquare()
 {
     KisRectangleMaskGenerator gen(1000, 0.5, 0.5, 0.5, 3, true);
@@ -16,6 +16,11 @@ private Q_SLOTS:
     void benchmarkCircle();
     void benchmarkSIMD_SharpBrush();
     void benchmarkSIMD_FadedBrush();
+    void benchmarkSIMD_SoftCircleBrushGather();
+    void benchmarkSIMD_SoftCircleBrushApproximation();
+    void benchmarkSIMD_SoftRectBrushGather();
+    void benchmarkSIMD_SoftRectBrushApproximation();
+    void benchmarkSIMD_GaussCircleBrush();
     void benchmarkSquare();
 
 };
@@ -15,6 +15,7 @@
 
 #include <simpletest.h>
 #include <kis_random_accessor_ng.h>
+#include "testing_timed_default_bounds.h"
 
 
 void KisRandomIteratorBenchmark::initTestCase()
@@ -222,5 +223,46 @@ void KisRandomIteratorBenchmark::benchmarkTwoIteratorsNoMemCpy()
     }
 }
 
+void KisRandomIteratorBenchmark::benchmarkWrapAround_data()
+{
+    QTest::addColumn<QRect>("wrapRect");
+    QTest::addColumn<bool>("writable");
+
+    // the tile-aligned rect is wrapped on the level of tiles
+    QTest::newRow("aligned-read") << QRect(0, 0, 1024, 1024) << false;
+    QTest::newRow("aligned-write") << QRect(0, 0, 1024, 1024) << true;
+    QTest::newRow("unaligned-read") << QRect(0, 0, NO_TILE_EXACT_BOUNDARY_WIDTH, NO_TILE_EXACT_BOUNDARY_HEIGHT) << false;
+    QTest::newRow("unaligned-write") << QRect(0, 0, NO_TILE_EXACT_BOUNDARY_WIDTH, NO_TILE_EXACT_BOUNDARY_HEIGHT) << true;
+}
+
+void KisRandomIteratorBenchmark::benchmarkWrapAround()
+{
+    QFETCH(QRect, wrapRect);
+    QFETCH(bool, writable);
+
+    KisPaintDeviceSP dev = TestUtil::createWrapAroundDevice(m_colorSpace, wrapRect, *m_color);
+    const QRect rc(-TEST_IMAGE_WIDTH / 2, -TEST_IMAGE_HEIGHT / 2, TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT);
+    const int pixelSize = m_colorSpace->pixelSize();
+
+    QBENCHMARK{
+        if (writable) {
+            KisRandomAccessorSP it = dev->createRandomAccessorNG();
+            for (int i = rc.top(); i <= rc.bottom(); i++) {
+                for (int j = rc.left(); j <= rc.right(); j++) {
+                    it->moveTo(j, i);
+                    memcpy(it->rawData(), m_color->data(), pixelSize);
+                }
+            }
+        } else {
+            KisRandomConstAccessorSP it = dev->createRandomConstAccessorNG();
+            for (int i = rc.top(); i <= rc.bottom(); i++) {
+                for (int j = rc.left(); j <= rc.right(); j++) {
+                    it->moveTo(j, i);
+                    memcpy(m_color->data(), it->rawDataConst(), pixelSize);
+                }
+            }
+        }
+    }
+}
 
 SIMPLE_TEST_MAIN(KisRandomIteratorBenchmark)
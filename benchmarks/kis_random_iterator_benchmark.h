@@ -46,6 +46,10 @@ private Q_SLOTS:
     void benchmarkNoMemCpy();
     void benchmarkConstNoMemCpy();
     void benchmarkTwoIteratorsNoMemCpy();
+
+    // access a device in wraparound mode, crossing the wrap borders
+    void benchmarkWrapAround_data();
+    void benchmarkWrapAround();
 };
 
 #endif
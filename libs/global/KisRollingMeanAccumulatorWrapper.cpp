@@ -6,19 +6,30 @@
 
 #include "KisRollingMeanAccumulatorWrapper.h"
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics/stats.hpp>
 #include <boost/accumulators/statistics/rolling_mean.hpp>
+#include <boost/accumulators/statistics/rolling_window.hpp>
 
 using namespace boost::accumulators;
 
+namespace {
+// rolling_window doesn't store anything on its own, it just gives
+// access to the samples that are kept for the rolling mean anyway
+typedef accumulator_set<qreal, stats<tag::lazy_rolling_mean, tag::rolling_window> > AccumulatorType;
+}
+
 struct KisRollingMeanAccumulatorWrapper::Private {
     Private(int windowSize)
         : accumulator(tag::rolling_window::window_size = windowSize)
     {
     }
 
-    accumulator_set<qreal, stats<tag::lazy_rolling_mean> > accumulator;
+    AccumulatorType accumulator;
 };
 
 
@@ -52,9 +63,22 @@ int KisRollingMeanAccumulatorWrapper::rollingCount() const
     return boost::accumulators::rolling_count(m_d->accumulator);
 }
 
+qreal KisRollingMeanAccumulatorWrapper::rollingPercentile(qreal percentile) const
+{
+    const auto window = boost::accumulators::rolling_window(m_d->accumulator);
+    std::vector<qreal> values(window.begin(), window.end());
+
+    if (values.empty()) return 0;
+
+    const int rank = qBound(1, int(std::ceil(percentile * values.size())), int(values.size()));
+    auto nth = values.begin() + rank - 1;
+    std::nth_element(values.begin(), nth, values.end());
+
+    return *nth;
+}
+
 void KisRollingMeanAccumulatorWrapper::reset(int windowSize)
 {
     m_d->accumulator =
-        accumulator_set<qreal, stats<tag::lazy_rolling_mean>>(
-            tag::rolling_window::window_size = windowSize);
+        AccumulatorType(tag::rolling_window::window_size = windowSize);
 }
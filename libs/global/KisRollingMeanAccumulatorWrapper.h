@@ -47,6 +47,17 @@ public:
      */
     int rollingCount() const;
 
+    /**
+     * Get the \p percentile (in range [0.0, 1.0]) of the numbers in the
+     * rolling window using the nearest-rank method, e.g. 0.95 returns
+     * the value that 95% of the numbers don't exceed. If there are no
+     * elements in the rolling window, returns 0.
+     *
+     * The window is copied and partially sorted on every call, so the
+     * call is much more expensive than rollingMean().
+     */
+    qreal rollingPercentile(qreal percentile) const;
+
     /**
      * Reset  accumulator and any stored value
      */
@@ -0,0 +1,63 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisRollingMeanAccumulatorWrapperTest.h"
+
+#include "simpletest.h"
+
+#include "KisRollingMeanAccumulatorWrapper.h"
+
+void KisRollingMeanAccumulatorWrapperTest::testMean()
+{
+    KisRollingMeanAccumulatorWrapper acc(4);
+
+    QCOMPARE(acc.rollingMeanSafe(), 0.0);
+    QCOMPARE(acc.rollingCount(), 0);
+
+    for (int i = 1; i <= 6; i++) {
+        acc(i);
+    }
+
+    QCOMPARE(acc.rollingCount(), 4);
+    QCOMPARE(acc.rollingMean(), 4.5);
+}
+
+void KisRollingMeanAccumulatorWrapperTest::testPercentile()
+{
+    KisRollingMeanAccumulatorWrapper acc(100);
+
+    QCOMPARE(acc.rollingPercentile(0.5), 0.0);
+
+    // push the values in a shuffled order
+    for (int i = 0; i < 100; i++) {
+        acc((i * 37) % 100 + 1);
+    }
+
+    QCOMPARE(acc.rollingPercentile(0.0), 1.0);
+    QCOMPARE(acc.rollingPercentile(0.5), 50.0);
+    QCOMPARE(acc.rollingPercentile(0.95), 95.0);
+    QCOMPARE(acc.rollingPercentile(0.99), 99.0);
+    QCOMPARE(acc.rollingPercentile(1.0), 100.0);
+}
+
+void KisRollingMeanAccumulatorWrapperTest::testPercentileRollingWindow()
+{
+    KisRollingMeanAccumulatorWrapper acc(3);
+
+    acc(100);
+    acc(1);
+    acc(2);
+    acc(3);
+
+    // the first value has already left the window
+    QCOMPARE(acc.rollingPercentile(1.0), 3.0);
+    QCOMPARE(acc.rollingPercentile(0.5), 2.0);
+
+    acc.reset(3);
+    QCOMPARE(acc.rollingPercentile(1.0), 0.0);
+}
+
+SIMPLE_TEST_MAIN(KisRollingMeanAccumulatorWrapperTest)
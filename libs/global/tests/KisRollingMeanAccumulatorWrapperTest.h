@@ -0,0 +1,21 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISROLLINGMEANACCUMULATORWRAPPERTEST_H
+#define KISROLLINGMEANACCUMULATORWRAPPERTEST_H
+
+#include <QObject>
+
+class KisRollingMeanAccumulatorWrapperTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testMean();
+    void testPercentile();
+    void testPercentileRollingWindow();
+};
+
+#endif // KISROLLINGMEANACCUMULATORWRAPPERTEST_H
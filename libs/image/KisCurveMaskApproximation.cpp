@@ -0,0 +1,179 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisCurveMaskApproximation.h"
+
+#include <cmath>
+#include <array>
+
+namespace {
+
+/**
+ * Maximum allowed deviation from the source table. Half of
+ * an 8-bit step guarantees that the resulting mask differs
+ * from the table-based one by one level at most.
+ */
+const qreal maxAllowedError = 0.5 / 255.0;
+
+/**
+ * We need at least a few samples per segment to keep the
+ * least squares system well-conditioned
+ */
+const int minSamplesPerSegment = 8;
+
+bool solve4x4(std::array<std::array<qreal, 5>, 4> &m, std::array<qreal, 4> &result)
+{
+    for (int col = 0; col < 4; col++) {
+        int pivot = col;
+        for (int row = col + 1; row < 4; row++) {
+            if (std::abs(m[row][col]) > std::abs(m[pivot][col])) {
+                pivot = row;
+            }
+        }
+
+        if (std::abs(m[pivot][col]) < 1e-12) return false;
+
+        std::swap(m[col], m[pivot]);
+
+        for (int row = col + 1; row < 4; row++) {
+            const qreal factor = m[row][col] / m[col][col];
+            for (int k = col; k < 5; k++) {
+                m[row][k] -= factor * m[col][k];
+            }
+        }
+    }
+
+    for (int row = 3; row >= 0; row--) {
+        qreal value = m[row][4];
+        for (int k = row + 1; k < 4; k++) {
+            value -= m[row][k] * result[k];
+        }
+        result[row] = value / m[row][row];
+    }
+
+    return true;
+}
+
+}
+
+bool KisCurveMaskApproximation::fit(const QVector<qreal> &curveData, qreal curveResolution)
+{
+    reset();
+
+    const int numSamples = qRound(curveResolution) + 1;
+    if (numSamples < minSamplesPerSegment || curveData.size() < numSamples) {
+        return false;
+    }
+
+    for (int numSegments = 1; numSegments <= maxSegments; numSegments *= 2) {
+        if (numSamples / numSegments < minSamplesPerSegment) break;
+
+        if (tryFit(curveData, numSamples, numSegments)) {
+            return true;
+        }
+    }
+
+    reset();
+    return false;
+}
+
+bool KisCurveMaskApproximation::tryFit(const QVector<qreal> &curveData, int numSamples, int numSegments)
+{
+    const qreal resolution = numSamples - 1;
+
+    for (int segment = 0; segment < numSegments; segment++) {
+        std::array<qreal, 7> powerSums {};
+        std::array<qreal, 4> rhs {};
+
+        const int firstSample = qMax(0, int(std::floor(qreal(segment) / numSegments * resolution)));
+        const int lastSample = qMin(numSamples - 1, int(std::ceil(qreal(segment + 1) / numSegments * resolution)));
+
+        for (int i = firstSample; i <= lastSample; i++) {
+            const qreal u = qreal(i) / resolution * numSegments - segment;
+            const qreal y = curveData[i];
+
+            qreal up = 1.0;
+            for (int p = 0; p < 7; p++) {
+                powerSums[p] += up;
+                if (p < 4) {
+                    rhs[p] += up * y;
+                }
+                up *= u;
+            }
+        }
+
+        std::array<std::array<qreal, 5>, 4> m;
+        for (int row = 0; row < 4; row++) {
+            for (int col = 0; col < 4; col++) {
+                m[row][col] = powerSums[row + col];
+            }
+            m[row][4] = rhs[row];
+        }
+
+        std::array<qreal, 4> coeffs;
+        if (!solve4x4(m, coeffs)) return false;
+
+        c0[segment] = coeffs[0];
+        c1[segment] = coeffs[1];
+        c2[segment] = coeffs[2];
+        c3[segment] = coeffs[3];
+
+        /**
+         * Check the polynomial against the samples it has been fitted to.
+         * The boundary samples are shared by the neighbouring segments
+         * and must be reproduced by both of them, since the vectorized
+         * processors may select either of the two for such a sample. If
+         * the segment fails, the rest of them is not fitted at all.
+         */
+        for (int i = firstSample; i <= lastSample; i++) {
+            const float u = qreal(i) / resolution * numSegments - segment;
+            const float value = ((c3[segment] * u + c2[segment]) * u + c1[segment]) * u + c0[segment];
+
+            if (std::abs(value - curveData[i]) > maxAllowedError) {
+                return false;
+            }
+        }
+    }
+
+    m_numSegments = numSegments;
+
+    return true;
+}
+
+void KisCurveMaskApproximation::reset()
+{
+    m_numSegments = 0;
+}
+
+float KisCurveMaskApproximation::value(float x) const
+{
+    if (!m_numSegments) return 0.0f;
+
+    const float t = qBound(0.0f, x, 1.0f) * m_numSegments;
+    const int segment = qMin(int(t), m_numSegments - 1);
+    const float u = t - segment;
+
+    return ((c3[segment] * u + c2[segment]) * u + c1[segment]) * u + c0[segment];
+}
+
+const KisCurveMaskApproximationCache::Entry *KisCurveMaskApproximationCache::find(qreal softness) const
+{
+    auto it = m_entries.constFind(softness);
+    return it != m_entries.constEnd() ? &(*it) : nullptr;
+}
+
+void KisCurveMaskApproximationCache::insert(qreal softness, const Entry &entry)
+{
+    /**
+     * The values of the softness sensor are usually spread over a small
+     * range, so it is enough to just start over when the cache is full
+     */
+    if (m_entries.size() >= maxEntries) {
+        m_entries.clear();
+    }
+
+    m_entries.insert(softness, entry);
+}
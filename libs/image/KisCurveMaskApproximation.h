@@ -0,0 +1,107 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISCURVEMASKAPPROXIMATION_H
+#define KISCURVEMASKAPPROXIMATION_H
+
+#include <QHash>
+#include <QVector>
+#include <QtGlobal>
+
+#include <kritaimage_export.h>
+
+/**
+ * Piecewise-cubic approximation of the softness curve of the curve-based
+ * auto brushes (KisCurveCircleMaskGenerator and KisCurveRectangleMaskGenerator).
+ *
+ * The vectorized mask processors cannot look up the curve table without
+ * a gather operation, which is extremely slow on most of the architectures.
+ * Instead, the curve is split into a few segments of equal width, and every
+ * segment is approximated with a cubic polynomial using least squares.
+ * Coefficients of the polynomial can be selected with plain comparisons,
+ * so the evaluation is gather-free.
+ *
+ * The approximation is considered valid only when every segment reproduces
+ * the samples of the source table it has been fitted to with an error lower
+ * than half of an 8-bit quantization step. Otherwise the processors fall back
+ * to the table lookup.
+ */
+class KRITAIMAGE_EXPORT KisCurveMaskApproximation
+{
+public:
+    static const int maxSegments = 16;
+
+    /**
+     * Fit the curve table. The sample \p curveData[i] is considered to be
+     * the value of the curve at position `i / curveResolution`. Only the
+     * samples in range [0, curveResolution] are used for the fitting.
+     *
+     * \return true if the fitting is precise enough to be used for
+     *         mask generation
+     */
+    bool fit(const QVector<qreal> &curveData, qreal curveResolution);
+
+    void reset();
+
+    bool isValid() const {
+        return m_numSegments > 0;
+    }
+
+    int numSegments() const {
+        return m_numSegments;
+    }
+
+    /**
+     * Scalar version of the evaluation. The vectorized version is
+     * implemented in kis_brush_mask_processor_factories.cpp
+     */
+    float value(float x) const;
+
+    /**
+     * Coefficients of the polynomials in the local coordinates of the
+     * segment: `p(u) = ((c3 * u + c2) * u + c1) * u + c0`, where
+     * `u = x * numSegments - segmentIndex`
+     */
+    float c0[maxSegments] {};
+    float c1[maxSegments] {};
+    float c2[maxSegments] {};
+    float c3[maxSegments] {};
+
+private:
+    bool tryFit(const QVector<qreal> &curveData, int numSamples, int numSegments);
+
+private:
+    int m_numSegments = 0;
+};
+
+/**
+ * The softness of the curve-based brushes may be changed by a sensor for
+ * every dab. The generators keep the softness-transformed tables and their
+ * approximations for the recently used softness values, so that neither the
+ * transformation nor the fitting is repeated for them.
+ */
+class KRITAIMAGE_EXPORT KisCurveMaskApproximationCache
+{
+public:
+    static const int maxEntries = 32;
+
+    struct Entry {
+        QVector<qreal> curveData;
+        KisCurveMaskApproximation approximation;
+    };
+
+    /**
+     * \return the entry for \p softness or null if there is none
+     */
+    const Entry* find(qreal softness) const;
+
+    void insert(qreal softness, const Entry &entry);
+
+private:
+    QHash<qreal, Entry> m_entries;
+};
+
+#endif // KISCURVEMASKAPPROXIMATION_H
@@ -98,6 +98,24 @@ QVector<QRect> splitDabsIntoRects(const QVector<QRect> &dabRects, int idealNumRe
     return rects;
 }
 
+QVector<QRect> splitParticlesIntoRects(const QRect &totalRect, int idealNumRects)
+{
+    constexpr int minPatchSize = 64;
+    constexpr int maxPatchSize = 512;
+    constexpr int patchStep = 64;
+
+    int idealPatchSize = maxPatchSize;
+
+    QVector<QRect> rects = KritaUtils::splitRectIntoPatches(totalRect, QSize(idealPatchSize, idealPatchSize));
+
+    while (rects.size() < idealNumRects && idealPatchSize > minPatchSize) {
+        idealPatchSize = qMax(minPatchSize, idealPatchSize - patchStep);
+        rects = KritaUtils::splitRectIntoPatches(totalRect, QSize(idealPatchSize, idealPatchSize));
+    }
+
+    return rects;
+}
+
 
 
 }
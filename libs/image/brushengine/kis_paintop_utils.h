@@ -190,6 +190,15 @@ QVector<QRect> splitAndFilterDabRect(const QRect &totalRect, const QVector<QRect
 KRITAIMAGE_EXPORT
 QVector<QRect> splitDabsIntoRects(const QVector<QRect> &dabRects, int idealNumRects, int diameter, qreal spacing);
 
+/**
+ * Split the area of a dab consisting of many small independent particles
+ * into a set of tile-aligned patches that can be rendered in parallel.
+ * The patches are made smaller until there are at least \p idealNumRects
+ * of them (or the patches reach the size of a single tile).
+ */
+KRITAIMAGE_EXPORT
+QVector<QRect> splitParticlesIntoRects(const QRect &totalRect, int idealNumRects);
+
 }
 
 #endif /* __KIS_PAINTOP_UTILS_H */
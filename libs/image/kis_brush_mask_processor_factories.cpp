@@ -30,6 +30,48 @@
 #define a(_s) #_s
 #define b(_s) a(_s)
 
+namespace {
+
+/**
+ * Evaluate the piecewise-cubic approximation of the softness curve
+ * without gathering: coefficients of the segment are selected with
+ * a chain of comparisons, which is much cheaper than a gather for
+ * the small number of segments the approximation has.
+ */
+inline xsimd::batch<float, xsimd::current_arch>
+approximatedCurveValue(const KisCurveMaskApproximation &approximation,
+                       const xsimd::batch<float, xsimd::current_arch> &x)
+{
+    using float_v = xsimd::batch<float, xsimd::current_arch>;
+
+    const int numSegments = approximation.numSegments();
+
+    const float_v t = xsimd::min(xsimd::max(x, float_v(0.0f)), float_v(1.0f)) * float_v(static_cast<float>(numSegments));
+
+    float_v c0(approximation.c0[0]);
+    float_v c1(approximation.c1[0]);
+    float_v c2(approximation.c2[0]);
+    float_v c3(approximation.c3[0]);
+    float_v segmentStart(0.0f);
+
+    for (int i = 1; i < numSegments; i++) {
+        const float_v vSegmentStart(static_cast<float>(i));
+        const auto mask = t >= vSegmentStart;
+
+        c0 = xsimd::select(mask, float_v(approximation.c0[i]), c0);
+        c1 = xsimd::select(mask, float_v(approximation.c1[i]), c1);
+        c2 = xsimd::select(mask, float_v(approximation.c2[i]), c2);
+        c3 = xsimd::select(mask, float_v(approximation.c3[i]), c3);
+        segmentStart = xsimd::select(mask, vSegmentStart, segmentStart);
+    }
+
+    const float_v u = t - segmentStart;
+
+    return xsimd::fma(xsimd::fma(xsimd::fma(c3, u, c2), u, c1), u, c0);
+}
+
+} // namespace
+
 template<>
 template<>
 void FastRowProcessor<KisCircleMaskGenerator>::process<xsimd::current_arch>(float *buffer,
@@ -210,6 +252,7 @@ void FastRowProcessor<KisCurveCircleMaskGenerator>::process<xsimd::current_arch>
     float *bufferPointer = buffer;
 
     const qreal *curveDataPointer = d->curveData.data();
+    const bool useApproximation = d->useCurveApproximation && d->curveApproximation.isValid();
 
     float_v currentIndices = xsimd::detail::make_sequence_as_batch<float_v>();
 
@@ -243,22 +286,28 @@ void FastRowProcessor<KisCurveCircleMaskGenerator>::process<xsimd::current_arch>
         const float_m excludeMask = d->fadeMaker.needFade(dist);
 
         if (!xsimd::all(excludeMask)) {
-            const float_v valDist = dist * vCurveResolution;
-            // truncate
-            int_v vAlphaValue = xsimd::to_int(valDist);
-            const float_v vFloatAlphaValue = xsimd::to_float(vAlphaValue);
+            float_v fullFade;
 
-            const float_v alphaValueF = valDist - vFloatAlphaValue;
+            if (useApproximation) {
+                fullFade = approximatedCurveValue(d->curveApproximation, dist);
+            } else {
+                const float_v valDist = dist * vCurveResolution;
+                // truncate
+                int_v vAlphaValue = xsimd::to_int(valDist);
+                const float_v vFloatAlphaValue = xsimd::to_float(vAlphaValue);
 
-            const auto alphaMask = vAlphaValue < int_v(0);
-            vAlphaValue = xsimd::set_zero(vAlphaValue, alphaMask);
+                const float_v alphaValueF = valDist - vFloatAlphaValue;
 
-            vCurvedData = float_v::gather(curveDataPointer, vAlphaValue);
-            vCurvedData1 = float_v::gather(curveDataPointer, vAlphaValue + 1);
+                const auto alphaMask = vAlphaValue < int_v(0);
+                vAlphaValue = xsimd::set_zero(vAlphaValue, alphaMask);
 
-            // vAlpha
-            float_v fullFade = ((vOne - alphaValueF) * vCurvedData
-                                      + alphaValueF * vCurvedData1);
+                vCurvedData = float_v::gather(curveDataPointer, vAlphaValue);
+                vCurvedData1 = float_v::gather(curveDataPointer, vAlphaValue + 1);
+
+                // vAlpha
+                fullFade = ((vOne - alphaValueF) * vCurvedData
+                            + alphaValueF * vCurvedData1);
+            }
 
             // Mask in the inner circle of the mask
             const float_m mask = fullFade < vZero;
@@ -467,6 +516,7 @@ void FastRowProcessor<KisCurveRectangleMaskGenerator>::process<xsimd::current_ar
     float *bufferPointer = buffer;
 
     const qreal *curveDataPointer = d->curveData.data();
+    const bool useApproximation = d->useCurveApproximation && d->curveApproximation.isValid();
 
     float_v currentIndices = xsimd::detail::make_sequence_as_batch<float_v>();
 
@@ -505,16 +555,32 @@ void FastRowProcessor<KisCurveRectangleMaskGenerator>::process<xsimd::current_ar
             preSIndex = xsimd::select(preSIndex > vOne, vOne, preSIndex);
             preTIndex = xsimd::select(preTIndex > vOne, vOne, preTIndex);
 
-            const auto sIndex = xsimd::nearbyint_as_int(preSIndex * vCurveResolution);
-            const auto tIndex = xsimd::nearbyint_as_int(preTIndex * vCurveResolution);
-
-            const auto sIndexInverted = xsimd::to_int(vCurveResolution - xsimd::to_float(sIndex));
-            const auto tIndexInverted = xsimd::to_int(vCurveResolution - xsimd::to_float(tIndex));
-
-            const auto vCurvedDataSIndex = float_v::gather(curveDataPointer, sIndex);
-            const auto vCurvedDataTIndex = float_v::gather(curveDataPointer, tIndex);
-            const auto vCurvedDataSIndexInv = float_v::gather(curveDataPointer, sIndexInverted);
-            const auto vCurvedDataTIndexInv = float_v::gather(curveDataPointer, tIndexInverted);
+            float_v vCurvedDataSIndex;
+            float_v vCurvedDataTIndex;
+            float_v vCurvedDataSIndexInv;
+            float_v vCurvedDataTIndexInv;
+
+            if (useApproximation) {
+                // snap to the table samples, like the scalar version does
+                const float_v sPos = xsimd::nearbyint(preSIndex * vCurveResolution) / vCurveResolution;
+                const float_v tPos = xsimd::nearbyint(preTIndex * vCurveResolution) / vCurveResolution;
+
+                vCurvedDataSIndex = approximatedCurveValue(d->curveApproximation, sPos);
+                vCurvedDataTIndex = approximatedCurveValue(d->curveApproximation, tPos);
+                vCurvedDataSIndexInv = approximatedCurveValue(d->curveApproximation, vOne - sPos);
+                vCurvedDataTIndexInv = approximatedCurveValue(d->curveApproximation, vOne - tPos);
+            } else {
+                const auto sIndex = xsimd::nearbyint_as_int(preSIndex * vCurveResolution);
+                const auto tIndex = xsimd::nearbyint_as_int(preTIndex * vCurveResolution);
+
+                const auto sIndexInverted = xsimd::to_int(vCurveResolution - xsimd::to_float(sIndex));
+                const auto tIndexInverted = xsimd::to_int(vCurveResolution - xsimd::to_float(tIndex));
+
+                vCurvedDataSIndex = float_v::gather(curveDataPointer, sIndex);
+                vCurvedDataTIndex = float_v::gather(curveDataPointer, tIndex);
+                vCurvedDataSIndexInv = float_v::gather(curveDataPointer, sIndexInverted);
+                vCurvedDataTIndexInv = float_v::gather(curveDataPointer, tIndexInverted);
+            }
 
             float_v fullFade = vValMax
                 * (vOne
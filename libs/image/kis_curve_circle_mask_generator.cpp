@@ -25,6 +25,7 @@ KisCurveCircleMaskGenerator::KisCurveCircleMaskGenerator(qreal diameter, qreal r
     // here we set resolution for the maximum size of the brush!
     d->curveResolution = qRound(qMax(width(), height()) * OVERSAMPLING);
     d->curveData = curve.floatTransfer(d->curveResolution + 2);
+    d->curveApproximation.fit(d->curveData, d->curveResolution);
     d->curvePoints = curve.curvePoints();
     setCurveString(curve.toString());
     d->dirty = false;
@@ -117,7 +118,17 @@ void KisCurveCircleMaskGenerator::setSoftness(qreal softness)
 
     d->dirty = true;
     KisMaskGenerator::setSoftness(softness);
-    KisCurveCircleMaskGenerator::transformCurveForSoftness(softness,d->curvePoints, d->curveResolution+2, d->curveData);
+
+    const KisCurveMaskApproximationCache::Entry *entry = d->softnessCache.find(softness);
+    if (entry) {
+        d->curveData = entry->curveData;
+        d->curveApproximation = entry->approximation;
+    } else {
+        KisCurveCircleMaskGenerator::transformCurveForSoftness(softness,d->curvePoints, d->curveResolution+2, d->curveData);
+        d->curveApproximation.fit(d->curveData, d->curveResolution);
+        d->softnessCache.insert(softness, {d->curveData, d->curveApproximation});
+    }
+
     d->dirty = false;
 }
 
@@ -146,6 +157,16 @@ void KisCurveCircleMaskGenerator::transformCurveForSoftness(qreal softness,const
     result = curve.floatTransfer( curveResolution );
 }
 
+bool KisCurveCircleMaskGenerator::isCurveApproximated() const
+{
+    return d->useCurveApproximation && d->curveApproximation.isValid();
+}
+
+void KisCurveCircleMaskGenerator::disableCurveApproximation()
+{
+    d->useCurveApproximation = false;
+}
+
 void KisCurveCircleMaskGenerator::setMaskScalarApplicator()
 {
     d->applicator.reset(
@@ -50,6 +50,18 @@ public:
 
     void setMaskScalarApplicator();
 
+    /**
+     * \return true if the vectorized processor evaluates the curve with
+     * its gather-free approximation instead of the table lookup
+     */
+    bool isCurveApproximated() const;
+
+    /**
+     * Makes the vectorized processor always look up the curve table
+     * (used by the tests and benchmarks)
+     */
+    void disableCurveApproximation();
+
     static void transformCurveForSoftness(qreal softness,const QList<KisCubicCurvePoint> &points, int curveResolution, QVector<qreal> &result);
 
 private:
@@ -10,6 +10,7 @@
 #include "kis_antialiasing_fade_maker.h"
 #include "kis_brush_mask_applicator_base.h"
 #include "kis_cubic_curve.h"
+#include "KisCurveMaskApproximation.h"
 
 struct Q_DECL_HIDDEN KisCurveCircleMaskGenerator::Private
 {
@@ -23,6 +24,9 @@ struct Q_DECL_HIDDEN KisCurveCircleMaskGenerator::Private
         ycoef(rhs.ycoef),
         curveResolution(rhs.curveResolution),
         curveData(rhs.curveData),
+        curveApproximation(rhs.curveApproximation),
+        softnessCache(rhs.softnessCache),
+        useCurveApproximation(rhs.useCurveApproximation),
         curvePoints(rhs.curvePoints),
         dirty(true),
         fadeMaker(rhs.fadeMaker,*this)
@@ -33,6 +37,9 @@ struct Q_DECL_HIDDEN KisCurveCircleMaskGenerator::Private
     qreal ycoef {0.0};
     qreal curveResolution {0.0};
     QVector<qreal> curveData;
+    KisCurveMaskApproximation curveApproximation;
+    KisCurveMaskApproximationCache softnessCache;
+    bool useCurveApproximation {true};
     QList<KisCubicCurvePoint> curvePoints;
     bool dirty {false};
 
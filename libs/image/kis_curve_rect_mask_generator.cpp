@@ -24,6 +24,7 @@ KisCurveRectangleMaskGenerator::KisCurveRectangleMaskGenerator(qreal diameter, q
 {
     d->curveResolution = qRound( qMax(width(),height()) * OVERSAMPLING);
     d->curveData = curve.floatTransfer( d->curveResolution + 1);
+    d->curveApproximation.fit(d->curveData, d->curveResolution);
     d->curvePoints = curve.curvePoints();
     setCurveString(curve.toString());
     d->dirty = false;
@@ -106,7 +107,17 @@ void KisCurveRectangleMaskGenerator::setSoftness(qreal softness)
     if (!d->dirty && softness == 1.0) return;
     d->dirty = true;
     KisMaskGenerator::setSoftness(softness);
-    KisCurveCircleMaskGenerator::transformCurveForSoftness(softness,d->curvePoints, d->curveResolution + 1, d->curveData);
+
+    const KisCurveMaskApproximationCache::Entry *entry = d->softnessCache.find(softness);
+    if (entry) {
+        d->curveData = entry->curveData;
+        d->curveApproximation = entry->approximation;
+    } else {
+        KisCurveCircleMaskGenerator::transformCurveForSoftness(softness,d->curvePoints, d->curveResolution + 1, d->curveData);
+        d->curveApproximation.fit(d->curveData, d->curveResolution);
+        d->softnessCache.insert(softness, {d->curveData, d->curveApproximation});
+    }
+
     d->dirty = false;
 }
 
@@ -120,6 +131,16 @@ KisBrushMaskApplicatorBase *KisCurveRectangleMaskGenerator::applicator() const
     return d->applicator.data();
 }
 
+bool KisCurveRectangleMaskGenerator::isCurveApproximated() const
+{
+    return d->useCurveApproximation && d->curveApproximation.isValid();
+}
+
+void KisCurveRectangleMaskGenerator::disableCurveApproximation()
+{
+    d->useCurveApproximation = false;
+}
+
 void KisCurveRectangleMaskGenerator::setMaskScalarApplicator()
 {
     d->applicator.reset(
@@ -43,6 +43,18 @@ public:
     KisBrushMaskApplicatorBase *applicator() const override;
     void setMaskScalarApplicator();
 
+    /**
+     * \return true if the vectorized processor evaluates the curve with
+     * its gather-free approximation instead of the table lookup
+     */
+    bool isCurveApproximated() const;
+
+    /**
+     * Makes the vectorized processor always look up the curve table
+     * (used by the tests and benchmarks)
+     */
+    void disableCurveApproximation();
+
 private:
     struct Private;
     const QScopedPointer<Private> d;
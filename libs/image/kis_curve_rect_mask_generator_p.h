@@ -12,6 +12,7 @@
 #include "kis_antialiasing_fade_maker.h"
 #include "kis_brush_mask_applicator_base.h"
 #include "kis_cubic_curve.h"
+#include "KisCurveMaskApproximation.h"
 
 struct Q_DECL_HIDDEN KisCurveRectangleMaskGenerator::Private
 {
@@ -25,6 +26,9 @@ struct Q_DECL_HIDDEN KisCurveRectangleMaskGenerator::Private
         ycoeff(rhs.ycoeff),
         curveResolution(rhs.curveResolution),
         curveData(rhs.curveData),
+        curveApproximation(rhs.curveApproximation),
+        softnessCache(rhs.softnessCache),
+        useCurveApproximation(rhs.useCurveApproximation),
         curvePoints(rhs.curvePoints),
         dirty(rhs.dirty),
         fadeMaker(rhs.fadeMaker, *this)
@@ -35,6 +39,9 @@ struct Q_DECL_HIDDEN KisCurveRectangleMaskGenerator::Private
     qreal ycoeff {0.0};
     qreal curveResolution {0.0};
     QVector<qreal> curveData;
+    KisCurveMaskApproximation curveApproximation;
+    KisCurveMaskApproximationCache softnessCache;
+    bool useCurveApproximation {true};
     QList<KisCubicCurvePoint> curvePoints;
     bool dirty {false};
 
@@ -280,6 +280,9 @@ public:
     QPointF axesCenter;
     bool allowMasksOnRootNode = false;
 
+    /// the visible rects of all the views of the image, \see setUpdatesPriorityRect()
+    QHash<const void*, QRect> updatesPriorityRects;
+
     void requestProjectionUpdateImpl(KisNode *node,
                                      const QVector<QRect> &rects,
                                      const QRect &cropRect,
@@ -2557,6 +2560,22 @@ KisLodPreferences KisImage::lodPreferences() const
     return m_d->scheduler.lodPreferences();
 }
 
+void KisImage::setUpdatesPriorityRect(const void *view, const QRect &rc)
+{
+    if (rc.isEmpty()) {
+        m_d->updatesPriorityRects.remove(view);
+    } else {
+        m_d->updatesPriorityRects.insert(view, rc);
+    }
+
+    QRect priorityRect;
+    Q_FOREACH (const QRect &viewRect, m_d->updatesPriorityRects) {
+        priorityRect |= viewRect;
+    }
+
+    m_d->scheduler.setUpdatesPriorityRect(priorityRect);
+}
+
 void KisImage::nodeCollapsedChanged(KisNode * node)
 {
     Q_UNUSED(node);
@@ -784,6 +784,15 @@ public:
      */
     KisLodPreferences lodPreferences() const;
 
+    /**
+     * Set the area of the image the user is looking at in \p view. The
+     * updates of the areas of all the views are processed first, then
+     * the updates near them and after that all the other ones. Pass an
+     * empty rect when the view is closed or doesn't show the image
+     * anymore. Should be called from the GUI thread only.
+     */
+    void setUpdatesPriorityRect(const void *view, const QRect &rc);
+
     KisImageAnimationInterface *animationInterface() const;
 
     /**
@@ -44,6 +44,7 @@
 #include "tiles3/kis_hline_iterator.h"
 #include "tiles3/kis_vline_iterator.h"
 #include "tiles3/kis_random_accessor.h"
+#include "tiles3/KisTiledDataSnapshot.h"
 
 #include "kis_default_bounds.h"
 
@@ -155,6 +156,7 @@ public:
     {
 
         m_lodData.reset();
+        resetLodSyncState();
         m_externalFrameData.reset();
 
         if (!m_frames.isEmpty()) {
@@ -420,11 +422,17 @@ public:
     void updateLodDataStruct(LodDataStruct *dst, const QRect &srcRect);
     void uploadLodDataStruct(LodDataStruct *dst);
     KisRegion regionForLodSyncing() const;
+    KisRegion regionForLodSyncing(LodDataStruct *dst) const;
 
     void updateLodDataManager(KisDataManager *srcDataManager,
                               KisDataManager *dstDataManager, const QPoint &srcOffset, const QPoint &dstOffset,
                               const QRect &originalRect, int lod);
 
+    template<int numChannels>
+    void updateLodDataManagerU8(KisDataManager *srcDataManager,
+                                KisDataManager *dstDataManager, const QPoint &srcOffset, const QPoint &dstOffset,
+                                const QRect &srcRect, const QRect &dstRect, int lod);
+
     void generateLodCloneDevice(KisPaintDeviceSP dst, const QRect &originalRect, int lod);
 
     void testingFetchLodDevice(KisPaintDeviceSP targetDevice);
@@ -507,6 +515,17 @@ private:
         return data;
     }
 
+    /**
+     * Forgets the state of the last lod syncing, so the next
+     * syncing regenerates the whole lod plane. Must be called
+     * whenever the lod plane is dropped or its content is
+     * replaced by something else than a syncing.
+     */
+    void resetLodSyncState()
+    {
+        m_lodSyncState = LodSyncState();
+    }
+
     inline void ensureLodDataPresent() const
     {
         if (!m_lodData) {
@@ -595,6 +614,19 @@ private:
     DataSP m_data;
     mutable QScopedPointer<Data> m_lodData;
     mutable QScopedPointer<Data> m_externalFrameData;
+
+    /**
+     * The state of the device and of its lod plane at the moment of
+     * the last lod syncing. It lets the next syncing regenerate only
+     * the tiles that have changed since then.
+     */
+    struct LodSyncState {
+        KisTiledDataSnapshot srcSnapshot;
+        KisTiledDataSnapshot lodSnapshot;
+        QPoint srcOffset;
+        int levelOfDetail = 0;
+    };
+    LodSyncState m_lodSyncState;
     mutable QMutex m_dataSwitchLock;
 
     FramesHash m_frames;
@@ -677,6 +709,10 @@ struct KisPaintDevice::Private::StrategyPolicy {
 struct KisPaintDevice::Private::LodDataStructImpl : public KisPaintDevice::LodDataStruct {
     LodDataStructImpl(Data *_lodData) : lodData(_lodData) {}
     QScopedPointer<Data> lodData;
+
+    KisTiledDataSnapshot srcSnapshot;
+    QPoint srcOffset;
+    KisRegion syncRegion;
 };
 
 KisRegion KisPaintDevice::Private::regionForLodSyncing() const
@@ -685,22 +721,81 @@ KisRegion KisPaintDevice::Private::regionForLodSyncing() const
     return srcData->dataManager()->region().translated(srcData->x(), srcData->y());
 }
 
+KisRegion KisPaintDevice::Private::regionForLodSyncing(LodDataStruct *_dst) const
+{
+    LodDataStructImpl *dst = dynamic_cast<LodDataStructImpl*>(_dst);
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(dst, regionForLodSyncing());
+
+    return dst->syncRegion;
+}
+
 KisPaintDevice::LodDataStruct* KisPaintDevice::Private::createLodDataStruct(int newLod)
 {
     KIS_SAFE_ASSERT_RECOVER_NOOP(newLod > 0);
 
     Data *srcData = currentNonLodData();
 
-    Data *lodData = new Data(q, srcData, false);
-    LodDataStruct *lodStruct = new LodDataStructImpl(lodData);
+    const int expectedX = KisLodTransform::coordToLodCoord(srcData->x(), newLod);
+    const int expectedY = KisLodTransform::coordToLodCoord(srcData->y(), newLod);
+    const QPoint srcOffset(srcData->x(), srcData->y());
+
+    KisTiledDataSnapshot srcSnapshot(srcData->dataManager().data());
+
+    /**
+     * If the lod plane has been generated from the same layout of the
+     * device, we can reuse it and regenerate only the tiles that have
+     * changed since then, either in the device itself or in the lod plane
+     * (e.g. by a preview stroke). We compare color spaces as pure pointers,
+     * because they must be exactly the same, since they come from the
+     * common source.
+     */
+    const bool canSyncIncrementally =
+        m_lodData &&
+        !m_lodSyncState.srcSnapshot.isNull() &&
+        m_lodSyncState.levelOfDetail == newLod &&
+        m_lodSyncState.srcOffset == srcOffset &&
+        m_lodData->levelOfDetail() == newLod &&
+        m_lodData->colorSpace() == srcData->colorSpace() &&
+        m_lodData->x() == expectedX &&
+        m_lodData->y() == expectedY &&
+        m_lodData->dataManager()->pixelSize() == srcData->dataManager()->pixelSize() &&
+        !memcmp(m_lodData->dataManager()->defaultPixel(),
+                srcData->dataManager()->defaultPixel(),
+                srcData->dataManager()->pixelSize());
+
+    if (canSyncIncrementally) {
+        Data *lodData = new Data(q, m_lodData.data(), true);
+        LodDataStructImpl *lodStruct = new LodDataStructImpl(lodData);
+
+        QVector<QRect> dirtyRects = srcSnapshot.changedTileRects(m_lodSyncState.srcSnapshot);
+        for (auto it = dirtyRects.begin(); it != dirtyRects.end(); ++it) {
+            it->translate(srcOffset);
+        }
+
+        const KisTiledDataSnapshot lodSnapshot(m_lodData->dataManager().data());
+        Q_FOREACH (QRect rc, lodSnapshot.changedTileRects(m_lodSyncState.lodSnapshot)) {
+            rc.translate(m_lodData->x(), m_lodData->y());
+            dirtyRects << KisLodTransform::upscaledRect(rc, newLod);
+        }
+
+        lodStruct->syncRegion = KisRegion::fromOverlappingRects(dirtyRects, KisTileData::WIDTH);
+        lodStruct->srcSnapshot = srcSnapshot;
+        lodStruct->srcOffset = srcOffset;
 
-    int expectedX = KisLodTransform::coordToLodCoord(srcData->x(), newLod);
-    int expectedY = KisLodTransform::coordToLodCoord(srcData->y(), newLod);
+        lodData->cache()->invalidate();
+
+        return lodStruct;
+    }
 
     /**
-     * We compare color spaces as pure pointers, because they must be
-     * exactly the same, since they come from the common source.
+     * The lod plane is going to be regenerated from scratch, the
+     * previous state doesn't describe anything anymore
      */
+    resetLodSyncState();
+
+    Data *lodData = new Data(q, srcData, false);
+    LodDataStructImpl *lodStruct = new LodDataStructImpl(lodData);
+
     if (lodData->levelOfDetail() != newLod ||
         lodData->colorSpace() != srcData->colorSpace() ||
         lodData->x() != expectedX ||
@@ -718,9 +813,102 @@ KisPaintDevice::LodDataStruct* KisPaintDevice::Private::createLodDataStruct(int
 
     lodData->cache()->invalidate();
 
+    lodStruct->syncRegion = regionForLodSyncing();
+    lodStruct->srcSnapshot = srcSnapshot;
+    lodStruct->srcOffset = srcOffset;
+
     return lodStruct;
 }
 
+template<int numChannels>
+void KisPaintDevice::Private::updateLodDataManagerU8(KisDataManager *srcDataManager,
+                                                     KisDataManager *dstDataManager,
+                                                     const QPoint &srcOffset,
+                                                     const QPoint &dstOffset,
+                                                     const QRect &srcRect,
+                                                     const QRect &dstRect,
+                                                     int lod)
+{
+    /**
+     * Implements the same math as KoMixColorsOpImpl::mixColors() without
+     * weights: the color channels are averaged with alpha as a weight,
+     * the alpha channel is averaged directly. The sums fit into 32 bits
+     * for the levels of detail up to 7.
+     */
+    const int alphaPos = numChannels - 1;
+    const int srcStepSize = 1 << lod;
+    const qint32 cellSize = srcStepSize * srcStepSize;
+
+    QVector<qint32> totals(dstRect.width() * numChannels, 0);
+    QVector<quint8> dstRow(dstRect.width() * numChannels);
+
+    InternalSequentialConstIterator srcIt(StrategyPolicy(currentStrategy(), srcDataManager, srcOffset.x(), srcOffset.y()), srcRect);
+    InternalSequentialIterator dstIt(StrategyPolicy(currentStrategy(), dstDataManager, dstOffset.x(), dstOffset.y()), dstRect);
+
+    int rowsAccumulated = 0;
+    int srcColumn = 0;
+
+    int srcConseqPixels = srcIt.nConseqPixels();
+    int dstConseqPixels = dstIt.nConseqPixels();
+
+    while (srcIt.nextPixels(srcConseqPixels)) {
+        srcConseqPixels = srcIt.nConseqPixels();
+
+        const quint8 *srcPtr = srcIt.rawDataConst();
+        const int firstColumn = srcColumn;
+
+        for (int i = 0; i < srcConseqPixels; i++) {
+            qint32 *cellTotals = totals.data() + ((firstColumn + i) >> lod) * numChannels;
+            const qint32 alpha = srcPtr[alphaPos];
+
+            for (int ch = 0; ch < alphaPos; ch++) {
+                cellTotals[ch] += srcPtr[ch] * alpha;
+            }
+            cellTotals[alphaPos] += alpha;
+
+            srcPtr += numChannels;
+        }
+
+        // the runs of the sequential iterator never cross the row border
+        srcColumn += srcConseqPixels;
+        if (srcColumn < srcRect.width()) continue;
+
+        srcColumn = 0;
+        if (++rowsAccumulated < srcStepSize) continue;
+
+        const qint32 *cellTotals = totals.constData();
+        quint8 *dstPtr = dstRow.data();
+
+        for (int i = 0; i < dstRect.width(); i++) {
+            const qint32 totalAlpha = cellTotals[alphaPos];
+
+            if (totalAlpha > 0) {
+                for (int ch = 0; ch < alphaPos; ch++) {
+                    dstPtr[ch] = quint8(qMin(255, (cellTotals[ch] + totalAlpha / 2) / totalAlpha));
+                }
+                dstPtr[alphaPos] = quint8(qMin(255, (totalAlpha + cellSize / 2) / cellSize));
+            } else {
+                memset(dstPtr, 0, numChannels);
+            }
+
+            cellTotals += numChannels;
+            dstPtr += numChannels;
+        }
+
+        int columnsWritten = 0;
+        while (columnsWritten < dstRect.width() && dstIt.nextPixels(dstConseqPixels)) {
+            dstConseqPixels = dstIt.nConseqPixels();
+
+            memcpy(dstIt.rawData(), dstRow.constData() + columnsWritten * numChannels, dstConseqPixels * numChannels);
+
+            columnsWritten += dstConseqPixels;
+        }
+
+        totals.fill(0);
+        rowsAccumulated = 0;
+    }
+}
+
 void KisPaintDevice::Private::updateLodDataManager(KisDataManager *srcDataManager,
                                                    KisDataManager *dstDataManager,
                                                    const QPoint &srcOffset,
@@ -740,6 +928,36 @@ void KisPaintDevice::Private::updateLodDataManager(KisDataManager *srcDataManage
 
     KIS_ASSERT_RECOVER_NOOP(srcRect.width() / srcStepSize == dstRect.width());
 
+    /**
+     * Most of the devices are 8-bit ones with the alpha channel stored
+     * last. For them the cells are averaged right while reading the
+     * source rows, without gathering every cell into a temporary buffer
+     * and calling the mixing op for it. The result is exactly the same.
+     */
+    const KoColorSpace *cs = colorSpace();
+    if (lod <= 7 &&
+        cs->colorDepthId() == Integer8BitsColorDepthID &&
+        cs->pixelSize() == cs->channelCount() &&
+        cs->alphaPos() == cs->channelCount() - 1) {
+
+        switch (cs->channelCount()) {
+        case 1:
+            updateLodDataManagerU8<1>(srcDataManager, dstDataManager, srcOffset, dstOffset, srcRect, dstRect, lod);
+            return;
+        case 2:
+            updateLodDataManagerU8<2>(srcDataManager, dstDataManager, srcOffset, dstOffset, srcRect, dstRect, lod);
+            return;
+        case 4:
+            updateLodDataManagerU8<4>(srcDataManager, dstDataManager, srcOffset, dstOffset, srcRect, dstRect, lod);
+            return;
+        case 5:
+            updateLodDataManagerU8<5>(srcDataManager, dstDataManager, srcOffset, dstOffset, srcRect, dstRect, lod);
+            return;
+        default:
+            break;
+        }
+    }
+
     const int pixelSize = srcDataManager->pixelSize();
 
     int rowsAccumulated = 0;
@@ -844,6 +1062,11 @@ void KisPaintDevice::Private::uploadLodDataStruct(LodDataStruct *_dst)
 
     m_lodData->prepareClone(dst->lodData.data());
     m_lodData->dataManager()->bitBltRough(dst->lodData->dataManager(), dst->lodData->dataManager()->extent());
+
+    m_lodSyncState.srcSnapshot = dst->srcSnapshot;
+    m_lodSyncState.lodSnapshot = KisTiledDataSnapshot(m_lodData->dataManager().data());
+    m_lodSyncState.srcOffset = dst->srcOffset;
+    m_lodSyncState.levelOfDetail = dst->lodData->levelOfDetail();
 }
 
 void KisPaintDevice::Private::transferFromData(Data *data, KisPaintDeviceSP targetDevice)
@@ -996,6 +1219,8 @@ void KisPaintDevice::Private::convertColorSpace(const KoColorSpace *dstColorSpac
         data->convertDataColorSpace(dstColorSpace, renderingIntent, conversionFlags, mainCommand, progressUpdater);
     }
 
+    resetLodSyncState();
+
     q->emitColorSpaceChanged();
 }
 
@@ -1016,6 +1241,7 @@ bool KisPaintDevice::Private::assignProfile(const KoColorProfile * profile, KUnd
         if (!data) continue;
         data->assignColorSpace(dstColorSpace, mainCommand);
     }
+    resetLodSyncState();
     q->emitProfileChanged();
 
     // no undo information is provided here
@@ -2150,6 +2376,11 @@ KisRegion KisPaintDevice::regionForLodSyncing() const
     return m_d->regionForLodSyncing();
 }
 
+KisRegion KisPaintDevice::regionForLodSyncing(LodDataStruct *dst) const
+{
+    return m_d->regionForLodSyncing(dst);
+}
+
 KisPaintDevice::LodDataStruct* KisPaintDevice::createLodDataStruct(int lod)
 {
     return m_d->createLodDataStruct(lod);
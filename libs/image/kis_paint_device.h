@@ -918,6 +918,15 @@ public:
     };
 
     KisRegion regionForLodSyncing() const;
+
+    /**
+     * Returns the region that should be passed to updateLodDataStruct()
+     * for \p dst. If the lod plane of the device is still valid since the
+     * previous syncing, only the tiles changed since then are returned,
+     * otherwise the result is the same as of regionForLodSyncing().
+     */
+    KisRegion regionForLodSyncing(LodDataStruct *dst) const;
+
     LodDataStruct* createLodDataStruct(int lod);
     void updateLodDataStruct(LodDataStruct *dst, const QRect &srcRect);
     void uploadLodDataStruct(LodDataStruct *dst);
@@ -11,6 +11,7 @@
 #include "kis_wrapped_hline_iterator.h"
 #include "kis_wrapped_vline_iterator.h"
 #include "kis_wrapped_random_accessor.h"
+#include "tiles3/KisTileWrapMapping.h"
 
 
 class KisPaintDevice::Private::KisPaintDeviceStrategy
@@ -204,6 +205,21 @@ public:
         m_wrapRect = rc;
     }
 
+    /**
+     * When the wrap rect lies on the tiles grid, the wrapping is done
+     * on the level of tiles, so the normal iterators can be used
+     * instead of the ones splitting the lines at the wrap borders
+     */
+    bool canWrapTiles(qint32 offsetX, qint32 offsetY) const {
+        return KisTileWrapMapping::isTileAligned(m_wrapRect, m_device->defaultBounds()->wrapAroundModeAxis(),
+                                                 offsetX, offsetY);
+    }
+
+    KisTileWrapMapping tileWrapMapping(qint32 offsetX, qint32 offsetY) const {
+        return KisTileWrapMapping(m_wrapRect, m_device->defaultBounds()->wrapAroundModeAxis(),
+                                  offsetX, offsetY);
+    }
+
     void move(const QPoint& pt) override {
         QPoint offset (pt.x() - m_device->x(), pt.y() - m_device->y());
 
@@ -294,6 +310,11 @@ public:
     }
 
     KisHLineIteratorSP createHLineIteratorNG(KisDataManager *dataManager, qint32 x, qint32 y, qint32 w, qint32 offsetX, qint32 offsetY) override {
+        if (canWrapTiles(offsetX, offsetY)) {
+            return new KisHLineIterator2(dataManager, x, y, w, offsetX, offsetY, true, m_d->cacheInvalidator(),
+                                         tileWrapMapping(offsetX, offsetY));
+        }
+
         KisWrappedRect splitRect(QRect(x, y, w, m_wrapRect.height()), m_wrapRect, m_device->defaultBounds()->wrapAroundModeAxis());
         if (!splitRect.isSplit()) {
             return KisPaintDeviceStrategy::createHLineIteratorNG(dataManager, x, y, w, offsetX, offsetY);
@@ -302,6 +323,11 @@ public:
     }
 
     KisHLineConstIteratorSP createHLineConstIteratorNG(KisDataManager *dataManager, qint32 x, qint32 y, qint32 w, qint32 offsetX, qint32 offsetY) const override {
+        if (canWrapTiles(offsetX, offsetY)) {
+            return new KisHLineIterator2(dataManager, x, y, w, offsetX, offsetY, false, m_d->cacheInvalidator(),
+                                         tileWrapMapping(offsetX, offsetY));
+        }
+
         KisWrappedRect splitRect(QRect(x, y, w, m_wrapRect.height()), m_wrapRect, m_device->defaultBounds()->wrapAroundModeAxis());
         if (!splitRect.isSplit()) {
             return KisPaintDeviceStrategy::createHLineConstIteratorNG(dataManager, x, y, w, offsetX, offsetY);
@@ -312,6 +338,11 @@ public:
     KisVLineIteratorSP createVLineIteratorNG(qint32 x, qint32 y, qint32 h) override {
         m_d->cache()->invalidate();
 
+        if (canWrapTiles(m_d->x(), m_d->y())) {
+            return new KisVLineIterator2(m_d->dataManager().data(), x, y, h, m_d->x(), m_d->y(), true, m_d->cacheInvalidator(),
+                                         tileWrapMapping(m_d->x(), m_d->y()));
+        }
+
         KisWrappedRect splitRect(QRect(x, y, m_wrapRect.width(), h), m_wrapRect, m_device->defaultBounds()->wrapAroundModeAxis());
         if (!splitRect.isSplit()) {
             return KisPaintDeviceStrategy::createVLineIteratorNG(x, y, h);
@@ -320,6 +351,11 @@ public:
     }
 
     KisVLineConstIteratorSP createVLineConstIteratorNG(qint32 x, qint32 y, qint32 h) const override {
+        if (canWrapTiles(m_d->x(), m_d->y())) {
+            return new KisVLineIterator2(m_d->dataManager().data(), x, y, h, m_d->x(), m_d->y(), false, m_d->cacheInvalidator(),
+                                         tileWrapMapping(m_d->x(), m_d->y()));
+        }
+
         KisWrappedRect splitRect(QRect(x, y, m_wrapRect.width(), h), m_wrapRect, m_device->defaultBounds()->wrapAroundModeAxis());
         if (!splitRect.isSplit()) {
             return KisPaintDeviceStrategy::createVLineConstIteratorNG(x, y, h);
@@ -329,12 +365,23 @@ public:
 
     KisRandomAccessorSP createRandomAccessorNG() override {
         m_d->cache()->invalidate();
+
+        if (canWrapTiles(m_d->x(), m_d->y())) {
+            return new KisRandomAccessor2(m_d->dataManager().data(), m_d->x(), m_d->y(), true, m_d->cacheInvalidator(),
+                                          tileWrapMapping(m_d->x(), m_d->y()));
+        }
+
         return new KisWrappedRandomAccessor(
             m_d->dataManager().data(), m_d->x(), m_d->y(), true, m_d->cacheInvalidator(), m_wrapRect,
             m_device->defaultBounds()->wrapAroundModeAxis());
     }
 
     KisRandomConstAccessorSP createRandomConstAccessorNG() const override {
+        if (canWrapTiles(m_d->x(), m_d->y())) {
+            return new KisRandomAccessor2(m_d->dataManager().data(), m_d->x(), m_d->y(), false, m_d->cacheInvalidator(),
+                                          tileWrapMapping(m_d->x(), m_d->y()));
+        }
+
         return new KisWrappedRandomAccessor(
             m_d->dataManager().data(), m_d->x(), m_d->y(), false, m_d->cacheInvalidator(), m_wrapRect,
             m_device->defaultBounds()->wrapAroundModeAxis());
@@ -12,6 +12,7 @@
 #include "kis_image_config.h"
 #include "kis_full_refresh_walker.h"
 #include "kis_spontaneous_job.h"
+#include "kis_lod_transform_base.h"
 
 
 //#define ENABLE_DEBUG_JOIN
@@ -85,37 +86,87 @@ void KisSimpleUpdateQueue::processQueue(KisUpdaterContext &updaterContext)
     updaterContext.unlock();
 }
 
+void KisSimpleUpdateQueue::setPriorityRect(const QRect &rc)
+{
+    QMutexLocker locker(&m_lock);
+    m_priorityRect = rc;
+}
+
+QRect KisSimpleUpdateQueue::priorityRect() const
+{
+    QMutexLocker locker(&m_lock);
+    return m_priorityRect;
+}
+
+KisSimpleUpdateQueue::JobPriority KisSimpleUpdateQueue::jobPriority(KisBaseRectsWalkerSP walker) const
+{
+    if (m_priorityRect.isEmpty()) return VisibleJob;
+
+    const QRect visibleRect =
+        KisLodTransformBase::scaledRect(m_priorityRect, walker->levelOfDetail());
+
+    const QRect requestedRect = walker->requestedRect();
+
+    if (requestedRect.intersects(visibleRect)) {
+        return VisibleJob;
+    }
+
+    // the area the user will most probably see after a small pan
+    const int marginX = visibleRect.width() / 2;
+    const int marginY = visibleRect.height() / 2;
+
+    return requestedRect.intersects(visibleRect.adjusted(-marginX, -marginY, marginX, marginY)) ?
+        NearVisibleJob : OffscreenJob;
+}
+
 bool KisSimpleUpdateQueue::processOneJob(KisUpdaterContext &updaterContext)
 {
     QMutexLocker locker(&m_lock);
 
-    KisBaseRectsWalkerSP item;
-    KisMutableWalkersListIterator iter(m_updatesList);
     bool jobAdded = false;
 
     int currentLevelOfDetail = updaterContext.currentLevelOfDetail();
 
-    while(iter.hasNext()) {
-        item = iter.next();
+    /**
+     * The jobs visible in the viewport are started first, so that the
+     * user could see the result of big updates as soon as possible.
+     * Without the priority rect all the jobs have the same priority
+     * and the first allowed job is taken.
+     */
+    int bestIndex = -1;
+    JobPriority bestPriority = OffscreenJob;
+
+    for (int i = 0; i < m_updatesList.size(); i++) {
+        KisBaseRectsWalkerSP item = m_updatesList[i];
 
-        if ((currentLevelOfDetail < 0 || currentLevelOfDetail == item->levelOfDetail()) &&
-            !item->checksumValid()) {
+        if (currentLevelOfDetail >= 0 && currentLevelOfDetail != item->levelOfDetail()) {
+            continue;
+        }
+
+        const JobPriority priority = jobPriority(item);
+        if (bestIndex >= 0 && priority >= bestPriority) {
+            continue;
+        }
 
+        if (!item->checksumValid()) {
             m_overrideLevelOfDetail = item->levelOfDetail();
             item->recalculate(item->requestedRect());
             m_overrideLevelOfDetail = -1;
         }
 
-        if ((currentLevelOfDetail < 0 || currentLevelOfDetail == item->levelOfDetail()) &&
-            updaterContext.isJobAllowed(item)) {
+        if (updaterContext.isJobAllowed(item)) {
+            bestIndex = i;
+            bestPriority = priority;
 
-            updaterContext.addMergeJob(item);
-            iter.remove();
-            jobAdded = true;
-            break;
+            if (priority == VisibleJob) break;
         }
     }
 
+    if (bestIndex >= 0) {
+        updaterContext.addMergeJob(m_updatesList.takeAt(bestIndex));
+        jobAdded = true;
+    }
+
     if (jobAdded) return true;
 
     if (!m_spontaneousJobsList.isEmpty()) {
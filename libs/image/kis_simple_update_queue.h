@@ -49,7 +49,25 @@ public:
 
     int overrideLevelOfDetail() const;
 
+    /**
+     * Sets the area of the image (in image pixels) the user is looking
+     * at. The jobs intersecting this area are started first, then the
+     * ones located near it, and only after that all the others. The
+     * order of the jobs of the same priority is kept. An empty rect
+     * disables the prioritization.
+     */
+    void setPriorityRect(const QRect &rc);
+    QRect priorityRect() const;
+
 protected:
+    enum JobPriority {
+        VisibleJob = 0,
+        NearVisibleJob,
+        OffscreenJob
+    };
+
+    JobPriority jobPriority(KisBaseRectsWalkerSP walker) const;
+
     void addJob(KisNodeSP node, const QVector<QRect> &rects, const QRect& cropRect, int levelOfDetail, KisBaseRectsWalker::UpdateType type, bool dontInvalidateFrames);
 
     bool processOneJob(KisUpdaterContext &updaterContext);
@@ -97,6 +115,8 @@ protected:
     qreal m_maxMergeCollectAlpha;
 
     int m_overrideLevelOfDetail;
+
+    QRect m_priorityRect;
 };
 
 class KRITAIMAGE_EXPORT KisTestableSimpleUpdateQueue : public KisSimpleUpdateQueue
@@ -6,13 +6,47 @@
 
 #include "kis_sync_lod_cache_stroke_strategy.h"
 
+#include <QAtomicInt>
+#include <QElapsedTimer>
+
 #include <kis_image.h>
+#include <kis_image_config.h>
+#include <kis_debug.h>
 #include <kundo2magicstring.h>
 #include "krita_utils.h"
 #include "kis_layer_utils.h"
 #include "kis_pointer_utils.h"
 #include "KisRunnableStrokeJobUtils.h"
 
+namespace {
+
+struct SyncSharedData
+{
+    struct DeviceData {
+        KisPaintDeviceSP device;
+        QSharedPointer<KisPaintDevice::LodDataStruct> lodData;
+        QVector<QRect> patches;
+    };
+
+    struct Patch {
+        int deviceIndex = -1;
+        QRect rect;
+    };
+
+    QVector<DeviceData> devices;
+    QVector<Patch> patches;
+    QAtomicInt nextPatch;
+
+    QElapsedTimer timer;
+    qint64 prepareTime = 0;
+    qint64 downsampleTime = 0;
+    qint64 numPixels = 0;
+};
+
+using SyncSharedDataSP = QSharedPointer<SyncSharedData>;
+
+}
+
 struct KisSyncLodCacheStrokeStrategy::Private
 {
     KisImageWSP image;
@@ -59,10 +93,7 @@ void KisSyncLodCacheStrokeStrategy::createJobsData(QVector<KisStrokeJobData *> &
     using KritaUtils::splitRegionIntoPatches;
     using KritaUtils::optimalPatchSize;
 
-    using SharedData = QHash<KisPaintDeviceSP, QSharedPointer<KisPaintDevice::LodDataStruct>>;
-    using SharedDataSP = QSharedPointer<SharedData>;
-
-    SharedDataSP sharedData(new SharedData());
+    SyncSharedDataSP sharedData(new SyncSharedData());
 
     KisPaintDeviceList deviceList = extraDevices;
 
@@ -73,33 +104,65 @@ void KisSyncLodCacheStrokeStrategy::createJobsData(QVector<KisStrokeJobData *> &
 
     KritaUtils::makeContainerUnique(deviceList);
 
-    KritaUtils::addJobBarrierNoCancel(jobs, [updatesFacade] () {
+    sharedData->devices.resize(deviceList.size());
+    for (int i = 0; i < deviceList.size(); i++) {
+        sharedData->devices[i].device = deviceList[i];
+    }
+
+    KritaUtils::addJobBarrierNoCancel(jobs, [updatesFacade, sharedData] () {
         updatesFacade->blockUpdates();
+        sharedData->timer.start();
     });
 
-    KritaUtils::addJobBarrier(jobs, [sharedData, deviceList, levelOfDetail] () mutable {
-        Q_FOREACH (KisPaintDeviceSP device, deviceList) {
-            sharedData->insert(device, toQShared(device->createLodDataStruct(levelOfDetail)));
+    /**
+     * The lod planes remember the state of the devices they were
+     * generated from, so preparing them also finds out which parts
+     * of the devices have changed since the previous syncing. It
+     * is done for every device in parallel.
+     */
+    for (int i = 0; i < sharedData->devices.size(); i++) {
+        KritaUtils::addJobConcurrent(jobs, [sharedData, i, levelOfDetail] () {
+            SyncSharedData::DeviceData &data = sharedData->devices[i];
+
+            data.lodData = toQShared(data.device->createLodDataStruct(levelOfDetail));
+            data.patches = splitRegionIntoPatches(data.device->regionForLodSyncing(data.lodData.data()),
+                                                  optimalPatchSize());
+        });
+    }
+
+    KritaUtils::addJobSequential(jobs, [sharedData] () {
+        for (int i = 0; i < sharedData->devices.size(); i++) {
+            Q_FOREACH (const QRect &rc, sharedData->devices[i].patches) {
+                sharedData->patches.append({i, rc});
+                sharedData->numPixels += qint64(rc.width()) * rc.height();
+            }
         }
-    });
 
-    KritaUtils::addJobSequential(jobs, [](){});
+        sharedData->prepareTime = sharedData->timer.restart();
+    });
 
-    Q_FOREACH (KisPaintDeviceSP device, deviceList) {
-        KisRegion region = device->regionForLodSyncing();
-        QVector<QRect> rects = splitRegionIntoPatches(region, optimalPatchSize());
+    /**
+     * The number of the patches is known only after the lod planes
+     * are prepared, so the workers just pick the patches of all the
+     * devices one by one
+     */
+    const int numWorkers = qMax(1, KisImageConfig(true).maxNumberOfThreads());
 
-        Q_FOREACH (const QRect &rc, rects) {
-            KritaUtils::addJobConcurrent(jobs, [sharedData, device, rc] () mutable {
-                KIS_ASSERT(sharedData->contains(device));
+    for (int i = 0; i < numWorkers; i++) {
+        KritaUtils::addJobConcurrent(jobs, [sharedData] () {
+            int index = 0;
+            while ((index = sharedData->nextPatch.fetchAndAddOrdered(1)) < sharedData->patches.size()) {
+                const SyncSharedData::Patch &patch = sharedData->patches[index];
+                SyncSharedData::DeviceData &data = sharedData->devices[patch.deviceIndex];
 
-                KisPaintDevice::LodDataStruct *data = sharedData->value(device).data();
-                device->updateLodDataStruct(data, rc);
-            });
-        }
+                data.device->updateLodDataStruct(data.lodData.data(), patch.rect);
+            }
+        });
     }
 
-    KritaUtils::addJobSequential(jobs, [](){});
+    KritaUtils::addJobSequential(jobs, [sharedData] () {
+        sharedData->downsampleTime = sharedData->timer.restart();
+    });
 
     recursiveApplyNodes(imageRoot,
         [&jobs](KisNodeSP node) {
@@ -109,13 +172,17 @@ void KisSyncLodCacheStrokeStrategy::createJobsData(QVector<KisStrokeJobData *> &
         });
 
     KritaUtils::addJobSequential(jobs, [sharedData] () mutable {
-        auto it = sharedData->begin();
-        auto end = sharedData->end();
-
-        for (; it != end; ++it) {
-            KisPaintDeviceSP dev = it.key();
-            dev->uploadLodDataStruct(it.value().data());
+        Q_FOREACH (const SyncSharedData::DeviceData &data, sharedData->devices) {
+            if (!data.lodData) continue;
+            data.device->uploadLodDataStruct(data.lodData.data());
         }
+
+        dbgImage << "Synced lod planes of" << sharedData->devices.size() << "devices:"
+                 << sharedData->patches.size() << "patches,"
+                 << QString::number(sharedData->numPixels / 1e6, 'f', 2) << "Mpx,"
+                 << "prepare" << sharedData->prepareTime << "ms,"
+                 << "downsample" << sharedData->downsampleTime << "ms,"
+                 << "upload" << sharedData->timer.elapsed() << "ms";
     });
 
     KritaUtils::addJobSequentialNoCancel(jobs, [updatesFacade] () {
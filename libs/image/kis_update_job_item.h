@@ -17,6 +17,7 @@
 #include "kis_base_rects_walker.h"
 #include "kis_async_merger.h"
 #include "kis_updater_context.h"
+#include "krita_utils.h"
 #include <KoAlwaysInline.h>
 
 //#define DEBUG_JOBS_SEQUENCE
@@ -46,6 +47,12 @@ public:
     }
 
     void run() override {
+        /**
+         * All the threads of the context are busy with the updates,
+         * don't let the jobs spawn even more threads
+         */
+        KritaUtils::SerialParallelForGuard serialParallelForGuard;
+
         runImpl();
 
         // notify that the job is exiting and wake everybody
@@ -229,6 +229,11 @@ KisLodPreferences KisUpdateScheduler::lodPreferences() const
     return m_d->strokesQueue.lodPreferences();
 }
 
+void KisUpdateScheduler::setUpdatesPriorityRect(const QRect &rc)
+{
+    m_d->updatesQueue.setPriorityRect(rc);
+}
+
 void KisUpdateScheduler::explicitRegenerateLevelOfDetail()
 {
     m_d->strokesQueue.explicitRegenerateLevelOfDetail();
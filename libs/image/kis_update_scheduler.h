@@ -156,6 +156,15 @@ public:
      */
     KisLodPreferences lodPreferences() const;
 
+    /**
+     * Sets the area of the image visible on the canvas. The updates
+     * of this area are processed before the updates of the rest of
+     * the image.
+     *
+     * \see KisSimpleUpdateQueue::setPriorityRect()
+     */
+    void setUpdatesPriorityRect(const QRect &rc);
+
     /**
      * Explicitly start regeneration of LoD planes of all the devices
      * in the image. This call should be performed when the user is idle,
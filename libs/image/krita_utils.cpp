@@ -14,6 +14,10 @@
 #include <QPolygonF>
 #include <QPen>
 #include <QPainter>
+#include <QGlobalStatic>
+#include <QSemaphore>
+#include <QThreadPool>
+#include <atomic>
 
 #include "kis_algebra_2d.h"
 
@@ -600,6 +604,90 @@ namespace KritaUtils
         }
     }
 
+    namespace {
+
+    struct ParallelForThreadPool : public QThreadPool
+    {
+        ParallelForThreadPool()
+        {
+            // the calling thread does its share of the work
+            setMaxThreadCount(qMax(1, KisImageConfig(true).maxNumberOfThreads() - 1));
+        }
+    };
+
+    Q_GLOBAL_STATIC(ParallelForThreadPool, s_parallelForPool)
+
+    thread_local int s_serialParallelForLevel = 0;
+
+    }
+
+    SerialParallelForGuard::SerialParallelForGuard()
+    {
+        s_serialParallelForLevel++;
+    }
+
+    SerialParallelForGuard::~SerialParallelForGuard()
+    {
+        s_serialParallelForLevel--;
+    }
+
+    ParallelForUnlockGuard::ParallelForUnlockGuard()
+        : m_savedLevel(s_serialParallelForLevel)
+    {
+        s_serialParallelForLevel = 0;
+    }
+
+    ParallelForUnlockGuard::~ParallelForUnlockGuard()
+    {
+        s_serialParallelForLevel = m_savedLevel;
+    }
+
+    int parallelForMaxThreads()
+    {
+        return s_parallelForPool->maxThreadCount() + 1;
+    }
+
+    void parallelFor(int numItems, const std::function<void(int)> &func)
+    {
+        if (numItems <= 1 || s_serialParallelForLevel > 0) {
+            for (int i = 0; i < numItems; i++) {
+                func(i);
+            }
+            return;
+        }
+
+        std::atomic<int> nextItem(0);
+
+        auto worker = [&] () {
+            int item = 0;
+            while ((item = nextItem.fetch_add(1)) < numItems) {
+                func(item);
+            }
+        };
+
+        /**
+         * The helpers are started only when the pool has an idle
+         * thread. A queued helper could wait for a thread that is
+         * itself waiting for a parallelFor() to finish.
+         */
+        const int maxHelperJobs = qMin(numItems - 1, s_parallelForPool->maxThreadCount());
+        int numHelperJobs = 0;
+        QSemaphore helpersFinished;
+
+        for (; numHelperJobs < maxHelperJobs; numHelperJobs++) {
+            const bool started = s_parallelForPool->tryStart([&] () {
+                SerialParallelForGuard guard;
+                worker();
+                helpersFinished.release();
+            });
+
+            if (!started) break;
+        }
+
+        worker();
+        helpersFinished.acquire(numHelperJobs);
+    }
+
     QVector<QPoint> rasterizeHLine(const QPoint &startPoint, const QPoint &endPoint)
     {
         QVector<QPoint> points;
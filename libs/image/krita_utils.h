@@ -138,6 +138,64 @@ namespace KritaUtils
     void thresholdOpacity(KisPaintDeviceSP device, const QRect &rect, ThresholdMode mode);
     void thresholdOpacityAlpha8(KisPaintDeviceSP device, const QRect &rect, ThresholdMode mode);
 
+    /**
+     * Calls \p func for every index in range [0, numItems) and waits until
+     * all of them are processed. The items are distributed between the
+     * calling thread and the idle threads of a pool shared by all the
+     * callers. The pool is limited by KisImageConfig::maxNumberOfThreads(),
+     * so the concurrent callers never start more threads than that.
+     *
+     * The calling thread does its share of the work and the helper jobs
+     * are never queued, so the call progresses even when the pool is busy
+     * and it is safe to call parallelFor() from inside \p func. Such nested
+     * calls process all their items in the current thread.
+     *
+     * NOTE: \p func must not throw
+     */
+    void KRITAIMAGE_EXPORT parallelFor(int numItems, const std::function<void(int)> &func);
+
+    /**
+     * \return the maximum number of threads that may process the items of
+     * a single parallelFor() call, including the calling thread
+     */
+    int KRITAIMAGE_EXPORT parallelForMaxThreads();
+
+    /**
+     * While the guard exists, parallelFor() called in the current thread
+     * processes all the items in this thread. The threads of the update
+     * scheduler are guarded this way: they already keep all the cores
+     * busy, so spawning helpers from them would only oversubscribe the CPU.
+     */
+    struct KRITAIMAGE_EXPORT SerialParallelForGuard
+    {
+        SerialParallelForGuard();
+        ~SerialParallelForGuard();
+
+        SerialParallelForGuard(const SerialParallelForGuard &rhs) = delete;
+        SerialParallelForGuard& operator=(const SerialParallelForGuard &rhs) = delete;
+    };
+
+    /**
+     * While the guard exists, parallelFor() called in the current thread
+     * may use the helper threads again, even if the thread is guarded by
+     * SerialParallelForGuard. It is meant for the large independent jobs
+     * of the update scheduler's threads that would otherwise be the only
+     * busy thread in the end of an update (e.g. the texture conversion
+     * of the canvas). The helpers are started only when the pool has idle
+     * threads, so the CPU is not oversubscribed.
+     */
+    struct KRITAIMAGE_EXPORT ParallelForUnlockGuard
+    {
+        ParallelForUnlockGuard();
+        ~ParallelForUnlockGuard();
+
+        ParallelForUnlockGuard(const ParallelForUnlockGuard &rhs) = delete;
+        ParallelForUnlockGuard& operator=(const ParallelForUnlockGuard &rhs) = delete;
+
+    private:
+        int m_savedLevel;
+    };
+
     template <typename Visitor>
     void rasterizeHLine(const QPoint &startPoint, const QPoint &endPoint, Visitor visitor)
     {
@@ -229,6 +229,17 @@ void KisMaskSimilarityTest::testSoftCircleMask()
     KisMaskSimilarityTester::runMaskGenTest(generator,CIRC_SOFT);
 }
 
+void KisMaskSimilarityTest::testSoftCircleMaskCustomCurve()
+{
+    const KisCubicCurve pointsCurve(QString("0,1;0.3,0.7;0.6,0.1;1,0"));
+    KisCurveCircleMaskGenerator generator(499.5, 0.2, 0.5, 0.5, 2, pointsCurve,true);
+    QVERIFY(generator.isCurveApproximated());
+    KisMaskSimilarityTester::runMaskGenTest(generator,CIRC_SOFT);
+
+    generator.disableCurveApproximation();
+    KisMaskSimilarityTester::runMaskGenTest(generator,CIRC_SOFT);
+}
+
 void KisMaskSimilarityTest::testRectMask()
 {
     KisRectangleMaskGenerator generator(499.5, 0.1, 0.5, 0.5, 2, false);
@@ -248,4 +259,15 @@ void KisMaskSimilarityTest::testSoftRectMask()
     KisMaskSimilarityTester::runMaskGenTest(generator,RECT_SOFT);
 }
 
+void KisMaskSimilarityTest::testSoftRectMaskCustomCurve()
+{
+    const KisCubicCurve pointsCurve(QString("0,1;0.3,0.7;0.6,0.1;1,0"));
+    KisCurveRectangleMaskGenerator generator(499.5, 0.2, 0.5, 0.2, 2, pointsCurve, true);
+    QVERIFY(generator.isCurveApproximated());
+    KisMaskSimilarityTester::runMaskGenTest(generator,RECT_SOFT);
+
+    generator.disableCurveApproximation();
+    KisMaskSimilarityTester::runMaskGenTest(generator,RECT_SOFT);
+}
+
 SIMPLE_TEST_MAIN(KisMaskSimilarityTest)
@@ -17,10 +17,12 @@ private Q_SLOTS:
     void testCircleMask();
     void testGaussCircleMask();
     void testSoftCircleMask();
+    void testSoftCircleMaskCustomCurve();
 
     void testRectMask();
     void testGaussRectMask();
     void testSoftRectMask();
+    void testSoftRectMaskCustomCurve();
 };
 
 #endif
@@ -14,6 +14,7 @@
 #include <KoColor.h>
 #include <KoColorSpace.h>
 #include <KoColorSpaceRegistry.h>
+#include <KoMixColorsOp.h>
 #include <KoStore.h>
 
 #include "kis_paint_device_writer.h"
@@ -26,6 +27,7 @@
 #include "kis_datamanager.h"
 #include "kis_global.h"
 #include <testutil.h>
+#include <testing_benchmark_utils.h>
 #include "kis_transaction.h"
 #include "kis_image.h"
 #include "config-limit-long-tests.h"
@@ -830,11 +832,13 @@ void KisPaintDeviceTest::testExactBoundsNonTransparent()
     QCOMPARE(dev->nonDefaultPixelArea(), QRect(-1,-1,1002,1002));
 }
 
-KisPaintDeviceSP createWrapAroundPaintDevice(const KoColorSpace *cs)
+KisPaintDeviceSP createWrapAroundPaintDevice(const KoColorSpace *cs, const QRect &wrapRect = QRect(0,0,20,20))
 {
     struct TestingDefaultBounds : public KisDefaultBoundsBase {
+        TestingDefaultBounds(const QRect &bounds) : m_bounds(bounds) {}
+
         QRect bounds() const override {
-            return QRect(0,0,20,20);
+            return m_bounds;
         }
         bool wrapAroundMode() const override {
             return true;
@@ -854,11 +858,13 @@ KisPaintDeviceSP createWrapAroundPaintDevice(const KoColorSpace *cs)
         void * sourceCookie() const override {
             return 0;
         }
+
+        QRect m_bounds;
     };
 
     KisPaintDeviceSP dev = new KisPaintDevice(cs);
 
-    KisDefaultBoundsBaseSP bounds = new TestingDefaultBounds();
+    KisDefaultBoundsBaseSP bounds = new TestingDefaultBounds(wrapRect);
     dev->setDefaultBounds(bounds);
     dev->setSupportsWraparoundMode(true);
 
@@ -1295,6 +1301,80 @@ void KisPaintDeviceTest::testWrappedVLineIteratorReadMoreThanBounds()
     testWrappedLineIteratorReadMoreThanBounds<KisVLineIteratorSP>("vline_iterator");
 }
 
+template <class IteratorSP>
+bool checkTileAlignedWrappedIterator(KisPaintDeviceSP dev, const QRect &rect)
+{
+    const QRect wrapRect = dev->defaultBounds()->bounds();
+    IteratorSP it = createIterator<IteratorSP>(dev, rect);
+
+    int y = 0;
+    do {
+        do {
+            const quint8 *data = it->rawDataConst();
+            const QPoint pt(it->x(), it->y());
+
+            if (data[0] != KisWrappedRect::xToWrappedX(pt.x(), wrapRect, WRAPAROUND_BOTH) ||
+                data[1] != KisWrappedRect::yToWrappedY(pt.y(), wrapRect, WRAPAROUND_BOTH)) {
+
+                qWarning() << "Wrong pixel at" << pt << data[0] << data[1];
+                return false;
+            }
+        } while (it->nextPixel());
+    } while (nextRowGeneral(it, ++y, rect));
+
+    return true;
+}
+
+void KisPaintDeviceTest::testTileAlignedWrappedIterators()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    const QRect wrapRect(0, 0, 128, 192);
+    KisPaintDeviceSP dev = createWrapAroundPaintDevice(cs, wrapRect);
+
+    {
+        KisRandomAccessorSP it = dev->createRandomAccessorNG();
+        for (int y = wrapRect.top(); y <= wrapRect.bottom(); y++) {
+            for (int x = wrapRect.left(); x <= wrapRect.right(); x++) {
+                it->moveTo(x, y);
+                quint8 *data = it->rawData();
+                data[0] = x;
+                data[1] = y;
+                data[2] = 0;
+                data[3] = 255;
+            }
+        }
+    }
+
+    const QRect rect(-150, -70, 400, 300);
+
+    QVERIFY(checkTileAlignedWrappedIterator<KisHLineIteratorSP>(dev, rect));
+    QVERIFY(checkTileAlignedWrappedIterator<KisVLineIteratorSP>(dev, rect));
+
+    KisRandomConstAccessorSP accessor = dev->createRandomConstAccessorNG();
+    for (int y = rect.top(); y <= rect.bottom(); y += 7) {
+        for (int x = rect.left(); x <= rect.right(); x += 5) {
+            accessor->moveTo(x, y);
+            const quint8 *data = accessor->rawDataConst();
+
+            QCOMPARE(int(data[0]), KisWrappedRect::xToWrappedX(x, wrapRect, WRAPAROUND_BOTH));
+            QCOMPARE(int(data[1]), KisWrappedRect::yToWrappedY(y, wrapRect, WRAPAROUND_BOTH));
+            QVERIFY(accessor->numContiguousColumns(x) <= wrapRect.right() - KisWrappedRect::xToWrappedX(x, wrapRect, WRAPAROUND_BOTH) + 1);
+        }
+    }
+
+    // the writes outside the wrap rect go to the wrapped pixels
+    KoColor c1(Qt::red, cs);
+    {
+        KisHLineIteratorSP it = dev->createHLineIteratorNG(-128 + 5, 192 + 7, 1);
+        memcpy(it->rawData(), c1.data(), cs->pixelSize());
+    }
+
+    KoColor result(cs);
+    dev->pixel(5, 7, &result);
+    QCOMPARE(result, c1);
+    QCOMPARE(dev->extent(), wrapRect);
+}
+
 void KisPaintDeviceTest::testMoveWrapAround()
 {
     const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
@@ -1538,6 +1618,135 @@ void KisPaintDeviceTest::testLodDevice()
                                   "lod", "lod1-offset-6-14"));
 }
 
+KisRegion syncLodCacheIncrementally(KisPaintDeviceSP dev, int levelOfDetail)
+{
+    KisPaintDevice::LodDataStruct* s = dev->createLodDataStruct(levelOfDetail);
+
+    KisRegion region = dev->regionForLodSyncing(s);
+    Q_FOREACH(QRect rect2, KritaUtils::splitRegionIntoPatches(region, KritaUtils::optimalPatchSize())) {
+        dev->updateLodDataStruct(s, rect2);
+    }
+
+    dev->uploadLodDataStruct(s);
+    delete s;
+
+    return region;
+}
+
+void KisPaintDeviceTest::testLodDeviceIncremental()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+
+    const QRect imageRect(0,0,512,512);
+    TestingLodDefaultBounds *bounds = new TestingLodDefaultBounds(imageRect);
+    dev->setDefaultBounds(bounds);
+
+    fillGradientDevice(dev, imageRect);
+
+    auto checkLodPlane = [dev, cs] (const QRect &srcRect) {
+        KisPaintDeviceSP actual = new KisPaintDevice(cs);
+        dev->testingFetchLodDevice(actual);
+
+        KisPaintDeviceSP expected = new KisPaintDevice(cs);
+        dev->generateLodCloneDevice(expected, srcRect, 1);
+
+        QPoint pt;
+        if (!TestUtil::comparePaintDevices(pt, actual, expected)) {
+            qDebug() << "The lod plane differs at" << pt;
+            return false;
+        }
+        return true;
+    };
+
+    // the first sync has nothing to compare with, so everything is synced
+    bounds->testingSetLevelOfDetail(1);
+    KisRegion region = syncLodCacheIncrementally(dev, 1);
+    QCOMPARE(region.boundingRect(), imageRect);
+    QVERIFY(checkLodPlane(imageRect));
+
+    // nothing has changed
+    region = syncLodCacheIncrementally(dev, 1);
+    QVERIFY(region.isEmpty());
+    QVERIFY(checkLodPlane(imageRect));
+
+    // a change in the original plane syncs only the changed tiles
+    bounds->testingSetLevelOfDetail(0);
+    dev->fill(QRect(100,100,20,20), KoColor(Qt::red, cs));
+    bounds->testingSetLevelOfDetail(1);
+
+    region = syncLodCacheIncrementally(dev, 1);
+    QCOMPARE(region.boundingRect(), QRect(64,64,64,64));
+    QVERIFY(checkLodPlane(imageRect));
+
+    // a lod stroke has painted on the lod plane, which should be reverted
+    dev->fill(QRect(10,10,5,5), KoColor(Qt::blue, cs));
+
+    region = syncLodCacheIncrementally(dev, 1);
+    QCOMPARE(region.boundingRect(), QRect(0,0,128,128));
+    QVERIFY(checkLodPlane(imageRect));
+
+    // the offset change makes all the tiles dirty
+    bounds->testingSetLevelOfDetail(0);
+    dev->setX(20);
+    bounds->testingSetLevelOfDetail(1);
+
+    const KisRegion fullRegion = dev->regionForLodSyncing();
+    region = syncLodCacheIncrementally(dev, 1);
+    QCOMPARE(region.boundingRect(), fullRegion.boundingRect());
+    QVERIFY(checkLodPlane(imageRect.translated(20, 0)));
+}
+
+void KisPaintDeviceTest::testLodDownsamplingU8()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+
+    const QRect rect(0,0,70,70);
+    TestingLodDefaultBounds *bounds = new TestingLodDefaultBounds(rect);
+    dev->setDefaultBounds(bounds);
+
+    // semi-transparent noise, to check the alpha weighting
+    TestUtil::TestingRandomSequence random;
+    KisSequentialIterator it(dev, rect);
+    while (it.nextPixel()) {
+        quint8 *pixel = it.rawData();
+        for (int i = 0; i < 4; i++) {
+            pixel[i] = random.nextByte();
+        }
+        if (it.x() < 8) {
+            pixel[3] = 0;
+        }
+    }
+
+    for (int lod = 1; lod <= 3; lod++) {
+        const int cell = 1 << lod;
+
+        KisPaintDeviceSP lodDevice = new KisPaintDevice(cs);
+        dev->generateLodCloneDevice(lodDevice, rect, lod);
+
+        const QRect lodRect = KisLodTransform::scaledRect(KisLodTransform::alignedRect(rect, lod), lod);
+
+        QVector<quint8> cellPixels(cell * cell * cs->pixelSize());
+        KoColor expected(cs);
+        KoColor actual(cs);
+
+        for (int y = lodRect.top(); y <= lodRect.bottom(); y++) {
+            for (int x = lodRect.left(); x <= lodRect.right(); x++) {
+                dev->readBytes(cellPixels.data(), x * cell, y * cell, cell, cell);
+                cs->mixColorsOp()->mixColors(cellPixels.constData(), cell * cell, expected.data());
+
+                lodDevice->pixel(x, y, &actual);
+
+                if (memcmp(expected.data(), actual.data(), cs->pixelSize()) != 0) {
+                    qDebug() << ppVar(lod) << ppVar(x) << ppVar(y) << ppVar(expected) << ppVar(actual);
+                    QFAIL("The downsampled pixel differs from the mixed one");
+                }
+            }
+        }
+    }
+}
+
 void KisPaintDeviceTest::benchmarkLod1Generation()
 {
     const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
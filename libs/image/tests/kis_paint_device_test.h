@@ -47,12 +47,15 @@ private Q_SLOTS:
     void testWrappedVLineIterator();
     void testWrappedHLineIteratorReadMoreThanBounds();
     void testWrappedVLineIteratorReadMoreThanBounds();
+    void testTileAlignedWrappedIterators();
     void testMoveWrapAround();
 
     void testCacheState();
 
     void testLodTransform();
     void testLodDevice();
+    void testLodDeviceIncremental();
+    void testLodDownsamplingU8();
     void benchmarkLod1Generation();
     void benchmarkLod2Generation();
     void benchmarkLod3Generation();
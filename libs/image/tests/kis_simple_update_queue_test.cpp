@@ -278,5 +278,50 @@ void KisSimpleUpdateQueueTest::testSpontaneousJobsCompression()
     QCOMPARE(jobsList[0], job3);
 }
 
+void KisSimpleUpdateQueueTest::testPriorityRect()
+{
+    QRect imageRect(0,0,2048,2048);
+
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "priority test");
+
+    KisPaintLayerSP paintLayer = new KisPaintLayer(image, "test", OPACITY_OPAQUE_U8);
+
+    image->barrierLock();
+    image->addNode(paintLayer);
+    image->unlock();
+
+    KisTestableSimpleUpdateQueue queue;
+    KisWalkersList& walkersList = queue.getWalkersList();
+
+    queue.setPriorityRect(QRect(1536,1536,256,256));
+    queue.addUpdateJob(paintLayer, imageRect, imageRect, 0);
+
+    QCOMPARE(walkersList.size(), 16);
+
+    KisTestableUpdaterContext context(2);
+    queue.processQueue(context);
+
+    QVector<KisUpdateJobItem*> jobs = context.getJobs();
+
+    // the visible patch goes first, then the first of the nearby ones
+    QVERIFY(checkWalker(jobs[0]->walker(), QRect(1536,1536,512,512)));
+    QVERIFY(checkWalker(jobs[1]->walker(), QRect(1024,1024,512,512)));
+
+    QCOMPARE(walkersList.size(), 14);
+    QVERIFY(checkWalker(walkersList[0], QRect(0,0,512,512)));
+
+    context.clear();
+
+    // without the priority rect the jobs are taken in the order they came
+    queue.setPriorityRect(QRect());
+    queue.processQueue(context);
+
+    jobs = context.getJobs();
+
+    QVERIFY(checkWalker(jobs[0]->walker(), QRect(0,0,512,512)));
+    QVERIFY(checkWalker(jobs[1]->walker(), QRect(512,0,512,512)));
+}
+
 KISTEST_MAIN(KisSimpleUpdateQueueTest)
 
@@ -0,0 +1,104 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISTILEWRAPMAPPING_H
+#define KISTILEWRAPMAPPING_H
+
+#include <QRect>
+
+#include "kis_tile_data.h"
+#include "KisWraparoundAxis.h"
+
+/**
+ * Addresses the tiles of a data manager modulo a wraparound rect.
+ *
+ * When the wrap rect is aligned to the tiles grid, every pixel outside
+ * the rect has the same position inside its tile as the pixel it wraps
+ * to. Therefore it is enough to remap the column and the row of the
+ * tile, and the line iterators and the random accessor can walk through
+ * the wrapped device as fast as through a normal one, without splitting
+ * the lines at the borders of the wrap rect.
+ *
+ * A default-constructed mapping doesn't remap anything.
+ */
+class KisTileWrapMapping
+{
+public:
+    KisTileWrapMapping() = default;
+
+    /**
+     * Creates the mapping for \p wrapRect, which is given in the coordinates
+     * of a paint device with offsets \p offsetX and \p offsetY. The rect
+     * must be aligned to the tiles grid, see isTileAligned().
+     */
+    KisTileWrapMapping(const QRect &wrapRect, WrapAroundAxis axis, qint32 offsetX, qint32 offsetY)
+    {
+        Q_ASSERT(isTileAligned(wrapRect, axis, offsetX, offsetY));
+
+        if (axis != WRAPAROUND_VERTICAL) {
+            m_firstCol = (wrapRect.x() - offsetX) / KisTileData::WIDTH;
+            m_numCols = wrapRect.width() / KisTileData::WIDTH;
+        }
+
+        if (axis != WRAPAROUND_HORIZONTAL) {
+            m_firstRow = (wrapRect.y() - offsetY) / KisTileData::HEIGHT;
+            m_numRows = wrapRect.height() / KisTileData::HEIGHT;
+        }
+    }
+
+    /**
+     * \return true if the wrapping along \p axis can be done on the tile
+     * level, that is, if the borders of \p wrapRect lie on the borders
+     * of the tiles
+     */
+    static bool isTileAligned(const QRect &wrapRect, WrapAroundAxis axis, qint32 offsetX, qint32 offsetY)
+    {
+        if (wrapRect.isEmpty()) return false;
+
+        const bool colsAligned =
+            axis == WRAPAROUND_VERTICAL ||
+            ((wrapRect.x() - offsetX) % KisTileData::WIDTH == 0 &&
+             wrapRect.width() % KisTileData::WIDTH == 0);
+
+        const bool rowsAligned =
+            axis == WRAPAROUND_HORIZONTAL ||
+            ((wrapRect.y() - offsetY) % KisTileData::HEIGHT == 0 &&
+             wrapRect.height() % KisTileData::HEIGHT == 0);
+
+        return colsAligned && rowsAligned;
+    }
+
+    inline qint32 col(qint32 col) const {
+        return m_numCols ? wrap(col, m_firstCol, m_numCols) : col;
+    }
+
+    inline qint32 row(qint32 row) const {
+        return m_numRows ? wrap(row, m_firstRow, m_numRows) : row;
+    }
+
+private:
+    static inline qint32 wrap(qint32 index, qint32 first, qint32 size) {
+        index -= first;
+
+        // most of the tiles are inside the wrap rect, avoid division for them
+        if (index < 0 || index >= size) {
+            index %= size;
+            if (index < 0) {
+                index += size;
+            }
+        }
+
+        return index + first;
+    }
+
+private:
+    qint32 m_firstCol {0};
+    qint32 m_numCols {0};
+    qint32 m_firstRow {0};
+    qint32 m_numRows {0};
+};
+
+#endif // KISTILEWRAPMAPPING_H
@@ -0,0 +1,144 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisTiledDataSnapshot.h"
+
+#include <QVector>
+#include <QHash>
+#include <QReadWriteLock>
+
+#include <algorithm>
+
+#include "kis_tile.h"
+#include "kis_tiled_data_manager.h"
+
+
+struct KisTiledDataSnapshot::Private
+{
+    struct Item {
+        qint32 col;
+        qint32 row;
+        quint64 version;
+    };
+
+    qint32 pixelSize = 0;
+    QVector<Item> items;
+    uint hash = 0;
+};
+
+KisTiledDataSnapshot::KisTiledDataSnapshot()
+{
+}
+
+KisTiledDataSnapshot::KisTiledDataSnapshot(KisTiledDataManager *dm)
+    : m_d(new Private)
+{
+    QReadLocker locker(&dm->m_lock);
+
+    m_d->pixelSize = dm->pixelSize();
+    m_d->items.reserve(dm->m_hashTable->numTiles());
+
+    KisTileHashTableConstIterator iter(dm->m_hashTable);
+    KisTileSP tile;
+
+    while ((tile = iter.tile())) {
+        m_d->items.append({tile->col(), tile->row(), tile->tileData()->contentVersion()});
+
+        iter.next();
+    }
+
+    /**
+     * The order of iteration depends on the history of the hash
+     * table, so sort the tiles to make the snapshots comparable
+     */
+    std::sort(m_d->items.begin(), m_d->items.end(),
+              [] (const Private::Item &lhs, const Private::Item &rhs) {
+                  return lhs.row < rhs.row || (lhs.row == rhs.row && lhs.col < rhs.col);
+              });
+
+    uint hash = qHash(m_d->pixelSize);
+    Q_FOREACH (const Private::Item &item, m_d->items) {
+        hash = hash * 31 + qHash(item.version);
+    }
+    m_d->hash = hash;
+}
+
+bool KisTiledDataSnapshot::isNull() const
+{
+    return !m_d;
+}
+
+bool KisTiledDataSnapshot::operator==(const KisTiledDataSnapshot &rhs) const
+{
+    if (m_d == rhs.m_d) return true;
+    if (!m_d || !rhs.m_d) return false;
+
+    if (m_d->hash != rhs.m_d->hash ||
+        m_d->pixelSize != rhs.m_d->pixelSize ||
+        m_d->items.size() != rhs.m_d->items.size()) {
+
+        return false;
+    }
+
+    return std::equal(m_d->items.begin(), m_d->items.end(), rhs.m_d->items.begin(),
+                      [] (const Private::Item &lhs, const Private::Item &rhs) {
+                          return lhs.col == rhs.col &&
+                              lhs.row == rhs.row &&
+                              lhs.version == rhs.version;
+                      });
+}
+
+bool KisTiledDataSnapshot::operator!=(const KisTiledDataSnapshot &rhs) const
+{
+    return !(*this == rhs);
+}
+
+uint KisTiledDataSnapshot::hash() const
+{
+    return m_d ? m_d->hash : 0;
+}
+
+QVector<QRect> KisTiledDataSnapshot::changedTileRects(const KisTiledDataSnapshot &previous) const
+{
+    QVector<QRect> rects;
+
+    const QVector<Private::Item> emptyItems;
+    const QVector<Private::Item> &lhsItems = m_d ? m_d->items : emptyItems;
+    const QVector<Private::Item> &rhsItems = previous.m_d ? previous.m_d->items : emptyItems;
+
+    auto tileRect = [] (const Private::Item &item) {
+        return QRect(item.col * KisTileData::WIDTH, item.row * KisTileData::HEIGHT,
+                     KisTileData::WIDTH, KisTileData::HEIGHT);
+    };
+
+    auto lessThan = [] (const Private::Item &lhs, const Private::Item &rhs) {
+        return lhs.row < rhs.row || (lhs.row == rhs.row && lhs.col < rhs.col);
+    };
+
+    // both lists are sorted, so just merge them
+    auto lhsIt = lhsItems.begin();
+    auto rhsIt = rhsItems.begin();
+
+    while (lhsIt != lhsItems.end() || rhsIt != rhsItems.end()) {
+        if (rhsIt == rhsItems.end() ||
+            (lhsIt != lhsItems.end() && lessThan(*lhsIt, *rhsIt))) {
+
+            rects.append(tileRect(*lhsIt));
+            ++lhsIt;
+        } else if (lhsIt == lhsItems.end() || lessThan(*rhsIt, *lhsIt)) {
+            rects.append(tileRect(*rhsIt));
+            ++rhsIt;
+        } else {
+            if (lhsIt->version != rhsIt->version) {
+                rects.append(tileRect(*lhsIt));
+            }
+            ++lhsIt;
+            ++rhsIt;
+        }
+    }
+
+    return rects;
+}
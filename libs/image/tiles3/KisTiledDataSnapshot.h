@@ -0,0 +1,72 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISTILEDDATASNAPSHOT_H
+#define KISTILEDDATASNAPSHOT_H
+
+#include <QSharedPointer>
+#include <QVector>
+#include <QRect>
+#include "kritaimage_export.h"
+
+class KisTiledDataManager;
+
+/**
+ * A lightweight snapshot of the content of a data manager.
+ *
+ * The snapshot doesn't copy any pixels. Instead, it remembers the
+ * content version of every tile data of the data manager (see
+ * KisTileData::contentVersion()). The version changes whenever the
+ * tile is locked for writing, so two snapshots are equal only when
+ * they have exactly the same pixel data, which makes it a reliable
+ * and cheap way to check whether the content of a device has changed
+ * since some moment in the past.
+ *
+ * The snapshot doesn't keep the tile data alive and doesn't cause
+ * copy-on-write of the tiles, it costs a few bytes per tile only.
+ * The check is conservative: a tile that has been locked for writing
+ * is considered changed even if its pixels stayed the same.
+ *
+ * The default pixel is not a part of the snapshot.
+ */
+class KRITAIMAGE_EXPORT KisTiledDataSnapshot
+{
+public:
+    KisTiledDataSnapshot();
+    KisTiledDataSnapshot(KisTiledDataManager *dm);
+
+    bool isNull() const;
+
+    bool operator==(const KisTiledDataSnapshot &rhs) const;
+    bool operator!=(const KisTiledDataSnapshot &rhs) const;
+
+    /**
+     * A hash value suitable for using the snapshot as a key
+     * in QHash
+     */
+    uint hash() const;
+
+    /**
+     * Returns the rects of the tiles that differ between this snapshot
+     * and \p previous, including the tiles that are present in only one
+     * of them. The rects are in the coordinate system of the data manager,
+     * i.e. the offset of the paint device is not applied.
+     *
+     * A null snapshot is treated as an empty one.
+     */
+    QVector<QRect> changedTileRects(const KisTiledDataSnapshot &previous) const;
+
+private:
+    struct Private;
+    QSharedPointer<Private> m_d;
+};
+
+inline uint qHash(const KisTiledDataSnapshot &snapshot, uint seed = 0)
+{
+    return snapshot.hash() ^ seed;
+}
+
+#endif // KISTILEDDATASNAPSHOT_H
@@ -13,14 +13,17 @@
 #include "kis_types.h"
 #include "kis_shared.h"
 #include "kis_iterator_complete_listener.h"
+#include "KisTileWrapMapping.h"
 
 class KisBaseIterator {
 protected:
-    KisBaseIterator(KisTiledDataManager * _dataManager, bool _writable, KisIteratorCompleteListener *listener) {
+    KisBaseIterator(KisTiledDataManager * _dataManager, bool _writable, KisIteratorCompleteListener *listener,
+                    const KisTileWrapMapping &wrapMapping) {
         m_dataManager = _dataManager;
         m_pixelSize = m_dataManager->pixelSize();
         m_writable = _writable;
         m_completeListener = listener;
+        m_wrapMapping = wrapMapping;
     }
     ~KisBaseIterator() {
         if (m_writable && m_completeListener) {
@@ -31,6 +34,8 @@ protected:
     KisTiledDataManager *m_dataManager;
     qint32 m_pixelSize;        // bytes per pixel
     bool m_writable;
+    KisTileWrapMapping m_wrapMapping;
+
     inline void lockTile(KisTileSP &tile) {
         if (m_writable)
             tile->lockForWrite();
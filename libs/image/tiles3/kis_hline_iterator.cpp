@@ -7,8 +7,9 @@
 #include "kis_hline_iterator.h"
 
 
-KisHLineIterator2::KisHLineIterator2(KisDataManager *dataManager, qint32 x, qint32 y, qint32 w, qint32 offsetX, qint32 offsetY, bool writable, KisIteratorCompleteListener *completionListener)
-    : KisBaseIterator(dataManager, writable, completionListener),
+KisHLineIterator2::KisHLineIterator2(KisDataManager *dataManager, qint32 x, qint32 y, qint32 w, qint32 offsetX, qint32 offsetY, bool writable, KisIteratorCompleteListener *completionListener,
+                                     const KisTileWrapMapping &wrapMapping)
+    : KisBaseIterator(dataManager, writable, completionListener, wrapMapping),
       m_offsetX(offsetX),
       m_offsetY(offsetY)
 {
@@ -190,7 +191,8 @@ void KisHLineIterator2::switchToTile(qint32 xInTile)
 
 void KisHLineIterator2::fetchTileDataForCache(KisTileInfo& kti, qint32 col, qint32 row)
 {
-    m_dataManager->getTilesPair(col, row, m_writable, &kti.tile, &kti.oldtile);
+    m_dataManager->getTilesPair(m_wrapMapping.col(col), m_wrapMapping.row(row),
+                                m_writable, &kti.tile, &kti.oldtile);
 
     lockTile(kti.tile);
     kti.data = kti.tile->data();
@@ -25,7 +25,8 @@ public:
 
 
 public:    
-    KisHLineIterator2(KisDataManager *dataManager, qint32 x, qint32 y, qint32 w, qint32 offsetX, qint32 offsetY, bool writable, KisIteratorCompleteListener *listener);
+    KisHLineIterator2(KisDataManager *dataManager, qint32 x, qint32 y, qint32 w, qint32 offsetX, qint32 offsetY, bool writable, KisIteratorCompleteListener *listener,
+                      const KisTileWrapMapping &wrapMapping = KisTileWrapMapping());
     ~KisHLineIterator2() override;
     
     bool nextPixel() override;
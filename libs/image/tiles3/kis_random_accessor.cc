@@ -12,7 +12,8 @@
 
 const quint32 KisRandomAccessor2::CACHESIZE = 4; // Define the number of tiles we keep in cache
 
-KisRandomAccessor2::KisRandomAccessor2(KisTiledDataManager *ktm, qint32 offsetX, qint32 offsetY, bool writable, KisIteratorCompleteListener *completeListener) :
+KisRandomAccessor2::KisRandomAccessor2(KisTiledDataManager *ktm, qint32 offsetX, qint32 offsetY, bool writable, KisIteratorCompleteListener *completeListener,
+                                       const KisTileWrapMapping &wrapMapping) :
         m_ktm(ktm),
         m_tilesCache(new KisTileInfo*[CACHESIZE]),
         m_tilesCacheSize(0),
@@ -24,7 +25,8 @@ KisRandomAccessor2::KisRandomAccessor2(KisTiledDataManager *ktm, qint32 offsetX,
         m_lastY(0),
         m_offsetX(offsetX),
         m_offsetY(offsetY),
-        m_completeListener(completeListener)
+        m_completeListener(completeListener),
+        m_wrapMapping(wrapMapping)
 {
     Q_ASSERT(ktm != 0);
 }
@@ -110,7 +112,8 @@ KisRandomAccessor2::KisTileInfo* KisRandomAccessor2::fetchTileData(qint32 col, q
 {
     KisTileInfo* kti = new KisTileInfo;
 
-    m_ktm->getTilesPair(col, row, m_writable, &kti->tile, &kti->oldtile);
+    m_ktm->getTilesPair(m_wrapMapping.col(col), m_wrapMapping.row(row),
+                        m_writable, &kti->tile, &kti->oldtile);
 
     lockTile(kti->tile);
     kti->data = kti->tile->data();
@@ -12,6 +12,7 @@
 #include "kis_tiled_data_manager.h"
 #include "kis_random_accessor_ng.h"
 #include "kis_iterator_complete_listener.h"
+#include "KisTileWrapMapping.h"
 
 
 class KisRandomAccessor2 : public KisRandomAccessorNG
@@ -27,7 +28,8 @@ class KisRandomAccessor2 : public KisRandomAccessorNG
 
 public:
 
-    KisRandomAccessor2(KisTiledDataManager *ktm, qint32 offsetX, qint32 offsetY, bool writable, KisIteratorCompleteListener *completeListener);
+    KisRandomAccessor2(KisTiledDataManager *ktm, qint32 offsetX, qint32 offsetY, bool writable, KisIteratorCompleteListener *completeListener,
+                       const KisTileWrapMapping &wrapMapping = KisTileWrapMapping());
     KisRandomAccessor2(const KisTiledRandomAccessor& lhs);
     ~KisRandomAccessor2() override;
 
@@ -89,6 +91,7 @@ private:
     int m_lastX, m_lastY;
     qint32 m_offsetX, m_offsetY;
     KisIteratorCompleteListener *m_completeListener;
+    KisTileWrapMapping m_wrapMapping;
     static const quint32 CACHESIZE; // Define the number of tiles we keep in cache
 
 };
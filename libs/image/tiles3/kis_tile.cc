@@ -258,11 +258,19 @@ void KisTile::lockForWrite()
 #endif
     }
 
+    m_tileData->resetContentVersion();
+
     DEBUG_LOG_ACTION("lock [W]");
 }
 
 void KisTile::unlockForWrite()
 {
+    /**
+     * The version could have been requested while we were
+     * writing, so reset it once again
+     */
+    m_tileData->resetContentVersion();
+
     unblockSwapping();
     DEBUG_LOG_ACTION("unlock [W]");
 
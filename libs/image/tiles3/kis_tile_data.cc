@@ -25,6 +25,7 @@ const qint32 KisTileData::WIDTH = __TILE_DATA_WIDTH;
 const qint32 KisTileData::HEIGHT = __TILE_DATA_HEIGHT;
 
 SimpleCache KisTileData::m_cache;
+QAtomicInteger<quint64> KisTileData::m_lastContentVersion(0);
 
 SimpleCache::~SimpleCache()
 {
@@ -56,6 +57,7 @@ KisTileData::KisTileData(qint32 pixelSize, const quint8 *defPixel, KisTileDataSt
       m_age(0),
       m_usersCount(0),
       m_refCount(0),
+      m_contentVersion(0),
       m_pixelSize(pixelSize),
       m_store(store)
 {
@@ -85,6 +87,7 @@ KisTileData::KisTileData(const KisTileData& rhs, bool checkFreeMemory)
       m_age(0),
       m_usersCount(0),
       m_refCount(0),
+      m_contentVersion(0),
       m_pixelSize(rhs.m_pixelSize),
       m_store(rhs.m_store)
 {
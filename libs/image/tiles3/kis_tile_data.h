@@ -25,6 +25,7 @@ inline quint8* KisTileData::data() const {
 
 void KisTileData::setData(const quint8 *data) {
     Q_ASSERT(m_data);
+    resetContentVersion();
     memcpy(m_data, data, m_pixelSize*WIDTH*HEIGHT);
 }
 
@@ -107,6 +108,28 @@ inline bool KisTileData::historical() const {
     return mementoed() && numUsers() <= 1;
 }
 
+inline quint64 KisTileData::contentVersion() const {
+    quint64 version = m_contentVersion.loadAcquire();
+
+    if (!version) {
+        const quint64 newVersion = m_lastContentVersion.fetchAndAddOrdered(1) + 1;
+
+        /**
+         * Someone else could have assigned the version
+         * concurrently, then just use their value
+         */
+        if (m_contentVersion.testAndSetOrdered(0, newVersion, version)) {
+            version = newVersion;
+        }
+    }
+
+    return version;
+}
+
+inline void KisTileData::resetContentVersion() {
+    m_contentVersion.storeRelease(0);
+}
+
 inline int KisTileData::age() const {
     return m_age;
 }
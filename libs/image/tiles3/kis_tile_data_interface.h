@@ -180,6 +180,23 @@ public:
      */
     inline bool historical() const;
 
+    /**
+     * A number identifying the current content of the tile data.
+     * The number is assigned lazily on the first request and is
+     * unique during the whole run of the application. It changes
+     * whenever the tile data is locked for writing, so if two calls
+     * return the same value, the pixels haven't changed in between.
+     *
+     * Unlike acquiring the tile data, requesting the version doesn't
+     * prevent in-place modifications and doesn't keep any memory alive.
+     */
+    inline quint64 contentVersion() const;
+
+    /**
+     * Called by KisTile when the tile data is going to be modified
+     */
+    inline void resetContentVersion();
+
     /**
      * Used for swapping purposes only.
      * Frees the memory occupied by the tile data.
@@ -300,6 +317,14 @@ private:
      */
     mutable QAtomicInt m_refCount;
 
+    /**
+     * The version of the content, zero means it hasn't
+     * been requested since the last modification.
+     * See contentVersion()
+     */
+    mutable QAtomicInteger<quint64> m_contentVersion;
+    static QAtomicInteger<quint64> m_lastContentVersion;
+
 
     qint32 m_pixelSize;
     //qint32 m_timeStamp;
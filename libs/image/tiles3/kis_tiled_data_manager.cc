@@ -116,18 +116,23 @@ bool KisTiledDataManager::write(KisPaintDeviceWriter &store)
     KisTileHashTableConstIterator iter(m_hashTable);
     KisTileSP tile;
 
-    KisAbstractTileCompressorSP compressor =
-        KisTileCompressorFactory::create(CURRENT_VERSION);
+    QVector<KisTileSP> tiles;
+    tiles.reserve(m_hashTable->numTiles());
 
     while ((tile = iter.tile())) {
-        retval = compressor->writeTile(tile, store);
-        if (!retval) {
-            warnFile << "Failed to write tile";
-            break;
-        }
+        tiles.append(tile);
         iter.next();
     }
 
+    /**
+     * The compressor is free to compress the tiles in parallel,
+     * we hold the read lock anyway
+     */
+    KisAbstractTileCompressorSP compressor =
+        KisTileCompressorFactory::create(CURRENT_VERSION);
+
+    retval = compressor->writeTiles(tiles, store);
+
     return retval;
 }
 bool KisTiledDataManager::read(QIODevice *stream)
@@ -167,12 +172,7 @@ bool KisTiledDataManager::read(QIODevice *stream)
     KisAbstractTileCompressorSP compressor =
         KisTileCompressorFactory::create(tilesVersion);
 
-    bool readSuccess = true;
-    for (quint32 i = 0; i < numTiles; i++) {
-        if (!compressor->readTile(stream, this)) {
-            readSuccess = false;
-        }
-    }
+    bool readSuccess = compressor->readTiles(stream, this, numTiles);
 
     m_mementoManager->commit();
     return readSuccess;
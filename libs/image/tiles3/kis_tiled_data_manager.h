@@ -345,6 +345,7 @@ private:
     // and pixel size
     friend class KisAbstractTileCompressor;
     friend class KisTileDataWrapper;
+    friend class KisTiledDataSnapshot;
     inline qint32 xToCol(qint32 x) const
     {
         return divideRoundDown(x, KisTileData::WIDTH);
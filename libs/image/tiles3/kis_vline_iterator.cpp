@@ -9,8 +9,9 @@
 
 #include <iostream>
 
-KisVLineIterator2::KisVLineIterator2(KisDataManager *dataManager, qint32 x, qint32 y, qint32 h, qint32 offsetX, qint32 offsetY, bool writable, KisIteratorCompleteListener *completeListener)
-    : KisBaseIterator(dataManager, writable, completeListener),
+KisVLineIterator2::KisVLineIterator2(KisDataManager *dataManager, qint32 x, qint32 y, qint32 h, qint32 offsetX, qint32 offsetY, bool writable, KisIteratorCompleteListener *completeListener,
+                                     const KisTileWrapMapping &wrapMapping)
+    : KisBaseIterator(dataManager, writable, completeListener, wrapMapping),
       m_offsetX(offsetX),
       m_offsetY(offsetY)
 {
@@ -193,7 +194,8 @@ void KisVLineIterator2::switchToTile(qint32 yInTile)
 
 void KisVLineIterator2::fetchTileDataForCache(KisTileInfo& kti, qint32 col, qint32 row)
 {
-    m_dataManager->getTilesPair(col, row, m_writable, &kti.tile, &kti.oldtile);
+    m_dataManager->getTilesPair(m_wrapMapping.col(col), m_wrapMapping.row(row),
+                                m_writable, &kti.tile, &kti.oldtile);
 
     lockTile(kti.tile);
     kti.data = kti.tile->data();
@@ -26,7 +26,8 @@ public:
 
 
 public:
-    KisVLineIterator2(KisDataManager *dataManager, qint32 x, qint32 y, qint32 h, qint32 offsetX, qint32 offsetY, bool writable, KisIteratorCompleteListener *completeListener);
+    KisVLineIterator2(KisDataManager *dataManager, qint32 x, qint32 y, qint32 h, qint32 offsetX, qint32 offsetY, bool writable, KisIteratorCompleteListener *completeListener,
+                      const KisTileWrapMapping &wrapMapping = KisTileWrapMapping());
     ~KisVLineIterator2() override;
 
     void resetPixelPos() override;
@@ -6,6 +6,8 @@
 
 #include "kis_abstract_tile_compressor.h"
 
+#include <kis_debug.h>
+
 KisAbstractTileCompressor::KisAbstractTileCompressor()
 {
 }
@@ -13,3 +15,28 @@ KisAbstractTileCompressor::KisAbstractTileCompressor()
 KisAbstractTileCompressor::~KisAbstractTileCompressor()
 {
 }
+
+bool KisAbstractTileCompressor::writeTiles(const QVector<KisTileSP> &tiles, KisPaintDeviceWriter &store)
+{
+    Q_FOREACH (KisTileSP tile, tiles) {
+        if (!writeTile(tile, store)) {
+            warnFile << "Failed to write tile";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool KisAbstractTileCompressor::readTiles(QIODevice *stream, KisTiledDataManager *dm, quint32 numTiles)
+{
+    bool readSuccess = true;
+
+    for (quint32 i = 0; i < numTiles; i++) {
+        if (!readTile(stream, dm)) {
+            readSuccess = false;
+        }
+    }
+
+    return readSuccess;
+}
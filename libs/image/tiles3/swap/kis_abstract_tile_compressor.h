@@ -35,6 +35,15 @@ public:
      */
     virtual bool writeTile(KisTileSP tile, KisPaintDeviceWriter &store) = 0;
 
+    /**
+     * Compresses all the \p tiles and writes them into the \p store
+     * in the order they are passed. The default implementation just
+     * calls writeTile() for every tile, the compressors are free to
+     * compress the tiles in parallel as long as the resulting stream
+     * stays the same.
+     */
+    virtual bool writeTiles(const QVector<KisTileSP> &tiles, KisPaintDeviceWriter &store);
+
     /**
      * Decompresses the \a tile from the \a stream.
      * Used by datamanager in load/save routines
@@ -43,6 +52,15 @@ public:
      */
     virtual bool readTile(QIODevice *stream, KisTiledDataManager *dm) = 0;
 
+    /**
+     * Reads \p numTiles tiles from the \p stream. The default
+     * implementation just calls readTile() for every tile, the
+     * compressors are free to decompress the tiles in parallel.
+     *
+     * \return false if any of the tiles failed to load
+     */
+    virtual bool readTiles(QIODevice *stream, KisTiledDataManager *dm, quint32 numTiles);
+
     /**
      * Compresses a \p tileData and writes it into the \p buffer.
      * The buffer must be at least tileDataBufferSize() bytes long.
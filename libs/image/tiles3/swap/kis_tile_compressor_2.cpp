@@ -7,11 +7,36 @@
 #include "kis_tile_compressor_2.h"
 #include "kis_lzf_compression.h"
 #include <QIODevice>
+#include <QSet>
+#include <atomic>
 #include "kis_paint_device_writer.h"
+#include "krita_utils.h"
 #define TILE_DATA_SIZE(pixelSize) ((pixelSize) * KisTileData::WIDTH * KisTileData::HEIGHT)
 
 const QString KisTileCompressor2::m_compressionName = "LZF";
 
+namespace {
+
+/**
+ * Don't spawn a job for fewer tiles than that, the
+ * synchronization would cost more than the compression
+ */
+const int minTilesPerJob = 16;
+
+/**
+ * The number of tiles compressed before flushing them into
+ * the store. It limits the memory used for the compressed
+ * data, which is 64 MiB in the worst case of 16-byte pixels.
+ */
+const int tilesBatchSize = 1024;
+
+int numJobsForBatch(int numTiles)
+{
+    return qBound(1, numTiles / minTilesPerJob, KritaUtils::parallelForMaxThreads());
+}
+
+}
+
 
 KisTileCompressor2::KisTileCompressor2()
 {
@@ -25,15 +50,8 @@ KisTileCompressor2::~KisTileCompressor2()
 
 bool KisTileCompressor2::writeTile(KisTileSP tile, KisPaintDeviceWriter &store)
 {
-    const qint32 tileDataSize = TILE_DATA_SIZE(tile->pixelSize());
-    prepareStreamingBuffer(tileDataSize);
-
     qint32 bytesWritten;
-
-    tile->lockForRead();
-    compressTileData(tile->tileData(), (quint8*)m_streamingBuffer.data(),
-                     m_streamingBuffer.size(), bytesWritten);
-    tile->unlockForRead();
+    compressTile(tile, m_streamingBuffer, bytesWritten);
 
     QString header = getHeader(tile, bytesWritten);
     bool retval = true;
@@ -48,6 +66,55 @@ bool KisTileCompressor2::writeTile(KisTileSP tile, KisPaintDeviceWriter &store)
     return retval;
 }
 
+bool KisTileCompressor2::writeTiles(const QVector<KisTileSP> &tiles, KisPaintDeviceWriter &store)
+{
+    if (numJobsForBatch(tiles.size()) < 2) {
+        return KisAbstractTileCompressor::writeTiles(tiles, store);
+    }
+
+    struct CompressedTile {
+        QByteArray data;
+        qint32 bytesWritten = 0;
+        QByteArray header;
+    };
+
+    QVector<CompressedTile> batch(qMin(tilesBatchSize, tiles.size()));
+
+    for (int batchStart = 0; batchStart < tiles.size(); batchStart += tilesBatchSize) {
+        const int batchEnd = qMin(batchStart + tilesBatchSize, tiles.size());
+        std::atomic<int> nextTile(batchStart);
+
+        auto compressTiles = [&] () {
+            KisTileCompressor2 compressor;
+
+            int i;
+            while ((i = nextTile.fetch_add(1)) < batchEnd) {
+                CompressedTile &result = batch[i - batchStart];
+                compressor.compressTile(tiles[i], result.data, result.bytesWritten);
+                result.header = compressor.getHeader(tiles[i], result.bytesWritten).toLatin1();
+            }
+        };
+
+        KritaUtils::parallelFor(numJobsForBatch(batchEnd - batchStart), [&] (int) { compressTiles(); });
+
+        for (int i = 0; i < batchEnd - batchStart; i++) {
+            const CompressedTile &result = batch[i];
+
+            if (!store.write(result.header)) {
+                warnFile << "Failed to write the tile header";
+                return false;
+            }
+
+            if (!store.write(result.data.constData(), result.bytesWritten)) {
+                warnFile << "Failed to write the tile data";
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
 bool KisTileCompressor2::readTile(QIODevice *stream, KisTiledDataManager *dm)
 {
     const qint32 tileDataSize = TILE_DATA_SIZE(pixelSize(dm));
@@ -80,6 +147,151 @@ bool KisTileCompressor2::readTile(QIODevice *stream, KisTiledDataManager *dm)
     return false;
 }
 
+bool KisTileCompressor2::readTiles(QIODevice *stream, KisTiledDataManager *dm, quint32 numTiles)
+{
+    if (numJobsForBatch(numTiles) < 2) {
+        return KisAbstractTileCompressor::readTiles(stream, dm, numTiles);
+    }
+
+    const qint32 tileDataSize = TILE_DATA_SIZE(pixelSize(dm));
+
+    struct CompressedTile {
+        KisTileSP tile;
+        QByteArray data;
+        qint32 dataSize = 0;
+    };
+
+    QVector<CompressedTile> batch(qMin(quint32(tilesBatchSize), numTiles));
+    QSet<KisTile*> tilesInBatch;
+    CompressedTile duplicatedTile;
+
+    bool readSuccess = true;
+    quint32 tilesLeft = numTiles;
+
+    while (tilesLeft > 0) {
+        int batchSize = 0;
+        tilesInBatch.clear();
+
+        /**
+         * Reading from the store is sequential, so we read the
+         * compressed data in the current thread and decompress
+         * the whole batch in parallel.
+         */
+        while (tilesLeft > 0 && batchSize < batch.size()) {
+            QByteArray header = stream->readLine(maxHeaderLength());
+            tilesLeft--;
+
+            QList<QByteArray> headerItems = header.trimmed().split(',');
+            if (headerItems.size() != 4) {
+                readSuccess = false;
+                continue;
+            }
+
+            qint32 x = headerItems.takeFirst().toInt();
+            qint32 y = headerItems.takeFirst().toInt();
+            QString compressionName = headerItems.takeFirst();
+            qint32 dataSize = headerItems.takeFirst().toInt();
+
+            Q_ASSERT(headerItems.isEmpty());
+            Q_ASSERT(compressionName == m_compressionName);
+
+            /**
+             * The compressed data of a tile is never bigger than the raw
+             * data plus the compression flag. Skip the broken tile as a
+             * whole, so that the next header would still be found.
+             */
+            if (dataSize < 0 || dataSize > tileDataSize + 1) {
+                readSuccess = false;
+                if (dataSize > 0) {
+                    stream->skip(dataSize);
+                }
+                continue;
+            }
+
+            KisTileSP tile = dm->getTile(xToCol(dm, x), yToRow(dm, y), true);
+
+            /**
+             * A broken file may contain the same tile twice. The
+             * last copy should win, like in the serial reading, so
+             * we decompress it only after the batch is finished.
+             */
+            const bool isDuplicate = tilesInBatch.contains(tile.data());
+            tilesInBatch.insert(tile.data());
+
+            CompressedTile &item = isDuplicate ? duplicatedTile : batch[batchSize];
+            item.tile = tile;
+            item.dataSize = dataSize;
+
+            if (item.data.size() < tileDataSize + 1) {
+                item.data.resize(tileDataSize + 1);
+            }
+
+            stream->read(item.data.data(), item.dataSize);
+
+            if (isDuplicate) break;
+
+            batchSize++;
+        }
+
+        std::atomic<int> nextTile(0);
+        std::atomic<bool> decompressionSuccess(true);
+
+        auto decompressTiles = [&] () {
+            KisTileCompressor2 compressor;
+
+            int i;
+            while ((i = nextTile.fetch_add(1)) < batchSize) {
+                CompressedTile &item = batch[i];
+
+                item.tile->lockForWrite();
+                const bool res = compressor.decompressTileData((quint8*)item.data.data(),
+                                                               item.dataSize,
+                                                               item.tile->tileData());
+                item.tile->unlockForWrite();
+
+                if (!res) {
+                    decompressionSuccess = false;
+                }
+
+                item.tile = 0;
+            }
+        };
+
+        KritaUtils::parallelFor(numJobsForBatch(batchSize), [&] (int) { decompressTiles(); });
+
+        if (!decompressionSuccess) {
+            readSuccess = false;
+        }
+
+        if (duplicatedTile.tile) {
+            duplicatedTile.tile->lockForWrite();
+            if (!decompressTileData((quint8*)duplicatedTile.data.data(),
+                                    duplicatedTile.dataSize,
+                                    duplicatedTile.tile->tileData())) {
+                readSuccess = false;
+            }
+            duplicatedTile.tile->unlockForWrite();
+            duplicatedTile.tile = 0;
+        }
+    }
+
+    return readSuccess;
+}
+
+void KisTileCompressor2::compressTile(KisTileSP tile, QByteArray &buffer, qint32 &bytesWritten)
+{
+    const qint32 tileDataSize = TILE_DATA_SIZE(tile->pixelSize());
+
+    if (buffer.size() < tileDataSize + 1) {
+        buffer.resize(tileDataSize + 1);
+    }
+
+    tile->lockForRead();
+    compressTileData(tile->tileData(), (quint8*)buffer.data(),
+                     buffer.size(), bytesWritten);
+    tile->unlockForRead();
+}
+
 void KisTileCompressor2::prepareStreamingBuffer(qint32 tileDataSize)
 {
     /**
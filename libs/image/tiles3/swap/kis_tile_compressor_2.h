@@ -18,8 +18,21 @@ public:
     ~KisTileCompressor2() override;
 
     bool writeTile(KisTileSP tile, KisPaintDeviceWriter &store) override;
+
+    /**
+     * The tiles are compressed in parallel in small batches and
+     * written in the original order, so the resulting stream is
+     * byte-to-byte the same as the one written with writeTile()
+     */
+    bool writeTiles(const QVector<KisTileSP> &tiles, KisPaintDeviceWriter &store) override;
     bool readTile(QIODevice *io, KisTiledDataManager *dm) override;
 
+    /**
+     * The compressed data is read sequentially in batches, and
+     * every batch is decompressed in parallel
+     */
+    bool readTiles(QIODevice *stream, KisTiledDataManager *dm, quint32 numTiles) override;
+
 
     void compressTileData(KisTileData *tileData,quint8 *buffer,
                           qint32 bufferSize, qint32 &bytesWritten) override;
@@ -34,6 +47,12 @@ private:
 
     QString getHeader(KisTileSP tile, qint32 compressedSize);
 
+    /**
+     * Compresses the tile into the \p buffer, which is resized to
+     * be big enough to hold the data of the tile
+     */
+    void compressTile(KisTileSP tile, QByteArray &buffer, qint32 &bytesWritten);
+
     void prepareWorkBuffers(qint32 tileDataSize);
     void prepareStreamingBuffer(qint32 tileDataSize);
 
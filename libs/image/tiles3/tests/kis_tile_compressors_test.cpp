@@ -7,6 +7,8 @@
 #include "kis_tile_compressors_test.h"
 #include <simpletest.h>
 
+#include <QRandomGenerator>
+
 #include "tiles3/kis_tiled_data_manager.h"
 #include "tiles3/swap/kis_legacy_tile_compressor.h"
 #include "tiles3/swap/kis_tile_compressor_2.h"
@@ -168,5 +170,154 @@ void KisTileCompressorsTest::testLowLevelRoundTripIncompressible2()
 }
 
 
+void KisTileCompressorsTest::testParallelWriteTiles2()
+{
+    const qint32 pixelSize = 4;
+    const quint8 defaultPixel[pixelSize] = {0, 0, 0, 0};
+    KisTiledDataManager dm(pixelSize, defaultPixel);
+
+    /**
+     * Fill the tiles with different data, a part of them with
+     * noise, so that the compressed sizes are different
+     */
+    const int numTiles = 2500;
+    QVector<KisTileSP> tiles;
+    QRandomGenerator random(1000);
+
+    for (int i = 0; i < numTiles; i++) {
+        KisTileSP tile = dm.getTile(i % 50, i / 50, true);
+        quint8 *data = tile->data();
+
+        for (int j = 0; j < TILESIZE * pixelSize; j++) {
+            data[j] = i % 3 ? quint8(i) : quint8(random.bounded(256));
+        }
+
+        tiles.append(tile);
+    }
+
+    KoStoreFake serialStore;
+    KisFakePaintDeviceWriter serialWriter(&serialStore);
+
+    KisTileCompressor2 serialCompressor;
+    Q_FOREACH (KisTileSP tile, tiles) {
+        QVERIFY(serialCompressor.writeTile(tile, serialWriter));
+    }
+
+    KoStoreFake parallelStore;
+    KisFakePaintDeviceWriter parallelWriter(&parallelStore);
+
+    KisTileCompressor2 parallelCompressor;
+    QVERIFY(parallelCompressor.writeTiles(tiles, parallelWriter));
+
+    serialStore.startReading();
+    parallelStore.startReading();
+
+    const QByteArray serialData = serialStore.device()->readAll();
+    const QByteArray parallelData = parallelStore.device()->readAll();
+
+    QVERIFY(!serialData.isEmpty());
+    QCOMPARE(parallelData.size(), serialData.size());
+    QVERIFY(parallelData == serialData);
+
+    tiles.clear();
+
+    parallelStore.startReading();
+    dm.clear();
+
+    for (int i = 0; i < numTiles; i++) {
+        QVERIFY(parallelCompressor.readTile(parallelStore.device(), &dm));
+    }
+
+    KisTileSP tile = dm.getTile(1, 0, false);
+    QVERIFY(memoryIsFilled(1, tile->data(), TILESIZE * pixelSize));
+}
+
+void KisTileCompressorsTest::testParallelReadTiles2()
+{
+    const qint32 pixelSize = 4;
+    const quint8 defaultPixel[pixelSize] = {0, 0, 0, 0};
+    KisTiledDataManager dm(pixelSize, defaultPixel);
+
+    const int numTiles = 1000;
+    QVector<KisTileSP> tiles;
+
+    for (int i = 0; i < numTiles; i++) {
+        KisTileSP tile = dm.getTile(i % 50, i / 50, true);
+        memset(tile->data(), i % 256, TILESIZE * pixelSize);
+        tiles.append(tile);
+    }
+
+    /**
+     * Write the first tile once again with different data at the
+     * end of the stream, so that it is duplicated in the same batch.
+     * The last copy should win.
+     */
+    KoStoreFake store;
+    KisFakePaintDeviceWriter writer(&store);
+
+    KisTileCompressor2 compressor;
+    QVERIFY(compressor.writeTiles(tiles, writer));
+
+    memset(tiles.first()->data(), 255, TILESIZE * pixelSize);
+    QVERIFY(compressor.writeTile(tiles.first(), writer));
+
+    tiles.clear();
+    store.startReading();
+
+    KisTiledDataManager dm2(pixelSize, defaultPixel);
+    QVERIFY(compressor.readTiles(store.device(), &dm2, numTiles + 1));
+
+    for (int i = 1; i < numTiles; i++) {
+        KisTileSP tile = dm2.getTile(i % 50, i / 50, false);
+        QVERIFY(memoryIsFilled(i % 256, tile->data(), TILESIZE * pixelSize));
+    }
+
+    KisTileSP tile = dm2.getTile(0, 0, false);
+    QVERIFY(memoryIsFilled(255, tile->data(), TILESIZE * pixelSize));
+}
+
+void KisTileCompressorsTest::testParallelReadOversizedTile2()
+{
+    const qint32 pixelSize = 4;
+    const quint8 defaultPixel[pixelSize] = {0, 0, 0, 0};
+    KisTiledDataManager dm(pixelSize, defaultPixel);
+
+    const int numTiles = 1000;
+    QVector<KisTileSP> tiles;
+
+    for (int i = 0; i < numTiles; i++) {
+        KisTileSP tile = dm.getTile(i % 50, i / 50, true);
+        memset(tile->data(), i % 256, TILESIZE * pixelSize);
+        tiles.append(tile);
+    }
+
+    /**
+     * Put a tile with the data bigger than any compressed tile
+     * in the middle of the stream. It should be skipped as a whole,
+     * and the tiles after it should still be read.
+     */
+    const int brokenTileSize = 2 * TILESIZE * pixelSize;
+
+    KoStoreFake store;
+    KisFakePaintDeviceWriter writer(&store);
+
+    KisTileCompressor2 compressor;
+    QVERIFY(compressor.writeTiles(tiles.mid(0, numTiles / 2), writer));
+    QVERIFY(writer.write(QString("%1,%2,LZF,%3\n").arg(0).arg(0).arg(brokenTileSize).toLatin1()));
+    QVERIFY(writer.write(QByteArray(brokenTileSize, '\xff')));
+    QVERIFY(compressor.writeTiles(tiles.mid(numTiles / 2), writer));
+
+    tiles.clear();
+    store.startReading();
+
+    KisTiledDataManager dm2(pixelSize, defaultPixel);
+    QVERIFY(!compressor.readTiles(store.device(), &dm2, numTiles + 1));
+
+    for (int i = 0; i < numTiles; i++) {
+        KisTileSP tile = dm2.getTile(i % 50, i / 50, false);
+        QVERIFY(memoryIsFilled(i % 256, tile->data(), TILESIZE * pixelSize));
+    }
+}
+
 SIMPLE_TEST_MAIN(KisTileCompressorsTest)
 
@@ -9,7 +9,10 @@
 
 #include <QRandomGenerator>
 
+#include <algorithm>
+
 #include "tiles3/kis_tiled_data_manager.h"
+#include "tiles3/KisTiledDataSnapshot.h"
 
 #include "tiles_test_utils.h"
 #include "config-limit-long-tests.h"
@@ -531,6 +534,80 @@ void KisTiledDataManagerTest::testUndoSetDefaultPixel()
 
 //#include <valgrind/callgrind.h>
 
+void KisTiledDataManagerTest::testContentSnapshot()
+{
+    quint8 defaultPixel = 0;
+    KisTiledDataManager dm(1, &defaultPixel);
+
+    quint8 oddPixel1 = 128;
+    quint8 oddPixel2 = 129;
+
+    dm.clear(QRect(0,0,128,64), &oddPixel1);
+
+    KisTiledDataSnapshot snapshot1(&dm);
+    KisTiledDataSnapshot snapshot2(&dm);
+
+    QVERIFY(!snapshot1.isNull());
+    QVERIFY(snapshot1 == snapshot2);
+    QCOMPARE(snapshot1.hash(), snapshot2.hash());
+
+    {
+        // a copy of the data manager shares the tiles until modified
+        KisTiledDataManager dmCopy(dm);
+        QVERIFY(KisTiledDataSnapshot(&dmCopy) == snapshot1);
+    }
+
+    dm.clear(QRect(0,0,10,10), &oddPixel2);
+
+    KisTiledDataSnapshot snapshot3(&dm);
+    QVERIFY(snapshot3 != snapshot1);
+
+    /**
+     * Now the tile is not shared with anyone, so it is modified
+     * in-place. The snapshot must neither prevent that nor miss
+     * the change.
+     */
+    KisTileData *tileData = dm.getTile(0, 0, false)->tileData();
+
+    dm.clear(QRect(0,0,10,10), &oddPixel1);
+    QCOMPARE(dm.getTile(0, 0, false)->tileData(), tileData);
+    QVERIFY(KisTiledDataSnapshot(&dm) != snapshot3);
+
+    QVERIFY(KisTiledDataSnapshot().isNull());
+    QVERIFY(KisTiledDataSnapshot() != snapshot3);
+}
+
+void KisTiledDataManagerTest::testSnapshotChangedTiles()
+{
+    quint8 defaultPixel = 0;
+    KisTiledDataManager dm(1, &defaultPixel);
+
+    quint8 oddPixel1 = 128;
+    quint8 oddPixel2 = 129;
+
+    dm.clear(QRect(0,0,128,128), &oddPixel1);
+
+    KisTiledDataSnapshot snapshot1(&dm);
+    QVERIFY(KisTiledDataSnapshot(&dm).changedTileRects(snapshot1).isEmpty());
+
+    // all the tiles are new compared to a null snapshot
+    QCOMPARE(snapshot1.changedTileRects(KisTiledDataSnapshot()).size(), 4);
+
+    // modify one tile and add another one
+    dm.clear(QRect(70,10,10,10), &oddPixel2);
+    dm.clear(QRect(200,10,10,10), &oddPixel2);
+
+    KisTiledDataSnapshot snapshot2(&dm);
+    QVector<QRect> rects = snapshot2.changedTileRects(snapshot1);
+    std::sort(rects.begin(), rects.end(), [] (const QRect &lhs, const QRect &rhs) { return lhs.x() < rhs.x(); });
+
+    QCOMPARE(rects, QVector<QRect>({QRect(64,0,64,64), QRect(192,0,64,64)}));
+
+    // removed tiles are reported as well
+    dm.clear();
+    QCOMPARE(KisTiledDataSnapshot(&dm).changedTileRects(snapshot2).size(), 5);
+}
+
 void KisTiledDataManagerTest::benchmarkReadOnlyTileLazy()
 {
     quint8 defaultPixel = 0;
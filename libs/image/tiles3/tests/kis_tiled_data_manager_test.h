@@ -40,6 +40,8 @@ private Q_SLOTS:
     void testTransactions();
     void testPurgeHistory();
     void testUndoSetDefaultPixel();
+    void testContentSnapshot();
+    void testSnapshotChangedTiles();
 
     void benchmarkReadOnlyTileLazy();
     void benchmarkSharedPointers();
@@ -12,12 +12,16 @@
 #include <QtEndian>
 #include <QtGlobal>
 
+#include <functional>
+#include <memory>
+
 #include <KoColorSpace.h>
 #include <KoColorSpaceMaths.h>
 #include <KoColorSpaceTraits.h>
 #include <colorspaces/KoAlphaColorSpace.h>
 #include <kis_global.h>
 #include <kis_iterator_ng.h>
+#include <krita_utils.h>
 
 #include <asl/kis_asl_reader_utils.h>
 #include <asl/kis_asl_writer_utils.h>
@@ -298,39 +302,130 @@ void readAlphaMaskPixelCommon(int channelSize, const QMap<quint16, QByteArray> &
     }
 }
 
-QMap<quint16, QByteArray> fetchChannelsBytes(QIODevice &io, QVector<ChannelInfo *> channelInfoRecords, int row, int width, int channelSize, bool processMasks)
+namespace
 {
-    const int uncompressedLength = width * channelSize;
+/**
+ * The channel data is processed in bands of this height. It is the
+ * height of a tile, so every band covers whole rows of tiles of the
+ * device, and the memory needed for the conversion doesn't depend on
+ * the size of the layer.
+ */
+const int bandHeight = 64;
 
-    QMap<quint16, QByteArray> channelBytes;
+/**
+ * Returns the row right after the end of the band starting at \p row.
+ * The bands are aligned to the tiles grid of the device, whose origin
+ * is at \p originY.
+ */
+int bandEnd(int row, int originY, int bottom)
+{
+    const int relativeRow = row - originY;
+    const int bandIndex = relativeRow >= 0 ? relativeRow / bandHeight : (relativeRow + 1) / bandHeight - 1;
 
-    Q_FOREACH (ChannelInfo *channelInfo, channelInfoRecords) {
-        // user supplied masks are ignored here
-        if (!processMasks && channelInfo->channelId < -1)
-            continue;
+    return qMin(originY + (bandIndex + 1) * bandHeight, bottom + 1);
+}
 
-        io.seek(channelInfo->channelDataStart + channelInfo->channelOffset);
+/**
+ * Decoding state of a single channel. The compressed data of every band
+ * is fetched from the file serially, then the band is decoded in the
+ * worker threads.
+ */
+struct ChannelBandReader {
+    ChannelInfo *info = nullptr;
+
+    QByteArray bandData;
+    QVector<int> rleRowOffsets;
+
+    // ZIP-compressed channel is a single zlib stream
+    std::unique_ptr<KisZipInflateStream> zipStream;
+
+    // uncompressed rows of the current band
+    QVector<QByteArray> rows;
+
+    bool isValid = true;
+};
 
-        if (channelInfo->compressionType == psd_compression_type::Uncompressed) {
-            channelBytes[channelInfo->channelId] = io.read(uncompressedLength);
-            channelInfo->channelOffset += uncompressedLength;
-        } else if (channelInfo->compressionType == psd_compression_type::RLE) {
-            int rleLength = channelInfo->rleRowLengths[row];
-            QByteArray compressedBytes = io.read(rleLength);
-            QByteArray uncompressedBytes = Compression::uncompress(uncompressedLength, compressedBytes, channelInfo->compressionType);
-            channelBytes.insert(channelInfo->channelId, uncompressedBytes);
-            channelInfo->channelOffset += rleLength;
-        } else {
-            QString error = QString("Unsupported Compression mode: %1")
-                                .arg(static_cast<std::uint16_t>(channelInfo->compressionType));
-            dbgFile << "ERROR: fetchChannelsBytes:" << error;
+void fetchBand(QIODevice &io, ChannelBandReader &reader, int firstRow, int numRows, int width, int channelSize)
+{
+    ChannelInfo *channelInfo = reader.info;
+    const int uncompressedLength = width * channelSize;
+
+    if (channelInfo->compressionType == psd_compression_type::Uncompressed) {
+        io.seek(channelInfo->channelDataStart + channelInfo->channelOffset);
+        reader.bandData = io.read(qint64(uncompressedLength) * numRows);
+        channelInfo->channelOffset += uncompressedLength * numRows;
+    } else if (channelInfo->compressionType == psd_compression_type::RLE) {
+        if (channelInfo->rleRowLengths.size() < firstRow + numRows) {
+            QString error = QString("Incomplete RLE row lengths block: channelId = %1").arg(channelInfo->channelId);
+            dbgFile << "ERROR: fetchBand:" << error;
             throw KisAslReaderUtils::ASLParseException(error);
         }
+
+        reader.rleRowOffsets.resize(numRows + 1);
+
+        int bandLength = 0;
+        for (int i = 0; i < numRows; i++) {
+            reader.rleRowOffsets[i] = bandLength;
+            bandLength += channelInfo->rleRowLengths[firstRow + i];
+        }
+        reader.rleRowOffsets[numRows] = bandLength;
+
+        io.seek(channelInfo->channelDataStart + channelInfo->channelOffset);
+        reader.bandData = io.read(bandLength);
+        channelInfo->channelOffset += bandLength;
+    } else if (channelInfo->compressionType == psd_compression_type::ZIP
+               || channelInfo->compressionType == psd_compression_type::ZIPWithPrediction) {
+        if (!reader.zipStream) {
+            io.seek(channelInfo->channelDataStart);
+            const QByteArray compressedBytes = io.read(channelInfo->channelDataLength);
+            reader.zipStream.reset(new KisZipInflateStream(compressedBytes, channelInfo->compressionType, width, channelSize * 8));
+        }
+    } else {
+        QString error = QString("Unsupported Compression mode: %1").arg(static_cast<std::uint16_t>(channelInfo->compressionType));
+        dbgFile << "ERROR: fetchBand:" << error;
+        throw KisAslReaderUtils::ASLParseException(error);
+    }
+
+    reader.rows.resize(numRows);
+}
+
+/**
+ * Returns a shallow copy of a part of \p data, clipped to its bounds
+ */
+QByteArray rawDataSlice(const QByteArray &data, int offset, int length)
+{
+    const int availableLength = qBound(0, data.size() - offset, length);
+    return QByteArray::fromRawData(data.constData() + offset, availableLength);
+}
+
+void decodeRow(ChannelBandReader &reader, int row, int width, int channelSize)
+{
+    const int uncompressedLength = width * channelSize;
+
+    if (reader.info->compressionType == psd_compression_type::RLE) {
+        const int offset = reader.rleRowOffsets[row];
+        const int length = reader.rleRowOffsets[row + 1] - offset;
+
+        reader.rows[row] = Compression::uncompress(uncompressedLength, rawDataSlice(reader.bandData, offset, length), psd_compression_type::RLE);
+    } else {
+        reader.rows[row] = rawDataSlice(reader.bandData, row * uncompressedLength, uncompressedLength);
     }
+}
+
+void decodeZipBand(ChannelBandReader &reader, int numRows, int width, int channelSize)
+{
+    const int uncompressedLength = width * channelSize;
+
+    reader.bandData.resize(uncompressedLength * numRows);
+    reader.isValid = reader.zipStream->readRows(reinterpret_cast<quint8 *>(reader.bandData.data()), numRows);
 
-    return channelBytes;
+    for (int row = 0; row < numRows; row++) {
+        reader.rows[row] = reader.isValid ? rawDataSlice(reader.bandData, row * uncompressedLength, uncompressedLength) : QByteArray();
+    }
 }
 
+} // namespace
+
 using PixelFunc = std::function<void(int, const QMap<quint16, QByteArray> &, int, quint8 *)>;
 
 void readCommon(KisPaintDeviceSP dev,
@@ -348,19 +443,65 @@ void readCommon(KisPaintDeviceSP dev,
         return;
     }
 
-    if (infoRecords.first()->compressionType == psd_compression_type::ZIP || infoRecords.first()->compressionType == psd_compression_type::ZIPWithPrediction) {
-        const int numPixels = channelSize * layerRect.width() * layerRect.height();
+    std::vector<ChannelBandReader> readers;
+
+    Q_FOREACH (ChannelInfo *channelInfo, infoRecords) {
+        // user supplied masks are ignored here
+        if (!processMasks && channelInfo->channelId < -1)
+            continue;
+
+        readers.emplace_back();
+        readers.back().info = channelInfo;
+    }
+
+    if (readers.empty()) {
+        dbgFile << "No channels to read!";
+        return;
+    }
+
+    const int width = layerRect.width();
+    const int pixelSize = dev->pixelSize();
+
+    /**
+     * Every band is fetched from the file serially, then the channels are
+     * decompressed concurrently (row by row for RLE), and then the pixels
+     * are converted and written into the device. Only one band of the
+     * uncompressed data is kept in memory at a time.
+     */
+    for (int y = layerRect.top(); y <= layerRect.bottom();) {
+        const int nextY = bandEnd(y, dev->y(), layerRect.bottom());
+        const int numRows = nextY - y;
+        const int firstRow = y - layerRect.top();
+
+        for (ChannelBandReader &reader : readers) {
+            fetchBand(io, reader, firstRow, numRows, width, channelSize);
+        }
+
+        QVector<std::function<void()>> decodingJobs;
 
-        QMap<quint16, QByteArray> channelBytes;
+        for (ChannelBandReader &reader : readers) {
+            ChannelBandReader *readerPtr = &reader;
 
-        Q_FOREACH (ChannelInfo *info, infoRecords) {
-            io.seek(info->channelDataStart);
-            QByteArray compressedBytes = io.read(info->channelDataLength);
-            QByteArray uncompressedBytes;
+            if (reader.zipStream) {
+                decodingJobs.append([readerPtr, numRows, width, channelSize]() {
+                    decodeZipBand(*readerPtr, numRows, width, channelSize);
+                });
+            } else {
+                for (int row = 0; row < numRows; row++) {
+                    decodingJobs.append([readerPtr, row, width, channelSize]() {
+                        decodeRow(*readerPtr, row, width, channelSize);
+                    });
+                }
+            }
+        }
 
-            uncompressedBytes = Compression::uncompress(numPixels, compressedBytes, infoRecords.first()->compressionType, layerRect.width(), channelSize * 8);
+        KritaUtils::parallelFor(decodingJobs.size(), [&](int i) {
+            decodingJobs[i]();
+        });
 
-            if (uncompressedBytes.size() != numPixels) {
+        for (const ChannelBandReader &reader : readers) {
+            if (!reader.isValid) {
+                ChannelInfo *info = reader.info;
                 QString error = QString("Failed to unzip channel data: id = %1, compression = %2")
                                     .arg(info->channelId)
                                     .arg(static_cast<std::uint16_t>(info->compressionType));
@@ -371,35 +512,29 @@ void readCommon(KisPaintDeviceSP dev,
                 dbgFile << "      " << ppVar(info->compressionType);
                 throw KisAslReaderUtils::ASLParseException(error);
             }
-
-            channelBytes.insert(info->channelId, uncompressedBytes);
         }
 
-        KisSequentialIterator it(dev, layerRect);
-        int col = 0;
-        while (it.nextPixel()) {
-            pixelFunc(channelSize, channelBytes, col, it.rawData());
-            col++;
-        }
+        QByteArray pixels(width * numRows * pixelSize, 0);
+        quint8 *pixelsPtr = reinterpret_cast<quint8 *>(pixels.data());
 
-    } else {
-        KisHLineIteratorSP it = dev->createHLineIteratorNG(layerRect.left(), layerRect.top(), layerRect.width());
-        for (int i = 0; i < layerRect.height(); i++) {
+        KritaUtils::parallelFor(numRows, [&](int row) {
             QMap<quint16, QByteArray> channelBytes;
 
-            channelBytes = fetchChannelsBytes(io, infoRecords, i, layerRect.width(), channelSize, processMasks);
-
-            for (int col = 0; col < layerRect.width(); col++) {
-                pixelFunc(channelSize, channelBytes, col, it->rawData());
-                it->nextPixel();
+            for (const ChannelBandReader &reader : readers) {
+                channelBytes.insert(reader.info->channelId, reader.rows[row]);
             }
 
-            /// don't write-access the row right after the
-            /// the end of the read area
-            if (i < layerRect.height() - 1) {
-                it->nextRow();
+            quint8 *dstPtr = pixelsPtr + row * width * pixelSize;
+
+            for (int col = 0; col < width; col++) {
+                pixelFunc(channelSize, channelBytes, col, dstPtr);
+                dstPtr += pixelSize;
             }
-        }
+        });
+
+        dev->writeBytes(reinterpret_cast<const quint8 *>(pixels.constData()), QRect(layerRect.left(), y, width, numRows));
+
+        y = nextY;
     }
 }
 
@@ -474,13 +609,12 @@ void readAlphaMaskChannels(QIODevice &io,
 }
 
 template<psd_byte_order byteOrder = psd_byte_order::psdBigEndian>
-void writeChannelDataRLEImpl(QIODevice &io,
-                             const quint8 *plane,
-                             const int channelSize,
-                             const QRect &rc,
-                             const qint64 sizeFieldOffset,
-                             const qint64 rleBlockOffset,
-                             const bool writeCompressionType)
+void writeChannelBlockRLEImpl(QIODevice &io,
+                              const QByteArray &compressedData,
+                              const QVector<quint16> &rleRowLengths,
+                              const qint64 sizeFieldOffset,
+                              const qint64 rleBlockOffset,
+                              const bool writeCompressionType)
 {
     using Pusher = KisAslWriterUtils::OffsetStreamPusher<quint32, byteOrder>;
     QScopedPointer<Pusher> channelBlockSizeExternalTag;
@@ -494,9 +628,6 @@ void writeChannelDataRLEImpl(QIODevice &io,
 
     const bool externalRleBlock = rleBlockOffset >= 0;
 
-    // the start of RLE sizes block
-    const qint64 channelRLESizePos = externalRleBlock ? rleBlockOffset : io.pos();
-
     {
         QScopedPointer<KisOffsetKeeper> rleOffsetKeeper;
 
@@ -505,34 +636,20 @@ void writeChannelDataRLEImpl(QIODevice &io,
             io.seek(rleBlockOffset);
         }
 
-        // write zero's for the channel lengths block
-        for (int i = 0; i < rc.height(); ++i) {
+        // the data is already compressed, so the lengths are known beforehand
+        Q_FOREACH (const quint16 rleRowLength, rleRowLengths) {
             // XXX: choose size for PSB!
-            const quint16 fakeRLEBLockSize = 0;
-            SAFE_WRITE_EX(byteOrder, io, fakeRLEBLockSize);
+            SAFE_WRITE_EX(byteOrder, io, rleRowLength);
         }
     }
 
-    const int stride = channelSize * rc.width();
-    for (qint32 row = 0; row < rc.height(); ++row) {
-        QByteArray uncompressed = QByteArray::fromRawData((const char *)plane + row * stride, stride);
-        QByteArray compressed = Compression::compress(uncompressed, psd_compression_type::RLE);
-
-        KisAslWriterUtils::OffsetStreamPusher<quint16, byteOrder> rleExternalTag(io, 0, channelRLESizePos + row * static_cast<qint64>(sizeof(quint16)));
-
-        if (io.write(compressed) != compressed.size()) {
-            throw KisAslWriterUtils::ASLWriteException("Failed to write image data");
-        }
+    if (io.write(compressedData) != compressedData.size()) {
+        throw KisAslWriterUtils::ASLWriteException("Failed to write image data");
     }
 }
 
 template<psd_byte_order byteOrder = psd_byte_order::psdBigEndian>
-void writeChannelDataZIPImpl(QIODevice &io,
-                             const quint8 *plane,
-                             const int channelSize,
-                             const QRect &rc,
-                             const qint64 sizeFieldOffset,
-                             const bool writeCompressionType)
+void writeChannelBlockZIPImpl(QIODevice &io, const QByteArray &compressedData, const qint64 sizeFieldOffset, const bool writeCompressionType)
 {
     using Pusher = KisAslWriterUtils::OffsetStreamPusher<quint32, byteOrder>;
     QScopedPointer<Pusher> channelBlockSizeExternalTag;
@@ -544,14 +661,41 @@ void writeChannelDataZIPImpl(QIODevice &io,
         SAFE_WRITE_EX(byteOrder, io, static_cast<quint16>(psd_compression_type::ZIP));
     }
 
-    QByteArray uncompressed(reinterpret_cast<const char *>(plane), rc.width() * rc.height() * channelSize);
-    QByteArray compressed(Compression::compress(uncompressed, psd_compression_type::ZIP));
-
-    if (compressed.size() == 0 || io.write(compressed) != compressed.size()) {
+    if (compressedData.size() == 0 || io.write(compressedData) != compressedData.size()) {
         throw KisAslWriterUtils::ASLWriteException("Failed to write image data");
     }
 }
 
+template<psd_byte_order byteOrder = psd_byte_order::psdBigEndian>
+void writeChannelDataRLEImpl(QIODevice &io,
+                             const quint8 *plane,
+                             const int channelSize,
+                             const QRect &rc,
+                             const qint64 sizeFieldOffset,
+                             const qint64 rleBlockOffset,
+                             const bool writeCompressionType)
+{
+    const int stride = channelSize * rc.width();
+
+    QVector<QByteArray> compressedRows(rc.height());
+
+    KritaUtils::parallelFor(rc.height(), [&](int row) {
+        QByteArray uncompressed = QByteArray::fromRawData((const char *)plane + row * stride, stride);
+        compressedRows[row] = Compression::compress(uncompressed, psd_compression_type::RLE);
+    });
+
+    QByteArray compressedData;
+    QVector<quint16> rleRowLengths;
+    rleRowLengths.reserve(rc.height());
+
+    Q_FOREACH (const QByteArray &compressedRow, compressedRows) {
+        compressedData.append(compressedRow);
+        rleRowLengths.append(static_cast<quint16>(compressedRow.size()));
+    }
+
+    writeChannelBlockRLEImpl<byteOrder>(io, compressedData, rleRowLengths, sizeFieldOffset, rleBlockOffset, writeCompressionType);
+}
+
 void writeChannelDataRLE(QIODevice &io,
                          const quint8 *plane,
                          const int channelSize,
@@ -609,6 +753,24 @@ inline void preparePixelForWrite(quint8 *dataPlane, int numPixels, int channelSi
     }
 }
 
+/**
+ * Encoding state of a single channel. The whole channel must be written
+ * into the file in one block, so the compressed data is accumulated in
+ * memory, while the uncompressed data is read from the device band by
+ * band.
+ */
+struct ChannelBandWriter {
+    QByteArray compressedData;
+    QVector<quint16> rleRowLengths;
+
+    // RLE-compressed rows of the current band
+    QVector<QByteArray> compressedRows;
+
+    std::unique_ptr<KisZipDeflateStream> zipStream;
+
+    bool isValid = true;
+};
+
 template<psd_byte_order byteOrder = psd_byte_order::psdBigEndian>
 void writePixelDataCommonImpl(QIODevice &io,
                               KisPaintDeviceSP dev,
@@ -623,87 +785,144 @@ void writePixelDataCommonImpl(QIODevice &io,
     // Empty rects must be processed separately on a higher level!
     KIS_ASSERT_RECOVER_RETURN(!rc.isEmpty());
 
-    QVector<quint8 *> tmp = dev->readPlanarBytes(rc.x() - dev->x(), rc.y() - dev->y(), rc.width(), rc.height());
     const KoColorSpace *colorSpace = dev->colorSpace();
 
-    QVector<quint8 *> planes;
+    // indexes of the device channels in the order they are written
+    QVector<int> planeChannels;
 
-    { // prepare 'planes' array
-
-        quint8 *alphaPlanePtr = 0;
+    {
+        int alphaChannel = -1;
 
         const QList<KoChannelInfo *> origChannels = colorSpace->channels();
         Q_FOREACH (KoChannelInfo *ch, KoChannelInfo::displayOrderSorted(origChannels)) {
             int channelIndex = KoChannelInfo::displayPositionToChannelIndex(ch->displayPosition(), origChannels);
 
-            quint8 *holder = 0;
-            std::swap(holder, tmp[channelIndex]);
-
             if (ch->channelType() == KoChannelInfo::ALPHA) {
-                std::swap(holder, alphaPlanePtr);
+                alphaChannel = channelIndex;
             } else {
-                planes.append(holder);
+                planeChannels.append(channelIndex);
             }
         }
 
-        if (alphaPlanePtr) {
+        if (alphaChannel >= 0) {
             if (alphaFirst) {
-                planes.insert(0, alphaPlanePtr);
+                planeChannels.insert(0, alphaChannel);
                 KIS_ASSERT_RECOVER_NOOP(writingInfoList.first().channelId == -1);
             } else {
-                planes.append(alphaPlanePtr);
-                KIS_ASSERT_RECOVER_NOOP((writingInfoList.size() == planes.size() - 1) || (writingInfoList.last().channelId == -1));
+                planeChannels.append(alphaChannel);
+                KIS_ASSERT_RECOVER_NOOP((writingInfoList.size() == planeChannels.size() - 1) || (writingInfoList.last().channelId == -1));
             }
         }
-
-        // now planes are holding pointers to quint8 arrays
-        tmp.clear();
     }
 
-    KIS_ASSERT_RECOVER_RETURN(planes.size() >= writingInfoList.size());
+    KIS_ASSERT_RECOVER_RETURN(planeChannels.size() >= writingInfoList.size());
 
-    const int numPixels = rc.width() * rc.height();
+    const bool useZip = compressionType == psd_compression_type::ZIP || compressionType == psd_compression_type::ZIPWithPrediction;
+    const int numChannels = writingInfoList.size();
+    const int stride = rc.width() * channelSize;
 
-    // write down the planes
+    std::vector<ChannelBandWriter> writers(numChannels);
 
-    try {
-        for (int i = 0; i < writingInfoList.size(); i++) {
-            const ChannelWritingInfo &info = writingInfoList[i];
+    if (useZip) {
+        for (ChannelBandWriter &writer : writers) {
+            writer.zipStream.reset(new KisZipDeflateStream());
+        }
+    }
 
-            dbgFile << "\tWriting channel" << i << "psd channel id" << info.channelId;
+    /**
+     * The device is read band by band, the channels of every band (and
+     * the rows of every channel in case of RLE) are compressed in
+     * parallel. Only one band of the uncompressed data is kept in memory.
+     */
+    for (int y = rc.top(); y <= rc.bottom();) {
+        const int nextY = bandEnd(y, dev->y(), rc.bottom());
+        const int numRows = nextY - y;
+        const int numPixels = rc.width() * numRows;
+
+        const QVector<quint8 *> planes = dev->readPlanarBytes(rc.x() - dev->x(), y - dev->y(), rc.width(), numRows);
+
+        QVector<std::function<void()>> encodingJobs;
+
+        for (int i = 0; i < numChannels; i++) {
+            ChannelBandWriter *writer = &writers[i];
+            quint8 *plane = planes[planeChannels[i]];
+            const int channelId = writingInfoList[i].channelId;
+
+            if (useZip) {
+                encodingJobs.append([=]() {
+                    // WARNING: Pixel data is ALWAYS in big endian!!!
+                    preparePixelForWrite<psd_byte_order::psdBigEndian>(plane, numPixels, channelSize, channelId, colorMode);
+                    writer->isValid &= writer->zipStream->write(plane, numPixels * channelSize, writer->compressedData);
+                });
+            } else {
+                writer->compressedRows.resize(numRows);
 
-            // WARNING: Pixel data is ALWAYS in big endian!!!
-            preparePixelForWrite<psd_byte_order::psdBigEndian>(planes[i], numPixels, channelSize, info.channelId, colorMode);
+                for (int row = 0; row < numRows; row++) {
+                    encodingJobs.append([=]() {
+                        quint8 *rowPtr = plane + row * stride;
 
-            dbgFile << "\t\tchannel start" << ppVar(io.pos()) << ", compression type" << compressionType;
+                        // WARNING: Pixel data is ALWAYS in big endian!!!
+                        preparePixelForWrite<psd_byte_order::psdBigEndian>(rowPtr, rc.width(), channelSize, channelId, colorMode);
 
-            switch (compressionType) {
-            case psd_compression_type::ZIP:
-            case psd_compression_type::ZIPWithPrediction: {
-                writeChannelDataZIPImpl<byteOrder>(io, planes[i], channelSize, rc, info.sizeFieldOffset, writeCompressionType);
-                break;
-            }
-            case psd_compression_type::RLE:
-            default: {
-                writeChannelDataRLEImpl<byteOrder>(io, planes[i], channelSize, rc, info.sizeFieldOffset, info.rleBlockOffset, writeCompressionType);
-                break;
-            }
+                        QByteArray uncompressed = QByteArray::fromRawData(reinterpret_cast<const char *>(rowPtr), stride);
+                        writer->compressedRows[row] = Compression::compress(uncompressed, psd_compression_type::RLE);
+                    });
+                }
             }
         }
 
-    } catch (KisAslWriterUtils::ASLWriteException &e) {
+        KritaUtils::parallelFor(encodingJobs.size(), [&](int i) {
+            encodingJobs[i]();
+        });
+
         Q_FOREACH (quint8 *plane, planes) {
             delete[] plane;
         }
-        planes.clear();
 
-        throw KisAslWriterUtils::ASLWriteException(PREPEND_METHOD(e.what()));
+        if (!useZip) {
+            for (ChannelBandWriter &writer : writers) {
+                Q_FOREACH (const QByteArray &compressedRow, writer.compressedRows) {
+                    writer.compressedData.append(compressedRow);
+                    writer.rleRowLengths.append(static_cast<quint16>(compressedRow.size()));
+                }
+                writer.compressedRows.clear();
+            }
+        }
+
+        y = nextY;
     }
 
-    Q_FOREACH (quint8 *plane, planes) {
-        delete[] plane;
+    if (useZip) {
+        for (ChannelBandWriter &writer : writers) {
+            writer.isValid &= writer.zipStream->finish(writer.compressedData);
+            writer.zipStream.reset();
+        }
+    }
+
+    // write down the channels
+
+    try {
+        for (int i = 0; i < numChannels; i++) {
+            const ChannelWritingInfo &info = writingInfoList[i];
+            const ChannelBandWriter &writer = writers[i];
+
+            dbgFile << "\tWriting channel" << i << "psd channel id" << info.channelId;
+            dbgFile << "\t\tchannel start" << ppVar(io.pos()) << ", compression type" << compressionType;
+
+            if (!writer.isValid) {
+                throw KisAslWriterUtils::ASLWriteException("Failed to compress image data");
+            }
+
+            if (useZip) {
+                writeChannelBlockZIPImpl<byteOrder>(io, writer.compressedData, info.sizeFieldOffset, writeCompressionType);
+            } else {
+                writeChannelBlockRLEImpl<byteOrder>(io, writer.compressedData, writer.rleRowLengths, info.sizeFieldOffset, info.rleBlockOffset, writeCompressionType);
+            }
+        }
+
+    } catch (KisAslWriterUtils::ASLWriteException &e) {
+        throw KisAslWriterUtils::ASLWriteException(PREPEND_METHOD(e.what()));
     }
-    planes.clear();
 }
 
 void writePixelDataCommon(QIODevice &io,
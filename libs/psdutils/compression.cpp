@@ -243,14 +243,12 @@ int psd_unzip_without_prediction(const char *src, int packed_len, char *dst, int
 }
 
 template<typename T>
-inline void psd_unzip_with_prediction(QByteArray &dst_buf, int row_size);
+inline void psd_unzip_with_prediction(uint8_t *buf, int dst_len, int row_size);
 
 template<>
-inline void psd_unzip_with_prediction<uint8_t>(QByteArray &dst_buf, const int row_size)
+inline void psd_unzip_with_prediction<uint8_t>(uint8_t *buf, int dst_len, const int row_size)
 {
-    auto *buf = reinterpret_cast<uint8_t *>(dst_buf.data());
     int len = 0;
-    int dst_len = dst_buf.size();
 
     while (dst_len > 0) {
         len = row_size;
@@ -264,11 +262,9 @@ inline void psd_unzip_with_prediction<uint8_t>(QByteArray &dst_buf, const int ro
 }
 
 template<>
-inline void psd_unzip_with_prediction<uint16_t>(QByteArray &dst_buf, const int row_size)
+inline void psd_unzip_with_prediction<uint16_t>(uint8_t *buf, int dst_len, const int row_size)
 {
-    auto *buf = reinterpret_cast<uint8_t *>(dst_buf.data());
     int len = 0;
-    int dst_len = dst_buf.size();
 
     while (dst_len > 0) {
         len = row_size;
@@ -294,9 +290,9 @@ QByteArray psd_unzip_with_prediction(const QByteArray &src, int dst_len, int row
         errKrita << "Unsupported bit depth for prediction";
         return {};
     } else if (color_depth == 16) {
-        psd_unzip_with_prediction<quint16>(dst_buf, row_size);
+        psd_unzip_with_prediction<quint16>(reinterpret_cast<uint8_t *>(dst_buf.data()), dst_buf.size(), row_size);
     } else {
-        psd_unzip_with_prediction<quint8>(dst_buf, row_size);
+        psd_unzip_with_prediction<quint8>(reinterpret_cast<uint8_t *>(dst_buf.data()), dst_buf.size(), row_size);
     }
 
     return dst_buf;
@@ -414,3 +410,145 @@ QByteArray Compression::compress(QByteArray bytes, psd_compression_type compress
 
     return QByteArray();
 }
+
+struct KisZipInflateStream::Private {
+    QByteArray compressedData;
+    z_stream stream{};
+    bool isInitialized = false;
+    psd_compression_type compressionType = psd_compression_type::ZIP;
+    int rowSize = 0;
+    int colorDepth = 0;
+};
+
+KisZipInflateStream::KisZipInflateStream(const QByteArray &compressedData, psd_compression_type compressionType, int row_size, int color_depth)
+    : m_d(new Private)
+{
+    m_d->compressedData = compressedData;
+    m_d->compressionType = compressionType;
+    m_d->rowSize = row_size;
+    m_d->colorDepth = color_depth;
+
+    m_d->stream.data_type = Z_BINARY;
+    m_d->stream.next_in = const_cast<Bytef *>(reinterpret_cast<const Bytef *>(m_d->compressedData.constData()));
+    m_d->stream.avail_in = static_cast<uInt>(m_d->compressedData.size());
+
+    m_d->isInitialized = inflateInit(&m_d->stream) == Z_OK;
+}
+
+KisZipInflateStream::~KisZipInflateStream()
+{
+    if (m_d->isInitialized) {
+        inflateEnd(&m_d->stream);
+    }
+}
+
+bool KisZipInflateStream::readRows(quint8 *dst, int numRows)
+{
+    if (!m_d->isInitialized) {
+        dbgFile << "Failed inflate initialization";
+        return false;
+    }
+
+    if (m_d->compressionType == psd_compression_type::ZIPWithPrediction && m_d->colorDepth == 32) {
+        // Placeholded for future implementation.
+        errKrita << "Unsupported bit depth for prediction";
+        return false;
+    }
+
+    const int length = numRows * m_d->rowSize * (m_d->colorDepth / 8);
+
+    m_d->stream.next_out = reinterpret_cast<Bytef *>(dst);
+    m_d->stream.avail_out = static_cast<uInt>(length);
+
+    while (m_d->stream.avail_out > 0) {
+        const int state = inflate(&m_d->stream, Z_SYNC_FLUSH);
+
+        if (state == Z_STREAM_END) {
+            break;
+        } else if (state != Z_OK) {
+            dbgFile << "Failed inflating" << state << m_d->stream.msg;
+            return false;
+        }
+    }
+
+    if (m_d->stream.avail_out > 0) {
+        dbgFile << "Unexpected end of the compressed stream, missing" << m_d->stream.avail_out << "bytes";
+        return false;
+    }
+
+    if (m_d->compressionType == psd_compression_type::ZIPWithPrediction) {
+        if (m_d->colorDepth == 16) {
+            KisZip::psd_unzip_with_prediction<quint16>(dst, length, m_d->rowSize);
+        } else {
+            KisZip::psd_unzip_with_prediction<quint8>(dst, length, m_d->rowSize);
+        }
+    }
+
+    return true;
+}
+
+struct KisZipDeflateStream::Private {
+    z_stream stream{};
+    bool isInitialized = false;
+};
+
+KisZipDeflateStream::KisZipDeflateStream()
+    : m_d(new Private)
+{
+    m_d->stream.data_type = Z_BINARY;
+    m_d->isInitialized = deflateInit(&m_d->stream, -1) == Z_OK;
+}
+
+KisZipDeflateStream::~KisZipDeflateStream()
+{
+    if (m_d->isInitialized) {
+        deflateEnd(&m_d->stream);
+    }
+}
+
+bool KisZipDeflateStream::write(const quint8 *data, int size, QByteArray &dst)
+{
+    m_d->stream.next_in = const_cast<Bytef *>(data);
+    m_d->stream.avail_in = static_cast<uInt>(size);
+
+    return deflateImpl(Z_NO_FLUSH, dst);
+}
+
+bool KisZipDeflateStream::finish(QByteArray &dst)
+{
+    m_d->stream.next_in = nullptr;
+    m_d->stream.avail_in = 0;
+
+    return deflateImpl(Z_FINISH, dst);
+}
+
+bool KisZipDeflateStream::deflateImpl(int flush, QByteArray &dst)
+{
+    if (!m_d->isInitialized) {
+        dbgFile << "Failed deflate initialization";
+        return false;
+    }
+
+    const int chunkSize = 64 * 1024;
+
+    int state = Z_OK;
+
+    do {
+        const int oldSize = dst.size();
+        dst.resize(oldSize + chunkSize);
+
+        m_d->stream.next_out = reinterpret_cast<Bytef *>(dst.data() + oldSize);
+        m_d->stream.avail_out = static_cast<uInt>(chunkSize);
+
+        state = deflate(&m_d->stream, flush);
+
+        dst.resize(dst.size() - static_cast<int>(m_d->stream.avail_out));
+
+        if (state == Z_STREAM_ERROR) {
+            dbgFile << "Error deflating" << state << m_d->stream.msg;
+            return false;
+        }
+    } while (m_d->stream.avail_out == 0 || (flush == Z_FINISH && state != Z_STREAM_END));
+
+    return true;
+}
@@ -10,6 +10,7 @@
 #include "kritapsdutils_export.h"
 
 #include <QByteArray>
+#include <QScopedPointer>
 #include <psd.h>
 
 class KRITAPSDUTILS_EXPORT Compression
@@ -19,4 +20,59 @@ public:
     static QByteArray compress(QByteArray bytes, psd_compression_type compressionType, int row_size = 0, int color_depth = 0);
 };
 
+/**
+ * Inflates ZIP-compressed channel data by portions of whole rows, so
+ * that the uncompressed plane of the channel never has to be kept in
+ * memory at once. The prediction of ZIPWithPrediction is undone row
+ * by row.
+ */
+class KRITAPSDUTILS_EXPORT KisZipInflateStream
+{
+public:
+    KisZipInflateStream(const QByteArray &compressedData, psd_compression_type compressionType, int row_size, int color_depth);
+    ~KisZipInflateStream();
+
+    /**
+     * Inflates the next \p numRows rows into \p dst. The buffer must
+     * be at least numRows * row_size * color_depth / 8 bytes long.
+     *
+     * \return false if the compressed data is corrupted or too short
+     */
+    bool readRows(quint8 *dst, int numRows);
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+/**
+ * Deflates the channel data by portions, the result is the same
+ * zlib stream as produced by Compression::compress() with
+ * psd_compression_type::ZIP
+ */
+class KRITAPSDUTILS_EXPORT KisZipDeflateStream
+{
+public:
+    KisZipDeflateStream();
+    ~KisZipDeflateStream();
+
+    /**
+     * Compresses \p size bytes of \p data and appends the compressed
+     * bytes that are ready to \p dst
+     */
+    bool write(const quint8 *data, int size, QByteArray &dst);
+
+    /**
+     * Flushes the rest of the stream into \p dst
+     */
+    bool finish(QByteArray &dst);
+
+private:
+    bool deflateImpl(int flush, QByteArray &dst);
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
 #endif // PSD_COMPRESSION_H
@@ -189,7 +189,15 @@ bool KoQuaZipStore::openWrite(const QString &name)
     dd->currentFile = new QuaZipFile(dd->archive);
     QuaZipNewInfo newInfo(fixedPath);
     newInfo.setPermissions(QFileDevice::ReadOwner | QFileDevice::ReadGroup | QFileDevice::ReadOther);
-    bool r = dd->currentFile->open(QIODevice::WriteOnly, newInfo, 0, 0, Z_DEFLATED, dd->compressionLevel);
+
+    /**
+     * When the compression is disabled, write the entry with the
+     * "stored" method instead of deflating it with zero level. The
+     * data is just copied both on saving and on loading.
+     */
+    const int method = dd->compressionLevel == Z_NO_COMPRESSION ? 0 : Z_DEFLATED;
+
+    bool r = dd->currentFile->open(QIODevice::WriteOnly, newInfo, 0, 0, method, dd->compressionLevel);
     if (!r) {
         qWarning() << "Could not open" << name << dd->currentFile->getZipError();
     }
@@ -213,7 +213,9 @@ public:
 
     /**
      * Allow to enable or disable compression of the files. Only supported by the
-     * ZIP backend.
+     * ZIP backend. The files written with compression disabled are saved with
+     * the "stored" method, which is the best choice for the data that is
+     * compressed already, like layer tiles or PNG images.
      */
     virtual void setCompressionEnabled(bool e);
 
@@ -8,6 +8,7 @@
 #include "KisApplication.h"
 
 #include <stdlib.h>
+#include <algorithm>
 #ifdef Q_OS_WIN
 #include <windows.h>
 #include <tchar.h>
@@ -67,6 +68,8 @@
 #include <kis_meta_data_io_backend.h>
 #include <kis_meta_data_backend_registry.h>
 #include "KisApplicationArguments.h"
+#include "KisBatchExporter.h"
+#include <kis_image_config.h>
 #include <kis_debug.h>
 #include "kis_action_registry.h"
 #include <KoResourceServer.h>
@@ -455,11 +458,12 @@ bool KisApplication::start(const KisApplicationArguments &args)
     const bool exportAs = args.exportAs();
     const bool exportSequence = args.exportSequence();
     const QString exportFileName = args.exportFileName();
+    const QString exportBatch = args.exportBatch();
 
-    d->batchRun = (exportAs || exportSequence || !exportFileName.isEmpty());
-    const bool needsMainWindow = (!exportAs && !exportSequence);
+    d->batchRun = (exportAs || exportSequence || !exportFileName.isEmpty() || !exportBatch.isEmpty());
+    const bool needsMainWindow = (!exportAs && !exportSequence && exportBatch.isEmpty());
     // only show the mainWindow when no command-line mode option is passed
-    bool showmainWindow = (!exportAs && !exportSequence); // would be !batchRun;
+    bool showmainWindow = needsMainWindow; // would be !batchRun;
 
     const bool showSplashScreen = !d->batchRun && qEnvironmentVariableIsEmpty("NOSPLASH");
     if (showSplashScreen && d->splashScreen) {
@@ -568,6 +572,35 @@ bool KisApplication::start(const KisApplicationArguments &args)
     connect(this, &KisApplication::aboutToQuit, &KisSpinBoxUnitManagerFactory::clearUnitManagerBuilder); //ensure the builder is destroyed when the application leave.
     //the new syntax slot syntax allow to connect to a non q_object static method.
 
+    if (!exportBatch.isEmpty()) {
+        QVector<KisBatchExporter::Job> jobs;
+        QString errorMessage;
+
+        if (!KisBatchExporter::parseManifest(exportBatch, &jobs, &errorMessage)) {
+            errKrita << errorMessage;
+            QTimer::singleShot(0, this, SLOT(quit()));
+            return false;
+        }
+
+        KisBatchExporter exporter;
+        if (args.batchJobs() > 0) {
+            exporter.setMaxConcurrentDocuments(args.batchJobs());
+        }
+        exporter.setMemoryBudget(qint64(args.batchMemory() > 0 ? args.batchMemory() : KisImageConfig::totalRAM() / 2) * 1024 * 1024);
+
+        const QVector<KisBatchExporter::Result> results = exporter.run(jobs);
+
+        if (!args.batchReport().isEmpty() && !KisBatchExporter::writeReport(args.batchReport(), results)) {
+            errKrita << "Could not write the batch export report to" << args.batchReport();
+        }
+
+        const bool success = std::all_of(results.begin(), results.end(),
+                                         [] (const KisBatchExporter::Result &result) { return result.success; });
+
+        QTimer::singleShot(0, this, SLOT(quit()));
+        return success;
+    }
+
     // Create a new image, if needed
     if (doNewImage) {
         KisDocument *doc = args.createDocumentFromArguments();
@@ -33,6 +33,10 @@ struct Q_DECL_HIDDEN KisApplicationArguments::Private
     bool exportAs {false};
     bool exportSequence {false};
     QString exportFileName;
+    QString exportBatch;
+    QString batchReport;
+    int batchJobs {0};
+    int batchMemory {0};
     QString workspace;
     QString windowLayout;
     QString session;
@@ -95,6 +99,12 @@ KisApplicationArguments::KisApplicationArguments(const QApplication &app)
     parser.addOption(QCommandLineOption(QStringList() << QLatin1String("export"), i18n("Export to the given filename and exit")));
     parser.addOption(QCommandLineOption(QStringList() << QLatin1String("export-sequence"), i18n("Export animation to the given filename and exit")));
     parser.addOption(QCommandLineOption(QStringList() << QLatin1String("export-filename"), i18n("Filename for export"), QLatin1String("filename")));
+    parser.addOption(QCommandLineOption(QStringList() << QLatin1String("export-batch"), i18n("Export the files listed in the manifest and exit.\n"
+                                                                                             "Every line of the manifest contains the source and\n"
+                                                                                             "the destination filenames separated by a tab"), QLatin1String("manifest")));
+    parser.addOption(QCommandLineOption(QStringList() << QLatin1String("batch-jobs"), i18n("Maximum number of documents exported at the same time in the batch mode"), QLatin1String("count")));
+    parser.addOption(QCommandLineOption(QStringList() << QLatin1String("batch-memory"), i18n("Memory budget for the documents exported in the batch mode, in MiB"), QLatin1String("mib")));
+    parser.addOption(QCommandLineOption(QStringList() << QLatin1String("batch-report"), i18n("Write the timings of the batch export into a CSV file"), QLatin1String("filename")));
     parser.addOption(QCommandLineOption(QStringList() << QLatin1String("file-layer"), i18n("File layer to be added to existing or new file"), QLatin1String("file-layer")));
     parser.addOption(QCommandLineOption(QStringList() << QLatin1String("resource-location"), i18n("A location that overrides the configured location for Krita's resources"), QLatin1String("file-layer")));
     parser.addPositionalArgument(QLatin1String("[file(s)]"), i18n("File(s) or URL(s) to open"));
@@ -180,6 +190,13 @@ KisApplicationArguments::KisApplicationArguments(const QApplication &app)
 
     d->fileLayer = parser.value("file-layer");
     d->exportFileName = parser.value("export-filename");
+    d->exportBatch = parser.value("export-batch");
+    if (!d->exportBatch.isEmpty()) {
+        d->exportBatch = QDir::current().absoluteFilePath(d->exportBatch);
+    }
+    d->batchReport = parser.value("batch-report");
+    d->batchJobs = parser.value("batch-jobs").toInt();
+    d->batchMemory = parser.value("batch-memory").toInt();
     d->workspace = parser.value("workspace");
     d->windowLayout = parser.value("windowlayout");
     d->session = parser.value("load-session");
@@ -207,6 +224,10 @@ KisApplicationArguments::KisApplicationArguments(const KisApplicationArguments &
     d->doTemplate = rhs.doTemplate();
     d->exportAs = rhs.exportAs();
     d->exportFileName = rhs.exportFileName();
+    d->exportBatch = rhs.exportBatch();
+    d->batchReport = rhs.batchReport();
+    d->batchJobs = rhs.batchJobs();
+    d->batchMemory = rhs.batchMemory();
     d->canvasOnly = rhs.canvasOnly();
     d->workspace = rhs.workspace();
     d->windowLayout = rhs.windowLayout();
@@ -224,6 +245,10 @@ void KisApplicationArguments::operator=(const KisApplicationArguments &rhs)
     d->doTemplate = rhs.doTemplate();
     d->exportAs = rhs.exportAs();
     d->exportFileName = rhs.exportFileName();
+    d->exportBatch = rhs.exportBatch();
+    d->batchReport = rhs.batchReport();
+    d->batchJobs = rhs.batchJobs();
+    d->batchMemory = rhs.batchMemory();
     d->canvasOnly = rhs.canvasOnly();
     d->workspace = rhs.workspace();
     d->windowLayout = rhs.windowLayout();
@@ -332,6 +357,26 @@ QString KisApplicationArguments::exportFileName() const
     return d->exportFileName;
 }
 
+QString KisApplicationArguments::exportBatch() const
+{
+    return d->exportBatch;
+}
+
+QString KisApplicationArguments::batchReport() const
+{
+    return d->batchReport;
+}
+
+int KisApplicationArguments::batchJobs() const
+{
+    return d->batchJobs;
+}
+
+int KisApplicationArguments::batchMemory() const
+{
+    return d->batchMemory;
+}
+
 QString KisApplicationArguments::workspace() const
 {
     return d->workspace;
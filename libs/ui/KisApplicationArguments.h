@@ -34,6 +34,10 @@ public:
     bool exportAs() const;
     bool exportSequence() const;
     QString exportFileName() const;
+    QString exportBatch() const;
+    QString batchReport() const;
+    int batchJobs() const;
+    int batchMemory() const;
     QString workspace() const;
     QString windowLayout() const;
     QString session() const;
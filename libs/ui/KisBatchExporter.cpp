@@ -0,0 +1,288 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisBatchExporter.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QTextStream>
+#include <QThread>
+
+#include <klocalizedstring.h>
+
+#include <KisDocument.h>
+#include <KisImportExportErrorCode.h>
+#include <KisMimeDatabase.h>
+#include <KisPart.h>
+#include <kis_debug.h>
+#include <kis_image.h>
+#include <kis_layer_utils.h>
+#include <kis_paint_device.h>
+
+
+namespace {
+
+/**
+ * Estimates the amount of memory taken by the pixel data of the
+ * image. The estimation doesn't include the tiles shared between
+ * the devices, so it is usually a bit higher than the real usage.
+ */
+qint64 estimateMemoryUsage(KisImageSP image)
+{
+    qint64 bytes = 0;
+
+    auto addDevice = [&bytes] (KisPaintDeviceSP device) {
+        if (!device) return;
+
+        const QRect rc = device->extent();
+        bytes += qint64(rc.width()) * rc.height() * device->pixelSize();
+    };
+
+    addDevice(image->projection());
+
+    KisLayerUtils::recursiveApplyNodes(image->root(),
+        [&addDevice] (KisNodeSP node) {
+            addDevice(node->paintDevice());
+        });
+
+    return bytes;
+}
+
+}
+
+struct KisBatchExporter::Private
+{
+    struct ActiveJob {
+        int index = -1;
+        QElapsedTimer exportTimer;
+    };
+
+    int maxConcurrentDocuments = qMax(1, QThread::idealThreadCount() / 2);
+    qint64 memoryBudget = 4096LL * 1024 * 1024;
+
+    QVector<Job> jobs;
+    QVector<Result> results;
+    int nextJob = 0;
+
+    QHash<KisDocument*, ActiveJob> activeJobs;
+    qint64 memoryInUse = 0;
+
+    QEventLoop *eventLoop = 0;
+};
+
+KisBatchExporter::KisBatchExporter(QObject *parent)
+    : QObject(parent),
+      m_d(new Private)
+{
+}
+
+KisBatchExporter::~KisBatchExporter()
+{
+}
+
+bool KisBatchExporter::parseManifest(const QString &manifestPath, QVector<Job> *jobs, QString *errorMessage)
+{
+    QFile file(manifestPath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        *errorMessage = i18n("Could not open the manifest %1: %2", manifestPath, file.errorString());
+        return false;
+    }
+
+    const QDir baseDir = QFileInfo(manifestPath).absoluteDir();
+
+    QTextStream stream(&file);
+    int lineNumber = 0;
+
+    while (!stream.atEnd()) {
+        const QString line = stream.readLine().trimmed();
+        lineNumber++;
+
+        if (line.isEmpty() || line.startsWith('#')) continue;
+
+        const QStringList fields = line.split('\t', Qt::SkipEmptyParts);
+        if (fields.size() != 2) {
+            *errorMessage = i18n("Line %1 of the manifest should contain the source and the destination paths separated by a tab", lineNumber);
+            return false;
+        }
+
+        Job job;
+        job.source = baseDir.absoluteFilePath(fields[0].trimmed());
+        job.destination = baseDir.absoluteFilePath(fields[1].trimmed());
+        jobs->append(job);
+    }
+
+    return true;
+}
+
+void KisBatchExporter::setMaxConcurrentDocuments(int value)
+{
+    m_d->maxConcurrentDocuments = qMax(1, value);
+}
+
+void KisBatchExporter::setMemoryBudget(qint64 bytes)
+{
+    m_d->memoryBudget = qMax(qint64(0), bytes);
+}
+
+QVector<KisBatchExporter::Result> KisBatchExporter::run(const QVector<Job> &jobs)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(!m_d->eventLoop, QVector<Result>());
+
+    m_d->jobs = jobs;
+    m_d->results.clear();
+    m_d->results.resize(jobs.size());
+    m_d->nextJob = 0;
+
+    for (int i = 0; i < jobs.size(); i++) {
+        m_d->results[i].job = jobs[i];
+    }
+
+    QEventLoop eventLoop;
+    m_d->eventLoop = &eventLoop;
+
+    startNextJobs();
+
+    if (!m_d->activeJobs.isEmpty()) {
+        eventLoop.exec();
+    }
+
+    m_d->eventLoop = 0;
+
+    return m_d->results;
+}
+
+void KisBatchExporter::startNextJobs()
+{
+    /**
+     * The budget is checked before loading the next document, because
+     * the size of the document is not known before it is loaded. So the
+     * documents may exceed the budget by the size of the last one.
+     */
+    while (m_d->nextJob < m_d->jobs.size() &&
+           m_d->activeJobs.size() < m_d->maxConcurrentDocuments &&
+           (m_d->activeJobs.isEmpty() || m_d->memoryInUse < m_d->memoryBudget)) {
+
+        startJob(m_d->nextJob++);
+    }
+
+    if (m_d->activeJobs.isEmpty() && m_d->eventLoop) {
+        m_d->eventLoop->quit();
+    }
+}
+
+void KisBatchExporter::startJob(int index)
+{
+    const Job &job = m_d->jobs[index];
+    Result &result = m_d->results[index];
+
+    const QString mimeType = KisMimeDatabase::mimeTypeForFile(job.destination, false);
+    if (mimeType.isEmpty() || mimeType == "application/octetstream") {
+        result.errorMessage = i18n("Unknown format of %1", job.destination);
+        errKrita << "Could not export" << job.source << "to" << job.destination << ":" << result.errorMessage;
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    KisDocument *document = KisPart::instance()->createDocument();
+    document->setFileBatchMode(true);
+
+    if (!document->openPath(job.source)) {
+        result.errorMessage = document->errorMessage();
+        errKrita << "Could not load" << job.source << ":" << result.errorMessage;
+        delete document;
+        return;
+    }
+
+    result.loadTime = timer.restart();
+
+    QCoreApplication::processEvents(); // for vector layers to be updated
+    document->image()->waitForDone();
+
+    result.renderTime = timer.elapsed();
+    result.memoryUsage = estimateMemoryUsage(document->image());
+
+    Private::ActiveJob activeJob;
+    activeJob.index = index;
+    activeJob.exportTimer.start();
+
+    m_d->activeJobs.insert(document, activeJob);
+    m_d->memoryInUse += result.memoryUsage;
+
+    connect(document, &KisDocument::sigCompleteBackgroundSaving, this,
+            [this, document] (const KritaUtils::ExportFileJob &, KisImportExportErrorCode status, const QString &errorMessage, const QString &) {
+                finishJob(document, status, errorMessage);
+            });
+
+    if (!document->exportDocument(job.destination, mimeType.toLatin1())) {
+        finishJob(document, ImportExportCodes::Failure, i18n("Could not start exporting %1", job.destination));
+    }
+}
+
+void KisBatchExporter::finishJob(KisDocument *document, const KisImportExportErrorCode &status, const QString &errorMessage)
+{
+    // the failure may have been reported twice
+    if (!m_d->activeJobs.contains(document)) return;
+
+    const Private::ActiveJob activeJob = m_d->activeJobs.take(document);
+    Result &result = m_d->results[activeJob.index];
+
+    result.exportTime = activeJob.exportTimer.elapsed();
+    result.success = status.isOk();
+    result.errorMessage = status.isOk() ? QString() : errorMessage;
+
+    m_d->memoryInUse -= result.memoryUsage;
+
+    if (result.success) {
+        infoKrita << "Exported" << result.job.source << "to" << result.job.destination
+                  << QString("(load %1 ms, render %2 ms, export %3 ms)")
+                     .arg(result.loadTime).arg(result.renderTime).arg(result.exportTime);
+    } else {
+        errKrita << "Could not export" << result.job.source << "to" << result.job.destination << ":" << result.errorMessage;
+    }
+
+    /**
+     * We are inside a signal of the document, so it cannot be
+     * deleted right away
+     */
+    document->deleteLater();
+
+    startNextJobs();
+}
+
+bool KisBatchExporter::writeReport(const QString &fileName, const QVector<Result> &results)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        return false;
+    }
+
+    auto quoted = [] (QString value) {
+        return '"' + value.replace('"', "\"\"") + '"';
+    };
+
+    QTextStream stream(&file);
+    stream << "source,destination,status,load_ms,render_ms,export_ms,memory_mib,error\n";
+
+    Q_FOREACH (const Result &result, results) {
+        stream << quoted(result.job.source) << ','
+               << quoted(result.job.destination) << ','
+               << (result.success ? "ok" : "failed") << ','
+               << result.loadTime << ','
+               << result.renderTime << ','
+               << result.exportTime << ','
+               << QString::number(result.memoryUsage / (1024.0 * 1024.0), 'f', 1) << ','
+               << quoted(result.errorMessage) << '\n';
+    }
+
+    return stream.status() == QTextStream::Ok;
+}
@@ -0,0 +1,103 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISBATCHEXPORTER_H
+#define KISBATCHEXPORTER_H
+
+#include <QObject>
+#include <QScopedPointer>
+#include <QString>
+#include <QVector>
+
+#include "kritaui_export.h"
+
+class KisDocument;
+class KisImportExportErrorCode;
+
+/**
+ * Converts a list of documents into other formats without any UI,
+ * it is used by the --export-batch command line option.
+ *
+ * The documents are loaded one by one in the calling (GUI) thread,
+ * but the export filters are run in the background (the same way the
+ * background saving works), so the next document is loaded while the
+ * previous ones are still being exported. The number of the documents
+ * kept in memory at the same time is limited both by the count and by
+ * the estimated size of their pixel data.
+ *
+ * All the documents are converted in the same process, so the color
+ * conversion transformations, the plugins and the resources are
+ * loaded only once for the whole batch.
+ */
+class KRITAUI_EXPORT KisBatchExporter : public QObject
+{
+    Q_OBJECT
+public:
+    struct Job {
+        QString source;
+        QString destination;
+    };
+
+    struct Result {
+        Job job;
+        bool success = false;
+        QString errorMessage;
+
+        qint64 loadTime = 0; // ms
+        qint64 renderTime = 0; // ms
+        qint64 exportTime = 0; // ms
+        qint64 memoryUsage = 0; // bytes, estimated
+    };
+
+public:
+    KisBatchExporter(QObject *parent = 0);
+    ~KisBatchExporter() override;
+
+    /**
+     * Reads the list of jobs from \p manifestPath. Every non-empty line
+     * of the manifest contains the source and the destination paths
+     * separated by a tab character, the lines starting with '#' are
+     * ignored. Relative paths are resolved against the directory of
+     * the manifest. The format of the destination is deduced from its
+     * extension.
+     */
+    static bool parseManifest(const QString &manifestPath, QVector<Job> *jobs, QString *errorMessage);
+
+    /**
+     * Sets the maximum number of the documents loaded at the same time
+     */
+    void setMaxConcurrentDocuments(int value);
+
+    /**
+     * Sets the estimated amount of memory the loaded documents may take.
+     * A new document is not loaded until the ones being exported fit into
+     * the budget. A document larger than the budget is still converted,
+     * but alone.
+     */
+    void setMemoryBudget(qint64 bytes);
+
+    /**
+     * Converts all the \p jobs and returns the results in the same order.
+     * The function spins the event loop until all the jobs are finished.
+     */
+    QVector<Result> run(const QVector<Job> &jobs);
+
+    /**
+     * Writes \p results as a CSV table into \p fileName
+     */
+    static bool writeReport(const QString &fileName, const QVector<Result> &results);
+
+private:
+    void startNextJobs();
+    void startJob(int index);
+    void finishJob(KisDocument *document, const KisImportExportErrorCode &status, const QString &errorMessage);
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISBATCHEXPORTER_H
@@ -9,6 +9,7 @@
 #include "kis_layer_utils.h"
 
 #include <QApplication>
+#include <QElapsedTimer>
 
 
 struct KRITAIMAGE_NO_EXPORT KisCloneDocumentStroke::Private
@@ -19,6 +20,7 @@ struct KRITAIMAGE_NO_EXPORT KisCloneDocumentStroke::Private
     }
 
     KisDocument *document = 0;
+    qint64 cloningTime = -1;
 };
 
 KisCloneDocumentStroke::KisCloneDocumentStroke(KisDocument *document)
@@ -44,7 +46,12 @@ void KisCloneDocumentStroke::initStrokeCallback()
 
 void KisCloneDocumentStroke::finishStrokeCallback()
 {
+    QElapsedTimer timer;
+    timer.start();
+
     KisDocument *doc = m_d->document->clone();
+    m_d->cloningTime = timer.elapsed();
+
     doc->moveToThread(qApp->thread());
     Q_EMIT sigDocumentCloned(doc);
 }
@@ -53,3 +60,8 @@ void KisCloneDocumentStroke::cancelStrokeCallback()
 {
     Q_EMIT sigCloningCancelled();
 }
+
+qint64 KisCloneDocumentStroke::cloningTime() const
+{
+    return m_d->cloningTime;
+}
@@ -23,6 +23,12 @@ public:
     void finishStrokeCallback() override;
     void cancelStrokeCallback() override;
 
+    /**
+     * The time the image was blocked for cloning the document, in
+     * milliseconds. Valid only after sigDocumentCloned() is emitted.
+     */
+    qint64 cloningTime() const;
+
 Q_SIGNALS:
     void sigDocumentCloned(KisDocument *image);
     void sigCloningCancelled();
@@ -70,6 +70,7 @@
 #include <QStringList>
 #include <QtGlobal>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <QWidget>
 #include <QFuture>
 #include <QFutureWatcher>
@@ -359,6 +360,14 @@ public:
     bool disregardAutosaveFailure = false;
     int autoSaveFailureCount = 0;
 
+    // autosaving metrics: the time from the autosaving request till
+    // the moment the snapshot of the document is ready, and the time
+    // of the saving of the snapshot itself
+    QElapsedTimer autoSaveRequestTimer;
+    QElapsedTimer autoSaveSavingTimer;
+    qint64 autoSaveSnapshotLatency = -1;
+    qint64 autoSaveCloningTime = -1;
+
     KUndo2Stack *undoStack = 0;
 
     KisGuidesConfig guidesConfig;
@@ -424,6 +433,8 @@ public:
     QString embeddedResourcesStorageID;
     KisResourceStorageSP embeddedResourceStorage;
 
+    KisIncrementalSaveCacheSP incrementalSaveCache {new KisIncrementalSaveCache()};
+
     void syncDecorationsWrapperLayerState();
 
     void setImageAndInitIdleWatcher(KisImageSP _image) {
@@ -1180,7 +1191,13 @@ KisDocument *KisDocument::Private::lockAndCloneImpl(bool fetchResourcesFromLayer
 
 KisDocument* KisDocument::lockAndCloneForSaving()
 {
-    return d->lockAndCloneImpl(true);
+    KisDocument *doc = d->lockAndCloneImpl(true);
+
+    if (doc) {
+        doc->d->incrementalSaveCache = d->incrementalSaveCache;
+    }
+
+    return doc;
 }
 
 KisDocument *KisDocument::lockAndCreateSnapshot()
@@ -1390,6 +1407,12 @@ KritaUtils::BackgroudSavingStartResult KisDocument::initiateSavingInBackground(c
     d->backgroundSaveJob = job;
     d->modifiedWhileSaving = false;
 
+    if (job.flags & KritaUtils::SaveInAutosaveMode) {
+        d->autoSaveSnapshotLatency =
+            d->autoSaveRequestTimer.isValid() ? d->autoSaveRequestTimer.elapsed() : -1;
+        d->autoSaveSavingTimer.start();
+    }
+
     if (d->backgroundSaveJob.flags & KritaUtils::SaveInAutosaveMode) {
         d->backgroundSaveDocument->d->isAutosaving = true;
     }
@@ -1473,17 +1496,33 @@ void KisDocument::slotAutoSaveImpl(std::unique_ptr<KisDocument> &&optionalCloned
     const bool hadClonedDocument = bool(optionalClonedDocument);
     KritaUtils::BackgroudSavingStartResult result = KritaUtils::BackgroudSavingStartResult::Failure;
 
+    /**
+     * In the snapshot mode we don't wait for the image to become idle.
+     * Instead, we clone the document in a stroke, right between the
+     * user's strokes. The clone shares the tiles with the image in a
+     * copy-on-write manner, so it is cheap, and the whole serialization
+     * then happens in the background while the user keeps painting.
+     */
+    const bool useSnapshots = KisConfig(true).autoSaveUsingSnapshots();
+
+    if (!hadClonedDocument) {
+        d->autoSaveRequestTimer.start();
+        d->autoSaveCloningTime = -1;
+    }
+
     if (d->image->isIdle() || hadClonedDocument) {
         result = initiateSavingInBackground(i18n("Autosaving..."),
                                              this, SLOT(slotCompleteAutoSaving(KritaUtils::ExportFileJob, KisImportExportErrorCode, QString, QString)),
                                              KritaUtils::ExportFileJob(autoSaveFileName, nativeFormatMimeType(), KritaUtils::SaveIsExporting | KritaUtils::SaveInAutosaveMode),
                                              0,
                                              std::move(optionalClonedDocument));
-    } else {
+    } else if (!useSnapshots) {
         Q_EMIT statusBarMessage(i18n("Autosaving postponed: document is busy..."), errorMessageTimeout);
     }
 
-    if (result != KritaUtils::BackgroudSavingStartResult::Success && !hadClonedDocument && d->autoSaveFailureCount >= 3) {
+    if (result != KritaUtils::BackgroudSavingStartResult::Success && !hadClonedDocument &&
+        (useSnapshots || d->autoSaveFailureCount >= 3)) {
+
         KisCloneDocumentStroke *stroke = new KisCloneDocumentStroke(this);
         connect(stroke, SIGNAL(sigDocumentCloned(KisDocument*)),
                 this, SLOT(slotInitiateAsyncAutosaving(KisDocument*)),
@@ -1593,6 +1632,11 @@ void KisDocument::slotAutoSave()
 
 void KisDocument::slotInitiateAsyncAutosaving(KisDocument *clonedDocument)
 {
+    // the stroke is blocked until we return, so it is safe to access it
+    KisCloneDocumentStroke *stroke = qobject_cast<KisCloneDocumentStroke*>(sender());
+    d->autoSaveCloningTime = stroke ? stroke->cloningTime() : -1;
+
+    clonedDocument->d->incrementalSaveCache = d->incrementalSaveCache;
     slotAutoSaveImpl(std::unique_ptr<KisDocument>(clonedDocument));
 }
 
@@ -1638,6 +1682,11 @@ void KisDocument::slotCompleteAutoSaving(const KritaUtils::ExportFileJob &job, K
         }
 
         Q_EMIT statusBarMessage(i18n("Finished autosaving %1", fileName), successMessageTimeout);
+
+        KisUsageLogger::log(QString("Autosaving metrics: snapshot latency %1 ms, image blocked for cloning %2 ms, saving time %3 ms")
+                                .arg(d->autoSaveSnapshotLatency)
+                                .arg(d->autoSaveCloningTime)
+                                .arg(d->autoSaveSavingTimer.isValid() ? d->autoSaveSavingTimer.elapsed() : -1));
     }
 }
 
@@ -2354,6 +2403,11 @@ QList<KoResourceLoadResult> KisDocument::linkedDocumentResources()
     return result;
 }
 
+KisIncrementalSaveCacheSP KisDocument::incrementalSaveCache() const
+{
+    return d->incrementalSaveCache;
+}
+
 void KisDocument::setPaletteList(const QList<KoColorSetSP > &paletteList, bool emitSignal)
 {
     QList<KoColorSetSP> oldPaletteList;
@@ -27,6 +27,7 @@
 #include <KisImportExportUtils.h>
 #include <kis_config.h>
 #include "StoryboardItem.h"
+#include "KisIncrementalSaveCache.h"
 
 #include "kritaui_export.h"
 
@@ -375,6 +376,16 @@ public:
      */
     QList<KoResourceLoadResult> linkedDocumentResources();
 
+    /**
+     * The cache of the layers' content written during the previous
+     * savings of the document. The document clones created with
+     * lockAndCloneForSaving() share the cache with their source
+     * document.
+     *
+     * \see KisIncrementalSaveCache
+     */
+    KisIncrementalSaveCacheSP incrementalSaveCache() const;
+
     /**
      * @brief setPaletteList replaces the palettes in the document's local resource storage with the list
      * of palettes passed to this function. It will then Q_EMIT sigPaletteListChanged with both the old and
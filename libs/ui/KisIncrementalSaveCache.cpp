@@ -0,0 +1,107 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisIncrementalSaveCache.h"
+
+#include <QFileInfo>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <tiles3/KisTiledDataSnapshot.h>
+
+
+struct KisIncrementalSaveCache::Private
+{
+    typedef QHash<KisTiledDataSnapshot, Entry> EntriesHash;
+
+    struct SavedFile {
+        QString filePath;
+        EntriesHash entries;
+    };
+
+    mutable QMutex mutex;
+
+    /// the most recently saved file goes first
+    QList<SavedFile> savedFiles;
+
+    QString currentFilePath;
+    EntriesHash previousEntries;
+    EntriesHash newEntries;
+    int numCopiedEntries = 0;
+};
+
+KisIncrementalSaveCache::KisIncrementalSaveCache()
+    : m_d(new Private)
+{
+}
+
+KisIncrementalSaveCache::~KisIncrementalSaveCache()
+{
+}
+
+void KisIncrementalSaveCache::beginSaving(const QString &filePath)
+{
+    QMutexLocker l(&m_d->mutex);
+
+    m_d->currentFilePath = QFileInfo(filePath).absoluteFilePath();
+    m_d->previousEntries.clear();
+    m_d->newEntries.clear();
+    m_d->numCopiedEntries = 0;
+
+    for (auto it = m_d->savedFiles.begin(); it != m_d->savedFiles.end(); ++it) {
+        if (it->filePath == m_d->currentFilePath) {
+            m_d->previousEntries = it->entries;
+            m_d->savedFiles.erase(it);
+            break;
+        }
+    }
+}
+
+bool KisIncrementalSaveCache::findEntry(const KisTiledDataSnapshot &snapshot, Entry *entry) const
+{
+    QMutexLocker l(&m_d->mutex);
+
+    auto it = m_d->previousEntries.constFind(snapshot);
+    if (it == m_d->previousEntries.constEnd()) return false;
+
+    *entry = *it;
+    return true;
+}
+
+void KisIncrementalSaveCache::addEntry(const KisTiledDataSnapshot &snapshot, const Entry &entry, bool copied)
+{
+    QMutexLocker l(&m_d->mutex);
+    m_d->newEntries.insert(snapshot, entry);
+
+    if (copied) {
+        m_d->numCopiedEntries++;
+    }
+}
+
+void KisIncrementalSaveCache::endSaving(bool success)
+{
+    QMutexLocker l(&m_d->mutex);
+
+    if (success && !m_d->currentFilePath.isEmpty()) {
+        m_d->savedFiles.prepend({m_d->currentFilePath, m_d->newEntries});
+
+        while (m_d->savedFiles.size() > maxFiles) {
+            m_d->savedFiles.removeLast();
+        }
+    }
+
+    m_d->currentFilePath.clear();
+    m_d->previousEntries.clear();
+    m_d->newEntries.clear();
+}
+
+int KisIncrementalSaveCache::numCopiedEntries() const
+{
+    QMutexLocker l(&m_d->mutex);
+    return m_d->numCopiedEntries;
+}
@@ -0,0 +1,89 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISINCREMENTALSAVECACHE_H
+#define KISINCREMENTALSAVECACHE_H
+
+#include <QScopedPointer>
+#include <QSharedPointer>
+#include <QString>
+
+#include "kritaui_export.h"
+
+class KisTiledDataSnapshot;
+
+/**
+ * Remembers which pixel data has been written into which entry of
+ * the file during the previous saving, so that the saver could copy
+ * the already encoded data of the unchanged layers from the previous
+ * file instead of encoding them once again.
+ *
+ * The content of the layers is identified with KisTiledDataSnapshot,
+ * which stores only the content versions of the tiles, so the cache
+ * doesn't keep any pixel data alive. Only the last maxFiles saved files
+ * are remembered (usually, the document itself and its autosave file).
+ *
+ * The cache doesn't check that the previous file is still intact, the
+ * saver should verify the size and the checksum of the entry before
+ * reusing it.
+ *
+ * The cache is shared between the document and its clones created for
+ * saving, the methods can be called from any thread.
+ */
+class KRITAUI_EXPORT KisIncrementalSaveCache
+{
+public:
+    struct Entry {
+        QString location;
+        qint64 size = 0;
+        quint32 checksum = 0;
+    };
+
+    static const int maxFiles = 2;
+
+public:
+    KisIncrementalSaveCache();
+    ~KisIncrementalSaveCache();
+
+    /**
+     * Starts saving into \p filePath. The entries recorded during the
+     * previous saving into the same file become available via findEntry()
+     */
+    void beginSaving(const QString &filePath);
+
+    /**
+     * Searches for the entry of the previous saving into the same
+     * file that has exactly the same content as \p snapshot
+     */
+    bool findEntry(const KisTiledDataSnapshot &snapshot, Entry *entry) const;
+
+    /**
+     * Records that the content of \p snapshot has been written
+     * into \p entry of the file being saved. \p copied tells
+     * whether the data has been copied from the previous file.
+     */
+    void addEntry(const KisTiledDataSnapshot &snapshot, const Entry &entry, bool copied = false);
+
+    /**
+     * Finishes saving. If the saving failed, the cache forgets
+     * everything about the file.
+     */
+    void endSaving(bool success);
+
+    /**
+     * \return the number of entries copied from the previous
+     * file during the last saving
+     */
+    int numCopiedEntries() const;
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+typedef QSharedPointer<KisIncrementalSaveCache> KisIncrementalSaveCacheSP;
+
+#endif // KISINCREMENTALSAVECACHE_H
@@ -93,6 +93,7 @@
 #include "kis_node.h"
 #include "kis_node_manager.h"
 #include "KisDecorationsManager.h"
+#include "opengl/kis_opengl_canvas_debugger.h"
 #include <kis_paint_layer.h>
 #include "kis_paintop_box.h"
 #include <brushengine/kis_paintop_preset.h>
@@ -731,6 +732,9 @@ void KisViewManager::createActions()
     KisAction *tabletDebugger = actionManager()->createAction("tablet_debugger");
     connect(tabletDebugger, SIGNAL(triggered()), this, SLOT(toggleTabletLogger()));
 
+    KisAction *exportFrameStatistics = actionManager()->createAction("export_canvas_frame_statistics");
+    connect(exportFrameStatistics, SIGNAL(triggered()), this, SLOT(slotExportCanvasFrameStatistics()));
+
     d->createTemplate = actionManager()->createAction("create_template");
     connect(d->createTemplate, SIGNAL(triggered()), this, SLOT(slotCreateTemplate()));
 
@@ -1454,6 +1458,34 @@ void KisViewManager::toggleTabletLogger()
     d->inputManager.toggleTabletLogger();
 }
 
+void KisViewManager::slotExportCanvasFrameStatistics()
+{
+    KisOpenglCanvasDebugger *debugger = KisOpenglCanvasDebugger::instance();
+
+    if (!debugger->showFpsOnCanvas()) {
+        QMessageBox::information(mainWindow(),
+                                 i18nc("@title:window", "Krita"),
+                                 i18n("The canvas frame statistics are collected only when "
+                                      "\"Debug logging of OpenGL framerate\" is enabled in "
+                                      "the Performance settings."));
+        return;
+    }
+
+    KoFileDialog dialog(mainWindow(), KoFileDialog::SaveFile, "ExportCanvasFrameStatistics");
+    dialog.setCaption(i18n("Export Canvas Frame Statistics"));
+    dialog.setDefaultDir(QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation));
+    dialog.setMimeTypeFilters(QStringList() << "text/csv", "text/csv");
+    const QString fileName = dialog.filename();
+
+    if (fileName.isEmpty()) return;
+
+    if (!debugger->exportFrameStatistics(fileName)) {
+        QMessageBox::critical(mainWindow(),
+                              i18nc("@title:window", "Krita"),
+                              i18n("Could not save the canvas frame statistics to %1", fileName));
+    }
+}
+
 void KisViewManager::openResourcesDirectory()
 {
     QString resourcePath = KisResourceLocator::instance()->resourceLocationBase();
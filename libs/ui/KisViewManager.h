@@ -253,6 +253,7 @@ private Q_SLOTS:
     void slotSaveIncrementalBackup();
     void showStatusBar(bool toggled);
     void toggleTabletLogger();
+    void slotExportCanvasFrameStatistics();
     void openResourcesDirectory();
     void guiUpdateTimeout();
     void slotUpdatePixelGridAction();
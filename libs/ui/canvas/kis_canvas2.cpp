@@ -16,6 +16,7 @@
 #include <QWidget>
 #include <QVBoxLayout>
 #include <QTime>
+#include <QElapsedTimer>
 #include <QMouseEvent>
 #include <QScreen>
 #include <QScreen>
@@ -189,9 +190,20 @@ public:
     QRect regionOfInterest;
     qreal regionOfInterestMargin = 0.25;
 
+    /// the image we have passed our visible rect to
+    KisImageWSP updatesPriorityImage;
+
     QRect renderingLimit;
     int isBatchUpdateActive = 0;
 
+    void updateProjectionUpdatesFrameBudget(int fpsLimit) {
+        /**
+         * Leave the other half of the frame for painting the canvas and
+         * handling the input events
+         */
+        projectionUpdatesCompressor.setFrameBudget(qMax(1, 500 / qMax(1, fpsLimit)));
+    }
+
     bool effectiveLodAllowedInImage() const {
         return lodPreferredInImage && !bootstrapLodBlocked;
     }
@@ -256,6 +268,8 @@ KisCanvas2::KisCanvas2(KisCoordinatesConverter *coordConverter, KoCanvasResource
 
     m_d->frameRenderStartCompressor.setDelay(1000 / config.fpsLimit());
     m_d->frameRenderStartCompressor.setMode(KisSignalCompressor::FIRST_ACTIVE);
+
+    m_d->updateProjectionUpdatesFrameBudget(config.fpsLimit());
     snapGuide()->overrideSnapStrategy(KoSnapGuide::PixelSnapping, new KisSnapPixelStrategy());
 }
 
@@ -337,9 +351,20 @@ void KisCanvas2::initializeFpsDecoration()
 
 KisCanvas2::~KisCanvas2()
 {
+    resetUpdatesPriorityRect();
+    KisOpenglCanvasDebugger::instance()->forgetCanvas(this);
     delete m_d;
 }
 
+void KisCanvas2::resetUpdatesPriorityRect()
+{
+    KisImageSP image = m_d->updatesPriorityImage;
+    if (image) {
+        image->setUpdatesPriorityRect(this, QRect());
+    }
+    m_d->updatesPriorityImage = 0;
+}
+
 void KisCanvas2::setCanvasWidget(KisAbstractCanvasWidget *widget)
 {
     if (m_d->popupPalette) {
@@ -648,6 +673,8 @@ void KisCanvas2::disconnectImage()
     image->immediateLockForReadOnly();
     disconnect(image.data(), 0, this, 0);
     image->unlock();
+
+    resetUpdatesPriorityRect();
 }
 
 void KisCanvas2::connectCurrentCanvas()
@@ -840,6 +867,8 @@ void KisCanvas2::finishResizingImage(qint32 w, qint32 h)
 
 void KisCanvas2::startUpdateCanvasProjection(const QRect & rc)
 {
+    KisOpenglCanvasDebugger::instance()->notifyProjectionUpdated(this);
+
     KisUpdateInfoSP info = m_d->canvasWidget->startUpdateCanvasProjection(rc);
     if (m_d->projectionUpdatesCompressor.putUpdateInfo(info)) {
         Q_EMIT sigCanvasCacheUpdated();
@@ -866,7 +895,20 @@ void KisCanvas2::updateCanvasProjection()
     };
 
     auto uploadData = [this, tryIssueCanvasUpdates](const QVector<KisUpdateInfoSP> &infoObjects) {
+        qint64 numPixels = 0;
+        Q_FOREACH (KisUpdateInfoSP info, infoObjects) {
+            const QRect rc = info->dirtyImageRect();
+            numPixels += qint64(rc.width()) * rc.height();
+        }
+
+        QElapsedTimer uploadTimer;
+        uploadTimer.start();
+
         QVector<QRect> viewportRects = m_d->canvasWidget->updateCanvasProjection(infoObjects);
+
+        m_d->projectionUpdatesCompressor.reportUploadTime(numPixels, uploadTimer.nsecsElapsed());
+        KisOpenglCanvasDebugger::instance()->notifyTexturesUploaded(this);
+
         const QRect vRect = std::accumulate(viewportRects.constBegin(), viewportRects.constEnd(),
                                             QRect(), std::bit_or<QRect>());
 
@@ -877,7 +919,8 @@ void KisCanvas2::updateCanvasProjection()
 
     QVector<KisUpdateInfoSP> infoObjects;
     KisUpdateInfoList originalInfoObjects;
-    m_d->projectionUpdatesCompressor.takeUpdateInfo(originalInfoObjects);
+    const bool hasPostponedUpdates =
+        m_d->projectionUpdatesCompressor.takeUpdateInfo(originalInfoObjects);
 
     for (auto it = originalInfoObjects.constBegin();
          it != originalInfoObjects.constEnd();
@@ -916,6 +959,16 @@ void KisCanvas2::updateCanvasProjection()
     } else if (shouldExplicitlyIssueUpdates) {
         tryIssueCanvasUpdates(m_d->coordinatesConverter->imageRectInImagePixels());
     }
+
+    if (hasPostponedUpdates) {
+        // the rest of the updates didn't fit into the frame budget
+        Q_EMIT sigCanvasCacheUpdated();
+    }
+}
+
+KisCanvasUpdatesCompressor::Statistics KisCanvas2::projectionUpdatesStatistics() const
+{
+    return m_d->projectionUpdatesCompressor.statistics();
 }
 
 void KisCanvas2::slotBeginUpdatesBatch()
@@ -1139,6 +1192,21 @@ void KisCanvas2::slotUpdateRegionOfInterest()
     if (m_d->regionOfInterest != oldRegionOfInterest) {
         Q_EMIT sigRegionOfInterestChanged(m_d->regionOfInterest);
     }
+
+    /**
+     * Let the image process the updates of the visible area first, so
+     * that the user would see the result of big updates earlier
+     */
+    KisImageSP image = this->image();
+    if (image) {
+        if (m_d->updatesPriorityImage != image.data()) {
+            resetUpdatesPriorityRect();
+            m_d->updatesPriorityImage = image;
+        }
+
+        const QRect visibleRect = m_d->coordinatesConverter->widgetRectInImagePixels().toAlignedRect();
+        image->setUpdatesPriorityRect(this, visibleRect & imageRect);
+    }
 }
 
 void KisCanvas2::slotReferenceImagesChanged()
@@ -1248,6 +1316,7 @@ void KisCanvas2::slotConfigChanged()
     KisConfig cfg(true);
     m_d->vastScrolling = cfg.vastScrolling();
     m_d->regionOfInterestMargin = KisImageConfig(true).animationCacheRegionOfInterestMargin();
+    m_d->updateProjectionUpdatesFrameBudget(KisImageConfig(true).fpsLimit());
 
     resetCanvas(cfg.useOpenGL());
 
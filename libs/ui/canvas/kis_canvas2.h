@@ -29,6 +29,7 @@
 #include "input/KisInputActionGroup.h"
 #include "KisReferenceImagesDecoration.h"
 #include "KisWraparoundAxis.h"
+#include "kis_canvas_updates_compressor.h"
 
 class KoToolProxy;
 class KisDisplayConfig;
@@ -199,6 +200,12 @@ public: // KisCanvas2 methods
      */
     QRect regionOfInterest() const;
 
+    /**
+     * @return the statistics of merging and postponing of the canvas
+     * updates, shown in the FPS overlay
+     */
+    KisCanvasUpdatesCompressor::Statistics projectionUpdatesStatistics() const;
+
     /**
      * Set artificial limit outside which the image will not be rendered
      * \p rc is measured in image pixels
@@ -330,6 +337,12 @@ private:
 
     void notifyLevelOfDetailChange();
 
+    /**
+     * Removes the visible rect of this canvas from the
+     * updates priority rects of the image
+     */
+    void resetUpdatesPriorityRect();
+
     // Completes construction of canvas.
     // To be called by KisView in its constructor, once it has been setup enough
     // (to be defined what that means) for things KisCanvas2 expects from KisView
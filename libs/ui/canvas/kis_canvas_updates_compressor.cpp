@@ -6,6 +6,33 @@
 
 #include "kis_canvas_updates_compressor.h"
 
+#include <QMap>
+
+#include <KisRectsGrid.h>
+
+namespace {
+
+const int coverageGridSize = 64;
+
+/**
+ * Returns the largest rect aligned to the grid that fits into \p rc,
+ * so that the cells marked in the grid are always covered completely
+ */
+QRect innerAlignedRect(const QRect &rc, int gridSize)
+{
+    const int mask = ~(gridSize - 1);
+
+    const int left = (rc.x() + gridSize - 1) & mask;
+    const int top = (rc.y() + gridSize - 1) & mask;
+    const int right = (rc.x() + rc.width()) & mask;
+    const int bottom = (rc.y() + rc.height()) & mask;
+
+    return right > left && bottom > top ?
+        QRect(left, top, right - left, bottom - top) : QRect();
+}
+
+}
+
 bool KisCanvasUpdatesCompressor::putUpdateInfo(KisUpdateInfoSP info)
 {
     const int levelOfDetail = info->levelOfDetail();
@@ -27,6 +54,7 @@ bool KisCanvasUpdatesCompressor::putUpdateInfo(KisUpdateInfoSP info)
                  * may have tiles artifacts with "outdated" data
                  */
                 it = m_updatesList.erase(it);
+                m_statistics.numMergedUpdates++;
             } else {
                 ++it;
             }
@@ -38,10 +66,104 @@ bool KisCanvasUpdatesCompressor::putUpdateInfo(KisUpdateInfoSP info)
     return m_updatesList.size() <= 1;
 }
 
-void KisCanvasUpdatesCompressor::takeUpdateInfo(KisUpdateInfoList &list)
+void KisCanvasUpdatesCompressor::dropOverwrittenUpdates()
+{
+    if (m_updatesList.size() < 2) return;
+
+    /**
+     * putUpdateInfo() can drop an update only when a single newer update
+     * contains it, which doesn't happen when the stroke goes over the
+     * same place several times. Here we walk from the newest update to
+     * the oldest one, collect the area covered by the newer updates in
+     * a grid and drop the updates lying inside it completely.
+     */
+    QMap<int, KisRectsGrid> coveredAreas;
+
+    for (int i = m_updatesList.size() - 1; i >= 0; i--) {
+        KisUpdateInfoSP info = m_updatesList[i];
+        if (!info->canBeCompressed()) continue;
+
+        auto gridIt = coveredAreas.find(info->levelOfDetail());
+        if (gridIt == coveredAreas.end()) {
+            gridIt = coveredAreas.insert(info->levelOfDetail(), KisRectsGrid(coverageGridSize));
+        }
+
+        const QRect rc = info->dirtyImageRect();
+
+        if (gridIt->contains(rc)) {
+            m_updatesList.removeAt(i);
+            m_statistics.numMergedUpdates++;
+        } else {
+            gridIt->addAlignedRect(innerAlignedRect(rc, coverageGridSize));
+        }
+    }
+}
+
+bool KisCanvasUpdatesCompressor::takeUpdateInfo(KisUpdateInfoList &list)
 {
     KIS_SAFE_ASSERT_RECOVER(list.isEmpty()) { list.clear(); }
 
     QMutexLocker l(&m_mutex);
-    m_updatesList.swap(list);
+
+    dropOverwrittenUpdates();
+
+    if (m_frameBudget <= 0 || m_statistics.uploadThroughput <= 0.0) {
+        m_updatesList.swap(list);
+        return false;
+    }
+
+    /**
+     * The markers cost nothing, and at least one real update is
+     * always taken to guarantee the progress
+     */
+    const qreal pixelsBudget = m_statistics.uploadThroughput * m_frameBudget;
+    qreal numPixels = 0;
+
+    int numTakenUpdates = 0;
+
+    for (; numTakenUpdates < m_updatesList.size(); numTakenUpdates++) {
+        KisUpdateInfoSP info = m_updatesList[numTakenUpdates];
+        if (!info->canBeCompressed()) continue;
+
+        const QRect rc = info->dirtyImageRect();
+        const qreal infoPixels = qreal(rc.width()) * rc.height();
+
+        if (numPixels > 0 && numPixels + infoPixels > pixelsBudget) break;
+
+        numPixels += infoPixels;
+    }
+
+    list = m_updatesList.mid(0, numTakenUpdates);
+    m_updatesList.erase(m_updatesList.begin(), m_updatesList.begin() + numTakenUpdates);
+
+    m_statistics.numDeferredUpdates += m_updatesList.size();
+
+    return !m_updatesList.isEmpty();
+}
+
+void KisCanvasUpdatesCompressor::setFrameBudget(int milliseconds)
+{
+    QMutexLocker l(&m_mutex);
+    m_frameBudget = milliseconds;
+}
+
+void KisCanvasUpdatesCompressor::reportUploadTime(qint64 numPixels, qint64 nanoseconds)
+{
+    if (numPixels <= 0 || nanoseconds <= 0) return;
+
+    const qreal throughput = qreal(numPixels) / (qreal(nanoseconds) / 1000000.0);
+
+    QMutexLocker l(&m_mutex);
+
+    // the uploading time is noisy, so smooth it over a few frames
+    m_statistics.uploadThroughput =
+        m_statistics.uploadThroughput > 0.0 ?
+        0.8 * m_statistics.uploadThroughput + 0.2 * throughput :
+        throughput;
+}
+
+KisCanvasUpdatesCompressor::Statistics KisCanvasUpdatesCompressor::statistics() const
+{
+    QMutexLocker l(&m_mutex);
+    return m_statistics;
 }
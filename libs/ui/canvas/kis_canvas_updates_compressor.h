@@ -12,18 +12,80 @@
 #include <QMutexLocker>
 
 #include "kis_update_info.h"
+#include "kritaui_export.h"
 
 typedef QList<KisUpdateInfoSP> KisUpdateInfoList;
 
-class KisCanvasUpdatesCompressor
+/**
+ * Collects the update info objects prepared by the workers until the
+ * GUI thread uploads them into the canvas.
+ *
+ * Before passing the updates to the canvas the compressor drops the
+ * ones fully overwritten by the newer updates and limits the amount
+ * of work done in one frame to the uploading throughput measured on
+ * the previous frames. The rest of the updates is left in the queue
+ * for the next frame, where it can be overwritten again.
+ */
+class KRITAUI_EXPORT KisCanvasUpdatesCompressor
 {
 public:
+    struct Statistics {
+        /**
+         * The number of updates dropped because newer
+         * updates overwrote them
+         */
+        qint64 numMergedUpdates = 0;
+
+        /**
+         * The number of times the updates were postponed to
+         * the next frame because of the frame budget
+         */
+        qint64 numDeferredUpdates = 0;
+
+        /**
+         * The measured uploading throughput in pixels per millisecond,
+         * zero until the first measurement is done
+         */
+        qreal uploadThroughput = 0.0;
+    };
+
+public:
+    /**
+     * Adds \p info to the queue. Returns true if the queue was empty,
+     * that is, the canvas should be notified about the new updates.
+     */
     bool putUpdateInfo(KisUpdateInfoSP info);
-    void takeUpdateInfo(KisUpdateInfoList &list);
+
+    /**
+     * Moves the updates that fit into the frame budget into \p list.
+     * Returns true if some updates are still left in the queue and
+     * should be taken on the next frame.
+     */
+    bool takeUpdateInfo(KisUpdateInfoList &list);
+
+    /**
+     * Sets the time the canvas can spend on uploading the updates
+     * in one frame. Zero disables the budget.
+     */
+    void setFrameBudget(int milliseconds);
+
+    /**
+     * Reports that uploading the updates covering \p numPixels pixels
+     * took \p nanoseconds nanoseconds
+     */
+    void reportUploadTime(qint64 numPixels, qint64 nanoseconds);
+
+    Statistics statistics() const;
 
 private:
-    QMutex m_mutex;
+    void dropOverwrittenUpdates();
+
+private:
+    mutable QMutex m_mutex;
     KisUpdateInfoList m_updatesList;
+
+    int m_frameBudget = 0;
+    Statistics m_statistics;
 };
 
 #endif /* __KIS_CANVAS_UPDATES_COMPRESSOR_H */
@@ -10,11 +10,12 @@
 #include <QPainter>
 #include <QImage>
 #include <kis_types.h>
+#include "kritaui_export.h"
 
 #define BORDER_SIZE(scale) (ceil(0.5/scale))
 
 
-class KisImagePatch
+class KRITAUI_EXPORT KisImagePatch
 {
 public:
     /**
@@ -6,6 +6,9 @@
 #include "kis_image_pyramid.h"
 
 #include <QBitArray>
+
+#include <cstring>
+
 #include <KoChannelInfo.h>
 #include <KoCompositeOp.h>
 #include <KoColorSpaceRegistry.h>
@@ -20,6 +23,7 @@
 #include "kis_debug.h"
 #include "kis_config.h"
 #include "kis_image_config.h"
+#include "krita_utils.h"
 
 //#define DEBUG_PYRAMID
 
@@ -81,6 +85,37 @@ inline void alignRectBy2(qint32 &x, qint32 &y, qint32 &w, qint32 &h)
     h += isOdd(h);
 }
 
+namespace {
+
+/**
+ * The height of the bands the planes are downsampled in. It is aligned
+ * to the tile size of the destination plane, so that the bands would
+ * never write into the same tiles.
+ */
+const qint32 downsampleBandHeight = 128;
+
+/**
+ * Splits @rc into horizontal bands aligned to downsampleBandHeight
+ */
+QVector<QRect> splitIntoBands(const QRect &rc)
+{
+    QVector<QRect> bands;
+
+    qint32 bandTop = rc.y();
+    while (bandTop <= rc.bottom()) {
+        qint32 bandBottom = bandTop;
+        alignByPow2Hi(bandBottom, downsampleBandHeight);
+        bandBottom = qMin(bandBottom, rc.bottom() + 1);
+
+        bands.append(QRect(rc.x(), bandTop, rc.width(), bandBottom - bandTop));
+        bandTop = bandBottom;
+    }
+
+    return bands;
+}
+
+}
+
 
 /************* class KisImagePyramid ********************************/
 
@@ -171,8 +206,10 @@ void KisImagePyramid::setImage(KisImageWSP newImage)
         int patchWidth = config.updatePatchWidth();
         int patchHeight = config.updatePatchHeight();
 
+        QVector<QRect> patches;
+
         if (rc.width() * rc.height() <= patchWidth * patchHeight) {
-            retrieveImageData(rc);
+            patches.append(rc);
         }
         else {
             qint32 firstCol = rc.x() / patchWidth;
@@ -187,11 +224,24 @@ void KisImagePyramid::setImage(KisImageWSP newImage)
                                        i * patchHeight,
                                        patchWidth, patchHeight);
                     QRect patchRect = rc & maxPatchRect;
-                    retrieveImageData(patchRect);
+                    if (!patchRect.isEmpty()) {
+                        patches.append(patchRect);
+                    }
                 }
             }
 
         }
+
+        validateChannelFlags();
+
+        /**
+         * The patches cover different areas of the base plane, so
+         * they can be converted independently
+         */
+        KritaUtils::parallelFor(patches.size(), [this, &patches] (int i) {
+            retrieveImageData(patches[i]);
+        });
+
         //TODO: check whether there is needed recalculateCache()
     }
 }
@@ -205,7 +255,27 @@ void KisImagePyramid::setImageSize(qint32 w, qint32 h)
 
 void KisImagePyramid::updateCache(const QRect &dirtyImageRect)
 {
-    retrieveImageData(dirtyImageRect);
+    validateChannelFlags();
+
+    /**
+     * The bands are aligned to the tiles of the base plane, so they
+     * can be converted independently. When the update comes from the
+     * threads of the update scheduler, the bands are converted inline.
+     */
+    const QVector<QRect> bands = splitIntoBands(dirtyImageRect);
+
+    KritaUtils::parallelFor(bands.size(), [this, &bands] (int i) {
+        retrieveImageData(bands[i]);
+    });
+}
+
+void KisImagePyramid::validateChannelFlags()
+{
+    const KoColorSpace *projectionCs = m_originalImage->projection()->colorSpace();
+
+    if (m_channelFlags.size() != int(projectionCs->channelCount())) {
+        setChannelFlags(QBitArray());
+    }
 }
 
 void KisImagePyramid::retrieveImageData(const QRect &rect)
@@ -260,15 +330,10 @@ void KisImagePyramid::retrieveImageData(const QRect &rect)
 #endif
     }
     else {
-        if (m_channelFlags.size() != projectionCs->channelCount()) {
-            setChannelFlags(QBitArray());
-        }
         if (!m_channelFlags.isEmpty() && !m_allChannelsSelected) {
             QScopedArrayPointer<quint8> dst(new quint8[projectionCs->pixelSize() * numPixels]);
 
-            KisConfig cfg(true);
-
-            if (m_onlyOneChannelSelected && !cfg.showSingleChannelAsColor()) {
+            if (m_onlyOneChannelSelected && !m_showSingleChannelAsColor) {
                 projectionCs->convertChannelToVisualRepresentation(originalBytes.data(), dst.data(), numPixels, m_selectedChannelIndex);
             }
             else {
@@ -330,6 +395,32 @@ QRect KisImagePyramid::downsampleByFactor2(const QRect& srcRect,
     qint32 dstWidth = srcWidth / 2;
     qint32 dstHeight = srcHeight / 2;
 
+    /**
+     * The bands are aligned to the band height, so they
+     * can be downsampled in parallel
+     */
+    const QVector<QRect> bands = splitIntoBands(QRect(srcX, srcY, srcWidth, srcHeight));
+
+    KritaUtils::parallelFor(bands.size(), [this, &bands, src, dst] (int i) {
+        downsampleBand(bands[i], src, dst);
+    });
+
+    return QRect(dstX, dstY, dstWidth, dstHeight);
+}
+
+void KisImagePyramid::downsampleBand(const QRect &srcRect,
+                                     KisPaintDevice* src, KisPaintDevice* dst)
+{
+    qint32 srcX, srcY, srcWidth, srcHeight;
+    srcRect.getRect(&srcX, &srcY, &srcWidth, &srcHeight);
+
+    Q_ASSERT(!isOdd(srcX) && !isOdd(srcY) && !isOdd(srcWidth) && !isOdd(srcHeight));
+
+    qint32 dstX = srcX / 2;
+    qint32 dstY = srcY / 2;
+    qint32 dstWidth = srcWidth / 2;
+    qint32 dstHeight = srcHeight / 2;
+
     KisHLineConstIteratorSP srcIt0 = src->createHLineConstIteratorNG(srcX, srcY, srcWidth);
     KisHLineConstIteratorSP srcIt1 = src->createHLineConstIteratorNG(srcX, srcY + 1, srcWidth);
     KisHLineIteratorSP dstIt = dst->createHLineIteratorNG(dstX, dstY, dstWidth);
@@ -356,7 +447,6 @@ QRect KisImagePyramid::downsampleByFactor2(const QRect& srcRect,
         srcIt1->nextRow();
         dstIt->nextRow();
     }
-    return QRect(dstX, dstY, dstWidth, dstHeight);
 }
 
 void  KisImagePyramid::downsamplePixels(const quint8 *srcRow0,
@@ -365,26 +455,36 @@ void  KisImagePyramid::downsamplePixels(const quint8 *srcRow0,
                                         qint32 numSrcPixels)
 {
     /**
-     * FIXME (mandatory): Use SSE and friends here.
+     * The planes are always stored in 8-bit BGRA mode, so a pair of
+     * source pixels fits into a single 64-bit word. The even and the odd
+     * channels of the pair are summed up in separate 16-bit slots of the
+     * word, which is enough for the sum of four 8-bit values. This way
+     * all the channels are averaged with a few integer operations, and
+     * the result is exactly the same as of averaging them one by one.
      */
-
-    qint16 b = 0;
-    qint16 g = 0;
-    qint16 r = 0;
-    qint16 a = 0;
+    const quint64 channelsMask = 0x00FF00FF00FF00FFULL;
+    const quint32 resultMask = 0x00FF00FF;
 
     static const qint32 pixelSize = 4; // This is preview argb8 mode
 
     for (qint32 i = 0; i < numSrcPixels / 2; i++) {
-        b = srcRow0[0] + srcRow1[0] + srcRow0[4] + srcRow1[4];
-        g = srcRow0[1] + srcRow1[1] + srcRow0[5] + srcRow1[5];
-        r = srcRow0[2] + srcRow1[2] + srcRow0[6] + srcRow1[6];
-        a = srcRow0[3] + srcRow1[3] + srcRow0[7] + srcRow1[7];
+        quint64 row0;
+        quint64 row1;
+        memcpy(&row0, srcRow0, sizeof(row0));
+        memcpy(&row1, srcRow1, sizeof(row1));
+
+        quint64 even = (row0 & channelsMask) + (row1 & channelsMask);
+        quint64 odd = ((row0 >> 8) & channelsMask) + ((row1 >> 8) & channelsMask);
+
+        // add up the pixels of the pair
+        even += even >> 32;
+        odd += odd >> 32;
+
+        const quint32 result =
+            (quint32(even >> 2) & resultMask) |
+            ((quint32(odd >> 2) & resultMask) << 8);
 
-        dstRow[0] = b / 4;
-        dstRow[1] = g / 4;
-        dstRow[2] = r / 4;
-        dstRow[3] = a / 4;
+        memcpy(dstRow, &result, sizeof(result));
 
         dstRow += pixelSize;
         srcRow0 += 2 * pixelSize;
@@ -486,5 +586,6 @@ void KisImagePyramid::configChanged()
 {
     KisConfig cfg(true);
     m_useOcio = cfg.useOcio();
+    m_showSingleChannelAsColor = cfg.showSingleChannelAsColor();
 }
 
@@ -15,9 +15,10 @@
 #include <kis_image.h>
 #include <kis_paint_device.h>
 #include "kis_projection_backend.h"
+#include "kritaui_export.h"
 
 
-class KisImagePyramid : QObject, public KisProjectionBackend
+class KRITAUI_EXPORT KisImagePyramid : QObject, public KisProjectionBackend
 {
     Q_OBJECT
 
@@ -63,7 +64,19 @@ public:
 
 private:
 
+    /**
+     * Converts @rect of the image projection into the base plane.
+     * Can be called for several non-overlapping rects in parallel
+     */
     void retrieveImageData(const QRect &rect);
+
+    /**
+     * Resets the channel flags if the color space of the
+     * projection has changed. Should be called before
+     * retrieveImageData()
+     */
+    void validateChannelFlags();
+
     void rebuildPyramid();
     void clearPyramid();
 
@@ -75,6 +88,13 @@ private:
     QRect downsampleByFactor2(const QRect& srcRect,
                               KisPaintDevice* src, KisPaintDevice* dst);
 
+    /**
+     * Downsamples a single band of downsampleByFactor2().
+     * Note: @srcRect must be aligned by 2
+     */
+    void downsampleBand(const QRect& srcRect,
+                        KisPaintDevice* src, KisPaintDevice* dst);
+
     /**
      * Auxiliary function. Downsamples two lines in @srcRow0
      * and @srcRow1 into one line @dstRow
@@ -121,6 +141,7 @@ private:
     qint32 m_pyramidHeight {0};
 
     bool m_useOcio {false};
+    bool m_showSingleChannelAsColor {false};
 
     QBitArray m_channelFlags;
     bool m_allChannelsSelected {false};
@@ -37,6 +37,7 @@
 #include "kis_change_primary_setting_action.h"
 
 #include "kis_shortcut_matcher.h"
+#include "opengl/kis_opengl_canvas_debugger.h"
 #include "kis_stroke_shortcut.h"
 #include "kis_single_action_shortcut.h"
 #include "kis_touch_shortcut.h"
@@ -489,6 +490,8 @@ bool KisInputManager::eventFilterImpl(QEvent * event)
         QMouseEvent *mouseEvent = static_cast<QMouseEvent*>(event);
         retval = compressMoveEventCommon(mouseEvent);
 
+        KisOpenglCanvasDebugger::instance()->notifyInputEvent(d->canvas);
+
         break;
     }
     case QEvent::Wheel: {
@@ -649,6 +652,8 @@ bool KisInputManager::eventFilterImpl(QEvent * event)
             d->tabletLatencyTracker->push(tabletEvent->timestamp());
         }
 
+        KisOpenglCanvasDebugger::instance()->notifyInputEvent(d->canvas);
+
         /**
          * The flow of tablet events means the tablet is in the
          * proximity area, so activate it even when the
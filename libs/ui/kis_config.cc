@@ -1300,6 +1300,16 @@ void KisConfig::setAutoSaveInterval(int seconds)  const
     return m_cfg.writeEntry("AutoSaveInterval", seconds);
 }
 
+bool KisConfig::autoSaveUsingSnapshots(bool defaultValue) const
+{
+    return (defaultValue ? true : m_cfg.readEntry("AutoSaveUsingSnapshots", true));
+}
+
+void KisConfig::setAutoSaveUsingSnapshots(bool value)
+{
+    m_cfg.writeEntry("AutoSaveUsingSnapshots", value);
+}
+
 bool KisConfig::backupFile(bool defaultValue) const
 {
     return (defaultValue ? true : m_cfg.readEntry("CreateBackupFile", true));
@@ -2027,6 +2037,26 @@ void KisConfig::setTrackTabletEventLatency(bool value)
     m_cfg.writeEntry("trackTabletEventLatency", value);
 }
 
+bool KisConfig::trackFirstDabLatency(bool defaultValue) const
+{
+    return (defaultValue ? false : m_cfg.readEntry("trackFirstDabLatency", false));
+}
+
+void KisConfig::setTrackFirstDabLatency(bool value)
+{
+    m_cfg.writeEntry("trackFirstDabLatency", value);
+}
+
+bool KisConfig::prewarmStrokeResources(bool defaultValue) const
+{
+    return (defaultValue ? true : m_cfg.readEntry("prewarmStrokeResources", true));
+}
+
+void KisConfig::setPrewarmStrokeResources(bool value)
+{
+    m_cfg.writeEntry("prewarmStrokeResources", value);
+}
+
 bool KisConfig::testingAcceptCompressedTabletEvents(bool defaultValue) const
 {
     return (defaultValue ? false : m_cfg.readEntry("testingAcceptCompressedTabletEvents", false));
@@ -2077,6 +2107,16 @@ void KisConfig::setCompressKra(bool compress)
     m_cfg.writeEntry("compressLayersInKra", compress);
 }
 
+bool KisConfig::incrementalKraSaving(bool defaultValue) const
+{
+    return (defaultValue ? true : m_cfg.readEntry("incrementalKraSaving", true));
+}
+
+void KisConfig::setIncrementalKraSaving(bool value)
+{
+    m_cfg.writeEntry("incrementalKraSaving", value);
+}
+
 bool KisConfig::trimKra(bool defaultValue) const
 {
     return (defaultValue ? false : m_cfg.readEntry("TrimKra", false));
@@ -315,6 +315,14 @@ public:
     int autoSaveInterval(bool defaultValue = false) const;
     void setAutoSaveInterval(int seconds) const;
 
+    /**
+     * When the image is busy, autosave a copy-on-write snapshot of the
+     * document taken between the strokes instead of postponing the
+     * autosaving until the image becomes idle
+     */
+    bool autoSaveUsingSnapshots(bool defaultValue = false) const;
+    void setAutoSaveUsingSnapshots(bool value);
+
     bool backupFile(bool defaultValue = false) const;
     void setBackupFile(bool backupFile) const;
 
@@ -527,6 +535,12 @@ public:
     bool trackTabletEventLatency(bool defaultValue = false) const;
     void setTrackTabletEventLatency(bool value);
 
+    bool trackFirstDabLatency(bool defaultValue = false) const;
+    void setTrackFirstDabLatency(bool value);
+
+    bool prewarmStrokeResources(bool defaultValue = false) const;
+    void setPrewarmStrokeResources(bool value);
+
     bool testingAcceptCompressedTabletEvents(bool defaultValue = false) const;
     void setTestingAcceptCompressedTabletEvents(bool value);
 
@@ -564,6 +578,14 @@ public:
     bool compressKra(bool defaultValue = false) const;
     void setCompressKra(bool compress);
 
+    /**
+     * Copy the data of the layers that haven't changed since the
+     * previous saving from the previous file instead of encoding
+     * it once again
+     */
+    bool incrementalKraSaving(bool defaultValue = false) const;
+    void setIncrementalKraSaving(bool value);
+
     bool trimKra(bool defaultValue = false) const;
     void setTrimKra(bool trim);
 
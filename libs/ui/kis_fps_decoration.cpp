@@ -39,13 +39,13 @@ KisFpsDecoration::~KisFpsDecoration()
 {
 }
 
-void KisFpsDecoration::drawDecoration(QPainter& gc, const QRectF& /*updateRect*/, const KisCoordinatesConverter */*converter*/, KisCanvas2* /*canvas*/)
+void KisFpsDecoration::drawDecoration(QPainter& gc, const QRectF& /*updateRect*/, const KisCoordinatesConverter */*converter*/, KisCanvas2* canvas)
 {
     // we always paint into a pixmap instead of directly into gc, as the latter
     // approach is known to cause garbled graphics on macOS, Windows, and even
     // sometimes Linux.
 
-    const QString text = getText();
+    const QString text = getText(canvas);
 
     // note that USUALLY the pixmap will have the right size. in very rare cases
     // (e.g. on the very first call) the computed bounding rect will not be right
@@ -95,13 +95,41 @@ bool KisFpsDecoration::draw(const QString &text, QSize &outSize)
     return true;
 }
 
-QString KisFpsDecoration::getText() const
+QString KisFpsDecoration::getText(KisCanvas2 *canvas) const
 {
     QStringList lines;
 
-    if (KisOpenglCanvasDebugger::instance()->showFpsOnCanvas()) {
-        const qreal value = KisOpenglCanvasDebugger::instance()->accumulatedFps();
+    KisOpenglCanvasDebugger *debugger = KisOpenglCanvasDebugger::instance();
+
+    if (debugger->showFpsOnCanvas()) {
+        const qreal value = debugger->accumulatedFps();
         lines << QString("Canvas FPS: %1").arg(QString::number(value, 'f', 1));
+
+        for (int i = 0; i < KisOpenglCanvasDebugger::NumFrameIntervals; i++) {
+            const KisOpenglCanvasDebugger::FrameInterval interval =
+                KisOpenglCanvasDebugger::FrameInterval(i);
+            const KisOpenglCanvasDebugger::IntervalStatistics stats =
+                debugger->frameStatistics(interval);
+
+            if (!stats.count) continue;
+
+            lines << QString("%1 (ms, mean/p50/p95/p99): %2/%3/%4/%5")
+                    .arg(KisOpenglCanvasDebugger::frameIntervalName(interval))
+                    .arg(stats.mean, 0, 'f', 1)
+                    .arg(stats.p50, 0, 'f', 1)
+                    .arg(stats.p95, 0, 'f', 1)
+                    .arg(stats.p99, 0, 'f', 1);
+        }
+
+        if (canvas) {
+            const KisCanvasUpdatesCompressor::Statistics stats = canvas->projectionUpdatesStatistics();
+
+            lines << QString("Canvas updates merged/postponed: %1/%2")
+                    .arg(stats.numMergedUpdates)
+                    .arg(stats.numDeferredUpdates);
+            lines << QString("Canvas upload speed (Mpx/s): %1")
+                    .arg(stats.uploadThroughput / 1000.0, 0, 'f', 1);
+        }
     }
 
     KisStrokeSpeedMonitor *monitor = KisStrokeSpeedMonitor::instance();
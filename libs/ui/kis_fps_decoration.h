@@ -26,7 +26,7 @@ public:
 
 private:
     bool draw(const QString &text, QSize &outSize);
-	QString getText() const;
+    QString getText(KisCanvas2 *canvas) const;
 
     QFont m_font;
     QPixmap m_pixmap;
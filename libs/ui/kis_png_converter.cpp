@@ -20,11 +20,17 @@
 
 #include <limits.h>
 #include <stdio.h>
+#include <string.h>
 #include <zlib.h>
 
 #include <QBuffer>
 #include <QFile>
 #include <QApplication>
+#include <QtEndian>
+
+#include <functional>
+#include <limits>
+#include <vector>
 
 #include <klocalizedstring.h>
 #include <QUrl>
@@ -54,6 +60,7 @@
 #include <kis_paint_layer.h>
 #include <kis_painter.h>
 #include <kis_transaction.h>
+#include <krita_utils.h>
 
 #include <kis_assert.h>
 
@@ -410,6 +417,324 @@ void _flush_fn(png_structp png_ptr)
     Q_UNUSED(png_ptr);
 }
 
+namespace
+{
+
+/**
+ * The amount of the filtered image data compressed as a single band.
+ * Every band is compressed by its own deflate stream, so the bands
+ * should be big enough for the restarts not to be noticeable in the
+ * size of the file.
+ */
+const int targetBandBytes = 1024 * 1024;
+
+/**
+ * The size of the deflate window. Every band is primed with this amount
+ * of the data preceding it, so the matches can cross the band borders
+ * the same way they do in a single zlib stream.
+ */
+const int deflateWindowSize = 32768;
+
+inline quint8 paethPredictor(int a, int b, int c)
+{
+    const int p = a + b - c;
+    const int pa = qAbs(p - a);
+    const int pb = qAbs(p - b);
+    const int pc = qAbs(p - c);
+
+    return pa <= pb && pa <= pc ? a : pb <= pc ? b : c;
+}
+
+/**
+ * Filters \p row with \p filterType as described in the section 9
+ * of the PNG specification. \p prevRow is null for the first row
+ * of the image.
+ */
+void filterRow(int filterType, const quint8 *row, const quint8 *prevRow, int rowBytes, int bpp, quint8 *dst)
+{
+    switch (filterType) {
+    case PNG_FILTER_VALUE_SUB:
+        for (int i = 0; i < rowBytes; i++) {
+            dst[i] = row[i] - (i >= bpp ? row[i - bpp] : 0);
+        }
+        break;
+    case PNG_FILTER_VALUE_UP:
+        for (int i = 0; i < rowBytes; i++) {
+            dst[i] = row[i] - (prevRow ? prevRow[i] : 0);
+        }
+        break;
+    case PNG_FILTER_VALUE_AVG:
+        for (int i = 0; i < rowBytes; i++) {
+            const int left = i >= bpp ? row[i - bpp] : 0;
+            const int up = prevRow ? prevRow[i] : 0;
+            dst[i] = row[i] - ((left + up) >> 1);
+        }
+        break;
+    case PNG_FILTER_VALUE_PAETH:
+        for (int i = 0; i < rowBytes; i++) {
+            const int left = i >= bpp ? row[i - bpp] : 0;
+            const int up = prevRow ? prevRow[i] : 0;
+            const int upLeft = prevRow && i >= bpp ? prevRow[i - bpp] : 0;
+            dst[i] = row[i] - paethPredictor(left, up, upLeft);
+        }
+        break;
+    default:
+        memcpy(dst, row, rowBytes);
+        break;
+    }
+}
+
+/**
+ * The same heuristic libpng uses for choosing the filter of a row: the
+ * smaller the sum of the filtered bytes (taken as signed values) is,
+ * the better the row is expected to compress.
+ */
+quint64 filteredRowCost(const quint8 *data, int size)
+{
+    quint64 cost = 0;
+    for (int i = 0; i < size; i++) {
+        cost += qAbs(int(qint8(data[i])));
+    }
+    return cost;
+}
+
+/**
+ * Computes the zlib stream header the same way deflate() does
+ * for the given compression \p level and \p strategy
+ */
+QByteArray zlibStreamHeader(int level, int strategy)
+{
+    const int levelFlags =
+        strategy >= Z_HUFFMAN_ONLY || level < 2 ? 0 :
+        level < 6 ? 1 :
+        level == 6 ? 2 : 3;
+
+    quint16 header = (0x78 << 8) | (levelFlags << 6);
+    header += 31 - header % 31;
+
+    QByteArray result(2, 0);
+    result[0] = char(header >> 8);
+    result[1] = char(header & 0xff);
+    return result;
+}
+
+/**
+ * Encodes the image data (the contents of IDAT chunks) of a
+ * non-interlaced PNG file.
+ *
+ * The rows are split into bands, which are converted, filtered and
+ * compressed concurrently. Every band is compressed into a raw deflate
+ * stream primed with the last 32 KiB of the data preceding the band,
+ * and all the streams except the last one end with a sync flush, so
+ * they are byte-aligned and can be simply concatenated. The checksum of
+ * the whole stream is combined from the checksums of the bands. The
+ * result is a single valid zlib stream that compresses nearly as well
+ * as the one produced by libpng itself.
+ *
+ * The bands are encoded in small batches, and every batch is written
+ * into the file before the next one is started, so only a few bands are
+ * kept in memory at a time.
+ */
+class PngBandEncoder
+{
+public:
+    enum FilterMode {
+        FilterNone,
+        FilterSub,
+        FilterAdaptive
+    };
+
+    /**
+     * Converts the row \p row of the image into the PNG layout,
+     * with 16-bit samples in the network byte order
+     */
+    using RowConverter = std::function<bool(int row, quint8 *dst)>;
+
+    PngBandEncoder(int height, int rowBytes, int bpp,
+                   FilterMode filterMode, int level, int strategy,
+                   RowConverter convertRow)
+        : m_height(height),
+          m_rowBytes(rowBytes),
+          m_bpp(bpp),
+          m_filterMode(filterMode),
+          m_level(level),
+          m_strategy(strategy),
+          m_convertRow(convertRow)
+    {
+    }
+
+    bool write(png_structp png_ptr) const
+    {
+        static png_byte idatChunkName[] = "IDAT";
+
+        const int rowsPerBand = qMax(1, targetBandBytes / (m_rowBytes + 1));
+        const int numBands = (m_height + rowsPerBand - 1) / rowsPerBand;
+        const int batchSize = 2 * KritaUtils::parallelForMaxThreads();
+
+        uLong checksum = adler32(0L, Z_NULL, 0);
+
+        for (int batchStart = 0; batchStart < numBands; batchStart += batchSize) {
+            const int batchEnd = qMin(numBands, batchStart + batchSize);
+            std::vector<Band> bands(batchEnd - batchStart);
+
+            KritaUtils::parallelFor(int(bands.size()), [&](int i) {
+                const int band = batchStart + i;
+                const int top = band * rowsPerBand;
+                const int bottom = qMin(m_height, top + rowsPerBand);
+                bands[i].isValid = encodeBand(top, bottom, band == numBands - 1, &bands[i]);
+            });
+
+            for (int i = 0; i < int(bands.size()); i++) {
+                Band &band = bands[i];
+                if (!band.isValid) return false;
+
+                checksum = adler32_combine(checksum, band.checksum, band.size);
+
+                if (batchStart + i == 0) {
+                    band.data.prepend(zlibStreamHeader(m_level, m_strategy));
+                }
+
+                if (batchStart + i == numBands - 1) {
+                    for (int shift = 24; shift >= 0; shift -= 8) {
+                        band.data.append(char((checksum >> shift) & 0xff));
+                    }
+                }
+
+                png_write_chunk(png_ptr, idatChunkName,
+                                reinterpret_cast<png_bytep>(band.data.data()),
+                                band.data.size());
+            }
+        }
+
+        return true;
+    }
+
+private:
+    struct Band {
+        QByteArray data;
+        uLong checksum = 0;
+        z_off_t size = 0;
+        bool isValid = false;
+    };
+
+    int pickFilter(const quint8 *row, const quint8 *prevRow, quint8 *dst, quint8 *scratch) const
+    {
+        if (m_filterMode != FilterAdaptive) {
+            const int filterType = m_filterMode == FilterSub ? PNG_FILTER_VALUE_SUB : PNG_FILTER_VALUE_NONE;
+            filterRow(filterType, row, prevRow, m_rowBytes, m_bpp, dst);
+            return filterType;
+        }
+
+        int bestFilterType = PNG_FILTER_VALUE_NONE;
+        quint64 bestCost = std::numeric_limits<quint64>::max();
+
+        for (int filterType = PNG_FILTER_VALUE_NONE; filterType <= PNG_FILTER_VALUE_PAETH; filterType++) {
+            filterRow(filterType, row, prevRow, m_rowBytes, m_bpp, scratch);
+            const quint64 cost = filteredRowCost(scratch, m_rowBytes);
+
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestFilterType = filterType;
+                memcpy(dst, scratch, m_rowBytes);
+            }
+        }
+
+        return bestFilterType;
+    }
+
+    bool encodeBand(int top, int bottom, bool isLastBand, Band *band) const
+    {
+        const int rowStride = m_rowBytes + 1;
+
+        /**
+         * The rows preceding the band are filtered again to get the
+         * dictionary. It is cheaper than waiting for the previous band
+         * to be filtered, and the bands stay completely independent.
+         */
+        const int dictionaryRows = (deflateWindowSize + rowStride - 1) / rowStride;
+        const int firstRow = qMax(0, top - dictionaryRows);
+        const int firstConvertedRow = qMax(0, firstRow - 1);
+
+        std::vector<quint8> filtered(size_t(bottom - firstRow) * rowStride);
+        std::vector<quint8> currentRow(m_rowBytes);
+        std::vector<quint8> prevRow(m_rowBytes);
+        std::vector<quint8> scratch(m_rowBytes);
+
+        for (int row = firstConvertedRow; row < bottom; row++) {
+            if (!m_convertRow(row, currentRow.data())) return false;
+
+            if (row >= firstRow) {
+                quint8 *dst = filtered.data() + size_t(row - firstRow) * rowStride;
+                dst[0] = pickFilter(currentRow.data(), row > 0 ? prevRow.data() : 0, dst + 1, scratch.data());
+            }
+
+            std::swap(currentRow, prevRow);
+        }
+
+        const size_t prefixSize = size_t(top - firstRow) * rowStride;
+        const quint8 *data = filtered.data() + prefixSize;
+        const size_t dataSize = filtered.size() - prefixSize;
+
+        band->size = dataSize;
+        band->checksum = adler32(adler32(0L, Z_NULL, 0), data, dataSize);
+
+        z_stream stream;
+        memset(&stream, 0, sizeof(stream));
+
+        if (deflateInit2(&stream, m_level, Z_DEFLATED, -15, 8, m_strategy) != Z_OK) {
+            return false;
+        }
+
+        if (prefixSize > 0) {
+            const size_t dictionarySize = qMin(prefixSize, size_t(deflateWindowSize));
+            deflateSetDictionary(&stream, data - dictionarySize, dictionarySize);
+        }
+
+        const int flush = isLastBand ? Z_FINISH : Z_SYNC_FLUSH;
+
+        // a sync flush may add a few bytes over the bound
+        band->data.resize(deflateBound(&stream, dataSize) + 16);
+        stream.next_in = const_cast<quint8*>(data);
+        stream.avail_in = dataSize;
+
+        size_t produced = 0;
+        bool success = true;
+
+        Q_FOREVER {
+            stream.next_out = reinterpret_cast<Bytef*>(band->data.data()) + produced;
+            stream.avail_out = band->data.size() - produced;
+
+            const int result = deflate(&stream, flush);
+            produced = band->data.size() - stream.avail_out;
+
+            if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR) {
+                success = false;
+                break;
+            }
+
+            if (isLastBand ? result == Z_STREAM_END : stream.avail_out > 0) break;
+
+            band->data.resize(band->data.size() * 2);
+        }
+
+        deflateEnd(&stream);
+        band->data.resize(produced);
+
+        return success;
+    }
+
+private:
+    const int m_height;
+    const int m_rowBytes;
+    const int m_bpp;
+    const FilterMode m_filterMode;
+    const int m_level;
+    const int m_strategy;
+    const RowConverter m_convertRow;
+};
+
+}
+
 KisImportExportErrorCode KisPNGConverter::buildImage(QIODevice* iod)
 {
     dbgFile << "Start decoding PNG File";
@@ -1024,11 +1349,16 @@ KisImportExportErrorCode KisPNGConverter::buildFile(QIODevice* iodevice, const Q
     /* set the zlib compression level */
     png_set_compression_level(png_ptr, options.compression);
 
+    const int compressionStrategy =
+        options.encodingPreset == KisPNGOptions::Fastest ? Z_HUFFMAN_ONLY :
+        options.encodingPreset == KisPNGOptions::Balanced ? Z_RLE :
+        Z_DEFAULT_STRATEGY;
+
     png_set_write_fn(png_ptr, (void*)iodevice, _write_fn, _flush_fn);
 
     /* set other zlib parameters */
     png_set_compression_mem_level(png_ptr, 8);
-    png_set_compression_strategy(png_ptr, Z_DEFAULT_STRATEGY);
+    png_set_compression_strategy(png_ptr, compressionStrategy);
     png_set_compression_window_bits(png_ptr, 15);
     png_set_compression_method(png_ptr, 8);
     png_set_compression_buffer_size(png_ptr, 8192);
@@ -1294,57 +1624,43 @@ KisImportExportErrorCode KisPNGConverter::buildFile(QIODevice* iodevice, const Q
     png_write_info(png_ptr, info_ptr);
     png_write_flush(png_ptr);
 
-    // swap byteorder on little endian machines.
-#ifndef WORDS_BIGENDIAN
-    if (color_nb_bits > 8)
-        png_set_swap(png_ptr);
-#endif
-
-    // Write the PNG
-    //     png_write_png(png_ptr, info_ptr, PNG_TRANSFORM_IDENTITY, 0);
-
-    struct RowPointersStruct {
-        RowPointersStruct(const QSize &size, int pixelSize)
-            : numRows(size.height())
-        {
-            rows = new png_byte*[numRows];
-
-            for (int i = 0; i < numRows; i++) {
-                rows[i] = new png_byte[size.width() * pixelSize];
-            }
-        }
-
-        ~RowPointersStruct() {
-            for (int i = 0; i < numRows; i++) {
-                delete[] rows[i];
-            }
-            delete[] rows;
-        }
-
-        const int numRows = 0;
-        png_byte** rows = 0;
-    };
+    /**
+     * Filtering of the rows makes sense only when every pixel takes
+     * at least one byte, libpng doesn't filter the palette images
+     * either.
+     */
+    const bool canFilterRows = color_type != PNG_COLOR_TYPE_PALETTE && color_nb_bits >= 8;
 
+    const PngBandEncoder::FilterMode filterMode =
+        !canFilterRows ? PngBandEncoder::FilterNone :
+        options.encodingPreset == KisPNGOptions::Fastest ? PngBandEncoder::FilterSub :
+        PngBandEncoder::FilterAdaptive;
 
-    // Fill the data structure
-    RowPointersStruct rowPointers(imageRect.size(), device->pixelSize());
+    if (filterMode == PngBandEncoder::FilterSub) {
+        png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE, PNG_FILTER_SUB);
+    }
 
-    int row = 0;
-    for (int y = imageRect.y(); y < imageRect.y() + imageRect.height(); y++, row++) {
-        KisHLineConstIteratorSP it = device->createHLineConstIteratorNG(imageRect.x(), y, imageRect.width());
+    /**
+     * The rows are converted into the PNG layout with the 16-bit samples
+     * already in the network byte order, so that they could be filtered and
+     * compressed without libpng. The function is called concurrently for
+     * different rows.
+     */
+    auto convertRow = [&] (int row, quint8 *dstRow) {
+        KisHLineConstIteratorSP it = device->createHLineConstIteratorNG(imageRect.x(), imageRect.y() + row, imageRect.width());
 
         switch (color_type) {
         case PNG_COLOR_TYPE_GRAY:
         case PNG_COLOR_TYPE_GRAY_ALPHA:
             if (color_nb_bits == 16) {
-                quint16 *dst = reinterpret_cast<quint16 *>(rowPointers.rows[row]);
+                quint16 *dst = reinterpret_cast<quint16 *>(dstRow);
                 do {
                     const quint16 *d = reinterpret_cast<const quint16 *>(it->oldRawData());
-                    *(dst++) = d[0];
-                    if (options.alpha) *(dst++) = d[1];
+                    *(dst++) = qToBigEndian(d[0]);
+                    if (options.alpha) *(dst++) = qToBigEndian(d[1]);
                 } while (it->nextPixel());
             } else {
-                quint8 *dst = rowPointers.rows[row];
+                quint8 *dst = dstRow;
                 do {
                     const quint8 *d = it->oldRawData();
                     *(dst++) = d[0];
@@ -1355,16 +1671,16 @@ KisImportExportErrorCode KisPNGConverter::buildFile(QIODevice* iodevice, const Q
         case PNG_COLOR_TYPE_RGB:
         case PNG_COLOR_TYPE_RGB_ALPHA:
             if (color_nb_bits == 16) {
-                quint16 *dst = reinterpret_cast<quint16 *>(rowPointers.rows[row]);
+                quint16 *dst = reinterpret_cast<quint16 *>(dstRow);
                 do {
                     const quint16 *d = reinterpret_cast<const quint16 *>(it->oldRawData());
-                    *(dst++) = d[2];
-                    *(dst++) = d[1];
-                    *(dst++) = d[0];
-                    if (options.alpha) *(dst++) = d[3];
+                    *(dst++) = qToBigEndian(d[2]);
+                    *(dst++) = qToBigEndian(d[1]);
+                    *(dst++) = qToBigEndian(d[0]);
+                    if (options.alpha) *(dst++) = qToBigEndian(d[3]);
                 } while (it->nextPixel());
             } else {
-                quint8 *dst = rowPointers.rows[row];
+                quint8 *dst = dstRow;
                 do {
                     const quint8 *d = it->oldRawData();
                     *(dst++) = d[2];
@@ -1375,7 +1691,7 @@ KisImportExportErrorCode KisPNGConverter::buildFile(QIODevice* iodevice, const Q
             }
             break;
         case PNG_COLOR_TYPE_PALETTE: {
-            quint8 *dst = rowPointers.rows[row];
+            quint8 *dst = dstRow;
             KisPNGWriteStream writestream(dst, color_nb_bits);
             do {
                 const quint8 *d = it->oldRawData();
@@ -1392,14 +1708,81 @@ KisImportExportErrorCode KisPNGConverter::buildFile(QIODevice* iodevice, const Q
         }
             break;
         default:
-            return ImportExportCodes::FormatColorSpaceUnsupported;
+            return false;
         }
-    }
 
-    png_write_image(png_ptr, rowPointers.rows);
+        return true;
+    };
 
-    // Writing is over
-    png_write_end(png_ptr, info_ptr);
+    if (!options.interlace) {
+        /**
+         * The image data of non-interlaced images is filtered and
+         * compressed in parallel bands, see PngBandEncoder
+         */
+        const int bytesPerPixel = qMax(1, int(png_get_channels(png_ptr, info_ptr)) * color_nb_bits / 8);
+
+        PngBandEncoder encoder(imageRect.height(),
+                               png_get_rowbytes(png_ptr, info_ptr),
+                               bytesPerPixel,
+                               filterMode,
+                               options.compression,
+                               compressionStrategy,
+                               convertRow);
+
+        if (!encoder.write(png_ptr)) {
+            png_destroy_write_struct(&png_ptr, &info_ptr);
+            return ImportExportCodes::Failure;
+        }
+
+        /**
+         * png_write_end() refuses to work if the image data hasn't been
+         * written by libpng itself. All the other chunks have already
+         * been written in png_write_info(), so only IEND is left.
+         */
+        static png_byte iendChunkName[] = "IEND";
+        png_write_chunk(png_ptr, iendChunkName, 0, 0);
+
+    } else {
+        // Write the PNG
+        //     png_write_png(png_ptr, info_ptr, PNG_TRANSFORM_IDENTITY, 0);
+
+        struct RowPointersStruct {
+            RowPointersStruct(const QSize &size, int pixelSize)
+                : numRows(size.height())
+            {
+                rows = new png_byte*[numRows];
+
+                for (int i = 0; i < numRows; i++) {
+                    rows[i] = new png_byte[size.width() * pixelSize];
+                }
+            }
+
+            ~RowPointersStruct() {
+                for (int i = 0; i < numRows; i++) {
+                    delete[] rows[i];
+                }
+                delete[] rows;
+            }
+
+            const int numRows = 0;
+            png_byte** rows = 0;
+        };
+
+        // Fill the data structure
+        RowPointersStruct rowPointers(imageRect.size(), device->pixelSize());
+
+        for (int row = 0; row < imageRect.height(); row++) {
+            if (!convertRow(row, rowPointers.rows[row])) {
+                png_destroy_write_struct(&png_ptr, &info_ptr);
+                return ImportExportCodes::FormatColorSpaceUnsupported;
+            }
+        }
+
+        png_write_image(png_ptr, rowPointers.rows);
+
+        // Writing is over
+        png_write_end(png_ptr, info_ptr);
+    }
 
     // Free memory
     png_destroy_write_struct(&png_ptr, &info_ptr);
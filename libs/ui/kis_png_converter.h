@@ -29,6 +29,17 @@ class Store;
 }
 
 struct KisPNGOptions {
+    /**
+     * Defines how the image data is prepared for compression. The presets
+     * trade the size of the file for the encoding speed, the compression
+     * level is applied on top of the chosen preset.
+     */
+    enum EncodingPreset {
+        SmallestFile = 0, ///< every row picks the best filter, default zlib strategy
+        Balanced, ///< every row picks the best filter, run-length zlib strategy
+        Fastest ///< 'Sub' filter for all rows, Huffman-only zlib strategy
+    };
+
     KisPNGOptions()
         : compression(0)
         , interlace(false)
@@ -44,6 +55,7 @@ struct KisPNGOptions {
         , saveAsHDR(false)
         , transparencyFillColor(Qt::white)
         , downsample(false)
+        , encodingPreset(SmallestFile)
     {}
 
     int compression;
@@ -61,6 +73,7 @@ struct KisPNGOptions {
     QList<const KisMetaData::Filter*> filters;
     QColor transparencyFillColor;
     bool downsample; // Converts to 8 bit on export
+    EncodingPreset encodingPreset;
 };
 
 /**
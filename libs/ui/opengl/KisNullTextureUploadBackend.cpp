@@ -0,0 +1,98 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#include "KisNullTextureUploadBackend.h"
+
+#include <kis_assert.h>
+
+KisNullTextureUploadBackend::KisNullTextureUploadBackend(int numPixelBuffers, int fenceLatency)
+    : m_numPixelBuffers(numPixelBuffers),
+      m_fenceLatency(fenceLatency)
+{
+}
+
+bool KisNullTextureUploadBackend::uploadTile(const KisTextureTileUpdateInfo &tileInfo, bool blockMipmapRegeneration)
+{
+    Q_UNUSED(blockMipmapRegeneration);
+
+    if (m_numUploads == m_failingUpload) {
+        return false;
+    }
+
+    UploadRecord record;
+    record.tileCol = tileInfo.tileCol();
+    record.tileRow = tileInfo.tileRow();
+    record.levelOfDetail = tileInfo.patchLevelOfDetail();
+    record.patchRect = tileInfo.realPatchRect();
+    record.numBytes = record.patchRect.width() * record.patchRect.height() * tileInfo.pixelSize();
+
+    if (m_touchPixelData) {
+        const quint8 *data = tileInfo.data();
+        for (int i = 0; i < record.numBytes; i++) {
+            m_checksum ^= data[i];
+        }
+    }
+
+    m_uploads.append(record);
+    m_numUploads++;
+
+    return true;
+}
+
+int KisNullTextureUploadBackend::numPixelBuffers() const
+{
+    return m_numPixelBuffers;
+}
+
+void KisNullTextureUploadBackend::allocateMorePixelBuffers()
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(m_numPixelBuffers > 0);
+    m_numPixelBuffers *= 2;
+}
+
+void KisNullTextureUploadBackend::insertFence()
+{
+    KIS_SAFE_ASSERT_RECOVER_NOOP(m_fenceUploadIndex < 0);
+
+    m_fenceUploadIndex = m_numUploads;
+    m_numFences++;
+}
+
+bool KisNullTextureUploadBackend::isFenceSignaled()
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(m_fenceUploadIndex >= 0, true);
+
+    return m_fenceLatency >= 0 && m_numUploads - m_fenceUploadIndex >= m_fenceLatency;
+}
+
+void KisNullTextureUploadBackend::removeFence()
+{
+    m_fenceUploadIndex = -1;
+}
+
+void KisNullTextureUploadBackend::setTouchPixelData(bool value)
+{
+    m_touchPixelData = value;
+}
+
+void KisNullTextureUploadBackend::setFailingUpload(int index)
+{
+    m_failingUpload = index;
+}
+
+const QVector<KisNullTextureUploadBackend::UploadRecord>& KisNullTextureUploadBackend::uploads() const
+{
+    return m_uploads;
+}
+
+void KisNullTextureUploadBackend::clearUploads()
+{
+    m_uploads.clear();
+}
+
+int KisNullTextureUploadBackend::numFences() const
+{
+    return m_numFences;
+}
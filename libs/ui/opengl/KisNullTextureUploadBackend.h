@@ -0,0 +1,81 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef KISNULLTEXTUREUPLOADBACKEND_H
+#define KISNULLTEXTUREUPLOADBACKEND_H
+
+#include "KisTextureUploadScheduler.h"
+
+#include <QPoint>
+#include <QRect>
+#include <QVector>
+
+/**
+ * A texture upload backend that doesn't need any GL context. It only
+ * records the uploads and emulates a driver that finishes reading the
+ * pixel buffers with a delay, so the uploading can be tested and
+ * benchmarked on the machines without a GPU.
+ */
+class KRITAUI_EXPORT KisNullTextureUploadBackend : public KisTextureUploadBackend
+{
+public:
+    struct UploadRecord {
+        int tileCol = 0;
+        int tileRow = 0;
+        int levelOfDetail = 0;
+        QRect patchRect;
+        int numBytes = 0;
+    };
+
+public:
+    /**
+     * \p numPixelBuffers is the initial size of the emulated ring of the
+     * pixel buffers, zero disables it. The fence is signaled only after
+     * \p fenceLatency more tiles have been uploaded, a negative value
+     * means it never gets signaled.
+     */
+    KisNullTextureUploadBackend(int numPixelBuffers = 0, int fenceLatency = 0);
+
+    bool uploadTile(const KisTextureTileUpdateInfo &tileInfo, bool blockMipmapRegeneration) override;
+
+    int numPixelBuffers() const override;
+    void allocateMorePixelBuffers() override;
+
+    void insertFence() override;
+    bool isFenceSignaled() override;
+    void removeFence() override;
+
+    /**
+     * If enabled, the pixels of every tile are read, as a driver copying
+     * them into the video memory would do
+     */
+    void setTouchPixelData(bool value);
+
+    /**
+     * Makes the upload number \p index (counting from zero) fail,
+     * a negative value disables the failures
+     */
+    void setFailingUpload(int index);
+
+    const QVector<UploadRecord>& uploads() const;
+    void clearUploads();
+
+    int numFences() const;
+
+private:
+    int m_numPixelBuffers = 0;
+    int m_fenceLatency = 0;
+    bool m_touchPixelData = false;
+    int m_failingUpload = -1;
+
+    int m_fenceUploadIndex = -1;
+    int m_numUploads = 0;
+    int m_numFences = 0;
+
+    QVector<UploadRecord> m_uploads;
+    quint8 m_checksum = 0;
+};
+
+#endif // KISNULLTEXTUREUPLOADBACKEND_H
@@ -8,12 +8,24 @@
 // TODO: conversion options into a separate file!
 #include "kis_update_info.h"
 #include "opengl/kis_texture_tile_info_pool.h"
+#include "opengl/KisTextureTileFastConverter.h"
 
 #include "KisProofingConfiguration.h"
 
 #include <QReadWriteLock>
 #include <QReadLocker>
 #include <QWriteLocker>
+#include <krita_utils.h>
+
+namespace {
+
+/**
+ * The smallest number of converted tiles that is worth waking up
+ * the helper threads from the threads of the update scheduler
+ */
+const int MIN_TILES_FOR_PARALLEL_CONVERSION = 4;
+
+}
 
 
 struct KRITAUI_NO_EXPORT KisOpenGLUpdateInfoBuilder::Private
@@ -142,16 +154,6 @@ KisOpenGLUpdateInfoSP KisOpenGLUpdateInfoBuilder::buildUpdateInfo(const QRect &r
                                                      m_d->pool));
             // Don't update empty tiles
             if (tileInfo->valid()) {
-                tileInfo->retrieveData(projection, channelFlags, m_d->onlyOneChannelSelected, m_d->selectedChannelIndex);
-
-                if (convertColorSpace) {
-                    if (m_d->proofingTransform) {
-                        tileInfo->proofTo(m_d->conversionOptions.m_destinationColorSpace, m_d->proofingConfig->displayFlags, m_d->proofingTransform.data());
-                    } else {
-                        tileInfo->convertTo(m_d->conversionOptions.m_destinationColorSpace, m_d->conversionOptions.m_renderingIntent, m_d->conversionOptions.m_conversionFlags);
-                    }
-                }
-
                 info->tileList.append(tileInfo);
             }
             else {
@@ -160,6 +162,76 @@ KisOpenGLUpdateInfoSP KisOpenGLUpdateInfoBuilder::buildUpdateInfo(const QRect &r
         }
     }
 
+    const bool showSingleChannelAsColor = KisConfig(true).showSingleChannelAsColor();
+
+    const KoColorSpace *srcColorSpace = projection->colorSpace();
+    const KoColorSpace *dstColorSpace = m_d->conversionOptions.m_destinationColorSpace;
+
+    /**
+     * Depth-only conversions (e.g. for HDR surfaces) don't need a color
+     * transformation, so the converter is created once for all the tiles
+     * of the update.
+     */
+    QScopedPointer<KisTextureTileFastConverter> fastConverter;
+    if (convertColorSpace && !m_d->proofingTransform &&
+        dstColorSpace != srcColorSpace && !(*dstColorSpace == *srcColorSpace)) {
+
+        fastConverter.reset(KisTextureTileFastConverter::create(srcColorSpace, dstColorSpace));
+    }
+
+    /**
+     * Without proofing and channel swizzling the tiles can be converted
+     * right from the projection's memory, skipping the intermediate copy
+     */
+    const bool convertDirectly =
+        convertColorSpace && !m_d->proofingTransform &&
+        !KisTextureTileUpdateInfo::needsChannelConversion(srcColorSpace, channelFlags, m_d->selectedChannelIndex);
+
+    auto processTile = [&] (int index) {
+        KisTextureTileUpdateInfoSP tileInfo = info->tileList.at(index);
+
+        if (convertDirectly) {
+            tileInfo->retrieveConvertedData(projection, dstColorSpace, m_d->conversionOptions.m_renderingIntent, m_d->conversionOptions.m_conversionFlags, fastConverter.data());
+            return;
+        }
+
+        tileInfo->retrieveData(projection, channelFlags, m_d->onlyOneChannelSelected, m_d->selectedChannelIndex, showSingleChannelAsColor);
+
+        if (convertColorSpace) {
+            if (m_d->proofingTransform) {
+                tileInfo->proofTo(dstColorSpace, m_d->proofingConfig->displayFlags, m_d->proofingTransform.data());
+            } else {
+                tileInfo->convertTo(dstColorSpace, m_d->conversionOptions.m_renderingIntent, m_d->conversionOptions.m_conversionFlags, fastConverter.data());
+            }
+        }
+    };
+
+    /**
+     * Reading the projection and converting the tiles are independent
+     * for every tile, so they can be split between the threads. The color
+     * conversion cache gives every thread its own transformation instance.
+     *
+     * During strokes the builder is called from the threads of the update
+     * scheduler, where parallelFor() is serialized. A large update that
+     * needs a real color transformation (e.g. a fast stroke on a wide-gamut
+     * display) is CPU-bound, so it lifts the restriction and lets the idle
+     * helper threads join. Plain copies and depth-only conversions are
+     * limited by the memory bandwidth and stay in the calling thread.
+     */
+    const bool needsColorTransformation =
+        convertColorSpace &&
+        (m_d->proofingTransform ||
+         (!fastConverter && !(*dstColorSpace == *srcColorSpace)));
+
+    if (needsColorTransformation &&
+        info->tileList.size() >= MIN_TILES_FOR_PARALLEL_CONVERSION) {
+
+        KritaUtils::ParallelForUnlockGuard unlockGuard;
+        KritaUtils::parallelFor(info->tileList.size(), processTile);
+    } else {
+        KritaUtils::parallelFor(info->tileList.size(), processTile);
+    }
+
     info->assignDirtyImageRect(rect);
     info->assignLevelOfDetail(levelOfDetail);
     return info;
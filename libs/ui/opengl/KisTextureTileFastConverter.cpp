@@ -0,0 +1,220 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisTextureTileFastConverter.h"
+
+#include <limits>
+
+#include <QVector>
+
+#include <KoChannelInfo.h>
+#include <KoColorModelStandardIds.h>
+#include <KoColorProfile.h>
+#include <KoColorSpace.h>
+#include <KoOptimizedPixelDataScalerU8ToU16Factory.h>
+
+#include <KoConfig.h>
+#ifdef HAVE_OPENEXR
+#include <half.h>
+#endif
+
+
+namespace {
+
+enum ConversionMode {
+    U8ToU16,
+    U16ToU8,
+    U8ToF16,
+    U16ToF16,
+    F32ToF16
+};
+
+#ifdef HAVE_OPENEXR
+
+/**
+ * The integer depths have too few distinct values to convert them into
+ * half one by one, so we convert them only once
+ */
+template<typename SrcType>
+const half* halfLookupTable()
+{
+    static const QVector<half> table = [] () {
+        const int maxValue = std::numeric_limits<SrcType>::max();
+
+        QVector<half> result(maxValue + 1);
+        for (int i = 0; i <= maxValue; i++) {
+            result[i] = half(float(i) / maxValue);
+        }
+        return result;
+    }();
+
+    return table.constData();
+}
+
+template<typename SrcType, typename Func>
+void convertToHalf(const quint8 *src, quint8 *dst, int numPixels, const int *dstToSrcChannel, Func func)
+{
+    const SrcType *srcPtr = reinterpret_cast<const SrcType*>(src);
+    half *dstPtr = reinterpret_cast<half*>(dst);
+
+    const int c0 = dstToSrcChannel[0];
+    const int c1 = dstToSrcChannel[1];
+    const int c2 = dstToSrcChannel[2];
+    const int c3 = dstToSrcChannel[3];
+
+    for (int i = 0; i < numPixels; i++) {
+        dstPtr[0] = func(srcPtr[c0]);
+        dstPtr[1] = func(srcPtr[c1]);
+        dstPtr[2] = func(srcPtr[c2]);
+        dstPtr[3] = func(srcPtr[c3]);
+
+        srcPtr += 4;
+        dstPtr += 4;
+    }
+}
+
+#endif /* HAVE_OPENEXR */
+
+}
+
+struct KisTextureTileFastConverter::Private
+{
+    ConversionMode mode = U8ToU16;
+    int dstToSrcChannel[4] = {0, 1, 2, 3};
+    QScopedPointer<KoOptimizedPixelDataScalerU8ToU16Base> scaler;
+};
+
+KisTextureTileFastConverter::KisTextureTileFastConverter()
+    : m_d(new Private)
+{
+}
+
+KisTextureTileFastConverter::~KisTextureTileFastConverter()
+{
+}
+
+KisTextureTileFastConverter *KisTextureTileFastConverter::create(const KoColorSpace *srcColorSpace, const KoColorSpace *dstColorSpace)
+{
+    if (srcColorSpace->colorModelId() != RGBAColorModelID ||
+        dstColorSpace->colorModelId() != RGBAColorModelID) {
+
+        return 0;
+    }
+
+    const KoColorProfile *srcProfile = srcColorSpace->profile();
+    const KoColorProfile *dstProfile = dstColorSpace->profile();
+
+    if (!srcProfile || !dstProfile ||
+        (srcProfile != dstProfile && !(*srcProfile == *dstProfile))) {
+
+        return 0;
+    }
+
+    const KoID srcDepth = srcColorSpace->colorDepthId();
+    const KoID dstDepth = dstColorSpace->colorDepthId();
+
+    ConversionMode mode;
+
+    if (srcDepth == Integer8BitsColorDepthID && dstDepth == Integer16BitsColorDepthID) {
+        mode = U8ToU16;
+    } else if (srcDepth == Integer16BitsColorDepthID && dstDepth == Integer8BitsColorDepthID) {
+        mode = U16ToU8;
+#ifdef HAVE_OPENEXR
+    } else if (srcDepth == Integer8BitsColorDepthID && dstDepth == Float16BitsColorDepthID) {
+        mode = U8ToF16;
+    } else if (srcDepth == Integer16BitsColorDepthID && dstDepth == Float16BitsColorDepthID) {
+        mode = U16ToF16;
+    } else if (srcDepth == Float32BitsColorDepthID && dstDepth == Float16BitsColorDepthID) {
+        mode = F32ToF16;
+#endif
+    } else {
+        return 0;
+    }
+
+    /**
+     * Integer RGB color spaces store the channels in BGRA order, and
+     * the floating point ones in RGBA, so we should match the channels
+     * by their display positions.
+     */
+    const QList<KoChannelInfo*> srcChannels = srcColorSpace->channels();
+    const QList<KoChannelInfo*> dstChannels = dstColorSpace->channels();
+
+    if (srcChannels.size() != 4 || dstChannels.size() != 4) {
+        return 0;
+    }
+
+    int srcChannelByDisplayPosition[4] = {-1, -1, -1, -1};
+
+    Q_FOREACH (const KoChannelInfo *channel, srcChannels) {
+        const int displayPosition = channel->displayPosition();
+        if (displayPosition < 0 || displayPosition >= 4) return 0;
+
+        srcChannelByDisplayPosition[displayPosition] = channel->pos() / channel->size();
+    }
+
+    QScopedPointer<KisTextureTileFastConverter> converter(new KisTextureTileFastConverter());
+    converter->m_d->mode = mode;
+
+    Q_FOREACH (const KoChannelInfo *channel, dstChannels) {
+        const int displayPosition = channel->displayPosition();
+        if (displayPosition < 0 || displayPosition >= 4) return 0;
+
+        const int srcIndex = srcChannelByDisplayPosition[displayPosition];
+        const int dstIndex = channel->pos() / channel->size();
+
+        if (srcIndex < 0 || dstIndex < 0 || dstIndex >= 4) return 0;
+
+        converter->m_d->dstToSrcChannel[dstIndex] = srcIndex;
+    }
+
+    if (mode == U8ToU16 || mode == U16ToU8) {
+        // the scaler doesn't reorder the channels
+        for (int i = 0; i < 4; i++) {
+            if (converter->m_d->dstToSrcChannel[i] != i) return 0;
+        }
+
+        converter->m_d->scaler.reset(KoOptimizedPixelDataScalerU8ToU16Factory::createRgbaScaler());
+    }
+
+    return converter.take();
+}
+
+void KisTextureTileFastConverter::convert(const quint8 *src, quint8 *dst, int numPixels) const
+{
+    switch (m_d->mode) {
+    case U8ToU16:
+        m_d->scaler->convertU8ToU16(src, numPixels * 4 * sizeof(quint8),
+                                    dst, numPixels * 4 * sizeof(quint16),
+                                    1, numPixels);
+        break;
+    case U16ToU8:
+        m_d->scaler->convertU16ToU8(src, numPixels * 4 * sizeof(quint16),
+                                    dst, numPixels * 4 * sizeof(quint8),
+                                    1, numPixels);
+        break;
+#ifdef HAVE_OPENEXR
+    case U8ToF16: {
+        const half *table = halfLookupTable<quint8>();
+        convertToHalf<quint8>(src, dst, numPixels, m_d->dstToSrcChannel,
+                              [table] (quint8 value) { return table[value]; });
+        break;
+    }
+    case U16ToF16: {
+        const half *table = halfLookupTable<quint16>();
+        convertToHalf<quint16>(src, dst, numPixels, m_d->dstToSrcChannel,
+                               [table] (quint16 value) { return table[value]; });
+        break;
+    }
+    case F32ToF16:
+        convertToHalf<float>(src, dst, numPixels, m_d->dstToSrcChannel,
+                             [] (float value) { return half(value); });
+        break;
+#else
+    default:
+        Q_UNREACHABLE();
+#endif
+    }
+}
@@ -0,0 +1,49 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISTEXTURETILEFASTCONVERTER_H
+#define KISTEXTURETILEFASTCONVERTER_H
+
+#include <QScopedPointer>
+#include <QtGlobal>
+
+#include "kritaui_export.h"
+
+class KoColorSpace;
+
+/**
+ * Converts the pixels of the canvas texture tiles between two RGBA
+ * color spaces that have the same profile and differ in the bit depth
+ * only. Such conversion doesn't need a real color transformation, so
+ * it is done without going through the color conversion system:
+ *
+ * - U8 <-> U16 conversion uses the vectorized scaler from pigment
+ * - U8 -> F16 and U16 -> F16 (HDR surfaces) use lookup tables
+ * - F32 -> F16 converts the values directly
+ *
+ * For all other pairs of color spaces create() returns null and the
+ * caller should fall back to KoColorSpace::convertPixelsTo().
+ *
+ * convert() may be called from several threads at the same time.
+ */
+class KRITAUI_EXPORT KisTextureTileFastConverter
+{
+public:
+    ~KisTextureTileFastConverter();
+
+    static KisTextureTileFastConverter* create(const KoColorSpace *srcColorSpace,
+                                               const KoColorSpace *dstColorSpace);
+
+    void convert(const quint8 *src, quint8 *dst, int numPixels) const;
+
+private:
+    KisTextureTileFastConverter();
+
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISTEXTURETILEFASTCONVERTER_H
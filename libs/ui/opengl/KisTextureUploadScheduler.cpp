@@ -0,0 +1,62 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#include "KisTextureUploadScheduler.h"
+
+//#define DEBUG_BUFFER_REALLOCATION
+
+KisTextureUploadBackend::~KisTextureUploadBackend()
+{
+}
+
+bool KisTextureUploadScheduler::upload(const KisTextureTileUpdateInfoSPList &tiles,
+                                       KisTextureUploadBackend *backend,
+                                       bool blockMipmapRegeneration)
+{
+    bool result = true;
+    bool hasFence = false;
+    int numProcessedTiles = 0;
+
+    Q_FOREACH (KisTextureTileUpdateInfoSP tileInfo, tiles) {
+        const int numBuffers = backend->numPixelBuffers();
+
+        if (numBuffers > 0 && numProcessedTiles > numBuffers &&
+            hasFence && !backend->isFenceSignaled()) {
+
+#ifdef DEBUG_BUFFER_REALLOCATION
+            qDebug() << "Still unsignalled after processed" << numProcessedTiles << "tiles";
+#endif
+
+            backend->allocateMorePixelBuffers();
+
+#ifdef DEBUG_BUFFER_REALLOCATION
+            qDebug() << "    increased number of buffers to" << backend->numPixelBuffers();
+#endif
+        }
+
+        if (!backend->uploadTile(*tileInfo, blockMipmapRegeneration)) {
+            result = false;
+            break;
+        }
+
+        if (numBuffers > 0) {
+            if (!hasFence) {
+                backend->insertFence();
+                hasFence = true;
+                numProcessedTiles = 0;
+            } else if (backend->isFenceSignaled()) {
+                backend->removeFence();
+                hasFence = false;
+            }
+            numProcessedTiles++;
+        }
+    }
+
+    if (hasFence) {
+        backend->removeFence();
+    }
+
+    return result;
+}
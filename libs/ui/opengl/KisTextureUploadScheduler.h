@@ -0,0 +1,78 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef KISTEXTUREUPLOADSCHEDULER_H
+#define KISTEXTUREUPLOADSCHEDULER_H
+
+#include "kritaui_export.h"
+
+#include "opengl/kis_texture_tile_update_info.h"
+
+/**
+ * The part of the canvas that actually moves the converted tiles into
+ * the textures. KisOpenGLImageTextures implements it with GL calls,
+ * KisNullTextureUploadBackend only records the uploads, so that the
+ * uploading can be tested and benchmarked without a GPU.
+ */
+class KRITAUI_EXPORT KisTextureUploadBackend
+{
+public:
+    virtual ~KisTextureUploadBackend();
+
+    /**
+     * Uploads the pixels of \p tileInfo, already converted into the
+     * texture format, into the corresponding texture tile
+     *
+     * \return false if the tile cannot be uploaded, e.g. when the
+     * texture tile doesn't exist
+     */
+    virtual bool uploadTile(const KisTextureTileUpdateInfo &tileInfo, bool blockMipmapRegeneration) = 0;
+
+    /**
+     * The number of the pixel buffers the uploads are streamed through,
+     * zero if the data is passed to the driver directly
+     */
+    virtual int numPixelBuffers() const = 0;
+
+    /**
+     * Called when the driver hasn't finished reading the pixel buffers
+     * yet, but all of them have already been used
+     */
+    virtual void allocateMorePixelBuffers() = 0;
+
+    /**
+     * Inserts a fence after the last upload. Only one fence
+     * exists at a time.
+     */
+    virtual void insertFence() = 0;
+    virtual bool isFenceSignaled() = 0;
+    virtual void removeFence() = 0;
+};
+
+/**
+ * Uploads the tiles of the update infos through a backend.
+ *
+ * The tiles are read from the projection and converted on the worker
+ * threads by KisOpenGLUpdateInfoBuilder, so the GUI thread only passes
+ * the ready data to the driver. When the data goes through the ring of
+ * pixel buffers, the scheduler checks with a fence whether the driver
+ * keeps up with the uploads and grows the ring when it doesn't, instead
+ * of stalling on a buffer still in use.
+ */
+class KRITAUI_EXPORT KisTextureUploadScheduler
+{
+public:
+    /**
+     * Uploads \p tiles through \p backend. The uploading stops at the
+     * first tile the backend fails to upload.
+     *
+     * \return false if some of the tiles have not been uploaded
+     */
+    static bool upload(const KisTextureTileUpdateInfoSPList &tiles,
+                       KisTextureUploadBackend *backend,
+                       bool blockMipmapRegeneration);
+};
+
+#endif // KISTEXTUREUPLOADSCHEDULER_H
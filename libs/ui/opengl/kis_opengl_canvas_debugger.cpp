@@ -9,10 +9,51 @@
 #include <QGlobalStatic>
 
 #include <QElapsedTimer>
+#include <QHash>
 #include <QDebug>
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QTextStream>
+#include <QVector>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <KisRollingMeanAccumulatorWrapper.h>
 
 #include "kis_config.h"
 #include <kis_config_notifier.h>
+#include <kis_assert.h>
+
+namespace {
+
+/**
+ * The number of the last frames the rolling statistics are calculated for
+ */
+const int statisticsWindow = 200;
+
+/**
+ * The number of the last frames saved into the CSV file
+ */
+const int maxFrameRecords = 10000;
+
+/**
+ * An input event that hasn't reached the projection in a second is
+ * considered to have caused no canvas update at all (e.g. the cursor
+ * was just hovering over the canvas). The same limit separates the
+ * frames of a continuous redraw from the idle periods of the canvas.
+ */
+const qint64 maxIntervalNs = 1000000000;
+
+inline qreal nsToMs(qint64 value)
+{
+    return value / 1000000.0;
+}
+
+}
 
 struct KisOpenglCanvasDebugger::Private
 {
@@ -22,7 +63,32 @@ struct KisOpenglCanvasDebugger::Private
           fpsSum(0),
           syncFlaggedCounter(0),
           syncFlaggedSum(0),
-          isEnabled(true) {}
+          isEnabled(true)
+    {
+        for (int i = 0; i < NumFrameIntervals; i++) {
+            intervalStats.emplace_back(new KisRollingMeanAccumulatorWrapper(statisticsWindow));
+        }
+    }
+
+    /**
+     * The stages of the oldest input event of the canvas not shown to
+     * the user yet
+     */
+    struct CanvasPipeline {
+        qint64 inputTime = -1;
+        qint64 projectionTime = -1;
+        qint64 textureTime = -1;
+
+        qint64 lastPresentTime = -1;
+    };
+
+    struct FrameRecord {
+        qint64 timestamp = 0;
+        qreal intervals[NumFrameIntervals];
+    };
+
+    void resetFrameStatistics();
+    void addFrameRecord(const FrameRecord &record);
 
     QElapsedTimer time;
 
@@ -32,9 +98,49 @@ struct KisOpenglCanvasDebugger::Private
     int syncFlaggedCounter;
     int syncFlaggedSum;
 
-    bool isEnabled;
+    /**
+     * The projection is updated in the image threads, so they check
+     * the flag without taking the mutex
+     */
+    std::atomic<bool> isEnabled;
+
+    /**
+     * The projection is updated in the image threads, so all the frame
+     * statistics are guarded by the mutex
+     */
+    mutable QMutex frameStatsMutex;
+    QElapsedTimer clock;
+
+    QHash<const void*, CanvasPipeline> canvasPipelines;
+
+    std::vector<std::unique_ptr<KisRollingMeanAccumulatorWrapper>> intervalStats;
+
+    QVector<FrameRecord> frameRecords;
+    int nextFrameRecord = 0;
 };
 
+void KisOpenglCanvasDebugger::Private::resetFrameStatistics()
+{
+    canvasPipelines.clear();
+
+    for (auto &stats : intervalStats) {
+        stats->reset(statisticsWindow);
+    }
+
+    frameRecords.clear();
+    nextFrameRecord = 0;
+}
+
+void KisOpenglCanvasDebugger::Private::addFrameRecord(const FrameRecord &record)
+{
+    if (frameRecords.size() < maxFrameRecords) {
+        frameRecords.append(record);
+    } else {
+        frameRecords[nextFrameRecord] = record;
+        nextFrameRecord = (nextFrameRecord + 1) % maxFrameRecords;
+    }
+}
+
 Q_GLOBAL_STATIC(KisOpenglCanvasDebugger, s_instance)
 
 KisOpenglCanvasDebugger::KisOpenglCanvasDebugger()
@@ -73,10 +179,18 @@ qreal KisOpenglCanvasDebugger::accumulatedFps()
 void KisOpenglCanvasDebugger::slotConfigChanged()
 {
     KisConfig cfg(true);
-    m_d->isEnabled = cfg.enableOpenGLFramerateLogging();
+    const bool isEnabled = cfg.enableOpenGLFramerateLogging();
+    const bool wasEnabled = m_d->isEnabled.exchange(isEnabled);
 
-    if (m_d->isEnabled) {
+    if (isEnabled) {
         m_d->time.start();
+
+        QMutexLocker l(&m_d->frameStatsMutex);
+
+        if (!wasEnabled || !m_d->clock.isValid()) {
+            m_d->clock.start();
+            m_d->resetFrameStatistics();
+        }
     }
 }
 
@@ -107,3 +221,177 @@ void KisOpenglCanvasDebugger::notifySyncStatus(bool isBusy)
         m_d->syncFlaggedCounter = 0;
     }
 }
+
+void KisOpenglCanvasDebugger::notifyInputEvent(const void *canvas)
+{
+    if (!m_d->isEnabled) return;
+
+    QMutexLocker l(&m_d->frameStatsMutex);
+    Private::CanvasPipeline &pipeline = m_d->canvasPipelines[canvas];
+    const qint64 now = m_d->clock.nsecsElapsed();
+
+    if (pipeline.inputTime < 0 ||
+        (pipeline.projectionTime < 0 && now - pipeline.inputTime > maxIntervalNs)) {
+
+        pipeline.inputTime = now;
+    }
+}
+
+void KisOpenglCanvasDebugger::notifyProjectionUpdated(const void *canvas)
+{
+    if (!m_d->isEnabled) return;
+
+    QMutexLocker l(&m_d->frameStatsMutex);
+
+    auto it = m_d->canvasPipelines.find(canvas);
+    if (it == m_d->canvasPipelines.end()) return;
+
+    Private::CanvasPipeline &pipeline = *it;
+    if (pipeline.inputTime < 0 || pipeline.projectionTime >= 0) return;
+
+    const qint64 now = m_d->clock.nsecsElapsed();
+
+    if (now - pipeline.inputTime > maxIntervalNs) {
+        pipeline.inputTime = -1;
+    } else {
+        pipeline.projectionTime = now;
+    }
+}
+
+void KisOpenglCanvasDebugger::notifyTexturesUploaded(const void *canvas)
+{
+    if (!m_d->isEnabled) return;
+
+    QMutexLocker l(&m_d->frameStatsMutex);
+
+    auto it = m_d->canvasPipelines.find(canvas);
+    if (it == m_d->canvasPipelines.end()) return;
+
+    if (it->projectionTime >= 0 && it->textureTime < 0) {
+        it->textureTime = m_d->clock.nsecsElapsed();
+    }
+}
+
+void KisOpenglCanvasDebugger::notifyFramePresented(const void *canvas)
+{
+    if (!m_d->isEnabled) return;
+
+    QMutexLocker l(&m_d->frameStatsMutex);
+    Private::CanvasPipeline &pipeline = m_d->canvasPipelines[canvas];
+    const qint64 now = m_d->clock.nsecsElapsed();
+
+    Private::FrameRecord record;
+    record.timestamp = now;
+    std::fill(record.intervals, record.intervals + NumFrameIntervals, qQNaN());
+
+    if (pipeline.lastPresentTime >= 0 && now - pipeline.lastPresentTime <= maxIntervalNs) {
+        record.intervals[FrameTime] = nsToMs(now - pipeline.lastPresentTime);
+    }
+    pipeline.lastPresentTime = now;
+
+    if (pipeline.textureTime >= 0) {
+        record.intervals[InputToProjection] = nsToMs(pipeline.projectionTime - pipeline.inputTime);
+        record.intervals[ProjectionToTexture] = nsToMs(pipeline.textureTime - pipeline.projectionTime);
+        record.intervals[TextureToPresent] = nsToMs(now - pipeline.textureTime);
+        record.intervals[InputToPresent] = nsToMs(now - pipeline.inputTime);
+
+        pipeline.inputTime = -1;
+        pipeline.projectionTime = -1;
+        pipeline.textureTime = -1;
+    }
+
+    for (int i = 0; i < NumFrameIntervals; i++) {
+        if (!qIsNaN(record.intervals[i])) {
+            (*m_d->intervalStats[i])(record.intervals[i]);
+        }
+    }
+
+    m_d->addFrameRecord(record);
+}
+
+void KisOpenglCanvasDebugger::forgetCanvas(const void *canvas)
+{
+    QMutexLocker l(&m_d->frameStatsMutex);
+    m_d->canvasPipelines.remove(canvas);
+}
+
+QString KisOpenglCanvasDebugger::frameIntervalName(FrameInterval interval)
+{
+    switch (interval) {
+    case FrameTime:
+        return "Frame time";
+    case InputToProjection:
+        return "Input to projection";
+    case ProjectionToTexture:
+        return "Projection to texture";
+    case TextureToPresent:
+        return "Texture to present";
+    case InputToPresent:
+        return "Input to present";
+    case NumFrameIntervals:
+        break;
+    }
+
+    return QString();
+}
+
+KisOpenglCanvasDebugger::IntervalStatistics
+KisOpenglCanvasDebugger::frameStatistics(FrameInterval interval) const
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(interval >= 0 && interval < NumFrameIntervals, IntervalStatistics());
+
+    QMutexLocker l(&m_d->frameStatsMutex);
+    const KisRollingMeanAccumulatorWrapper &stats = *m_d->intervalStats[interval];
+
+    IntervalStatistics result;
+    result.count = stats.rollingCount();
+    result.mean = stats.rollingMeanSafe();
+    result.p50 = stats.rollingPercentile(0.50);
+    result.p95 = stats.rollingPercentile(0.95);
+    result.p99 = stats.rollingPercentile(0.99);
+
+    return result;
+}
+
+bool KisOpenglCanvasDebugger::exportFrameStatistics(const QString &fileName) const
+{
+    QVector<Private::FrameRecord> records;
+
+    {
+        QMutexLocker l(&m_d->frameStatsMutex);
+
+        // unroll the ring buffer, the oldest frame goes first
+        records = m_d->frameRecords.mid(m_d->nextFrameRecord);
+        records += m_d->frameRecords.mid(0, m_d->nextFrameRecord);
+    }
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        qWarning() << "Failed to open file for saving canvas frame statistics:" << fileName;
+        return false;
+    }
+
+    QTextStream stream(&file);
+
+    stream << "frame,timestamp_ms";
+    for (int i = 0; i < NumFrameIntervals; i++) {
+        stream << "," << frameIntervalName(FrameInterval(i)).toLower().replace(' ', '_') << "_ms";
+    }
+    stream << "\n";
+
+    for (int frame = 0; frame < records.size(); frame++) {
+        const Private::FrameRecord &record = records[frame];
+
+        stream << frame << "," << QString::number(nsToMs(record.timestamp), 'f', 3);
+        for (int i = 0; i < NumFrameIntervals; i++) {
+            stream << ",";
+            if (!qIsNaN(record.intervals[i])) {
+                stream << QString::number(record.intervals[i], 'f', 3);
+            }
+        }
+        stream << "\n";
+    }
+
+    stream.flush();
+    return file.error() == QFile::NoError;
+}
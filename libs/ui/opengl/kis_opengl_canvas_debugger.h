@@ -14,6 +14,33 @@
 class KisOpenglCanvasDebugger : public QObject
 {
     Q_OBJECT
+public:
+    /**
+     * The intervals measured for the frames presented on the canvas.
+     * The latencies are measured only for the frames that show the
+     * result of the user's input, that is, the input event has passed
+     * through the whole pipeline of the canvas.
+     *
+     * Every canvas has its own pipeline, so the frames of one view don't
+     * consume the input events and updates of another one.
+     */
+    enum FrameInterval {
+        FrameTime = 0,          ///< time between two presented frames
+        InputToProjection,      ///< input event -> projection of the image updated
+        ProjectionToTexture,    ///< projection updated -> canvas textures uploaded
+        TextureToPresent,       ///< textures uploaded -> frame presented
+        InputToPresent,         ///< full input latency of the canvas
+        NumFrameIntervals
+    };
+
+    struct IntervalStatistics {
+        qreal mean = 0.0;
+        qreal p50 = 0.0;
+        qreal p95 = 0.0;
+        qreal p99 = 0.0;
+        int count = 0;
+    };
+
 public:
     KisOpenglCanvasDebugger();
     ~KisOpenglCanvasDebugger();
@@ -26,6 +53,51 @@ public:
     void notifySyncStatus(bool value);
     qreal accumulatedFps();
 
+    /**
+     * Called by the input manager when the user moves the cursor or
+     * the stylus over \p canvas
+     */
+    void notifyInputEvent(const void *canvas);
+
+    /**
+     * Called when the image has updated its projection and \p canvas
+     * starts preparing the textures. May be called from any thread.
+     */
+    void notifyProjectionUpdated(const void *canvas);
+
+    /**
+     * Called when \p canvas has finished uploading the updated
+     * textures
+     */
+    void notifyTexturesUploaded(const void *canvas);
+
+    /**
+     * Called when the frame of \p canvas has been swapped to the screen
+     */
+    void notifyFramePresented(const void *canvas);
+
+    /**
+     * Drops the pipeline state of \p canvas. Called when the canvas
+     * is destroyed.
+     */
+    void forgetCanvas(const void *canvas);
+
+    static QString frameIntervalName(FrameInterval interval);
+
+    /**
+     * \return the rolling statistics of \p interval in milliseconds
+     */
+    IntervalStatistics frameStatistics(FrameInterval interval) const;
+
+    /**
+     * Saves the intervals of the last presented frames into a CSV file,
+     * one frame per row. The latencies that were not measured for the
+     * frame are left empty.
+     *
+     * \return false if the file cannot be written
+     */
+    bool exportFrameStatistics(const QString &fileName) const;
+
 private Q_SLOTS:
     void slotConfigChanged();
 
@@ -29,6 +29,7 @@
 #include "KisOpenGLModeProber.h"
 #include "kis_fixed_paint_device.h"
 #include "KisOpenGLSync.h"
+#include "KisTextureUploadScheduler.h"
 #include <QVector3D>
 #include "kis_painting_tweaks.h"
 #include "KisOpenGLBufferCreationGuard.h"
@@ -64,7 +65,63 @@
 #define GL_RGBA16_EXT 0x805B
 #endif
 
-//#define DEBUG_BUFFER_REALLOCATION
+
+namespace {
+
+/**
+ * Uploads the tiles into the textures of KisOpenGLImageTextures
+ * via the current GL context
+ */
+class GLTextureUploadBackend : public KisTextureUploadBackend
+{
+public:
+    GLTextureUploadBackend(KisOpenGLImageTextures *textures, KisOpenGLBufferCircularStorage *bufferStorage)
+        : m_textures(textures),
+          m_bufferStorage(bufferStorage)
+    {
+    }
+
+    bool uploadTile(const KisTextureTileUpdateInfo &tileInfo, bool blockMipmapRegeneration) override
+    {
+        KisTextureTile *tile = m_textures->getTextureTileCR(tileInfo.tileCol(), tileInfo.tileRow());
+        KIS_ASSERT_RECOVER_RETURN_VALUE(tile, false);
+
+        tile->update(tileInfo, blockMipmapRegeneration);
+        return true;
+    }
+
+    int numPixelBuffers() const override
+    {
+        return m_bufferStorage->isValid() ? m_bufferStorage->size() : 0;
+    }
+
+    void allocateMorePixelBuffers() override
+    {
+        m_bufferStorage->allocateMoreBuffers();
+    }
+
+    void insertFence() override
+    {
+        m_sync.reset(new KisOpenGLSync());
+    }
+
+    bool isFenceSignaled() override
+    {
+        return !m_sync || m_sync->isSignaled();
+    }
+
+    void removeFence() override
+    {
+        m_sync.reset();
+    }
+
+private:
+    KisOpenGLImageTextures *m_textures;
+    KisOpenGLBufferCircularStorage *m_bufferStorage;
+    QScopedPointer<KisOpenGLSync> m_sync;
+};
+
+}
 
 
 KisOpenGLImageTextures::ImageTexturesMap KisOpenGLImageTextures::imageTexturesMap;
@@ -340,41 +397,8 @@ void KisOpenGLImageTextures::recalculateCache(KisUpdateInfoSP info, bool blockMi
     KisOpenGLUpdateInfoSP glInfo = dynamic_cast<KisOpenGLUpdateInfo*>(info.data());
     if(!glInfo) return;
 
-    QScopedPointer<KisOpenGLSync> sync;
-    int numProcessedTiles = 0;
-
-    KisTextureTileUpdateInfoSP tileInfo;
-    Q_FOREACH (tileInfo, glInfo->tileList) {
-        KisTextureTile *tile = getTextureTileCR(tileInfo->tileCol(), tileInfo->tileRow());
-        KIS_ASSERT_RECOVER_RETURN(tile);
-
-        if (m_bufferStorage.isValid() && numProcessedTiles > m_bufferStorage.size() &&
-            sync && !sync->isSignaled()) {
-
-#ifdef DEBUG_BUFFER_REALLOCATION
-            qDebug() << "Still unsignalled after processed" << numProcessedTiles << "tiles";
-#endif
-
-            m_bufferStorage.allocateMoreBuffers();
-
-#ifdef DEBUG_BUFFER_REALLOCATION
-            qDebug() << "    increased number of buffers to" << m_bufferStorage.size();
-#endif
-        }
-
-
-        tile->update(*tileInfo, blockMipmapRegeneration);
-
-        if (m_bufferStorage.isValid()) {
-            if (!sync) {
-                sync.reset(new KisOpenGLSync());
-                numProcessedTiles = 0;
-            } else if (sync && sync->isSignaled()) {
-                sync.reset();
-            }
-            numProcessedTiles++;
-        }
-    }
+    GLTextureUploadBackend backend(this, &m_bufferStorage);
+    KisTextureUploadScheduler::upload(glInfo->tileList, &backend, blockMipmapRegeneration);
 }
 
 void KisOpenGLImageTextures::generateCheckerTexture(const QImage &checkImage)
@@ -14,10 +14,12 @@
 #include "kis_image.h"
 #include "kis_paint_device.h"
 #include "kis_texture_tile_info_pool.h"
+#include "KisTextureTileFastConverter.h"
 #include <KoChannelInfo.h>
 #include <KoColorConversionTransformation.h>
 #include <KoColorModelStandardIds.h>
 #include <KoColorSpace.h>
+#include <kis_random_accessor_ng.h>
 #include <kis_lod_transform.h>
 #include <KisPortingUtils.h>
 #include <KisDisplayConfig.h>
@@ -148,7 +150,7 @@ public:
     ~KisTextureTileUpdateInfo() {
     }
 
-    void retrieveData(KisPaintDeviceSP projectionDevice, const QBitArray &channelFlags, bool onlyOneChannelSelected, int selectedChannelIndex)
+    void retrieveData(KisPaintDeviceSP projectionDevice, const QBitArray &channelFlags, bool onlyOneChannelSelected, int selectedChannelIndex, bool showSingleChannelAsColor)
     {
         m_patchColorSpace = projectionDevice->colorSpace();
         m_patchPixels.allocate(m_patchColorSpace->pixelSize());
@@ -159,14 +161,12 @@ public:
 
         // XXX: if the paint colorspace is rgb, we should do the channel swizzling in
         //      the display shader
-        if (!channelFlags.isEmpty() && selectedChannelIndex >= 0 && selectedChannelIndex < m_patchColorSpace->channelCount()) {
+        if (needsChannelConversion(m_patchColorSpace, channelFlags, selectedChannelIndex)) {
             DataBuffer conversionCache(m_patchColorSpace->pixelSize(), m_pool);
 
             quint32 numPixels = m_patchRect.width() * m_patchRect.height();
 
-            KisConfig cfg(true);
-
-            if (onlyOneChannelSelected && !cfg.showSingleChannelAsColor()) {
+            if (onlyOneChannelSelected && !showSingleChannelAsColor) {
                 m_patchColorSpace->convertChannelToVisualRepresentation(m_patchPixels.data(), conversionCache.data(), numPixels, selectedChannelIndex);
             } else {
                 m_patchColorSpace->convertChannelToVisualRepresentation(m_patchPixels.data(), conversionCache.data(), numPixels, channelFlags);
@@ -177,15 +177,103 @@ public:
 
     }
 
+    /**
+     * Returns true if retrieveData() should convert the channels of the
+     * patch into their visual representation
+     */
+    static bool needsChannelConversion(const KoColorSpace *colorSpace, const QBitArray &channelFlags, int selectedChannelIndex)
+    {
+        return !channelFlags.isEmpty() &&
+            selectedChannelIndex >= 0 &&
+            selectedChannelIndex < int(colorSpace->channelCount());
+    }
+
+    /**
+     * Reads the patch from \p projectionDevice and converts it into \p dstCS.
+     * It is equivalent to calling retrieveData() without channel flags and
+     * convertTo(). If \p fastConverter is non-null, the pixels are converted
+     * in one pass, right from the memory of the tiles, without copying them
+     * into an intermediate buffer.
+     */
+    void retrieveConvertedData(KisPaintDeviceSP projectionDevice,
+                               const KoColorSpace* dstCS,
+                               KoColorConversionTransformation::Intent renderingIntent,
+                               KoColorConversionTransformation::ConversionFlags conversionFlags,
+                               const KisTextureTileFastConverter *fastConverter = nullptr)
+    {
+        const KoColorSpace *srcCS = projectionDevice->colorSpace();
+
+        /**
+         * The generic color transformations (e.g. LCMS ones) have a
+         * considerable per-call overhead, so calling them for every
+         * run of the tile rows is slower than an extra copy of the
+         * patch followed by a single conversion.
+         */
+        if (!fastConverter || dstCS == srcCS || *dstCS == *srcCS) {
+            m_patchColorSpace = srcCS;
+            m_patchPixels.allocate(m_patchColorSpace->pixelSize());
+
+            projectionDevice->readBytes(m_patchPixels.data(),
+                                        m_patchRect.x(), m_patchRect.y(),
+                                        m_patchRect.width(), m_patchRect.height());
+
+            // does nothing if the formats match
+            convertTo(dstCS, renderingIntent, conversionFlags);
+            return;
+        }
+
+        m_patchColorSpace = dstCS;
+        m_patchPixels.allocate(dstCS->pixelSize());
+
+        if (!m_patchRect.isValid()) return;
+
+        const int dstPixelSize = dstCS->pixelSize();
+        const int dstRowStride = m_patchRect.width() * dstPixelSize;
+
+        KisRandomConstAccessorSP it = projectionDevice->createRandomConstAccessorNG();
+
+        for (int y = m_patchRect.y(); y <= m_patchRect.bottom();) {
+            const int numRows = qMin(it->numContiguousRows(y), m_patchRect.bottom() - y + 1);
+
+            for (int x = m_patchRect.x(); x <= m_patchRect.right();) {
+                const int numColumns = qMin(it->numContiguousColumns(x), m_patchRect.right() - x + 1);
+
+                it->moveTo(x, y);
+
+                const qint32 srcRowStride = it->rowStride(x, y);
+                const quint8 *srcPtr = it->rawDataConst();
+                quint8 *dstPtr = m_patchPixels.data() +
+                    (y - m_patchRect.y()) * dstRowStride +
+                    (x - m_patchRect.x()) * dstPixelSize;
+
+                for (int row = 0; row < numRows; row++) {
+                    fastConverter->convert(srcPtr, dstPtr, numColumns);
+
+                    srcPtr += srcRowStride;
+                    dstPtr += dstRowStride;
+                }
+
+                x += numColumns;
+            }
+
+            y += numRows;
+        }
+    }
+
+    /**
+     * Converts the patch into \p dstCS. If \p fastConverter is non-null,
+     * it is used instead of the generic color conversion. The caller should
+     * make sure it has been created for the same pair of color spaces.
+     */
     void convertTo(const KoColorSpace* dstCS,
                    KoColorConversionTransformation::Intent renderingIntent,
-                   KoColorConversionTransformation::ConversionFlags conversionFlags)
+                   KoColorConversionTransformation::ConversionFlags conversionFlags,
+                   const KisTextureTileFastConverter *fastConverter = nullptr)
     {
         // we use two-stage check of the color space equivalence:
-        // first check pointers, and if not, check the spaces themselves
-        if ((dstCS == m_patchColorSpace || *dstCS == *m_patchColorSpace) &&
-            conversionFlags == KoColorConversionTransformation::Empty) {
-
+        // first check pointers, and if not, check the spaces themselves;
+        // convertPixelsTo() ignores the flags for equal spaces anyway
+        if (dstCS == m_patchColorSpace || *dstCS == *m_patchColorSpace) {
             return;
         }
 
@@ -193,7 +281,11 @@ public:
             const qint32 numPixels = m_patchRect.width() * m_patchRect.height();
             DataBuffer conversionCache(dstCS->pixelSize(), m_pool);
 
-            m_patchColorSpace->convertPixelsTo(m_patchPixels.data(), conversionCache.data(), dstCS, numPixels, renderingIntent, conversionFlags);
+            if (fastConverter) {
+                fastConverter->convert(m_patchPixels.data(), conversionCache.data(), numPixels);
+            } else {
+                m_patchColorSpace->convertPixelsTo(m_patchPixels.data(), conversionCache.data(), dstCS, numPixels, renderingIntent, conversionFlags);
+            }
 
             m_patchColorSpace = dstCS;
             conversionCache.swap(m_patchPixels);
@@ -12,6 +12,7 @@
 #include "stroke_testing_utils.h"
 #include "strokes/KisFreehandStrokeInfo.h"
 #include "strokes/freehand_stroke.h"
+#include <kis_distance_information.h>
 #include <KoColor.h>
 #include <KoCompositeOpRegistry.h>
 #include <brushengine/kis_paint_information.h>
@@ -25,6 +26,32 @@
 #include "KisGlobalResourcesInterface.h"
 
 
+/**
+ * Counts the dabs painted by the stroke to be able to
+ * calculate the throughput of the particle-based engines
+ */
+class DabCountingFreehandStrokeStrategy : public FreehandStrokeStrategy
+{
+public:
+    DabCountingFreehandStrokeStrategy(KisResourcesSnapshotSP resources,
+                                      KisFreehandStrokeInfo *strokeInfo,
+                                      int *numDabs)
+        : FreehandStrokeStrategy(resources, strokeInfo, kundo2_noi18n("Freehand Stroke")),
+          m_strokeInfo(strokeInfo),
+          m_numDabs(numDabs)
+    {
+    }
+
+    void finishStrokeCallback() override {
+        *m_numDabs = m_strokeInfo->dragDistance->currentDabSeqNo();
+        FreehandStrokeStrategy::finishStrokeCallback();
+    }
+
+private:
+    KisFreehandStrokeInfo *m_strokeInfo;
+    int *m_numDabs;
+};
+
 class FreehandStrokeBenchmarkTester : public utils::StrokeTester
 {
 public:
@@ -38,6 +65,10 @@ public:
         m_cpuCoresLimit = value;
     }
 
+    int lastNumDabs() const {
+        return m_numDabs;
+    }
+
 protected:
     using utils::StrokeTester::initImage;
     void initImage(KisImageWSP image, KisNodeSP activeNode) override {
@@ -55,7 +86,7 @@ protected:
         KisFreehandStrokeInfo *strokeInfo = new KisFreehandStrokeInfo();
 
         QScopedPointer<FreehandStrokeStrategy> stroke(
-            new FreehandStrokeStrategy(resources, strokeInfo, kundo2_noi18n("Freehand Stroke")));
+            new DabCountingFreehandStrokeStrategy(resources, strokeInfo, &m_numDabs));
 
         return stroke.take();
     }
@@ -88,6 +119,7 @@ protected:
 
 private:
     int m_cpuCoresLimit = -1;
+    int m_numDabs = 0;
 };
 
 void benchmarkBrush(const QString &presetName)
@@ -115,6 +147,30 @@ void benchmarkBrushUnthreaded(const QString &presetName)
     }
 }
 
+/**
+ * \p particlesPerDab is the number of particles the preset
+ * generates for every dab (for the particle brush it is
+ * count * iterations)
+ */
+void benchmarkParticleBrush(const QString &presetName, int particlesPerDab)
+{
+    FreehandStrokeBenchmarkTester tester(presetName);
+
+    Q_FOREACH(int i, QVector<int>({1, QThread::idealThreadCount()})) {
+        tester.setCpuCoresLimit(i);
+        tester.benchmark();
+
+        const qreal numParticles = qreal(tester.lastNumDabs()) * particlesPerDab;
+        const int time = tester.lastStrokeTime();
+
+        qDebug() << qPrintable(QString("Cores: %1 Time: %2 (ms) Dabs: %3 Particles/sec: %4")
+                               .arg(i)
+                               .arg(time)
+                               .arg(tester.lastNumDabs())
+                               .arg(time > 0 ? numParticles / time * 1000.0 : 0.0, 0, 'f', 0));
+    }
+}
+
 #include <KoResourcePaths.h>
 #include <KisSupportedArchitectures.h>
 
@@ -255,4 +311,49 @@ void FreehandStrokeBenchmark::testColorsmudgeLightness_smear_new_nsa_ptoverwrite
     benchmarkBrushUnthreaded("testing_200px_colorsmudge_lightness_smearing_new_nsa_ptoverwrite.kpp");
 }
 
+void FreehandStrokeBenchmark::testSprayEllipse()
+{
+    benchmarkParticleBrush("testing_500px_spray_2000_ellipse.kpp", 2000);
+}
+
+void FreehandStrokeBenchmark::testSprayRectangle()
+{
+    benchmarkParticleBrush("testing_500px_spray_2000_rect.kpp", 2000);
+}
+
+void FreehandStrokeBenchmark::testSprayPixel()
+{
+    benchmarkParticleBrush("testing_500px_spray_5000_pixel.kpp", 5000);
+}
+
+void FreehandStrokeBenchmark::testParticle()
+{
+    benchmarkParticleBrush("testing_particle_500_iter_50.kpp", 500 * 50);
+}
+
+void FreehandStrokeBenchmark::testHairy_100_bristles()
+{
+    benchmarkBrushUnthreaded("testing_hairy_100_bristles.kpp");
+}
+
+void FreehandStrokeBenchmark::testHairy_500_bristles()
+{
+    benchmarkBrushUnthreaded("testing_hairy_500_bristles.kpp");
+}
+
+void FreehandStrokeBenchmark::testHairy_1000_bristles()
+{
+    benchmarkBrushUnthreaded("testing_hairy_1000_bristles.kpp");
+}
+
+void FreehandStrokeBenchmark::testHairy_2500_bristles()
+{
+    benchmarkBrushUnthreaded("testing_hairy_2500_bristles.kpp");
+}
+
+void FreehandStrokeBenchmark::testHairy_5000_bristles()
+{
+    benchmarkBrushUnthreaded("testing_hairy_5000_bristles.kpp");
+}
+
 KISTEST_MAIN(FreehandStrokeBenchmark)
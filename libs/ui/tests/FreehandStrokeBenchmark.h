@@ -43,6 +43,17 @@ private Q_SLOTS:
     void testColorsmudgeLightness_smear_new_nsa_nopt();
     void testColorsmudgeLightness_smear_new_nsa_ptoverlay();
     void testColorsmudgeLightness_smear_new_nsa_ptoverwrite();
+
+    void testSprayEllipse();
+    void testSprayRectangle();
+    void testSprayPixel();
+    void testParticle();
+
+    void testHairy_100_bristles();
+    void testHairy_500_bristles();
+    void testHairy_1000_bristles();
+    void testHairy_2500_bristles();
+    void testHairy_5000_bristles();
 };
 
 #endif // FREEHANDSTROKEBENCHMARK_H
@@ -0,0 +1,99 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisBatchExporterTest.h"
+
+#include <QFileInfo>
+#include <QImage>
+#include <QTemporaryDir>
+#include <simpletest.h>
+#include <testui.h>
+
+#include "KisBatchExporter.h"
+
+namespace {
+void writeManifest(const QString &fileName, const QString &content)
+{
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Text));
+    file.write(content.toUtf8());
+}
+}
+
+void KisBatchExporterTest::testParseManifest()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    const QString manifest = dir.filePath("manifest.txt");
+    writeManifest(manifest,
+                  "# comment\n"
+                  "\n"
+                  "first.kra\tout/first.png\n"
+                  "  /absolute/second.kra\t/absolute/second.exr  \n");
+
+    QVector<KisBatchExporter::Job> jobs;
+    QString errorMessage;
+
+    QVERIFY(KisBatchExporter::parseManifest(manifest, &jobs, &errorMessage));
+    QCOMPARE(jobs.size(), 2);
+    QCOMPARE(jobs[0].source, dir.filePath("first.kra"));
+    QCOMPARE(jobs[0].destination, dir.filePath("out/first.png"));
+    QCOMPARE(jobs[1].source, QString("/absolute/second.kra"));
+    QCOMPARE(jobs[1].destination, QString("/absolute/second.exr"));
+
+    writeManifest(manifest, "first.kra\n");
+
+    jobs.clear();
+    QVERIFY(!KisBatchExporter::parseManifest(manifest, &jobs, &errorMessage));
+    QVERIFY(!errorMessage.isEmpty());
+}
+
+void KisBatchExporterTest::testRun()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    QVector<KisBatchExporter::Job> jobs;
+
+    for (int i = 0; i < 4; i++) {
+        QImage image(64 + i, 32, QImage::Format_ARGB32);
+        image.fill(QColor(i * 40, 0, 0));
+
+        const QString source = dir.filePath(QString("source%1.png").arg(i));
+        QVERIFY(image.save(source, "PNG"));
+
+        jobs.append({source, dir.filePath(QString("result%1.kra").arg(i))});
+    }
+
+    jobs.append({dir.filePath("missing.png"), dir.filePath("missing.kra")});
+    jobs.append({jobs[0].source, dir.filePath("result.unknown-format")});
+
+    KisBatchExporter exporter;
+    exporter.setMaxConcurrentDocuments(2);
+
+    const QVector<KisBatchExporter::Result> results = exporter.run(jobs);
+    QCOMPARE(results.size(), jobs.size());
+
+    for (int i = 0; i < 4; i++) {
+        QVERIFY(results[i].success);
+        QCOMPARE(results[i].job.destination, jobs[i].destination);
+        QVERIFY(QFileInfo(jobs[i].destination).size() > 0);
+        QVERIFY(results[i].memoryUsage > 0);
+    }
+
+    QVERIFY(!results[4].success);
+    QVERIFY(!results[5].success);
+
+    const QString report = dir.filePath("report.csv");
+    QVERIFY(KisBatchExporter::writeReport(report, results));
+
+    QFile reportFile(report);
+    QVERIFY(reportFile.open(QIODevice::ReadOnly | QIODevice::Text));
+    QCOMPARE(QString(reportFile.readAll()).count('\n'), results.size() + 1);
+}
+
+KISTEST_MAIN(KisBatchExporterTest)
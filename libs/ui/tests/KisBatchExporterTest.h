@@ -0,0 +1,21 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISBATCHEXPORTERTEST_H
+#define KISBATCHEXPORTERTEST_H
+
+#include <QObject>
+
+class KisBatchExporterTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testParseManifest();
+    void testRun();
+};
+
+#endif // KISBATCHEXPORTERTEST_H
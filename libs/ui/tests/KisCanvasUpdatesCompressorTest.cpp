@@ -0,0 +1,105 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisCanvasUpdatesCompressorTest.h"
+
+#include <simpletest.h>
+
+#include "canvas/kis_canvas_updates_compressor.h"
+
+namespace {
+
+KisUpdateInfoSP createInfo(const QRect &rc)
+{
+    KisPPUpdateInfo *info = new KisPPUpdateInfo();
+    info->dirtyImageRectVar = rc;
+    return info;
+}
+
+}
+
+void KisCanvasUpdatesCompressorTest::testMergeContained()
+{
+    KisCanvasUpdatesCompressor compressor;
+
+    QVERIFY(compressor.putUpdateInfo(createInfo(QRect(10,10,50,50))));
+    QVERIFY(!compressor.putUpdateInfo(createInfo(QRect(100,100,50,50))));
+    QVERIFY(!compressor.putUpdateInfo(createInfo(QRect(0,0,70,70))));
+
+    KisUpdateInfoList list;
+    QVERIFY(!compressor.takeUpdateInfo(list));
+
+    QCOMPARE(list.size(), 2);
+    QCOMPARE(list[0]->dirtyImageRect(), QRect(100,100,50,50));
+    QCOMPARE(list[1]->dirtyImageRect(), QRect(0,0,70,70));
+
+    QCOMPARE(compressor.statistics().numMergedUpdates, 1);
+}
+
+void KisCanvasUpdatesCompressorTest::testMergeCoveredByGrid()
+{
+    KisCanvasUpdatesCompressor compressor;
+
+    // covered by the two newer updates together
+    compressor.putUpdateInfo(createInfo(QRect(0,0,128,128)));
+    // covered by the newer ones, but not aligned to the grid
+    compressor.putUpdateInfo(createInfo(QRect(10,200,50,50)));
+
+    compressor.putUpdateInfo(createInfo(QRect(0,0,64,128)));
+    compressor.putUpdateInfo(createInfo(QRect(64,0,64,128)));
+    compressor.putUpdateInfo(createInfo(QRect(0,190,40,100)));
+    compressor.putUpdateInfo(createInfo(QRect(40,190,60,100)));
+
+    KisUpdateInfoList list;
+    compressor.takeUpdateInfo(list);
+
+    QCOMPARE(list.size(), 5);
+    QCOMPARE(list[0]->dirtyImageRect(), QRect(10,200,50,50));
+    QCOMPARE(list[1]->dirtyImageRect(), QRect(0,0,64,128));
+
+    QCOMPARE(compressor.statistics().numMergedUpdates, 1);
+}
+
+void KisCanvasUpdatesCompressorTest::testFrameBudget()
+{
+    KisCanvasUpdatesCompressor compressor;
+
+    const QRect rc1(0,0,100,60);
+    const QRect rc2(200,0,100,60);
+    const QRect rc3(400,0,100,60);
+
+    compressor.putUpdateInfo(createInfo(rc1));
+    compressor.putUpdateInfo(createInfo(rc2));
+    compressor.putUpdateInfo(createInfo(rc3));
+
+    // 1000 pixels per millisecond, that is, 10000 pixels per frame
+    compressor.setFrameBudget(10);
+    compressor.reportUploadTime(1000, 1000000);
+    QCOMPARE(compressor.statistics().uploadThroughput, 1000.0);
+
+    KisUpdateInfoList list;
+
+    QVERIFY(compressor.takeUpdateInfo(list));
+    QCOMPARE(list.size(), 1);
+    QCOMPARE(list[0]->dirtyImageRect(), rc1);
+    QCOMPARE(compressor.statistics().numDeferredUpdates, 2);
+
+    list.clear();
+
+    QVERIFY(compressor.takeUpdateInfo(list));
+    QCOMPARE(list.size(), 1);
+    QCOMPARE(list[0]->dirtyImageRect(), rc2);
+
+    list.clear();
+
+    QVERIFY(!compressor.takeUpdateInfo(list));
+    QCOMPARE(list.size(), 1);
+    QCOMPARE(list[0]->dirtyImageRect(), rc3);
+
+    QCOMPARE(compressor.statistics().numDeferredUpdates, 3);
+}
+
+SIMPLE_TEST_MAIN(KisCanvasUpdatesCompressorTest)
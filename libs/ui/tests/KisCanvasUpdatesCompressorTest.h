@@ -0,0 +1,21 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KISCANVASUPDATESCOMPRESSORTEST_H
+#define __KISCANVASUPDATESCOMPRESSORTEST_H
+
+#include <simpletest.h>
+
+class KisCanvasUpdatesCompressorTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testMergeContained();
+    void testMergeCoveredByGrid();
+    void testFrameBudget();
+};
+
+#endif /* __KISCANVASUPDATESCOMPRESSORTEST_H */
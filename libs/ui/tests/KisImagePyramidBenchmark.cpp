@@ -0,0 +1,168 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisImagePyramidBenchmark.h"
+
+#include <simpletest.h>
+#include <testui.h>
+#include <testutil.h>
+#include <testing_benchmark_utils.h>
+
+#include <QPainter>
+
+#include <KoColorSpaceRegistry.h>
+#include <KoColorConversionTransformation.h>
+#include <kis_debug.h>
+#include <kis_image.h>
+#include <kis_paint_device.h>
+#include <kis_paint_layer.h>
+
+#include "canvas/kis_image_patch.h"
+#include "canvas/kis_image_pyramid.h"
+#include "canvas/kis_update_info.h"
+
+namespace {
+
+/**
+ * Creates an image with a single layer filled with opaque noise, so
+ * that the pyramid planes can be compared with QImage pixels directly
+ */
+KisImageSP createNoiseImage(const QSize &size, QImage *pixels = 0)
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    QImage noise(size, QImage::Format_ARGB32);
+    TestUtil::TestingRandomSequence random;
+
+    for (int y = 0; y < size.height(); y++) {
+        QRgb *line = reinterpret_cast<QRgb*>(noise.scanLine(y));
+
+        for (int x = 0; x < size.width(); x++) {
+            line[x] = qRgba(x & 0xff, y & 0xff, random.nextByte(), 255);
+        }
+    }
+
+    KisImageSP image = new KisImage(0, size.width(), size.height(), cs, "pyramid benchmark");
+    KisPaintLayerSP layer = new KisPaintLayer(image, "paint1", OPACITY_OPAQUE_U8);
+    layer->paintDevice()->convertFromQImage(noise, 0);
+    image->addNode(layer);
+
+    image->initialRefreshGraph();
+
+    if (pixels) {
+        *pixels = noise;
+    }
+
+    return image;
+}
+
+QImage downsampleReference(const QImage &src)
+{
+    QImage dst(src.width() / 2, src.height() / 2, QImage::Format_ARGB32);
+
+    for (int y = 0; y < dst.height(); y++) {
+        for (int x = 0; x < dst.width(); x++) {
+            const QRgb p0 = src.pixel(2 * x, 2 * y);
+            const QRgb p1 = src.pixel(2 * x + 1, 2 * y);
+            const QRgb p2 = src.pixel(2 * x, 2 * y + 1);
+            const QRgb p3 = src.pixel(2 * x + 1, 2 * y + 1);
+
+            dst.setPixel(x, y, qRgba((qRed(p0) + qRed(p1) + qRed(p2) + qRed(p3)) / 4,
+                                     (qGreen(p0) + qGreen(p1) + qGreen(p2) + qGreen(p3)) / 4,
+                                     (qBlue(p0) + qBlue(p1) + qBlue(p2) + qBlue(p3)) / 4,
+                                     (qAlpha(p0) + qAlpha(p1) + qAlpha(p2) + qAlpha(p3)) / 4));
+        }
+    }
+
+    return dst;
+}
+
+KisPPUpdateInfoSP createUpdateInfo(const QRect &imageRect, qreal scale)
+{
+    KisPPUpdateInfoSP info = new KisPPUpdateInfo();
+    info->dirtyImageRectVar = imageRect;
+    info->imageRect = imageRect;
+    info->viewportRect = QRectF(QPointF(), QSizeF(imageRect.size()) * scale);
+    info->scaleX = scale;
+    info->scaleY = scale;
+    info->transfer = KisPPUpdateInfo::PATCH;
+    info->renderHints = QPainter::RenderHints();
+    info->borderWidth = 0;
+
+    return info;
+}
+
+void initPyramid(KisImagePyramid &pyramid, KisImageSP image)
+{
+    pyramid.setMonitorProfile(image->colorSpace()->profile(),
+                              KoColorConversionTransformation::internalRenderingIntent(),
+                              KoColorConversionTransformation::internalConversionFlags());
+    pyramid.setImage(image);
+}
+
+}
+
+void KisImagePyramidBenchmark::testDownsampling()
+{
+    QImage pixels;
+    KisImageSP image = createNoiseImage(QSize(1000, 700), &pixels);
+
+    KisImagePyramid pyramid(3);
+    initPyramid(pyramid, image);
+    pyramid.recalculateCache(createUpdateInfo(image->bounds(), 1.0));
+
+    QImage reference = pixels;
+
+    for (int level = 1; level < 3; level++) {
+        const qreal scale = 1.0 / (1 << level);
+        reference = downsampleReference(reference);
+
+        KisPPUpdateInfoSP info = createUpdateInfo(image->bounds(), scale);
+
+        QImage result(reference.size(), QImage::Format_ARGB32);
+        result.fill(0);
+
+        QPainter gc(&result);
+        pyramid.drawFromOriginalImage(gc, info);
+        gc.end();
+
+        QPoint pt;
+        if (!TestUtil::compareQImages(pt, reference, result)) {
+            qDebug() << ppVar(level) << ppVar(pt);
+            QFAIL("The pyramid plane differs from the reference");
+        }
+    }
+}
+
+void KisImagePyramidBenchmark::benchmarkSetImage()
+{
+    KisImageSP image = createNoiseImage(QSize(6000, 4000));
+
+    KisImagePyramid pyramid(1);
+    pyramid.setMonitorProfile(image->colorSpace()->profile(),
+                              KoColorConversionTransformation::internalRenderingIntent(),
+                              KoColorConversionTransformation::internalConversionFlags());
+
+    QBENCHMARK {
+        pyramid.setImage(image);
+    }
+}
+
+void KisImagePyramidBenchmark::benchmarkRecalculateCache()
+{
+    KisImageSP image = createNoiseImage(QSize(6000, 4000));
+
+    KisImagePyramid pyramid(5);
+    initPyramid(pyramid, image);
+
+    KisPPUpdateInfoSP info = createUpdateInfo(image->bounds(), 1.0);
+
+    QBENCHMARK {
+        pyramid.recalculateCache(info);
+    }
+}
+
+KISTEST_MAIN(KisImagePyramidBenchmark)
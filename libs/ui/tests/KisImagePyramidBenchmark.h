@@ -0,0 +1,26 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISIMAGEPYRAMIDBENCHMARK_H
+#define KISIMAGEPYRAMIDBENCHMARK_H
+
+#include <simpletest.h>
+
+/**
+ * Measures rebuilding of the image pyramid used by the QPainter
+ * canvas on a synthetic projection.
+ */
+class KisImagePyramidBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testDownsampling();
+
+    void benchmarkSetImage();
+    void benchmarkRecalculateCache();
+};
+
+#endif // KISIMAGEPYRAMIDBENCHMARK_H
@@ -0,0 +1,376 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisOpenGLUpdateInfoBuilderBenchmark.h"
+
+#include <simpletest.h>
+#include <testui.h>
+#include <testing_benchmark_utils.h>
+
+#include <KoColorModelStandardIds.h>
+#include <KoColorProfile.h>
+#include <KoColorSpaceRegistry.h>
+#include <kis_debug.h>
+#include <kis_paint_device.h>
+#include <kis_pointer_utils.h>
+#include <krita_utils.h>
+
+#include "canvas/kis_update_info.h"
+#include "opengl/KisNullTextureUploadBackend.h"
+#include "opengl/KisOpenGLUpdateInfoBuilder.h"
+#include "opengl/KisTextureTileFastConverter.h"
+#include "opengl/kis_texture_tile_info_pool.h"
+#include "opengl/kis_texture_tile_update_info.h"
+#include "opengl/KisTextureUploadScheduler.h"
+
+namespace {
+
+const QRect projectionBounds(0, 0, 3840, 2160);
+
+/**
+ * Creates a device filled with a noisy gradient, so that neither the
+ * color conversion cache nor the tiles' default pixel would kick in
+ */
+KisPaintDeviceSP createProjection(const KoColorSpace *colorSpace, const QRect &rc)
+{
+    const KoColorSpace *rgb8 = KoColorSpaceRegistry::instance()->rgb8();
+
+    QVector<quint8> data(rc.width() * rc.height() * rgb8->pixelSize());
+    TestUtil::TestingRandomSequence random;
+
+    for (int y = 0; y < rc.height(); y++) {
+        for (int x = 0; x < rc.width(); x++) {
+            quint8 *pixel = data.data() + (y * rc.width() + x) * rgb8->pixelSize();
+
+            const quint32 noise = random.next();
+
+            pixel[0] = quint8(x * 255 / rc.width());
+            pixel[1] = quint8(y * 255 / rc.height());
+            pixel[2] = quint8(noise >> 24);
+            pixel[3] = quint8(128 + ((noise >> 16) & 0x7f));
+        }
+    }
+
+    KisPaintDeviceSP dev = new KisPaintDevice(rgb8);
+    dev->writeBytes(data.constData(), rc);
+    dev->convertTo(colorSpace);
+
+    return dev;
+}
+
+const KoColorSpace* rgbColorSpace(const QString &depthId, const QString &profileName = QString())
+{
+    return KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), depthId, profileName);
+}
+
+/**
+ * Splits the projection into the patches of the size of the texture tiles
+ */
+QVector<QRect> projectionPatches()
+{
+    QVector<QRect> rects;
+
+    for (int y = 0; y < projectionBounds.height(); y += 256) {
+        for (int x = 0; x < projectionBounds.width(); x += 256) {
+            rects << (QRect(x, y, 256, 256) & projectionBounds);
+        }
+    }
+
+    return rects;
+}
+
+}
+
+void KisOpenGLUpdateInfoBuilderBenchmark::testFastConversion_data()
+{
+    QTest::addColumn<QString>("srcDepth");
+    QTest::addColumn<QString>("dstDepth");
+
+    QTest::newRow("u8-u16") << Integer8BitsColorDepthID.id() << Integer16BitsColorDepthID.id();
+    QTest::newRow("u16-u8") << Integer16BitsColorDepthID.id() << Integer8BitsColorDepthID.id();
+    QTest::newRow("u8-f16") << Integer8BitsColorDepthID.id() << Float16BitsColorDepthID.id();
+    QTest::newRow("u16-f16") << Integer16BitsColorDepthID.id() << Float16BitsColorDepthID.id();
+    QTest::newRow("f32-f16") << Float32BitsColorDepthID.id() << Float16BitsColorDepthID.id();
+}
+
+void KisOpenGLUpdateInfoBuilderBenchmark::testFastConversion()
+{
+    QFETCH(QString, srcDepth);
+    QFETCH(QString, dstDepth);
+
+    const KoColorSpace *srcCS = rgbColorSpace(srcDepth);
+    const KoColorSpace *dstCS = rgbColorSpace(dstDepth, srcCS->profile()->name());
+
+    QScopedPointer<KisTextureTileFastConverter> converter(KisTextureTileFastConverter::create(srcCS, dstCS));
+    if (!converter) {
+        QSKIP("The conversion is not supported in this build");
+    }
+
+    const QRect rc(0, 0, 64, 64);
+    const int numPixels = rc.width() * rc.height();
+
+    KisPaintDeviceSP dev = createProjection(srcCS, rc);
+
+    QVector<quint8> src(numPixels * srcCS->pixelSize());
+    dev->readBytes(src.data(), rc);
+
+    QVector<quint8> fast(numPixels * dstCS->pixelSize());
+    QVector<quint8> reference(numPixels * dstCS->pixelSize());
+
+    converter->convert(src.constData(), fast.data(), numPixels);
+    srcCS->convertPixelsTo(src.constData(), reference.data(), dstCS, numPixels,
+                           KoColorConversionTransformation::internalRenderingIntent(),
+                           KoColorConversionTransformation::internalConversionFlags());
+
+    QVector<float> fastChannels(dstCS->channelCount());
+    QVector<float> referenceChannels(dstCS->channelCount());
+
+    for (int i = 0; i < numPixels; i++) {
+        dstCS->normalisedChannelsValue(fast.constData() + i * dstCS->pixelSize(), fastChannels);
+        dstCS->normalisedChannelsValue(reference.constData() + i * dstCS->pixelSize(), referenceChannels);
+
+        for (int ch = 0; ch < int(dstCS->channelCount()); ch++) {
+            if (qAbs(fastChannels[ch] - referenceChannels[ch]) > 1.01f / 255.0f) {
+                qDebug() << ppVar(i) << ppVar(ch) << ppVar(fastChannels[ch]) << ppVar(referenceChannels[ch]);
+                QFAIL("The fast conversion differs from the generic one");
+            }
+        }
+    }
+}
+
+void KisOpenGLUpdateInfoBuilderBenchmark::testDirectConversion_data()
+{
+    QTest::addColumn<QString>("dstDepth");
+    QTest::addColumn<QString>("dstProfile");
+
+    KoColorSpaceRegistry *registry = KoColorSpaceRegistry::instance();
+
+    const QString srgb = registry->rgb8()->profile()->name();
+    const QString rec2020 = registry->p2020G10Profile()->name();
+
+    QTest::newRow("u8-same") << Integer8BitsColorDepthID.id() << srgb;
+    QTest::newRow("u8-wide-gamut") << Integer8BitsColorDepthID.id() << rec2020;
+    QTest::newRow("f16-depth-only") << Float16BitsColorDepthID.id() << srgb;
+    QTest::newRow("f16-hdr") << Float16BitsColorDepthID.id() << rec2020;
+}
+
+void KisOpenGLUpdateInfoBuilderBenchmark::testDirectConversion()
+{
+    QFETCH(QString, dstDepth);
+    QFETCH(QString, dstProfile);
+
+    const KoColorSpace *srcCS = KoColorSpaceRegistry::instance()->rgb8();
+    const KoColorSpace *dstCS = rgbColorSpace(dstDepth, dstProfile);
+    QVERIFY(dstCS);
+
+    const KoColorConversionTransformation::Intent intent = KoColorConversionTransformation::internalRenderingIntent();
+    const KoColorConversionTransformation::ConversionFlags flags = KoColorConversionTransformation::internalConversionFlags();
+
+    QScopedPointer<KisTextureTileFastConverter> fastConverter(KisTextureTileFastConverter::create(srcCS, dstCS));
+
+    KisPaintDeviceSP projection = createProjection(srcCS, QRect(0, 0, 512, 512));
+    KisTextureTileInfoPoolSP pool = toQShared(new KisTextureTileInfoPool(256, 256));
+
+    // the patch is not aligned to the tiles of the device
+    const QRect tileRect(37, 100, 256, 256);
+    const QRect updateRect(50, 110, 200, 230);
+    const QRect imageRect(0, 0, 512, 512);
+
+    KisTextureTileUpdateInfo reference(0, 0, tileRect, updateRect, imageRect, 0, pool);
+    reference.retrieveData(projection, QBitArray(), false, -1, false);
+    reference.convertTo(dstCS, intent, flags, fastConverter.data());
+
+    KisTextureTileUpdateInfo direct(0, 0, tileRect, updateRect, imageRect, 0, pool);
+    direct.retrieveConvertedData(projection, dstCS, intent, flags, fastConverter.data());
+
+    QVERIFY(*direct.patchColorSpace() == *reference.patchColorSpace());
+
+    const int numBytes = direct.realPatchSize().width() * direct.realPatchSize().height() * direct.pixelSize();
+    QVERIFY(memcmp(direct.data(), reference.data(), numBytes) == 0);
+}
+
+void KisOpenGLUpdateInfoBuilderBenchmark::benchmarkBuildUpdateInfo_data()
+{
+    QTest::addColumn<QString>("dstDepth");
+    QTest::addColumn<QString>("dstProfile");
+    QTest::addColumn<QRect>("updateRect");
+    QTest::addColumn<bool>("schedulerThread");
+
+    KoColorSpaceRegistry *registry = KoColorSpaceRegistry::instance();
+
+    const QString srgb = registry->rgb8()->profile()->name();
+    const QString rec2020 = registry->p2020G10Profile()->name();
+
+    const QRect strokeRect(1024, 512, 512, 512);
+
+    QTest::newRow("stroke-u8-same") << Integer8BitsColorDepthID.id() << srgb << strokeRect << false;
+    QTest::newRow("stroke-u8-wide-gamut") << Integer8BitsColorDepthID.id() << rec2020 << strokeRect << false;
+    QTest::newRow("stroke-f16-depth-only") << Float16BitsColorDepthID.id() << srgb << strokeRect << false;
+    QTest::newRow("stroke-f16-hdr") << Float16BitsColorDepthID.id() << rec2020 << strokeRect << false;
+
+    QTest::newRow("scheduler-stroke-u8-same") << Integer8BitsColorDepthID.id() << srgb << strokeRect << true;
+    QTest::newRow("scheduler-stroke-u8-wide-gamut") << Integer8BitsColorDepthID.id() << rec2020 << strokeRect << true;
+    QTest::newRow("scheduler-stroke-f16-depth-only") << Float16BitsColorDepthID.id() << srgb << strokeRect << true;
+    QTest::newRow("scheduler-stroke-f16-hdr") << Float16BitsColorDepthID.id() << rec2020 << strokeRect << true;
+
+    QTest::newRow("full-u8-same") << Integer8BitsColorDepthID.id() << srgb << projectionBounds << false;
+    QTest::newRow("full-u8-wide-gamut") << Integer8BitsColorDepthID.id() << rec2020 << projectionBounds << false;
+    QTest::newRow("full-u16-depth-only") << Integer16BitsColorDepthID.id() << srgb << projectionBounds << false;
+    QTest::newRow("full-f16-depth-only") << Float16BitsColorDepthID.id() << srgb << projectionBounds << false;
+    QTest::newRow("full-f16-hdr") << Float16BitsColorDepthID.id() << rec2020 << projectionBounds << false;
+}
+
+void KisOpenGLUpdateInfoBuilderBenchmark::benchmarkBuildUpdateInfo()
+{
+    QFETCH(QString, dstDepth);
+    QFETCH(QString, dstProfile);
+    QFETCH(QRect, updateRect);
+    QFETCH(bool, schedulerThread);
+
+    const KoColorSpace *srcCS = KoColorSpaceRegistry::instance()->rgb8();
+    const KoColorSpace *dstCS = rgbColorSpace(dstDepth, dstProfile);
+    QVERIFY(dstCS);
+
+    KisPaintDeviceSP projection = createProjection(srcCS, projectionBounds);
+
+    /**
+     * The threads of the update scheduler serialize parallelFor(), only
+     * the updates that need a color transformation are still split
+     * between the threads there
+     */
+    QScopedPointer<KritaUtils::SerialParallelForGuard> schedulerGuard;
+    if (schedulerThread) {
+        schedulerGuard.reset(new KritaUtils::SerialParallelForGuard());
+    }
+
+    // the same configuration KisOpenGLImageTextures uses by default
+    KisOpenGLUpdateInfoBuilder builder;
+    builder.setTextureInfoPool(toQShared(new KisTextureTileInfoPool(256, 256)));
+    builder.setTextureBorder(4);
+    builder.setEffectiveTextureSize(QSize(248, 248));
+    builder.setConversionOptions(
+        ConversionOptions(dstCS,
+                          KoColorConversionTransformation::internalRenderingIntent(),
+                          KoColorConversionTransformation::internalConversionFlags()));
+
+    QBENCHMARK {
+        KisOpenGLUpdateInfoSP info = builder.buildUpdateInfo(updateRect, projection, projectionBounds, 0, true);
+        QVERIFY(!info->tileList.isEmpty());
+    }
+}
+
+void KisOpenGLUpdateInfoBuilderBenchmark::benchmarkRetrieveTiles_data()
+{
+    QTest::addColumn<QString>("dstDepth");
+    QTest::addColumn<QString>("dstProfile");
+    QTest::addColumn<bool>("convertDirectly");
+
+    KoColorSpaceRegistry *registry = KoColorSpaceRegistry::instance();
+
+    const QString srgb = registry->rgb8()->profile()->name();
+    const QString rec2020 = registry->p2020G10Profile()->name();
+
+    QTest::newRow("u8-wide-gamut-copy") << Integer8BitsColorDepthID.id() << rec2020 << false;
+    QTest::newRow("u8-wide-gamut-direct") << Integer8BitsColorDepthID.id() << rec2020 << true;
+    QTest::newRow("f16-depth-only-copy") << Float16BitsColorDepthID.id() << srgb << false;
+    QTest::newRow("f16-depth-only-direct") << Float16BitsColorDepthID.id() << srgb << true;
+}
+
+/**
+ * Compares reading the tiles of the whole 4k projection through the
+ * intermediate buffer and converting them directly from the projection's
+ * memory. Both run in a single thread to measure the memory traffic
+ * rather than the scaling.
+ */
+void KisOpenGLUpdateInfoBuilderBenchmark::benchmarkRetrieveTiles()
+{
+    QFETCH(QString, dstDepth);
+    QFETCH(QString, dstProfile);
+    QFETCH(bool, convertDirectly);
+
+    const KoColorSpace *srcCS = KoColorSpaceRegistry::instance()->rgb8();
+    const KoColorSpace *dstCS = rgbColorSpace(dstDepth, dstProfile);
+    QVERIFY(dstCS);
+
+    const KoColorConversionTransformation::Intent intent = KoColorConversionTransformation::internalRenderingIntent();
+    const KoColorConversionTransformation::ConversionFlags flags = KoColorConversionTransformation::internalConversionFlags();
+
+    QScopedPointer<KisTextureTileFastConverter> fastConverter(KisTextureTileFastConverter::create(srcCS, dstCS));
+
+    KisPaintDeviceSP projection = createProjection(srcCS, projectionBounds);
+    KisTextureTileInfoPoolSP pool = toQShared(new KisTextureTileInfoPool(256, 256));
+
+    const QVector<QRect> tileRects = projectionPatches();
+
+    QBENCHMARK {
+        Q_FOREACH (const QRect &rc, tileRects) {
+            KisTextureTileUpdateInfo tileInfo(0, 0, rc, rc, projectionBounds, 0, pool);
+
+            if (convertDirectly) {
+                tileInfo.retrieveConvertedData(projection, dstCS, intent, flags, fastConverter.data());
+            } else {
+                tileInfo.retrieveData(projection, QBitArray(), false, -1, false);
+                tileInfo.convertTo(dstCS, intent, flags, fastConverter.data());
+            }
+        }
+    }
+}
+
+/**
+ * Measures the intermediate copy of the patches alone, that is,
+ * the part of the work the direct conversion doesn't do
+ */
+void KisOpenGLUpdateInfoBuilderBenchmark::benchmarkReadTiles()
+{
+    const KoColorSpace *srcCS = KoColorSpaceRegistry::instance()->rgb8();
+
+    KisPaintDeviceSP projection = createProjection(srcCS, projectionBounds);
+    KisTextureTileInfoPoolSP pool = toQShared(new KisTextureTileInfoPool(256, 256));
+
+    const QVector<QRect> tileRects = projectionPatches();
+
+    QBENCHMARK {
+        Q_FOREACH (const QRect &rc, tileRects) {
+            KisTextureTileUpdateInfo tileInfo(0, 0, rc, rc, projectionBounds, 0, pool);
+            tileInfo.retrieveData(projection, QBitArray(), false, -1, false);
+        }
+    }
+}
+
+/**
+ * Runs the whole pipeline of a full canvas update: the tiles are
+ * converted on the workers and then passed to the upload scheduler,
+ * which streams them through an emulated ring of pixel buffers
+ */
+void KisOpenGLUpdateInfoBuilderBenchmark::benchmarkUploadPipeline()
+{
+    const KoColorSpace *srcCS = KoColorSpaceRegistry::instance()->rgb8();
+    const KoColorSpace *dstCS = rgbColorSpace(Float16BitsColorDepthID.id(), srcCS->profile()->name());
+    QVERIFY(dstCS);
+
+    KisPaintDeviceSP projection = createProjection(srcCS, projectionBounds);
+
+    KisOpenGLUpdateInfoBuilder builder;
+    builder.setTextureInfoPool(toQShared(new KisTextureTileInfoPool(256, 256)));
+    builder.setTextureBorder(4);
+    builder.setEffectiveTextureSize(QSize(248, 248));
+    builder.setConversionOptions(
+        ConversionOptions(dstCS,
+                          KoColorConversionTransformation::internalRenderingIntent(),
+                          KoColorConversionTransformation::internalConversionFlags()));
+
+    // the same number of buffers KisOpenGLImageTextures starts with
+    KisNullTextureUploadBackend backend(16, 4);
+    backend.setTouchPixelData(true);
+
+    QBENCHMARK {
+        KisOpenGLUpdateInfoSP info = builder.buildUpdateInfo(projectionBounds, projection, projectionBounds, 0, true);
+        KisTextureUploadScheduler::upload(info->tileList, &backend, false);
+        backend.clearUploads();
+    }
+}
+
+KISTEST_MAIN(KisOpenGLUpdateInfoBuilderBenchmark)
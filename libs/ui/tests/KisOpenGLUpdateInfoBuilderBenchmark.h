@@ -0,0 +1,38 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISOPENGLUPDATEINFOBUILDERBENCHMARK_H
+#define KISOPENGLUPDATEINFOBUILDERBENCHMARK_H
+
+#include <simpletest.h>
+
+/**
+ * Measures building of the canvas texture updates on a synthetic
+ * 4k projection. The builder doesn't need any GL context, so the
+ * benchmark can be run headless.
+ */
+class KisOpenGLUpdateInfoBuilderBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testFastConversion_data();
+    void testFastConversion();
+
+    void testDirectConversion_data();
+    void testDirectConversion();
+
+    void benchmarkBuildUpdateInfo_data();
+    void benchmarkBuildUpdateInfo();
+
+    void benchmarkRetrieveTiles_data();
+    void benchmarkRetrieveTiles();
+
+    void benchmarkReadTiles();
+
+    void benchmarkUploadPipeline();
+};
+
+#endif // KISOPENGLUPDATEINFOBUILDERBENCHMARK_H
@@ -0,0 +1,300 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisStrokeReplayBenchmark.h"
+
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+
+#include <algorithm>
+#include <numeric>
+
+#include <KoCanvasResourceProvider.h>
+#include <KoColor.h>
+#include <KoColorSpaceRegistry.h>
+#include <brushengine/kis_paint_information.h>
+#include <brushengine/kis_paintop_preset.h>
+#include <kis_distance_information.h>
+
+#include "kis_image.h"
+#include "kis_paint_layer.h"
+#include "kis_undo_stores.h"
+#include "kis_resources_snapshot.h"
+#include "KisAsynchronousStrokeUpdateHelper.h"
+#include "KisStrokeReplayRecording.h"
+#include "strokes/KisFreehandStrokeInfo.h"
+#include "strokes/freehand_stroke.h"
+
+#include "stroke_testing_utils.h"
+#include <testutil.h>
+#include <testui.h>
+#include <KisGlobalResourcesInterface.h>
+
+
+namespace {
+
+struct ReplayStats
+{
+    QElapsedTimer clock;
+
+    QMutex mutex;
+    QVector<qint64> latencies;
+    QVector<qint64> jobTimes;
+    qint64 numDabs = 0;
+
+    void reset() {
+        latencies.clear();
+        jobTimes.clear();
+        numDabs = 0;
+        clock.start();
+    }
+};
+
+/**
+ * A freehand painting job that knows the moment it has been issued
+ */
+class ReplayData : public FreehandStrokeStrategy::Data
+{
+public:
+    ReplayData(const KisStrokeReplayRecording::Segment &segment)
+        : FreehandStrokeStrategy::Data(0, segment.pi1)
+    {
+        switch (segment.type) {
+        case KisStrokeReplayRecording::Segment::POINT:
+            type = POINT;
+            break;
+        case KisStrokeReplayRecording::Segment::LINE:
+            type = LINE;
+            pi2 = segment.pi2;
+            break;
+        case KisStrokeReplayRecording::Segment::CURVE:
+            type = CURVE;
+            pi2 = segment.pi2;
+            control1 = segment.control1;
+            control2 = segment.control2;
+            break;
+        }
+    }
+
+    qint64 issueTimeNs = 0;
+};
+
+class ReplayStrokeStrategy : public FreehandStrokeStrategy
+{
+public:
+    ReplayStrokeStrategy(KisResourcesSnapshotSP resources,
+                         KisFreehandStrokeInfo *strokeInfo,
+                         ReplayStats *stats)
+        : FreehandStrokeStrategy(resources, strokeInfo, kundo2_noi18n("Replay Stroke")),
+          m_strokeInfo(strokeInfo),
+          m_stats(stats)
+    {
+    }
+
+    void doStrokeCallback(KisStrokeJobData *data) override {
+        ReplayData *replayData = dynamic_cast<ReplayData*>(data);
+        if (!replayData) {
+            FreehandStrokeStrategy::doStrokeCallback(data);
+            return;
+        }
+
+        const qint64 startTime = m_stats->clock.nsecsElapsed();
+        FreehandStrokeStrategy::doStrokeCallback(data);
+        const qint64 endTime = m_stats->clock.nsecsElapsed();
+
+        QMutexLocker l(&m_stats->mutex);
+        m_stats->jobTimes.append(endTime - startTime);
+        m_stats->latencies.append(endTime - replayData->issueTimeNs);
+    }
+
+    void finishStrokeCallback() override {
+        {
+            QMutexLocker l(&m_stats->mutex);
+            m_stats->numDabs += m_strokeInfo->dragDistance->currentDabSeqNo();
+        }
+
+        FreehandStrokeStrategy::finishStrokeCallback();
+    }
+
+private:
+    KisFreehandStrokeInfo *m_strokeInfo;
+    ReplayStats *m_stats;
+};
+
+qreal percentileMs(QVector<qint64> values, qreal percentile)
+{
+    if (values.isEmpty()) return 0.0;
+
+    std::sort(values.begin(), values.end());
+    const int index = qBound(0, qRound(percentile * (values.size() - 1)), values.size() - 1);
+    return values[index] / 1e6;
+}
+
+qreal meanMs(const QVector<qint64> &values)
+{
+    if (values.isEmpty()) return 0.0;
+    return std::accumulate(values.begin(), values.end(), qint64(0)) / 1e6 / values.size();
+}
+
+QString recordingFileName()
+{
+    const QString fileName = qEnvironmentVariable("KRITA_STROKE_REPLAY_FILE");
+    return !fileName.isEmpty() ? fileName : TestUtil::fetchDataFileLazy("stroke_replay_sample.xml");
+}
+
+KisPaintOpPresetSP loadPreset()
+{
+    QString fileName = qEnvironmentVariable("KRITA_STROKE_REPLAY_PRESET", "autobrush_300px.kpp");
+    if (!QFileInfo(fileName).isAbsolute()) {
+        fileName = TestUtil::fetchDataFileLazy(fileName);
+    }
+
+    KisPaintOpPresetSP preset(new KisPaintOpPreset(fileName));
+    if (!preset->load(KisGlobalResourcesInterface::instance())) {
+        qWarning() << "Failed to load preset" << fileName;
+        return KisPaintOpPresetSP();
+    }
+
+    return preset;
+}
+
+QSize canvasSize(const KisStrokeReplayRecording &recording)
+{
+    const QString sizeString = qEnvironmentVariable("KRITA_STROKE_REPLAY_CANVAS");
+    const QStringList parts = sizeString.split('x');
+
+    if (parts.size() == 2) {
+        const QSize size(parts[0].toInt(), parts[1].toInt());
+        if (!size.isEmpty()) return size;
+    }
+
+    const int margin = 200;
+    const QRect bounds = recording.boundingRect().toAlignedRect();
+    return QSize(bounds.right() + margin, bounds.bottom() + margin);
+}
+
+enum ReplayMode {
+    Flood,
+    RealTime
+};
+
+void replayRecording(ReplayMode mode)
+{
+    KisStrokeReplayRecording recording;
+    QVERIFY(recording.load(recordingFileName()));
+    QVERIFY(!recording.isEmpty());
+
+    KisPaintOpPresetSP preset = loadPreset();
+    QVERIFY(preset);
+
+    const QSize imageSize = canvasSize(recording);
+    KisImageSP image = utils::createImage(new KisSurrogateUndoStore(), imageSize);
+
+    const int threadsLimit = qEnvironmentVariableIntValue("KRITA_STROKE_REPLAY_THREADS");
+    if (threadsLimit > 0) {
+        image->setWorkingThreadsLimit(threadsLimit);
+    }
+
+    QScopedPointer<KoCanvasResourceProvider> manager(
+        utils::createResourceManager(image, 0, QString()));
+    manager->setResource(KoCanvasResource::CurrentPaintOpPreset, QVariant::fromValue(preset));
+
+    ReplayStats stats;
+    stats.reset();
+
+    Q_FOREACH (const KisStrokeReplayRecording::Stroke &stroke, recording.strokes()) {
+        if (stroke.isEmpty()) continue;
+
+        KisResourcesSnapshotSP resources =
+            new KisResourcesSnapshot(image,
+                                     image->rootLayer()->firstChild(),
+                                     manager.data());
+
+        KisDistanceInitInfo startDistInfo(stroke.first().pi1.pos(), 0.0, 0);
+        KisFreehandStrokeInfo *strokeInfo = new KisFreehandStrokeInfo(startDistInfo.makeDistInfo());
+
+        KisStrokeId strokeId = image->startStroke(new ReplayStrokeStrategy(resources, strokeInfo, &stats));
+
+        const qint64 strokeStartTime = stats.clock.elapsed();
+
+        Q_FOREACH (const KisStrokeReplayRecording::Segment &segment, stroke) {
+            if (mode == RealTime) {
+                const qint64 waitTime = strokeStartTime + segment.issueTime - stats.clock.elapsed();
+                if (waitTime > 0) {
+                    QThread::msleep(waitTime);
+                }
+            }
+
+            ReplayData *data = new ReplayData(segment);
+            data->issueTimeNs = stats.clock.nsecsElapsed();
+            image->addJob(strokeId, data);
+        }
+
+        image->addJob(strokeId, new KisAsynchronousStrokeUpdateHelper::UpdateData(true));
+        image->endStroke(strokeId);
+    }
+
+    image->waitForDone();
+
+    const qreal totalTimeMs = stats.clock.nsecsElapsed() / 1e6;
+    const qreal renderingTimeMs = std::accumulate(stats.jobTimes.begin(), stats.jobTimes.end(), qint64(0)) / 1e6;
+
+    qDebug() << qPrintable(QString("Replayed %1 jobs, %2 dabs on %3x%4 canvas with preset \"%5\"")
+                           .arg(stats.jobTimes.size())
+                           .arg(stats.numDabs)
+                           .arg(imageSize.width())
+                           .arg(imageSize.height())
+                           .arg(preset->name()));
+
+    qDebug() << qPrintable(QString("Total time: %1 ms, dabs/sec (wall): %2, dabs/sec (rendering): %3")
+                           .arg(totalTimeMs, 0, 'f', 2)
+                           .arg(totalTimeMs > 0 ? stats.numDabs / totalTimeMs * 1000.0 : 0.0, 0, 'f', 1)
+                           .arg(renderingTimeMs > 0 ? stats.numDabs / renderingTimeMs * 1000.0 : 0.0, 0, 'f', 1));
+
+    qDebug() << qPrintable(QString("Latency (ms): p50 %1, p90 %2, p99 %3, max %4")
+                           .arg(percentileMs(stats.latencies, 0.5), 0, 'f', 3)
+                           .arg(percentileMs(stats.latencies, 0.9), 0, 'f', 3)
+                           .arg(percentileMs(stats.latencies, 0.99), 0, 'f', 3)
+                           .arg(percentileMs(stats.latencies, 1.0), 0, 'f', 3));
+
+    qDebug() << qPrintable(QString("Job time (ms): mean %1, p50 %2, p99 %3, max %4")
+                           .arg(meanMs(stats.jobTimes), 0, 'f', 3)
+                           .arg(percentileMs(stats.jobTimes, 0.5), 0, 'f', 3)
+                           .arg(percentileMs(stats.jobTimes, 0.99), 0, 'f', 3)
+                           .arg(percentileMs(stats.jobTimes, 1.0), 0, 'f', 3));
+}
+
+}
+
+void KisStrokeReplayBenchmark::initTestCase()
+{
+    // warm-up memory pools
+    replayRecording(Flood);
+}
+
+void KisStrokeReplayBenchmark::testReplayFlood()
+{
+    /**
+     * All the jobs are issued at once, the result shows the
+     * pure throughput of the brush engine
+     */
+    replayRecording(Flood);
+}
+
+void KisStrokeReplayBenchmark::testReplayRealTime()
+{
+    /**
+     * The jobs are issued with the same rate they were issued
+     * by the tablet during recording, the latency shows how
+     * well the engine keeps up with the real input
+     */
+    replayRecording(RealTime);
+}
+
+KISTEST_MAIN(KisStrokeReplayBenchmark)
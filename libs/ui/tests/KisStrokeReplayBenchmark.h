@@ -0,0 +1,37 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISSTROKEREPLAYBENCHMARK_H
+#define KISSTROKEREPLAYBENCHMARK_H
+
+#include <simpletest.h>
+
+/**
+ * Replays a stroke recording (see KisStrokeReplayRecording) headless
+ * through FreehandStrokeStrategy and reports dabs/sec, job latency
+ * percentiles and per-job rendering times.
+ *
+ * The benchmark is configured with environment variables:
+ *
+ * KRITA_STROKE_REPLAY_FILE     path to the recording (default:
+ *                              data/stroke_replay_sample.xml)
+ * KRITA_STROKE_REPLAY_PRESET   path or test-data name of the preset
+ *                              (default: autobrush_300px.kpp)
+ * KRITA_STROKE_REPLAY_CANVAS   canvas size as WIDTHxHEIGHT (default:
+ *                              bounds of the recording plus a margin)
+ * KRITA_STROKE_REPLAY_THREADS  limit for the number of worker threads
+ */
+class KisStrokeReplayBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+
+    void testReplayFlood();
+    void testReplayRealTime();
+};
+
+#endif // KISSTROKEREPLAYBENCHMARK_H
@@ -0,0 +1,84 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisStrokeReplayRecordingTest.h"
+
+#include <simpletest.h>
+#include <testutil.h>
+
+#include "KisStrokeReplayRecording.h"
+
+
+void KisStrokeReplayRecordingTest::testSaveLoad()
+{
+    KisPaintInformation pi1(QPointF(10.5, 20.25), 0.3, 12.0, -7.0, 0.0, 0.0, 1.0, 15.0, 2.5);
+    KisPaintInformation pi2(QPointF(110.5, 40.0), 0.8, 10.0, -5.0, 0.0, 0.0, 1.0, 20.0, 3.0);
+    KisPaintInformation pi3(QPointF(200.0, 80.0), 1.0, 8.0, -3.0, 0.0, 0.0, 1.0, 25.0, 3.5);
+
+    KisStrokeReplayRecording recording;
+    QVERIFY(recording.isEmpty());
+
+    recording.beginStroke();
+    recording.addPoint(pi1, 3);
+    recording.addLine(pi1, pi2, 7);
+
+    recording.beginStroke();
+    recording.addCurve(pi2, QPointF(150, 50), QPointF(170, 70), pi3, 12);
+
+    QVERIFY(!recording.isEmpty());
+    QCOMPARE(recording.boundingRect().toAlignedRect(), QRect(10, 20, 191, 61));
+
+    const QString fileName = QString(FILES_OUTPUT_DIR) + '/' + "stroke_replay_recording_test.xml";
+    QVERIFY(recording.save(fileName));
+
+    KisStrokeReplayRecording loaded;
+    QVERIFY(loaded.load(fileName));
+
+    const QVector<KisStrokeReplayRecording::Stroke> strokes = loaded.strokes();
+    QCOMPARE(strokes.size(), 2);
+    QCOMPARE(strokes[0].size(), 2);
+    QCOMPARE(strokes[1].size(), 1);
+
+    QCOMPARE(strokes[0][0].type, KisStrokeReplayRecording::Segment::POINT);
+    QCOMPARE(strokes[0][0].issueTime, 3);
+    QCOMPARE(strokes[0][0].pi1.pos(), pi1.pos());
+    QCOMPARE(strokes[0][0].pi1.pressure(), pi1.pressure());
+    QCOMPARE(strokes[0][0].pi1.xTilt(), pi1.xTilt());
+    QCOMPARE(strokes[0][0].pi1.currentTime(), pi1.currentTime());
+
+    QCOMPARE(strokes[0][1].type, KisStrokeReplayRecording::Segment::LINE);
+    QCOMPARE(strokes[0][1].pi2.pos(), pi2.pos());
+    QCOMPARE(strokes[0][1].pi2.yTilt(), pi2.yTilt());
+
+    QCOMPARE(strokes[1][0].type, KisStrokeReplayRecording::Segment::CURVE);
+    QCOMPARE(strokes[1][0].issueTime, 12);
+    QCOMPARE(strokes[1][0].control1, QPointF(150, 50));
+    QCOMPARE(strokes[1][0].control2, QPointF(170, 70));
+    QCOMPARE(strokes[1][0].pi2.pressure(), pi3.pressure());
+}
+
+void KisStrokeReplayRecordingTest::testLoadSample()
+{
+    KisStrokeReplayRecording recording;
+    QVERIFY(recording.load(TestUtil::fetchDataFileLazy("stroke_replay_sample.xml")));
+
+    const QVector<KisStrokeReplayRecording::Stroke> strokes = recording.strokes();
+    QCOMPARE(strokes.size(), 3);
+
+    Q_FOREACH (const KisStrokeReplayRecording::Stroke &stroke, strokes) {
+        QCOMPARE(stroke.size(), 160);
+
+        int prevIssueTime = 0;
+        Q_FOREACH (const KisStrokeReplayRecording::Segment &segment, stroke) {
+            QCOMPARE(segment.type, KisStrokeReplayRecording::Segment::LINE);
+            QVERIFY(segment.issueTime >= prevIssueTime);
+            QVERIFY(segment.pi1.pressure() > 0.0 && segment.pi1.pressure() <= 1.0);
+            prevIssueTime = segment.issueTime;
+        }
+    }
+}
+
+SIMPLE_TEST_MAIN(KisStrokeReplayRecordingTest)
@@ -0,0 +1,20 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISSTROKEREPLAYRECORDINGTEST_H
+#define KISSTROKEREPLAYRECORDINGTEST_H
+
+#include <simpletest.h>
+
+class KisStrokeReplayRecordingTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testSaveLoad();
+    void testLoadSample();
+};
+
+#endif // KISSTROKEREPLAYRECORDINGTEST_H
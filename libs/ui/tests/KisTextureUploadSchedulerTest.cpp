@@ -0,0 +1,113 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisTextureUploadSchedulerTest.h"
+
+#include <simpletest.h>
+#include <testui.h>
+
+#include <KoColor.h>
+#include <KoColorSpaceRegistry.h>
+#include <kis_paint_device.h>
+#include <kis_pointer_utils.h>
+
+#include "opengl/KisNullTextureUploadBackend.h"
+#include "opengl/KisTextureUploadScheduler.h"
+#include "opengl/kis_texture_tile_info_pool.h"
+#include "opengl/kis_texture_tile_update_info.h"
+
+namespace {
+
+/**
+ * Creates \p numTiles tiles of 64x64 pixels arranged in a row
+ */
+KisTextureTileUpdateInfoSPList createTiles(int numTiles)
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    const QRect imageRect(0, 0, 64 * numTiles, 64);
+
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    dev->fill(imageRect, KoColor(Qt::red, cs));
+
+    KisTextureTileInfoPoolSP pool = toQShared(new KisTextureTileInfoPool(64, 64));
+
+    KisTextureTileUpdateInfoSPList tiles;
+
+    for (int i = 0; i < numTiles; i++) {
+        const QRect tileRect(64 * i, 0, 64, 64);
+
+        KisTextureTileUpdateInfoSP tile(new KisTextureTileUpdateInfo(i, 0, tileRect, imageRect, imageRect, 0, pool));
+        tile->retrieveData(dev, QBitArray(), false, -1, false);
+        tiles << tile;
+    }
+
+    return tiles;
+}
+
+}
+
+void KisTextureUploadSchedulerTest::testDirectUpload()
+{
+    KisTextureTileUpdateInfoSPList tiles = createTiles(10);
+
+    KisNullTextureUploadBackend backend;
+
+    QVERIFY(KisTextureUploadScheduler::upload(tiles, &backend, false));
+
+    QCOMPARE(backend.uploads().size(), 10);
+    for (int i = 0; i < 10; i++) {
+        QCOMPARE(backend.uploads()[i].tileCol, i);
+        QCOMPARE(backend.uploads()[i].patchRect, QRect(64 * i, 0, 64, 64));
+        QCOMPARE(backend.uploads()[i].numBytes, 64 * 64 * 4);
+    }
+
+    // without the pixel buffers nothing should be synchronized
+    QCOMPARE(backend.numFences(), 0);
+}
+
+void KisTextureUploadSchedulerTest::testFastDriver()
+{
+    KisTextureTileUpdateInfoSPList tiles = createTiles(100);
+
+    // the driver finishes reading the buffer right after the next upload
+    KisNullTextureUploadBackend backend(4, 1);
+
+    QVERIFY(KisTextureUploadScheduler::upload(tiles, &backend, false));
+
+    QCOMPARE(backend.uploads().size(), 100);
+    QCOMPARE(backend.numPixelBuffers(), 4);
+    QVERIFY(backend.numFences() > 1);
+}
+
+void KisTextureUploadSchedulerTest::testSlowDriver()
+{
+    KisTextureTileUpdateInfoSPList tiles = createTiles(100);
+
+    // the driver never catches up with the uploads
+    KisNullTextureUploadBackend backend(4, -1);
+
+    QVERIFY(KisTextureUploadScheduler::upload(tiles, &backend, false));
+
+    QCOMPARE(backend.uploads().size(), 100);
+
+    // the ring should have grown instead of reusing the buffers in use
+    QVERIFY(backend.numPixelBuffers() >= 64);
+    QCOMPARE(backend.numFences(), 1);
+}
+
+void KisTextureUploadSchedulerTest::testFailedUpload()
+{
+    KisTextureTileUpdateInfoSPList tiles = createTiles(10);
+
+    KisNullTextureUploadBackend backend(4, 1);
+    backend.setFailingUpload(5);
+
+    // the uploading should stop at the failed tile
+    QVERIFY(!KisTextureUploadScheduler::upload(tiles, &backend, false));
+    QCOMPARE(backend.uploads().size(), 5);
+}
+
+KISTEST_MAIN(KisTextureUploadSchedulerTest)
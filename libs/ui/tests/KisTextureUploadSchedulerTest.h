@@ -0,0 +1,22 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KISTEXTUREUPLOADSCHEDULERTEST_H
+#define __KISTEXTUREUPLOADSCHEDULERTEST_H
+
+#include <simpletest.h>
+
+class KisTextureUploadSchedulerTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testDirectUpload();
+    void testFastDriver();
+    void testSlowDriver();
+    void testFailedUpload();
+};
+
+#endif /* __KISTEXTUREUPLOADSCHEDULERTEST_H */
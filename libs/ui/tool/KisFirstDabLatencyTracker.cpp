@@ -0,0 +1,65 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisFirstDabLatencyTracker.h"
+
+#include <QGlobalStatic>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+
+#include "kis_config.h"
+
+
+Q_GLOBAL_STATIC(KisFirstDabLatencyTracker, s_instance)
+
+
+KisFirstDabLatencyTracker::KisFirstDabLatencyTracker()
+    // every stroke gives only one sample, so keep the window small
+    : KisLatencyTracker(50),
+      m_isEnabled(KisConfig(true).trackFirstDabLatency())
+{
+}
+
+KisFirstDabLatencyTracker *KisFirstDabLatencyTracker::instance()
+{
+    return s_instance;
+}
+
+bool KisFirstDabLatencyTracker::isEnabled() const
+{
+    return m_isEnabled;
+}
+
+qint64 KisFirstDabLatencyTracker::timestamp()
+{
+    QElapsedTimer elapsed;
+    elapsed.start();
+    return elapsed.msecsSinceReference();
+}
+
+void KisFirstDabLatencyTracker::push(qint64 timestamp)
+{
+    QMutexLocker l(&m_mutex);
+    m_lastLatency = currentTimestamp() - timestamp;
+    KisLatencyTracker::push(timestamp);
+}
+
+qint64 KisFirstDabLatencyTracker::lastLatency() const
+{
+    QMutexLocker l(&m_mutex);
+    return m_lastLatency;
+}
+
+qint64 KisFirstDabLatencyTracker::currentTimestamp() const
+{
+    return timestamp();
+}
+
+QString KisFirstDabLatencyTracker::format(qint64 mean, qint64 variance, qint64 max)
+{
+    return QString("pen-down to first dab: last %1 ms, mean %2 ms, var %3, max %4 ms")
+        .arg(m_lastLatency).arg(mean).arg(variance).arg(max);
+}
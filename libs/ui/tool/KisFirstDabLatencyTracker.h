@@ -0,0 +1,60 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISFIRSTDABLATENCYTRACKER_H
+#define KISFIRSTDABLATENCYTRACKER_H
+
+#include <QMutex>
+
+#include "kis_latency_tracker.h"
+#include "kritaui_export.h"
+
+/**
+ * Tracks the time between the pen touching the canvas (the moment
+ * a freehand stroke is started) and the moment the first painted
+ * pixels of this stroke are passed to the image for merging.
+ *
+ * The tracker is disabled by default, set "trackFirstDabLatency"
+ * option in kritarc to enable it. The statistics are printed into
+ * the debug output, the same way as for the tablet events latency.
+ */
+class KRITAUI_EXPORT KisFirstDabLatencyTracker : public KisLatencyTracker
+{
+public:
+    KisFirstDabLatencyTracker();
+
+    static KisFirstDabLatencyTracker* instance();
+
+    bool isEnabled() const;
+
+    /**
+     * The timestamp that should be passed to push() when the first
+     * dab has been painted
+     */
+    static qint64 timestamp();
+
+    /**
+     * The push() can be called from any thread
+     */
+    void push(qint64 timestamp) override;
+
+    /**
+     * The latency of the last stroke in milliseconds, -1 if no
+     * stroke has been measured yet
+     */
+    qint64 lastLatency() const;
+
+protected:
+    qint64 currentTimestamp() const override;
+    QString format(qint64 mean, qint64 variance, qint64 max) override;
+
+private:
+    const bool m_isEnabled;
+    mutable QMutex m_mutex;
+    qint64 m_lastLatency = -1;
+};
+
+#endif // KISFIRSTDABLATENCYTRACKER_H
@@ -0,0 +1,304 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisStrokeReplayRecording.h"
+
+#include <QDomDocument>
+#include <QDomElement>
+#include <QFile>
+#include <QDir>
+#include <QDateTime>
+#include <QAtomicInt>
+
+#include <kis_debug.h>
+#include <kis_dom_utils.h>
+
+
+namespace {
+const int CURRENT_VERSION = 1;
+
+QString typeToTag(KisStrokeReplayRecording::Segment::Type type)
+{
+    switch (type) {
+    case KisStrokeReplayRecording::Segment::POINT:
+        return "point";
+    case KisStrokeReplayRecording::Segment::LINE:
+        return "line";
+    case KisStrokeReplayRecording::Segment::CURVE:
+        return "curve";
+    }
+
+    return "point";
+}
+
+bool tagToType(const QString &tag, KisStrokeReplayRecording::Segment::Type *type)
+{
+    if (tag == "point") {
+        *type = KisStrokeReplayRecording::Segment::POINT;
+    } else if (tag == "line") {
+        *type = KisStrokeReplayRecording::Segment::LINE;
+    } else if (tag == "curve") {
+        *type = KisStrokeReplayRecording::Segment::CURVE;
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+void savePaintInfo(QDomDocument &doc, QDomElement &parent, const QString &tag, const KisPaintInformation &pi)
+{
+    QDomElement e = doc.createElement(tag);
+    pi.toXML(doc, e);
+    parent.appendChild(e);
+}
+
+KisPaintInformation loadPaintInfo(const QDomElement &parent, const QString &tag)
+{
+    return KisPaintInformation::fromXML(parent.firstChildElement(tag));
+}
+}
+
+struct KisStrokeReplayRecording::Private
+{
+    QVector<Stroke> strokes;
+};
+
+KisStrokeReplayRecording::KisStrokeReplayRecording()
+    : m_d(new Private)
+{
+}
+
+KisStrokeReplayRecording::KisStrokeReplayRecording(const KisStrokeReplayRecording &rhs)
+    : m_d(new Private(*rhs.m_d))
+{
+}
+
+KisStrokeReplayRecording &KisStrokeReplayRecording::operator=(const KisStrokeReplayRecording &rhs)
+{
+    if (this != &rhs) {
+        *m_d = *rhs.m_d;
+    }
+    return *this;
+}
+
+KisStrokeReplayRecording::~KisStrokeReplayRecording()
+{
+}
+
+void KisStrokeReplayRecording::beginStroke()
+{
+    m_d->strokes.append(Stroke());
+}
+
+void KisStrokeReplayRecording::addPoint(const KisPaintInformation &pi, int issueTime)
+{
+    if (m_d->strokes.isEmpty()) {
+        beginStroke();
+    }
+
+    Segment segment;
+    segment.type = Segment::POINT;
+    segment.pi1 = pi;
+    segment.issueTime = issueTime;
+    m_d->strokes.last().append(segment);
+}
+
+void KisStrokeReplayRecording::addLine(const KisPaintInformation &pi1, const KisPaintInformation &pi2, int issueTime)
+{
+    if (m_d->strokes.isEmpty()) {
+        beginStroke();
+    }
+
+    Segment segment;
+    segment.type = Segment::LINE;
+    segment.pi1 = pi1;
+    segment.pi2 = pi2;
+    segment.issueTime = issueTime;
+    m_d->strokes.last().append(segment);
+}
+
+void KisStrokeReplayRecording::addCurve(const KisPaintInformation &pi1, const QPointF &control1, const QPointF &control2, const KisPaintInformation &pi2, int issueTime)
+{
+    if (m_d->strokes.isEmpty()) {
+        beginStroke();
+    }
+
+    Segment segment;
+    segment.type = Segment::CURVE;
+    segment.pi1 = pi1;
+    segment.pi2 = pi2;
+    segment.control1 = control1;
+    segment.control2 = control2;
+    segment.issueTime = issueTime;
+    m_d->strokes.last().append(segment);
+}
+
+QVector<KisStrokeReplayRecording::Stroke> KisStrokeReplayRecording::strokes() const
+{
+    return m_d->strokes;
+}
+
+bool KisStrokeReplayRecording::isEmpty() const
+{
+    Q_FOREACH (const Stroke &stroke, m_d->strokes) {
+        if (!stroke.isEmpty()) return false;
+    }
+    return true;
+}
+
+void KisStrokeReplayRecording::clear()
+{
+    m_d->strokes.clear();
+}
+
+QRectF KisStrokeReplayRecording::boundingRect() const
+{
+    QRectF rect;
+
+    auto addPoint = [&rect] (const QPointF &pt) {
+        rect |= QRectF(pt, QSizeF(1.0, 1.0));
+    };
+
+    Q_FOREACH (const Stroke &stroke, m_d->strokes) {
+        Q_FOREACH (const Segment &segment, stroke) {
+            addPoint(segment.pi1.pos());
+
+            if (segment.type != Segment::POINT) {
+                addPoint(segment.pi2.pos());
+            }
+
+            if (segment.type == Segment::CURVE) {
+                addPoint(segment.control1);
+                addPoint(segment.control2);
+            }
+        }
+    }
+
+    return rect;
+}
+
+bool KisStrokeReplayRecording::save(const QString &fileName) const
+{
+    QDomDocument doc("strokeReplayRecording");
+    QDomElement root = doc.createElement("strokeReplayRecording");
+    root.setAttribute("version", CURRENT_VERSION);
+    doc.appendChild(root);
+
+    Q_FOREACH (const Stroke &stroke, m_d->strokes) {
+        QDomElement strokeEl = doc.createElement("stroke");
+
+        Q_FOREACH (const Segment &segment, stroke) {
+            QDomElement segmentEl = doc.createElement(typeToTag(segment.type));
+            segmentEl.setAttribute("issueTime", segment.issueTime);
+
+            savePaintInfo(doc, segmentEl, "pi1", segment.pi1);
+
+            if (segment.type != Segment::POINT) {
+                savePaintInfo(doc, segmentEl, "pi2", segment.pi2);
+            }
+
+            if (segment.type == Segment::CURVE) {
+                KisDomUtils::saveValue(&segmentEl, "control1", segment.control1);
+                KisDomUtils::saveValue(&segmentEl, "control2", segment.control2);
+            }
+
+            strokeEl.appendChild(segmentEl);
+        }
+
+        root.appendChild(strokeEl);
+    }
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        warnKrita << "KisStrokeReplayRecording: failed to open" << fileName << "for writing";
+        return false;
+    }
+
+    return file.write(doc.toByteArray(1)) >= 0;
+}
+
+bool KisStrokeReplayRecording::load(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        warnKrita << "KisStrokeReplayRecording: failed to open" << fileName;
+        return false;
+    }
+
+    QDomDocument doc;
+    QString errorMessage;
+    if (!doc.setContent(&file, &errorMessage)) {
+        warnKrita << "KisStrokeReplayRecording: failed to parse" << fileName << errorMessage;
+        return false;
+    }
+
+    QDomElement root = doc.documentElement();
+    if (root.tagName() != "strokeReplayRecording" ||
+        KisDomUtils::toInt(root.attribute("version", "0")) > CURRENT_VERSION) {
+
+        warnKrita << "KisStrokeReplayRecording: unsupported file" << fileName;
+        return false;
+    }
+
+    QVector<Stroke> strokes;
+
+    for (QDomElement strokeEl = root.firstChildElement("stroke");
+         !strokeEl.isNull();
+         strokeEl = strokeEl.nextSiblingElement("stroke")) {
+
+        Stroke stroke;
+
+        for (QDomElement segmentEl = strokeEl.firstChildElement();
+             !segmentEl.isNull();
+             segmentEl = segmentEl.nextSiblingElement()) {
+
+            Segment segment;
+            if (!tagToType(segmentEl.tagName(), &segment.type)) {
+                warnKrita << "KisStrokeReplayRecording: unknown segment type" << segmentEl.tagName();
+                continue;
+            }
+
+            segment.issueTime = KisDomUtils::toInt(segmentEl.attribute("issueTime", "0"));
+            segment.pi1 = loadPaintInfo(segmentEl, "pi1");
+
+            if (segment.type != Segment::POINT) {
+                segment.pi2 = loadPaintInfo(segmentEl, "pi2");
+            }
+
+            if (segment.type == Segment::CURVE) {
+                KisDomUtils::loadValue(segmentEl, "control1", &segment.control1);
+                KisDomUtils::loadValue(segmentEl, "control2", &segment.control2);
+            }
+
+            stroke.append(segment);
+        }
+
+        strokes.append(stroke);
+    }
+
+    m_d->strokes = strokes;
+    return true;
+}
+
+QString KisStrokeReplayRecording::autoRecordingFileName()
+{
+    static const QString recordingDir = qEnvironmentVariable("KRITA_RECORD_FREEHAND_STROKES");
+    if (recordingDir.isEmpty()) return QString();
+
+    static QAtomicInt counter;
+
+    QDir dir(recordingDir);
+    if (!dir.exists() && !dir.mkpath(".")) {
+        warnKrita << "KisStrokeReplayRecording: failed to create directory" << recordingDir;
+        return QString();
+    }
+
+    return dir.absoluteFilePath(
+        QString("stroke_%1_%2.xml")
+            .arg(QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss"))
+            .arg(counter.fetchAndAddOrdered(1), 4, 10, QChar('0')));
+}
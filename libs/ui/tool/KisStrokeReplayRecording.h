@@ -0,0 +1,98 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISSTROKEREPLAYRECORDING_H
+#define KISSTROKEREPLAYRECORDING_H
+
+#include <QPointF>
+#include <QRectF>
+#include <QVector>
+#include <QScopedPointer>
+
+#include <brushengine/kis_paint_information.h>
+#include "kritaui_export.h"
+
+/**
+ * A recording of the painting jobs that KisToolFreehandHelper passes to
+ * FreehandStrokeStrategy. The recording keeps the paint information
+ * (position, pressure, tilt, rotation, time, speed) of every job together
+ * with the moment it was issued, so that the stroke can later be replayed
+ * headless against an arbitrary preset (see KisStrokeReplayBenchmark).
+ *
+ * Recording is enabled in the GUI by setting KRITA_RECORD_FREEHAND_STROKES
+ * environment variable to a directory path. Every finished stroke is saved
+ * into a separate file in that directory.
+ */
+class KRITAUI_EXPORT KisStrokeReplayRecording
+{
+public:
+    struct Segment {
+        enum Type {
+            POINT,
+            LINE,
+            CURVE
+        };
+
+        Type type = POINT;
+        KisPaintInformation pi1;
+        KisPaintInformation pi2;
+        QPointF control1;
+        QPointF control2;
+
+        /**
+         * Time in milliseconds since the beginning of the stroke
+         * when the job was issued by the freehand helper
+         */
+        int issueTime = 0;
+    };
+
+    using Stroke = QVector<Segment>;
+
+public:
+    KisStrokeReplayRecording();
+    KisStrokeReplayRecording(const KisStrokeReplayRecording &rhs);
+    KisStrokeReplayRecording& operator=(const KisStrokeReplayRecording &rhs);
+    ~KisStrokeReplayRecording();
+
+    /**
+     * Starts a new stroke. All the segments added afterwards
+     * belong to this stroke.
+     */
+    void beginStroke();
+
+    void addPoint(const KisPaintInformation &pi, int issueTime);
+    void addLine(const KisPaintInformation &pi1, const KisPaintInformation &pi2, int issueTime);
+    void addCurve(const KisPaintInformation &pi1,
+                  const QPointF &control1,
+                  const QPointF &control2,
+                  const KisPaintInformation &pi2,
+                  int issueTime);
+
+    QVector<Stroke> strokes() const;
+    bool isEmpty() const;
+    void clear();
+
+    /**
+     * Returns the bounding rect of all the recorded positions,
+     * including bezier control points
+     */
+    QRectF boundingRect() const;
+
+    bool save(const QString &fileName) const;
+    bool load(const QString &fileName);
+
+    /**
+     * If KRITA_RECORD_FREEHAND_STROKES is set, returns a new unique file
+     * name in the requested directory, otherwise returns an empty string.
+     */
+    static QString autoRecordingFileName();
+
+private:
+    struct Private;
+    QScopedPointer<Private> m_d;
+};
+
+#endif // KISSTROKEREPLAYRECORDING_H
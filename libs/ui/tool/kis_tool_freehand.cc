@@ -86,7 +86,12 @@ KisToolFreehand::~KisToolFreehand()
 void KisToolFreehand::mouseMoveEvent(KoPointerEvent *event)
 {
     KisToolPaint::mouseMoveEvent(event);
-    m_helper->cursorMoved(convertToPixelCoord(event));
+    const QPointF pixelCoords = convertToPixelCoord(event);
+    m_helper->cursorMoved(pixelCoords);
+
+    if (mode() == KisTool::HOVER_MODE) {
+        m_helper->prewarmStrokeResources(pixelCoords, image(), currentNode());
+    }
 }
 
 KisSmoothingOptionsSP KisToolFreehand::smoothingOptions() const
@@ -14,18 +14,24 @@
 
 #include <KoPointerEvent.h>
 #include <KoCanvasResourceProvider.h>
+#include <KoColor.h>
+#include <KoColorSpace.h>
+#include <KoResourceCacheInterface.h>
 
 #include "kis_algebra_2d.h"
 #include "kis_distance_information.h"
 #include "kis_painting_information_builder.h"
 #include "kis_image.h"
 #include "kis_painter.h"
+#include "kis_resources_snapshot.h"
+#include "kis_paint_device.h"
 #include <brushengine/kis_paintop_preset.h>
 #include <brushengine/kis_paintop_utils.h>
 
 #include "kis_update_time_monitor.h"
 #include "kis_stabilized_events_sampler.h"
 #include "KisStabilizerDelayedPaintHelper.h"
+#include "KisStrokeReplayRecording.h"
 #include "kis_config.h"
 
 #include "kis_random_source.h"
@@ -54,6 +60,9 @@ const qreal SPACING_UPDATE_INTERVAL = 50.0;
 // used when airbrushing.
 const qreal TIMING_UPDATE_INTERVAL = 50.0;
 
+// The maximum size of the dab painted while prewarming the stroke resources on hover.
+const qreal PREWARM_MAX_DAB_SIZE = 32.0;
+
 struct KisToolFreehandHelper::Private
 {
     KoCanvasResourceProvider *resourceManager;
@@ -108,6 +117,20 @@ struct KisToolFreehandHelper::Private
     KisStabilizedEventsSampler stabilizedSampler;
     KisStabilizerDelayedPaintHelper stabilizerDelayedPaintHelper;
 
+    // Recording of the painting jobs for KisStrokeReplayBenchmark,
+    // active only when KRITA_RECORD_FREEHAND_STROKES is set
+    QScopedPointer<KisStrokeReplayRecording> recording;
+    QString recordingFileName;
+
+    // the state the stroke resources have been prewarmed for
+    bool prewarmStrokeResources = true;
+    const KoColorSpace *prewarmedColorSpace = nullptr;
+    const KoColorSpace *prewarmedCompositionColorSpace = nullptr;
+    KoColor prewarmedFgColor;
+    KoColor prewarmedBgColor;
+    KisPaintOpPresetSP prewarmedPreset;
+    KoResourceCacheInterfaceSP prewarmedPresetCache;
+
     qreal effectiveSmoothnessDistance(qreal speed) const;
 };
 
@@ -127,6 +150,8 @@ KisToolFreehandHelper::KisToolFreehandHelper(KisPaintingInformationBuilder *info
     m_d->fakeDabRandomSource = new KisRandomSource();
     m_d->fakeStrokeRandomSource = new KisPerStrokeRandomSource();
 
+    m_d->prewarmStrokeResources = KisConfig(true).prewarmStrokeResources();
+
     m_d->strokeTimeoutTimer.setSingleShot(true);
     connect(&m_d->strokeTimeoutTimer, SIGNAL(timeout()), SLOT(finishStroke()));
     connect(&m_d->airbrushingTimer, SIGNAL(timeout()), SLOT(doAirbrushing()));
@@ -234,6 +259,118 @@ void KisToolFreehandHelper::cursorMoved(const QPointF &cursorPos)
     m_d->lastCursorPos.pushThroughHistory(cursorPos, currentZoom());
 }
 
+void KisToolFreehandHelper::prewarmStrokeResources(const QPointF &pixelCoords, KisImageWSP image, KisNodeSP currentNode)
+{
+    if (!m_d->prewarmStrokeResources || isRunning() || !image || !currentNode) return;
+
+    KisPaintDeviceSP device = currentNode->paintDevice();
+    if (!device) return;
+
+    prewarmColorConversions(device);
+    prewarmPaintOp(pixelCoords, image, currentNode, device);
+}
+
+void KisToolFreehandHelper::prewarmColorConversions(KisPaintDeviceSP device)
+{
+    const KoColor fgColor = m_d->resourceManager->resource(KoCanvasResource::ForegroundColor).value<KoColor>();
+    const KoColor bgColor = m_d->resourceManager->resource(KoCanvasResource::BackgroundColor).value<KoColor>();
+    const KoColorSpace *colorSpace = device->colorSpace();
+    const KoColorSpace *compositionColorSpace = device->compositionSourceColorSpace();
+
+    if (m_d->prewarmedColorSpace == colorSpace &&
+        m_d->prewarmedCompositionColorSpace == compositionColorSpace &&
+        m_d->prewarmedFgColor == fgColor &&
+        m_d->prewarmedBgColor == bgColor) {
+
+        return;
+    }
+
+    /**
+     * The color transformations are created and cached lazily on the
+     * first conversion, which may take a few milliseconds for LCMS-based
+     * color spaces. Make sure this happens before the pen touches the
+     * canvas, not while the first dab is being painted:
+     *
+     * 1) the painter converts the paint colors into the color space
+     *    of the target device
+     *
+     * 2) the indirect painting device (and the dabs) are composited into
+     *    the layer from the composition source color space
+     */
+    Q_FOREACH (const KoColorSpace *cs, QVector<const KoColorSpace*>({colorSpace, compositionColorSpace})) {
+        KoColor color = fgColor;
+        color.convertTo(cs);
+
+        color = bgColor;
+        color.convertTo(cs);
+    }
+
+    if (compositionColorSpace != colorSpace) {
+        KoColor color = KoColor::createTransparent(compositionColorSpace);
+        color.convertTo(colorSpace);
+    }
+
+    m_d->prewarmedColorSpace = colorSpace;
+    m_d->prewarmedCompositionColorSpace = compositionColorSpace;
+    m_d->prewarmedFgColor = fgColor;
+    m_d->prewarmedBgColor = bgColor;
+}
+
+void KisToolFreehandHelper::prewarmPaintOp(const QPointF &pixelCoords, KisImageWSP image, KisNodeSP currentNode, KisPaintDeviceSP device)
+{
+    KisPaintOpPresetSP preset =
+        m_d->resourceManager->resource(KoCanvasResource::CurrentPaintOpPreset).value<KisPaintOpPresetSP>();
+    KoResourceCacheInterfaceSP presetCache =
+        m_d->resourceManager->resource(KoCanvasResource::CurrentPaintOpPresetCache).value<KoResourceCacheInterfaceSP>();
+
+    /**
+     * KisPresetShadowUpdater regenerates the cache of the preset in the
+     * background after every change of the preset, so a new cache object
+     * means that the brush has changed. Until the cache is ready, the
+     * stroke would have to prepare the brush itself anyway.
+     */
+    if (!preset || !presetCache) return;
+    if (m_d->prewarmedPreset == preset && m_d->prewarmedPresetCache == presetCache) return;
+
+    /**
+     * Paint a single dab of the preset into a scratch device the same
+     * way the stroke will do that. The paintop instance and its dab cache
+     * belong to the stroke, but the first dab also creates the state
+     * shared between the strokes: the lazily initialized brush tip caches
+     * linked to the cached brush of the preset, the pattern of the texture
+     * option, the mask processors and the composite ops of the layer's
+     * color space. The dab itself is thrown away.
+     *
+     * This happens in the GUI thread, so the size of the dab is limited.
+     * None of the shared state depends on the size of the brush, so a
+     * small dab warms it up as well as the real one, without stalling the
+     * cursor for big brushes.
+     */
+    KisResourcesSnapshotSP resources = new KisResourcesSnapshot(image, currentNode, m_d->resourceManager);
+
+    // the snapshot owns a copy of the preset, so we can safely resize it
+    KisPaintOpSettingsSP settings = resources->currentPaintOpPreset()->settings();
+    if (settings->paintOpSize() > PREWARM_MAX_DAB_SIZE) {
+        settings->setPaintOpSize(PREWARM_MAX_DAB_SIZE);
+    }
+
+    KisPaintDeviceSP scratchDevice = new KisPaintDevice(device->colorSpace());
+    KisPainter painter(scratchDevice);
+    resources->setupPainter(&painter);
+
+    if (painter.paintOp()) {
+        KisPaintInformation info(pixelCoords);
+        info.setRandomSource(m_d->fakeDabRandomSource);
+        info.setPerStrokeRandomSource(m_d->fakeStrokeRandomSource);
+
+        KisDistanceInformation distance;
+        painter.paintAt(info, &distance);
+    }
+
+    m_d->prewarmedPreset = preset;
+    m_d->prewarmedPresetCache = presetCache;
+}
+
 void KisToolFreehandHelper::initPaint(KoPointerEvent *event,
                                       const QPointF &pixelCoords,
                                       KisImageWSP image, KisNodeSP currentNode,
@@ -310,6 +447,12 @@ void KisToolFreehandHelper::initPaintImpl(qreal startAngle,
 
     m_d->strokeId = m_d->strokesFacade->startStroke(stroke);
 
+    m_d->recordingFileName = KisStrokeReplayRecording::autoRecordingFileName();
+    if (!m_d->recordingFileName.isEmpty()) {
+        m_d->recording.reset(new KisStrokeReplayRecording());
+        m_d->recording->beginStroke();
+    }
+
     m_d->history.clear();
     m_d->distanceHistory.clear();
     m_d->lastDrawnPixel = QPointF(-1.0, -1.0); 
@@ -702,6 +845,11 @@ void KisToolFreehandHelper::endPaint()
     m_d->strokesFacade->endStroke(m_d->strokeId);
     m_d->strokeId.clear();
     m_d->infoBuilder->reset();
+
+    if (m_d->recording) {
+        m_d->recording->save(m_d->recordingFileName);
+        m_d->recording.reset();
+    }
 }
 
 void KisToolFreehandHelper::cancelPaint()
@@ -732,6 +880,8 @@ void KisToolFreehandHelper::cancelPaint()
     m_d->strokesFacade->cancelStroke(m_d->strokeId);
     m_d->strokeId.clear();
 
+    m_d->recording.reset();
+
 }
 
 int KisToolFreehandHelper::elapsedStrokeTime() const
@@ -977,6 +1127,10 @@ void KisToolFreehandHelper::paintAt(int strokeInfoId,
     m_d->strokesFacade->addJob(m_d->strokeId,
                                new FreehandStrokeStrategy::Data(strokeInfoId, pi));
 
+    if (m_d->recording && strokeInfoId == 0) {
+        m_d->recording->addPoint(pi, elapsedStrokeTime());
+    }
+
 }
 
 void KisToolFreehandHelper::paintLine(int strokeInfoId,
@@ -987,6 +1141,10 @@ void KisToolFreehandHelper::paintLine(int strokeInfoId,
     m_d->strokesFacade->addJob(m_d->strokeId,
                                new FreehandStrokeStrategy::Data(strokeInfoId, pi1, pi2));
 
+    if (m_d->recording && strokeInfoId == 0) {
+        m_d->recording->addLine(pi1, pi2, elapsedStrokeTime());
+    }
+
 }
 
 void KisToolFreehandHelper::paintBezierCurve(int strokeInfoId,
@@ -1025,6 +1183,10 @@ void KisToolFreehandHelper::paintBezierCurve(int strokeInfoId,
                                new FreehandStrokeStrategy::Data(strokeInfoId,
                                                                 pi1, control1, control2, pi2));
 
+    if (m_d->recording && strokeInfoId == 0) {
+        m_d->recording->addCurve(pi1, control1, control2, pi2, elapsedStrokeTime());
+    }
+
 }
 
 void KisToolFreehandHelper::createPainters(QVector<KisFreehandStrokeInfo*> &strokeInfos,
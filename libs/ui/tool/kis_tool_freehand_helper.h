@@ -47,6 +47,16 @@ public:
 
     void cursorMoved(const QPointF &cursorPos);
 
+    /**
+     * Prepares the resources that would otherwise be initialized lazily
+     * when the first dab of the stroke is painted (color conversion
+     * transformations, brush tip caches of the current preset). Should
+     * be called while the cursor is hovering over the canvas at
+     * \p pixelCoords, the call is cheap when nothing has changed since
+     * the last call.
+     */
+    void prewarmStrokeResources(const QPointF &pixelCoords, KisImageWSP image, KisNodeSP currentNode);
+
     /**
      * @param event The event
      * @param pixelCoords The position of the KoPointerEvent, in pixel coordinates.
@@ -142,6 +152,9 @@ private:
     qreal currentZoom() const;
     qreal currentPhysicalZoom() const;
 
+    void prewarmColorConversions(KisPaintDeviceSP device);
+    void prewarmPaintOp(const QPointF &pixelCoords, KisImageWSP image, KisNodeSP currentNode, KisPaintDeviceSP device);
+
 private Q_SLOTS:
     void finishStroke();
     void doAirbrushing();
@@ -9,6 +9,7 @@
 #include <QElapsedTimer>
 #include <QThread>
 #include <QApplication>
+#include <QSharedPointer>
 
 #include "kis_canvas_resource_provider.h"
 #include <brushengine/kis_paintop_preset.h>
@@ -23,9 +24,11 @@
 #include <KisRunnableStrokeJobUtils.h>
 #include "FreehandStrokeRunnableJobDataWithUpdate.h"
 #include <mutex>
+#include <atomic>
 
 #include "KisStrokeEfficiencyMeasurer.h"
 #include <KisStrokeSpeedMonitor.h>
+#include <KisFirstDabLatencyTracker.h>
 #include <strokes/KisFreehandStrokeInfo.h>
 #include <strokes/KisMaskedFreehandStrokePainter.h>
 
@@ -41,12 +44,19 @@ struct FreehandStrokeStrategy::Private
         if (needsAsynchronousUpdates) {
             timeSinceLastUpdate.start();
         }
+
+        if (KisFirstDabLatencyTracker::instance()->isEnabled()) {
+            strokeStartTimestamp = KisFirstDabLatencyTracker::timestamp();
+            firstDabReported.reset(new std::atomic<bool>(false));
+        }
     }
 
     Private(const Private &rhs)
         : randomSource(rhs.randomSource),
           resources(rhs.resources),
-          needsAsynchronousUpdates(rhs.needsAsynchronousUpdates)
+          needsAsynchronousUpdates(rhs.needsAsynchronousUpdates),
+          strokeStartTimestamp(rhs.strokeStartTimestamp),
+          firstDabReported(rhs.firstDabReported)
     {
         if (needsAsynchronousUpdates) {
             timeSinceLastUpdate.start();
@@ -64,6 +74,13 @@ struct FreehandStrokeStrategy::Private
 
     const bool needsAsynchronousUpdates = false;
     std::mutex updateEntryMutex;
+
+    /**
+     * The flag is shared between the stroke and its LoD clone, so
+     * only the first of them to show the dab reports the latency
+     */
+    qint64 strokeStartTimestamp = 0;
+    QSharedPointer<std::atomic<bool>> firstDabReported;
 };
 
 FreehandStrokeStrategy::FreehandStrokeStrategy(KisResourcesSnapshotSP resources,
@@ -287,6 +304,12 @@ void FreehandStrokeStrategy::issueSetDirtySignals()
         dirtyRects.append(maskedPainter->takeDirtyRegion());
     }
 
+    if (m_d->firstDabReported && !dirtyRects.isEmpty() &&
+        !m_d->firstDabReported->exchange(true)) {
+
+        KisFirstDabLatencyTracker::instance()->push(m_d->strokeStartTimestamp);
+    }
+
     if (needsMaskingUpdates()) {
 
         // optimize the rects so that they would never intersect with each other!
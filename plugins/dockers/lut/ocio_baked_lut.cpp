@@ -0,0 +1,371 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "ocio_baked_lut.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <QGlobalStatic>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPair>
+
+#include <kis_debug.h>
+
+#include <config-ocio.h>
+
+namespace OCIO = OCIO_NAMESPACE;
+
+namespace {
+
+/**
+ * Every display configuration change creates a new processor, so we
+ * keep only a few last LUTs, e.g. to switch between the views quickly
+ */
+const int maxCachedLuts = 4;
+
+const int alphaTableSize = 1025;
+
+/**
+ * The pixels are checked against the domain of the LUT in chunks,
+ * a chunk with at least one pixel outside is passed to the real
+ * processor as a whole
+ */
+const int chunkSize = 64;
+
+struct BakedLutCache {
+    QMutex mutex;
+    QList<QPair<QString, QSharedPointer<const OcioBakedLut>>> entries;
+
+    /**
+     * Searches for \p key and moves the found entry to the front.
+     * The mutex must be locked by the caller.
+     */
+    bool find(const QString &key, QSharedPointer<const OcioBakedLut> *lut) {
+        for (int i = 0; i < entries.size(); i++) {
+            if (entries[i].first == key) {
+                if (i > 0) {
+                    entries.move(i, 0);
+                }
+                *lut = entries.first().second;
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+Q_GLOBAL_STATIC(BakedLutCache, s_lutCache)
+
+inline bool fuzzyEqual(float a, float b)
+{
+    return std::abs(a - b) <= 1e-4f * std::max(1.0f, std::abs(a));
+}
+
+inline float lerp(float a, float b, float t)
+{
+    return a + (b - a) * t;
+}
+
+bool isDisplayReferred(OCIO::ConstColorSpaceRcPtr colorSpace)
+{
+    if (colorSpace->isData()) return true;
+
+#ifdef HAVE_OCIO_V2
+    return colorSpace->getReferenceSpaceType() == OCIO::REFERENCE_SPACE_DISPLAY;
+#else
+    // OCIO v1 has no display-referred spaces
+    return false;
+#endif
+}
+
+}
+
+OcioBakedLut::OcioBakedLut(const Shaper &shaper)
+    : m_shaper(shaper)
+{
+    const float range = std::max(1e-6f, m_shaper.max - m_shaper.min);
+
+    m_shaperMin = m_shaper.min;
+    m_shaperScale = (latticeSize - 1) / range;
+}
+
+OcioBakedLut::Shaper OcioBakedLut::shaperForColorSpace(OCIO::ConstColorSpaceRcPtr colorSpace)
+{
+    Shaper shaper;
+
+    if (!colorSpace) return shaper;
+
+    const int numVars = colorSpace->getAllocationNumVars();
+    float vars[3] = {0.0f, 0.0f, 0.0f};
+
+    if (numVars > 0) {
+        std::vector<float> allVars(numVars);
+        colorSpace->getAllocationVars(allVars.data());
+        std::copy_n(allVars.begin(), std::min(numVars, 3), vars);
+    }
+
+    if (colorSpace->getAllocation() == OCIO::ALLOCATION_LG2) {
+        shaper.type = Shaper::Log2;
+
+        // the default range of OCIO's log allocation
+        shaper.min = numVars >= 2 ? vars[0] : -10.0f;
+        shaper.max = numVars >= 2 ? vars[1] : 6.0f;
+        shaper.offset = numVars >= 3 ? vars[2] : 0.0f;
+    } else if (numVars >= 2 || isDisplayReferred(colorSpace)) {
+        shaper.type = Shaper::Uniform;
+        shaper.min = numVars >= 2 ? vars[0] : 0.0f;
+        shaper.max = numVars >= 2 ? vars[1] : 1.0f;
+    } else {
+        /**
+         * A scene-referred space without explicit allocation is most
+         * probably linear, so its values go far above 1.0 and need a
+         * lot of precision in the shadows. A uniform lattice over
+         * [0, 1] would pass all the highlights to the slow path and
+         * band the darks, so use the default log range instead. The
+         * offset makes zero a lattice point.
+         */
+        shaper.type = Shaper::Log2;
+        shaper.min = -10.0f;
+        shaper.max = 6.0f;
+        shaper.offset = std::exp2(shaper.min);
+    }
+
+    return shaper;
+}
+
+QSharedPointer<const OcioBakedLut> OcioBakedLut::fetch(const QString &cacheId,
+                                                       const Shaper &shaper,
+                                                       const Processor &processor)
+{
+    const QString key = QString("%1|%2|%3|%4|%5")
+        .arg(cacheId).arg(int(shaper.type))
+        .arg(shaper.min).arg(shaper.max).arg(shaper.offset);
+
+    QSharedPointer<const OcioBakedLut> cachedLut;
+
+    {
+        QMutexLocker l(&s_lutCache->mutex);
+        if (s_lutCache->find(key, &cachedLut)) {
+            return cachedLut;
+        }
+    }
+
+    /**
+     * Baking takes a while, so do it without holding the lock, the
+     * other views should not wait for us to fetch their own LUTs.
+     *
+     * The failed attempts are cached as well, so that we would
+     * not try to bake the same transform again and again
+     */
+    QSharedPointer<OcioBakedLut> lut(new OcioBakedLut(shaper));
+    if (!lut->bake(processor)) {
+        dbgKrita << "OCIO transform cannot be baked into a 3D LUT, using the processor directly";
+        lut.clear();
+    }
+
+    QMutexLocker l(&s_lutCache->mutex);
+
+    // someone could have baked the same LUT while we were baking ours
+    if (s_lutCache->find(key, &cachedLut)) {
+        return cachedLut;
+    }
+
+    auto &entries = s_lutCache->entries;
+    entries.prepend(qMakePair(key, QSharedPointer<const OcioBakedLut>(lut)));
+
+    while (entries.size() > maxCachedLuts) {
+        entries.removeLast();
+    }
+
+    return lut;
+}
+
+float OcioBakedLut::latticeCoordinate(float value) const
+{
+    float coordinate = -1.0f;
+
+    if (m_shaper.type == Shaper::Log2) {
+        const float shifted = value + m_shaper.offset;
+
+        // the values darker than the shaper's range are clamped to its bottom
+        if (shifted >= 0.0f) {
+            coordinate = shifted > 0.0f ?
+                std::max(0.0f, (std::log2(shifted) - m_shaperMin) * m_shaperScale) : 0.0f;
+        }
+    } else {
+        coordinate = (value - m_shaperMin) * m_shaperScale;
+    }
+
+    // the check is written to fail for NaN
+    return coordinate >= 0.0f && coordinate <= latticeSize - 1 ? coordinate : -1.0f;
+}
+
+float OcioBakedLut::valueForLatticePoint(int index) const
+{
+    const float shaped = m_shaperMin + index / m_shaperScale;
+
+    return m_shaper.type == Shaper::Log2 ?
+        std::exp2(shaped) - m_shaper.offset : shaped;
+}
+
+bool OcioBakedLut::bake(const Processor &processor)
+{
+    const int numPoints = latticeSize * latticeSize * latticeSize;
+
+    QVector<float> axis(latticeSize);
+    for (int i = 0; i < latticeSize; i++) {
+        axis[i] = valueForLatticePoint(i);
+    }
+
+    // the red channel changes the fastest
+    QVector<float> pixels(numPoints * 4);
+    float *ptr = pixels.data();
+
+    for (int b = 0; b < latticeSize; b++) {
+        for (int g = 0; g < latticeSize; g++) {
+            for (int r = 0; r < latticeSize; r++) {
+                ptr[0] = axis[r];
+                ptr[1] = axis[g];
+                ptr[2] = axis[b];
+                ptr[3] = 1.0f;
+                ptr += 4;
+            }
+        }
+    }
+
+    processor(pixels.data(), numPoints);
+
+    m_lattice.resize(numPoints * 3);
+    for (int i = 0; i < numPoints; i++) {
+        std::copy_n(pixels.constData() + i * 4, 3, m_lattice.data() + i * 3);
+    }
+
+    m_alphaTable.resize(alphaTableSize);
+    {
+        QVector<float> alphaPixels(alphaTableSize * 4);
+        for (int i = 0; i < alphaTableSize; i++) {
+            std::fill_n(alphaPixels.data() + i * 4, 3, 0.18f);
+            alphaPixels[i * 4 + 3] = float(i) / (alphaTableSize - 1);
+        }
+
+        processor(alphaPixels.data(), alphaTableSize);
+
+        for (int i = 0; i < alphaTableSize; i++) {
+            m_alphaTable[i] = alphaPixels[i * 4 + 3];
+        }
+    }
+
+    /**
+     * The LUT can represent the transform only if its color part
+     * doesn't depend on alpha and the alpha doesn't depend on the
+     * color, which is not the case e.g. for the alpha channel view.
+     * Check that on a subset of the lattice.
+     */
+    const int probeStep = 97;
+    const int halfAlphaIndex = (alphaTableSize - 1) / 2;
+
+    QVector<float> probes;
+    for (int i = 0; i < numPoints; i += probeStep) {
+        const float *src = pixels.constData() + i * 4;
+
+        if (!fuzzyEqual(src[3], m_alphaTable.last())) {
+            return false;
+        }
+
+        const int r = i % latticeSize;
+        const int g = (i / latticeSize) % latticeSize;
+        const int b = i / (latticeSize * latticeSize);
+
+        probes << axis[r] << axis[g] << axis[b] << float(halfAlphaIndex) / (alphaTableSize - 1);
+    }
+
+    const int numProbes = probes.size() / 4;
+    processor(probes.data(), numProbes);
+
+    for (int j = 0; j < numProbes; j++) {
+        const int i = j * probeStep;
+        const float *expected = m_lattice.constData() + i * 3;
+        const float *probe = probes.constData() + j * 4;
+
+        if (!fuzzyEqual(probe[0], expected[0]) ||
+            !fuzzyEqual(probe[1], expected[1]) ||
+            !fuzzyEqual(probe[2], expected[2]) ||
+            !fuzzyEqual(probe[3], m_alphaTable[halfAlphaIndex])) {
+
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void OcioBakedLut::apply(float *pixels, int numPixels, const Processor &processor) const
+{
+    const int stride = latticeSize * 3;
+    const int planeStride = latticeSize * stride;
+    const int maxCell = latticeSize - 2;
+
+    float coordinates[chunkSize * 3];
+
+    for (int chunkStart = 0; chunkStart < numPixels; chunkStart += chunkSize) {
+        const int numChunkPixels = std::min(chunkSize, numPixels - chunkStart);
+        float *chunk = pixels + chunkStart * 4;
+
+        bool insideDomain = true;
+
+        for (int i = 0; i < numChunkPixels && insideDomain; i++) {
+            const float *pixel = chunk + i * 4;
+
+            for (int ch = 0; ch < 3; ch++) {
+                const float coordinate = latticeCoordinate(pixel[ch]);
+                coordinates[i * 3 + ch] = coordinate;
+                insideDomain &= coordinate >= 0.0f;
+            }
+
+            insideDomain &= pixel[3] >= 0.0f && pixel[3] <= 1.0f;
+        }
+
+        if (!insideDomain) {
+            processor(chunk, numChunkPixels);
+            continue;
+        }
+
+        for (int i = 0; i < numChunkPixels; i++) {
+            float *pixel = chunk + i * 4;
+            const float *coordinate = coordinates + i * 3;
+
+            const int r0 = std::min(int(coordinate[0]), maxCell);
+            const int g0 = std::min(int(coordinate[1]), maxCell);
+            const int b0 = std::min(int(coordinate[2]), maxCell);
+
+            const float dr = coordinate[0] - r0;
+            const float dg = coordinate[1] - g0;
+            const float db = coordinate[2] - b0;
+
+            const float *c000 = m_lattice.constData() + b0 * planeStride + g0 * stride + r0 * 3;
+            const float *c010 = c000 + stride;
+            const float *c001 = c000 + planeStride;
+            const float *c011 = c001 + stride;
+
+            for (int ch = 0; ch < 3; ch++) {
+                const float v00 = lerp(c000[ch], c000[ch + 3], dr);
+                const float v10 = lerp(c010[ch], c010[ch + 3], dr);
+                const float v01 = lerp(c001[ch], c001[ch + 3], dr);
+                const float v11 = lerp(c011[ch], c011[ch + 3], dr);
+
+                pixel[ch] = lerp(lerp(v00, v10, dg), lerp(v01, v11, dg), db);
+            }
+
+            const float alphaCoordinate = pixel[3] * (alphaTableSize - 1);
+            const int a0 = std::min(int(alphaCoordinate), alphaTableSize - 2);
+            pixel[3] = lerp(m_alphaTable[a0], m_alphaTable[a0 + 1], alphaCoordinate - a0);
+        }
+    }
+}
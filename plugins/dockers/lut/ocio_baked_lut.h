@@ -0,0 +1,111 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef OCIO_BAKED_LUT_H
+#define OCIO_BAKED_LUT_H
+
+#include <functional>
+
+#include <QSharedPointer>
+#include <QString>
+#include <QVector>
+
+#include <OpenColorIO.h>
+
+/**
+ * A CPU approximation of an OCIO display processor. The color part of
+ * the transform is baked into a 3D LUT, which is preceded by a shaper
+ * built from the allocation of the input color space, the same way as
+ * OCIO v1 baked its GPU LUTs. The alpha channel is baked into a separate
+ * 1D table.
+ *
+ * Applying the LUT costs the same for every transform, so it is much
+ * faster than running the full chain of OCIO ops for every pixel of
+ * the canvas. The pixels the LUT cannot represent (negative, too bright
+ * or not a number) are still passed to the real processor.
+ *
+ * The baked LUTs are cached by the cache id of the processor, so all the
+ * views with the same display settings share the same LUT.
+ */
+class OcioBakedLut
+{
+public:
+    struct Shaper {
+        enum Type {
+            Uniform,
+            Log2
+        };
+
+        Type type = Uniform;
+        float min = 0.0f;
+        float max = 1.0f;
+        float offset = 0.0f;
+    };
+
+    /**
+     * Applies the real transform to \p numPixels RGBA float pixels in place
+     */
+    using Processor = std::function<void(float *pixels, int numPixels)>;
+
+    /**
+     * The number of lattice points along every axis of the 3D LUT
+     */
+    static const int latticeSize = 65;
+
+    /**
+     * Baking costs about the same as filtering latticeSize^3 pixels
+     * directly, so it is not worth doing for a few pixels only,
+     * e.g. for the color selectors.
+     */
+    static const int minPixelsForBaking = 4096;
+
+    /**
+     * Returns the shaper described by the allocation of \p colorSpace.
+     * If the allocation has no variables, the uniform [0, 1] range is
+     * used for display-referred spaces only, the scene-referred ones
+     * get the default log2 range.
+     */
+    static Shaper shaperForColorSpace(OCIO_NAMESPACE::ConstColorSpaceRcPtr colorSpace);
+
+    /**
+     * Returns the cached LUT for \p cacheId, or bakes a new one
+     * from \p processor. Returns null if the transform cannot
+     * be represented by the LUT, e.g. when its color part
+     * depends on the alpha channel. Thread-safe.
+     */
+    static QSharedPointer<const OcioBakedLut> fetch(const QString &cacheId,
+                                                    const Shaper &shaper,
+                                                    const Processor &processor);
+
+    /**
+     * Transforms \p numPixels RGBA float pixels in place. The pixels
+     * outside the domain of the LUT are passed to \p processor.
+     * Thread-safe.
+     */
+    void apply(float *pixels, int numPixels, const Processor &processor) const;
+
+private:
+    OcioBakedLut(const Shaper &shaper);
+
+    bool bake(const Processor &processor);
+
+    /**
+     * Returns the position of \p value in the lattice, or a negative
+     * value if it is outside the domain of the LUT
+     */
+    float latticeCoordinate(float value) const;
+    float valueForLatticePoint(int index) const;
+
+private:
+    Shaper m_shaper;
+    float m_shaperMin = 0.0f;
+    float m_shaperScale = 1.0f;
+
+    QVector<float> m_lattice;
+    QVector<float> m_alphaTable;
+};
+
+#endif // OCIO_BAKED_LUT_H
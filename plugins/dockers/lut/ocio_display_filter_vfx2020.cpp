@@ -55,6 +55,21 @@ void OcioDisplayFilter::filter(quint8 *pixels, quint32 numPixels)
 {
     // processes that data _in_ place
     if (m_processor) {
+        if (numPixels >= OcioBakedLut::minPixelsForBaking) {
+            OcioBakedLut::Processor processor = [this] (float *rgba, int numPixels) {
+                OCIO::PackedImageDesc img(rgba, numPixels, 1, 4);
+                m_processor->apply(img);
+            };
+
+            QSharedPointer<const OcioBakedLut> lut =
+                OcioBakedLut::fetch(m_bakedLutCacheId, m_bakedLutShaper, processor);
+
+            if (lut) {
+                lut->apply(reinterpret_cast<float*>(pixels), numPixels, processor);
+                return;
+            }
+        }
+
         OCIO::PackedImageDesc img(reinterpret_cast<float*>(pixels), numPixels, 1, 4);
         m_processor->apply(img);
     }
@@ -260,6 +275,9 @@ void OcioDisplayFilter::updateProcessor()
         //m_reverseApproximationProcessor;
     }
 
+    m_bakedLutCacheId = QString::fromLatin1(m_processor->getCpuCacheID());
+    m_bakedLutShaper = OcioBakedLut::shaperForColorSpace(config->getColorSpace(inputColorSpaceName));
+
     m_shaderDirty = true;
 }
 
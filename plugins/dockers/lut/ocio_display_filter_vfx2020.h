@@ -16,6 +16,8 @@
 #include <kis_display_filter.h>
 #include <kis_exposure_gamma_correction_interface.h>
 
+#include "ocio_baked_lut.h"
+
 namespace OCIO = OCIO_NAMESPACE;
 
 enum OCIO_CHANNEL_SWIZZLE {
@@ -82,6 +84,9 @@ private:
     QString m_lut3dcacheid;
     QString m_shadercacheid;
 
+    QString m_bakedLutCacheId;
+    OcioBakedLut::Shaper m_bakedLutShaper;
+
     bool m_shaderDirty {true};
 };
 
@@ -19,6 +19,8 @@
 #include <kis_display_filter.h>
 #include <kis_exposure_gamma_correction_interface.h>
 
+#include "ocio_baked_lut.h"
+
 namespace OCIO = OCIO_NAMESPACE;
 
 enum OCIO_CHANNEL_SWIZZLE { LUMINANCE, RGBA, R, G, B, A };
@@ -112,6 +114,9 @@ private:
     QString m_shadercacheid;
     std::vector<KisTextureUniform> m_lut3dUniforms;
 
+    QString m_bakedLutCacheId;
+    OcioBakedLut::Shaper m_bakedLutShaper;
+
     bool m_shaderDirty;
 };
 
@@ -9,6 +9,7 @@
 #include <simpletest.h>
 #include <stroke_testing_utils.h>
 #include <testutil.h>
+#include <testing_benchmark_utils.h>
 
 #include <QFile>
 
@@ -107,4 +108,85 @@ void KisOcioDisplayFilterTest::test()
 
 }
 
+void KisOcioDisplayFilterTest::testBakedLut()
+{
+    KisExposureGammaCorrectionInterface *egInterface =
+            new KisDumbExposureGammaCorrectionInterface();
+
+    QSharedPointer<OcioDisplayFilter> filter(new OcioDisplayFilter(egInterface));
+
+    QString configFile = TestUtil::fetchDataFileLazy("./psyfiTestingConfig-master/config.ocio");
+    Q_ASSERT(QFile::exists(configFile));
+
+    OCIO::ConstConfigRcPtr ocioConfig =
+            OCIO::Config::CreateFromFile(configFile.toUtf8());
+
+    filter->config = ocioConfig;
+    filter->inputColorSpaceName = ocioConfig->getColorSpaceNameByIndex(0);
+    filter->displayDevice = ocioConfig->getDisplay(0);
+    filter->view = ocioConfig->getView(filter->displayDevice, 0);
+    filter->gamma = 1.0;
+    filter->exposure = 0.5;
+    filter->swizzle = RGBA;
+
+    filter->blackPoint = 0.0;
+    filter->whitePoint = 1.0;
+
+    filter->forceInternalColorManagement = false;
+    filter->setLockCurrentColorVisualRepresentation(false);
+
+    filter->updateProcessor();
+
+    // some pixels are out of the range of the LUT to check the fallback
+    const int numPixels = OcioBakedLut::minPixelsForBaking * 4;
+    QVector<float> pixels(numPixels * 4);
+
+    TestUtil::TestingRandomSequence random;
+    for (int i = 0; i < numPixels * 4; i++) {
+        const float value = float(random.next() >> 8) / float(1 << 24);
+
+        pixels[i] = (i % 4 == 3) ? value : value * 1.2f;
+    }
+    pixels[numPixels * 2] = -0.1f;
+    pixels[numPixels * 3] = 1000.0f;
+
+    QVector<float> reference = pixels;
+
+    // the filter uses the processor directly for small batches of pixels
+    for (int i = 0; i < numPixels; i++) {
+        filter->filter(reinterpret_cast<quint8*>(reference.data() + i * 4), 1);
+    }
+
+    filter->filter(reinterpret_cast<quint8*>(pixels.data()), numPixels);
+
+    for (int i = 0; i < numPixels * 4; i++) {
+        if (qAbs(pixels[i] - reference[i]) > 0.01f) {
+            qDebug() << ppVar(i) << ppVar(pixels[i]) << ppVar(reference[i]);
+            QFAIL("The baked LUT differs from the OCIO processor");
+        }
+    }
+}
+
+void KisOcioDisplayFilterTest::testBakedLutShaper()
+{
+    // a scene-linear space without allocation vars needs a log shaper
+    OCIO::ColorSpaceRcPtr linear = OCIO::ColorSpace::Create();
+    linear->setAllocation(OCIO::ALLOCATION_UNIFORM);
+    QCOMPARE(OcioBakedLut::shaperForColorSpace(linear).type, OcioBakedLut::Shaper::Log2);
+
+    // the explicit allocation is always respected
+    OCIO::ColorSpaceRcPtr allocated = OCIO::ColorSpace::Create();
+    const float vars[2] = {0.0f, 2.0f};
+    allocated->setAllocationVars(2, vars);
+
+    OcioBakedLut::Shaper shaper = OcioBakedLut::shaperForColorSpace(allocated);
+    QCOMPARE(shaper.type, OcioBakedLut::Shaper::Uniform);
+    QCOMPARE(shaper.max, 2.0f);
+
+#ifdef HAVE_OCIO_V2
+    OCIO::ColorSpaceRcPtr display = OCIO::ColorSpace::Create(OCIO::REFERENCE_SPACE_DISPLAY);
+    QCOMPARE(OcioBakedLut::shaperForColorSpace(display).type, OcioBakedLut::Shaper::Uniform);
+#endif
+}
+
 SIMPLE_TEST_MAIN(KisOcioDisplayFilterTest)
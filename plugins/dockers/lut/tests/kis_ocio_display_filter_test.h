@@ -14,6 +14,8 @@ class KisOcioDisplayFilterTest : public QObject
     Q_OBJECT
 private Q_SLOTS:
     void test();
+    void testBakedLut();
+    void testBakedLutShaper();
 };
 
 #endif /* __KIS_OCIO_DISPLAY_FILTER_TEST_H */
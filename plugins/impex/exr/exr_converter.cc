@@ -24,6 +24,8 @@
 #include <QDomDocument>
 #include <QThread>
 
+#include <cstddef>
+
 
 #include <KoColorSpaceRegistry.h>
 #include <KoCompositeOpRegistry.h>
@@ -40,6 +42,7 @@
 #include <kis_transaction.h>
 #include "kis_iterator_ng.h"
 #include <kis_exr_layers_sorter.h>
+#include <krita_utils.h>
 
 #include <kis_meta_data_entry.h>
 #include <kis_meta_data_schema.h>
@@ -123,6 +126,23 @@ struct ExrPaintLayerSaveInfo {
     Imf::PixelType pixelType;
 };
 
+namespace {
+
+/**
+ * The pixels are read and written in bands of this height. It is a
+ * multiple of the tile height, and it covers 16 line blocks of ZIP
+ * compression, which is enough to keep OpenEXR's threads busy, while
+ * only one band of every layer is kept in memory.
+ */
+const int bandHeight = 256;
+
+/**
+ * The number of rows converted by a single job
+ */
+const int rowsPerJob = 16;
+
+}
+
 struct EXRConverter::Private {
     Private()
         : doc(0)
@@ -138,16 +158,6 @@ struct EXRConverter::Private {
 
     QString errorMessage;
 
-    template <class WrapperType>
-    void unmultiplyAlpha(typename WrapperType::pixel_type *pixel);
-
-    template<typename _T_>
-    void decodeData4(Imf::InputFile& file, ExrPaintLayerInfo& info, KisPaintLayerSP layer, int width, int xstart, int ystart, int height, Imf::PixelType ptype);
-
-    template<typename _T_>
-    void decodeData1(Imf::InputFile& file, ExrPaintLayerInfo& info, KisPaintLayerSP layer, int width, int xstart, int ystart, int height, Imf::PixelType ptype);
-
-
     QDomDocument loadExtraLayersInfo(const Imf::Header &header);
     bool checkExtraLayersInfoConsistent(const QDomDocument &doc, std::set<std::string> exrLayerNames);
     void makeLayerNamesUnique(QList<ExrPaintLayerSaveInfo>& informationObjects);
@@ -305,12 +315,17 @@ struct GrayPixelWrapper
     pixel_type &pixel;
 };
 
+/**
+ * \return true if the alpha of the pixel had to be modified
+ */
 template <class WrapperType>
-void EXRConverter::Private::unmultiplyAlpha(typename WrapperType::pixel_type *pixel)
+bool unmultiplyAlpha(typename WrapperType::pixel_type *pixel)
 {
     typedef typename WrapperType::pixel_type pixel_type;
     typedef typename WrapperType::channel_type channel_type;
 
+    bool alphaWasModified = false;
+
     WrapperType srcPixel(*pixel);
 
     if (!srcPixel.checkMultipliedColorsConsistent()) {
@@ -341,6 +356,8 @@ void EXRConverter::Private::unmultiplyAlpha(typename WrapperType::pixel_type *pi
     } else if (srcPixel.alpha() > 0.0) {
         srcPixel.setUnmultiplied(srcPixel.pixel, srcPixel.alpha());
     }
+
+    return alphaWasModified;
 }
 
 template <typename T, typename Pixel, int size, int alphaPos>
@@ -365,112 +382,191 @@ void multiplyAlpha(Pixel *pixel)
     }
 }
 
-template<typename _T_>
-void EXRConverter::Private::decodeData4(Imf::InputFile& file, ExrPaintLayerInfo& info, KisPaintLayerSP layer, int width, int xstart, int ystart, int height, Imf::PixelType ptype)
+/**
+ * Decodes a single EXR layer into a paint device band by band. The
+ * layout of the band buffer is the same as the one of the device, so
+ * OpenEXR writes (and converts, if needed) the channels right into it,
+ * and after unmultiplying the alpha the band is written into the tiles
+ * of the device as a whole.
+ */
+class Decoder
 {
-    typedef Rgba<_T_> Rgba;
+public:
+    virtual ~Decoder() {}
+
+    /**
+     * Adds the slices of the band starting at \p ystart to \p frameBuffer
+     */
+    virtual void prepareFrameBuffer(Imf::FrameBuffer *frameBuffer, int ystart) = 0;
+
+    /**
+     * Postprocesses \p numRows rows of the band starting at \p firstRow.
+     * Can be called concurrently for different rows.
+     *
+     * \return true if alpha of some pixels had to be modified
+     */
+    virtual bool decodeRows(int firstRow, int numRows) = 0;
+
+    /**
+     * Writes the first \p numRows rows of the band into the device
+     */
+    virtual void writeBand(int ystart, int numRows) = 0;
+};
 
-    QVector<Rgba> pixels(width * height);
-
-    bool hasAlpha = info.channelMap.contains("A");
-
-    Imf::FrameBuffer frameBuffer;
-    Rgba* frameBufferData = (pixels.data()) - xstart - ystart * width;
-    frameBuffer.insert(info.channelMap["R"].toLatin1().constData(),
-            Imf::Slice(ptype, (char *) &frameBufferData->r,
-                       sizeof(Rgba) * 1,
-                       sizeof(Rgba) * width));
-    frameBuffer.insert(info.channelMap["G"].toLatin1().constData(),
-            Imf::Slice(ptype, (char *) &frameBufferData->g,
-                       sizeof(Rgba) * 1,
-                       sizeof(Rgba) * width));
-    frameBuffer.insert(info.channelMap["B"].toLatin1().constData(),
-            Imf::Slice(ptype, (char *) &frameBufferData->b,
-                       sizeof(Rgba) * 1,
-                       sizeof(Rgba) * width));
-    if (hasAlpha) {
-        frameBuffer.insert(info.channelMap["A"].toLatin1().constData(),
-                Imf::Slice(ptype, (char *) &frameBufferData->a,
-                           sizeof(Rgba) * 1,
-                           sizeof(Rgba) * width));
+template <class WrapperType>
+class DecoderImpl : public Decoder
+{
+public:
+    typedef typename WrapperType::pixel_type pixel_type;
+    typedef typename WrapperType::channel_type channel_type;
+
+    /**
+     * \p channels is a list of pairs of EXR channel names and offsets
+     * of the corresponding channels in the pixel
+     */
+    DecoderImpl(KisPaintDeviceSP device, const QVector<QPair<QString, int>> &channels, int alphaOffset, bool hasAlpha, Imf::PixelType pixelType, int width, int xstart)
+        : m_device(device),
+          m_channels(channels),
+          m_alphaOffset(alphaOffset),
+          m_hasAlpha(hasAlpha),
+          m_pixelType(pixelType),
+          m_width(width),
+          m_xstart(xstart),
+          m_pixels(width * bandHeight)
+    {
     }
 
-    file.setFrameBuffer(frameBuffer);
-    file.readPixels(ystart, height + ystart - 1);
-    Rgba *rgba = pixels.data();
+    void prepareFrameBuffer(Imf::FrameBuffer *frameBuffer, int ystart) override
+    {
+        char *frameBufferData = reinterpret_cast<char*>(m_pixels.data() - m_xstart - ystart * m_width);
 
-    QRect paintRegion(xstart, ystart, width, height);
-    KisSequentialIterator it(layer->paintDevice(), paintRegion);
-    while (it.nextPixel()) {
-        if (hasAlpha) {
-            unmultiplyAlpha<RgbPixelWrapper<_T_> >(rgba);
+        for (auto it = m_channels.constBegin(); it != m_channels.constEnd(); ++it) {
+            frameBuffer->insert(it->first.toLatin1().constData(),
+                                Imf::Slice(m_pixelType, frameBufferData + it->second,
+                                           sizeof(pixel_type) * 1,
+                                           sizeof(pixel_type) * m_width));
         }
+    }
 
-        typename KoRgbTraits<_T_>::Pixel* dst = reinterpret_cast<typename KoRgbTraits<_T_>::Pixel*>(it.rawData());
+    bool decodeRows(int firstRow, int numRows) override
+    {
+        bool alphaWasModified = false;
 
-        dst->red = rgba->r;
-        dst->green = rgba->g;
-        dst->blue = rgba->b;
-        if (hasAlpha) {
-            dst->alpha = rgba->a;
-        } else {
-            dst->alpha = 1.0;
+        pixel_type *pixel = m_pixels.data() + firstRow * m_width;
+        pixel_type *end = pixel + numRows * m_width;
+
+        for (; pixel < end; ++pixel) {
+            if (m_hasAlpha) {
+                alphaWasModified |= unmultiplyAlpha<WrapperType>(pixel);
+            } else {
+                *reinterpret_cast<channel_type*>(reinterpret_cast<char*>(pixel) + m_alphaOffset) = channel_type(1.0);
+            }
         }
 
-        ++rgba;
+        return alphaWasModified;
+    }
+
+    void writeBand(int ystart, int numRows) override
+    {
+        m_device->writeBytes(reinterpret_cast<const quint8*>(m_pixels.constData()), QRect(m_xstart, ystart, m_width, numRows));
+    }
+
+private:
+    KisPaintDeviceSP m_device;
+    QVector<QPair<QString, int>> m_channels;
+    int m_alphaOffset;
+    bool m_hasAlpha;
+    Imf::PixelType m_pixelType;
+    int m_width;
+    int m_xstart;
+    QVector<pixel_type> m_pixels;
+};
+
+template<typename _T_>
+Decoder* decoder4(const ExrPaintLayerInfo &info, KisPaintLayerSP layer, int width, int xstart, Imf::PixelType ptype)
+{
+    typedef Rgba<_T_> Rgba;
+
+    /**
+     * The layout of Rgba is the same as the one of KoRgbTraits<_T_>::Pixel
+     * (and KoXyzTraits<_T_>::Pixel), so the data is decoded in place
+     */
+    QVector<QPair<QString, int>> channels;
+    channels << qMakePair(info.channelMap["R"], int(offsetof(Rgba, r)));
+    channels << qMakePair(info.channelMap["G"], int(offsetof(Rgba, g)));
+    channels << qMakePair(info.channelMap["B"], int(offsetof(Rgba, b)));
+
+    const bool hasAlpha = info.channelMap.contains("A");
+    if (hasAlpha) {
+        channels << qMakePair(info.channelMap["A"], int(offsetof(Rgba, a)));
     }
+
+    return new DecoderImpl<RgbPixelWrapper<_T_>>(layer->paintDevice(), channels, offsetof(Rgba, a), hasAlpha, ptype, width, xstart);
 }
 
 template<typename _T_>
-void EXRConverter::Private::decodeData1(Imf::InputFile& file, ExrPaintLayerInfo& info, KisPaintLayerSP layer, int width, int xstart, int ystart, int height, Imf::PixelType ptype)
+Decoder* decoder1(const ExrPaintLayerInfo &info, KisPaintLayerSP layer, int width, int xstart, Imf::PixelType ptype)
 {
-    typedef typename GrayPixelWrapper<_T_>::channel_type channel_type;
     typedef typename GrayPixelWrapper<_T_>::pixel_type pixel_type;
 
-    KIS_ASSERT_RECOVER_RETURN(
-                layer->paintDevice()->colorSpace()->colorModelId() == GrayAColorModelID);
-
-    QVector<pixel_type> pixels(width * height);
+    KIS_ASSERT_RECOVER_RETURN_VALUE(
+                layer->paintDevice()->colorSpace()->colorModelId() == GrayAColorModelID, 0);
 
     Q_ASSERT(info.channelMap.contains("Y"));
     dbgFile << "Gray -> " << info.channelMap["Y"];
 
-    bool hasAlpha = info.channelMap.contains("A");
+    const bool hasAlpha = info.channelMap.contains("A");
     dbgFile << "Has Alpha:" << hasAlpha;
 
-
-    Imf::FrameBuffer frameBuffer;
-    pixel_type* frameBufferData = (pixels.data()) - xstart - ystart * width;
-    frameBuffer.insert(
-        info.channelMap["Y"].toLatin1().constData(),
-        Imf::Slice(ptype, (char *)&frameBufferData->gray, sizeof(pixel_type) * 1, sizeof(pixel_type) * width));
+    QVector<QPair<QString, int>> channels;
+    channels << qMakePair(info.channelMap["Y"], int(offsetof(pixel_type, gray)));
 
     if (hasAlpha) {
-        frameBuffer.insert(info.channelMap["A"].toLatin1().constData(),
-                Imf::Slice(ptype, (char *) &frameBufferData->alpha,
-                           sizeof(pixel_type) * 1,
-                           sizeof(pixel_type) * width));
+        channels << qMakePair(info.channelMap["A"], int(offsetof(pixel_type, alpha)));
     }
 
-    file.setFrameBuffer(frameBuffer);
-    file.readPixels(ystart, height + ystart - 1);
+    return new DecoderImpl<GrayPixelWrapper<_T_>>(layer->paintDevice(), channels, offsetof(pixel_type, alpha), hasAlpha, ptype, width, xstart);
+}
+
+/**
+ * Reads all the layers together, band by band. Every line block of
+ * the file is decompressed only once (in OpenEXR's thread pool), then
+ * the bands of all the layers are postprocessed concurrently.
+ *
+ * \return true if alpha of some pixels had to be modified
+ */
+bool decodeData(Imf::InputFile &file, const QVector<Decoder*> &decoders, int ystart, int height)
+{
+    QAtomicInt alphaWasModified(0);
 
-    pixel_type *srcPtr = pixels.data();
+    for (int y = ystart; y < ystart + height; y += bandHeight) {
+        const int numRows = qMin(bandHeight, ystart + height - y);
 
-    QRect paintRegion(xstart, ystart, width, height);
-    KisSequentialIterator it(layer->paintDevice(), paintRegion);
-    while (it.nextPixel()) {
-        if (hasAlpha) {
-            unmultiplyAlpha<GrayPixelWrapper<_T_> >(srcPtr);
+        Imf::FrameBuffer frameBuffer;
+        Q_FOREACH (Decoder *decoder, decoders) {
+            decoder->prepareFrameBuffer(&frameBuffer, y);
         }
 
-        pixel_type* dstPtr = reinterpret_cast<pixel_type*>(it.rawData());
+        file.setFrameBuffer(frameBuffer);
+        file.readPixels(y, y + numRows - 1);
+
+        const int jobsPerDecoder = (numRows + rowsPerJob - 1) / rowsPerJob;
+
+        KritaUtils::parallelFor(decoders.size() * jobsPerDecoder, [&] (int job) {
+            Decoder *decoder = decoders[job / jobsPerDecoder];
+            const int firstRow = (job % jobsPerDecoder) * rowsPerJob;
 
-        dstPtr->gray = srcPtr->gray;
-        dstPtr->alpha = hasAlpha ? srcPtr->alpha : channel_type(1.0);
+            if (decoder->decodeRows(firstRow, qMin(rowsPerJob, numRows - firstRow))) {
+                alphaWasModified.storeRelaxed(1);
+            }
+        });
+
+        KritaUtils::parallelFor(decoders.size(), [&] (int i) {
+            decoders[i]->writeBand(y, numRows);
+        });
+    }
 
-        ++srcPtr;
-    } ;
+    return alphaWasModified.loadRelaxed();
 }
 
 bool recCheckGroup(const ExrGroupLayerInfo& group, QStringList list, int idx1, int idx2)
@@ -838,7 +934,11 @@ KisImportExportErrorCode EXRConverter::decode(const QString &filename)
             d->image->addNode(info.groupLayer, groupLayerParent);
         }
 
-        // Load the layers
+        // Create the layers
+        QVector<KisPaintLayerSP> layers;
+        QVector<const ExrPaintLayerInfo*> layersInfo;
+        QVector<Decoder*> decoders;
+
         for (int i = informationObjects.size() - 1; i >= 0; --i) {
             ExrPaintLayerInfo& info = informationObjects[i];
             if (info.colorSpace) {
@@ -846,21 +946,23 @@ KisImportExportErrorCode EXRConverter::decode(const QString &filename)
                 KisPaintLayerSP layer = new KisPaintLayer(d->image, info.name, OPACITY_OPAQUE_U8, info.colorSpace);
 
                 if (!layer) {
+                    qDeleteAll(decoders);
                     return ImportExportCodes::Failure;
                 }
 
                 layer->setCompositeOpId(COMPOSITE_OVER);
 
+                Decoder *decoder = 0;
+
                 switch (info.channelMap.size()) {
                 case 1:
                 case 2:
-                    // Decode the data
                     switch (info.imageType) {
                     case IT_FLOAT16:
-                        d->decodeData1<half>(file, info, layer, width, dx, dy, height, Imf::HALF);
+                        decoder = decoder1<half>(info, layer, width, dx, Imf::HALF);
                         break;
                     case IT_FLOAT32:
-                        d->decodeData1<float>(file, info, layer, width, dx, dy, height, Imf::FLOAT);
+                        decoder = decoder1<float>(info, layer, width, dx, Imf::FLOAT);
                         break;
                     case IT_UNKNOWN:
                     case IT_UNSUPPORTED:
@@ -869,13 +971,12 @@ KisImportExportErrorCode EXRConverter::decode(const QString &filename)
                     break;
                 case 3:
                 case 4:
-                    // Decode the data
                     switch (info.imageType) {
                     case IT_FLOAT16:
-                        d->decodeData4<half>(file, info, layer, width, dx, dy, height, Imf::HALF);
+                        decoder = decoder4<half>(info, layer, width, dx, Imf::HALF);
                         break;
                     case IT_FLOAT32:
-                        d->decodeData4<float>(file, info, layer, width, dx, dy, height, Imf::FLOAT);
+                        decoder = decoder4<float>(info, layer, width, dx, Imf::FLOAT);
                         break;
                     case IT_UNKNOWN:
                     case IT_UNSUPPORTED:
@@ -885,25 +986,51 @@ KisImportExportErrorCode EXRConverter::decode(const QString &filename)
                 default:
                     qFatal("Invalid number of channels: %i", info.channelMap.size());
                 }
-                // Check if should set the channels
-                if (!info.remappedChannels.isEmpty()) {
-                    QList<KisMetaData::Value> values;
-                    Q_FOREACH (const ExrPaintLayerInfo::Remap& remap, info.remappedChannels) {
-                        QMap<QString, KisMetaData::Value> map;
-                        map["original"] = KisMetaData::Value(remap.original);
-                        map["current"] = KisMetaData::Value(remap.current);
-                        values.append(map);
-                    }
-                    layer->metaData()->addEntry(KisMetaData::Entry(KisMetaData::SchemaRegistry::instance()->create("http://krita.org/exrchannels/1.0/" , "exrchannels"), "channelsmap", values));
+
+                if (decoder) {
+                    decoders.append(decoder);
                 }
-                // Add the layer
-                KisGroupLayerSP groupLayerParent = (info.parent) ? info.parent->groupLayer : d->image->rootLayer();
-                d->image->addNode(layer, groupLayerParent);
+
+                layers.append(layer);
+                layersInfo.append(&info);
             } else {
                 dbgFile << "No decoding " << info.name << " with " << info.channelMap.size() << " channels, and lack of a color space";
             }
         }
 
+        // Decode the data of all the layers at once
+        try {
+            if (!decoders.isEmpty() && decodeData(file, decoders, dy, height)) {
+                d->alphaWasModified = true;
+            }
+        } catch (...) {
+            qDeleteAll(decoders);
+            throw;
+        }
+
+        qDeleteAll(decoders);
+
+        // Add the layers
+        for (int i = 0; i < layers.size(); ++i) {
+            KisPaintLayerSP layer = layers[i];
+            const ExrPaintLayerInfo& info = *layersInfo[i];
+
+            // Check if should set the channels
+            if (!info.remappedChannels.isEmpty()) {
+                QList<KisMetaData::Value> values;
+                Q_FOREACH (const ExrPaintLayerInfo::Remap& remap, info.remappedChannels) {
+                    QMap<QString, KisMetaData::Value> map;
+                    map["original"] = KisMetaData::Value(remap.original);
+                    map["current"] = KisMetaData::Value(remap.current);
+                    values.append(map);
+                }
+                layer->metaData()->addEntry(KisMetaData::Entry(KisMetaData::SchemaRegistry::instance()->create("http://krita.org/exrchannels/1.0/" , "exrchannels"), "channelsmap", values));
+            }
+            // Add the layer
+            KisGroupLayerSP groupLayerParent = (info.parent) ? info.parent->groupLayer : d->image->rootLayer();
+            d->image->addNode(layer, groupLayerParent);
+        }
+
         // After reading the image, notify the user about changed alpha.
         if (d->alphaWasModified) {
             QString msg =
@@ -968,8 +1095,17 @@ class Encoder
 {
 public:
     virtual ~Encoder() {}
+
+    /**
+     * Adds the slices of the band starting at \p line to \p frameBuffer
+     */
     virtual void prepareFrameBuffer(Imf::FrameBuffer*, int line) = 0;
-    virtual void encodeData(int line) = 0;
+
+    /**
+     * Fetches \p numRows rows of the band starting at \p line from
+     * the device. Can be called concurrently for different rows.
+     */
+    virtual void encodeData(int line, int firstRow, int numRows) = 0;
 
 };
 
@@ -977,10 +1113,10 @@ template<typename _T_, int size, int alphaPos>
 class EncoderImpl : public Encoder
 {
 public:
-    EncoderImpl(Imf::OutputFile* _file, const ExrPaintLayerSaveInfo* _info, int width) : file(_file), info(_info), pixels(width), m_width(width) {}
+    EncoderImpl(Imf::OutputFile* _file, const ExrPaintLayerSaveInfo* _info, int width) : file(_file), info(_info), pixels(width * bandHeight), m_width(width) {}
     ~EncoderImpl() override {}
     void prepareFrameBuffer(Imf::FrameBuffer*, int line) override;
-    void encodeData(int line) override;
+    void encodeData(int line, int firstRow, int numRows) override;
 private:
     typedef ExrPixel_<_T_, size> ExrPixel;
     Imf::OutputFile* file;
@@ -1004,23 +1140,21 @@ void EncoderImpl<_T_, size, alphaPos>::prepareFrameBuffer(Imf::FrameBuffer* fram
 }
 
 template<typename _T_, int size, int alphaPos>
-void EncoderImpl<_T_, size, alphaPos>::encodeData(int line)
+void EncoderImpl<_T_, size, alphaPos>::encodeData(int line, int firstRow, int numRows)
 {
-    ExrPixel *rgba = pixels.data();
-    KisHLineConstIteratorSP it = info->layerDevice->createHLineConstIteratorNG(0, line, m_width);
-    do {
-        const _T_* dst = reinterpret_cast < const _T_* >(it->oldRawData());
-
-        for (int i = 0; i < size; ++i) {
-            rgba->data[i] = dst[i];
-        }
-
-        if (alphaPos != -1) {
+    /**
+     * The layout of ExrPixel is the same as the one of the device,
+     * so the band is read right from the tiles
+     */
+    ExrPixel *rgba = pixels.data() + firstRow * m_width;
+    info->layerDevice->readBytes(reinterpret_cast<quint8*>(rgba), QRect(0, line + firstRow, m_width, numRows));
+
+    if (alphaPos != -1) {
+        ExrPixel *end = rgba + numRows * m_width;
+        for (; rgba < end; ++rgba) {
             multiplyAlpha<_T_, ExrPixel, size, alphaPos>(rgba);
         }
-
-        ++rgba;
-    } while (it->nextPixel());
+    }
 }
 
 Encoder* encoder(Imf::OutputFile& file, const ExrPaintLayerSaveInfo& info, int width)
@@ -1063,6 +1197,11 @@ Encoder* encoder(Imf::OutputFile& file, const ExrPaintLayerSaveInfo& info, int w
     return 0;
 }
 
+/**
+ * Writes all the layers together, band by band. The bands of the
+ * layers are fetched from the devices concurrently, and then OpenEXR
+ * compresses the line blocks of the band in its own thread pool.
+ */
 void encodeData(Imf::OutputFile& file, const QList<ExrPaintLayerSaveInfo>& informationObjects, int width, int height)
 {
     QList<Encoder*> encoders;
@@ -1070,16 +1209,25 @@ void encodeData(Imf::OutputFile& file, const QList<ExrPaintLayerSaveInfo>& infor
         encoders.push_back(encoder(file, info, width));
     }
 
-    for (int y = 0; y < height; ++y) {
+    for (int y = 0; y < height; y += bandHeight) {
+        const int numRows = qMin(bandHeight, height - y);
+
         Imf::FrameBuffer frameBuffer;
         Q_FOREACH (Encoder* encoder, encoders) {
             encoder->prepareFrameBuffer(&frameBuffer, y);
         }
         file.setFrameBuffer(frameBuffer);
-        Q_FOREACH (Encoder* encoder, encoders) {
-            encoder->encodeData(y);
-        }
-        file.writePixels(1);
+
+        const int jobsPerEncoder = (numRows + rowsPerJob - 1) / rowsPerJob;
+
+        KritaUtils::parallelFor(encoders.size() * jobsPerEncoder, [&] (int job) {
+            Encoder *encoder = encoders.at(job / jobsPerEncoder);
+            const int firstRow = (job % jobsPerEncoder) * rowsPerJob;
+
+            encoder->encodeData(y, firstRow, qMin(rowsPerJob, numRows - firstRow));
+        });
+
+        file.writePixels(numRows);
     }
     qDeleteAll(encoders);
 }
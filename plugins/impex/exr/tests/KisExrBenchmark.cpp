@@ -0,0 +1,137 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisExrBenchmark.h"
+
+#include <QFile>
+
+#include <half.h>
+
+#include <KoColorModelStandardIds.h>
+#include <KoColorSpaceRegistry.h>
+#include <KisDocument.h>
+#include <KisMimeDatabase.h>
+#include <KisPart.h>
+
+#include "kis_image.h"
+#include "kis_group_layer.h"
+#include "kis_paint_layer.h"
+#include "kis_paint_device.h"
+#include "kis_sequential_iterator.h"
+
+#include <testui.h>
+#include <testing_benchmark_utils.h>
+
+namespace {
+
+/**
+ * Fills the device with a smooth gradient with some noise, like
+ * a render pass would look like
+ */
+void fillLayerContent(KisPaintDeviceSP dev, const QRect &rc, int seed)
+{
+    TestUtil::TestingRandomSequence random(seed);
+
+    KisSequentialIterator it(dev, rc);
+    while (it.nextPixel()) {
+        const float noise = float(random.nextByte()) / 255.0f * 0.01f;
+
+        half *pixel = reinterpret_cast<half*>(it.rawData());
+        pixel[0] = half(float(it.x()) / rc.width() + noise);
+        pixel[1] = half(float(it.y()) / rc.height() + noise);
+        pixel[2] = half(float(seed % 7) / 7.0f + noise);
+        pixel[3] = half(1.0f);
+    }
+}
+
+/**
+ * Creates a document with KRITA_EXR_BENCHMARK_LAYERS half-float
+ * layers of KRITA_EXR_BENCHMARK_SIZE pixels square
+ */
+KisDocument* createBenchmarkDocument()
+{
+    const int numLayers = TestUtil::benchmarkEnvValue("KRITA_EXR_BENCHMARK_LAYERS", 16);
+    const int size = TestUtil::benchmarkEnvValue("KRITA_EXR_BENCHMARK_SIZE", 2048);
+
+    const QRect imageRect(0, 0, size, size);
+    const KoColorSpace *cs =
+        KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), Float16BitsColorDepthID.id(), QString());
+
+    KisDocument *doc = KisPart::instance()->createDocument();
+
+    KisImageSP image = new KisImage(doc->createUndoStore(), size, size, cs, "exr benchmark");
+    doc->setCurrentImage(image);
+
+    for (int i = 0; i < numLayers; i++) {
+        KisPaintLayerSP layer = new KisPaintLayer(image, QString("layer%1").arg(i), OPACITY_OPAQUE_U8, cs);
+        fillLayerContent(layer->paintDevice(), imageRect, i);
+        image->addNode(layer, image->root());
+    }
+
+    image->initialRefreshGraph();
+    image->waitForDone();
+
+    doc->setFileBatchMode(true);
+
+    return doc;
+}
+
+const QString benchmarkFileName("exr_benchmark.exr");
+
+QByteArray benchmarkMimeType()
+{
+    return KisMimeDatabase::mimeTypeForFile(benchmarkFileName, false).toLatin1();
+}
+
+}
+
+void KisExrBenchmark::initTestCase()
+{
+    KoColorSpaceRegistry::instance();
+}
+
+void KisExrBenchmark::benchmarkSave()
+{
+    QScopedPointer<KisDocument> doc(createBenchmarkDocument());
+    const QByteArray mimeType = benchmarkMimeType();
+
+    bool result = true;
+
+    QBENCHMARK {
+        result &= doc->exportDocumentSync(benchmarkFileName, mimeType);
+    }
+
+    QFile::remove(benchmarkFileName);
+
+    QVERIFY(result);
+}
+
+void KisExrBenchmark::benchmarkLoad()
+{
+    {
+        QScopedPointer<KisDocument> doc(createBenchmarkDocument());
+        QVERIFY(doc->exportDocumentSync(benchmarkFileName, benchmarkMimeType()));
+    }
+
+    bool result = true;
+
+    QBENCHMARK {
+        QScopedPointer<KisDocument> doc(KisPart::instance()->createDocument());
+        doc->setFileBatchMode(true);
+
+        result &= doc->importDocument(benchmarkFileName);
+
+        if (doc->image()) {
+            doc->image()->waitForDone();
+        }
+    }
+
+    QFile::remove(benchmarkFileName);
+
+    QVERIFY(result);
+}
+
+KISTEST_MAIN(KisExrBenchmark)
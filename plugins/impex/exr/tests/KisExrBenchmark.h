@@ -0,0 +1,22 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISEXRBENCHMARK_H
+#define KISEXRBENCHMARK_H
+
+#include <simpletest.h>
+
+class KisExrBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+
+    void benchmarkSave();
+    void benchmarkLoad();
+};
+
+#endif // KISEXRBENCHMARK_H
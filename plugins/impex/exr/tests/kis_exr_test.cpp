@@ -13,6 +13,11 @@
 
 #include <half.h>
 #include <KisMimeDatabase.h>
+#include <KoColorModelStandardIds.h>
+#include <KoColorSpaceRegistry.h>
+#include <kis_layer_utils.h>
+#include <kis_paint_layer.h>
+#include <kis_sequential_iterator.h>
 #include "filestest.h"
 
 #ifndef FILES_DATA_DIR
@@ -93,6 +98,73 @@ void KisExrTest::testRoundTrip()
 
 }
 
+void KisExrTest::testMultiLayerRoundTrip()
+{
+    /**
+     * The layers are read and written together in bands, make sure
+     * every layer gets its own data, including the last partial band
+     */
+    const QRect imageRect(0, 0, 300, 333);
+    const KoColorSpace *cs =
+        KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), Float16BitsColorDepthID.id(), QString());
+
+    QScopedPointer<KisDocument> doc1(KisPart::instance()->createDocument());
+    KisImageSP image = new KisImage(doc1->createUndoStore(), imageRect.width(), imageRect.height(), cs, "exr layers test");
+    doc1->setCurrentImage(image);
+
+    const int numLayers = 3;
+
+    for (int i = 0; i < numLayers; i++) {
+        KisPaintLayerSP layer = new KisPaintLayer(image, QString("layer%1").arg(i), OPACITY_OPAQUE_U8, cs);
+
+        KisSequentialIterator it(layer->paintDevice(), imageRect);
+        while (it.nextPixel()) {
+            half *pixel = reinterpret_cast<half*>(it.rawData());
+            pixel[0] = half(0.001f * it.x() + i);
+            pixel[1] = half(0.002f * it.y());
+            pixel[2] = half(float(i) / numLayers);
+            pixel[3] = half(1.0f);
+        }
+
+        image->addNode(layer, image->root());
+    }
+
+    image->initialRefreshGraph();
+    image->waitForDone();
+
+    QTemporaryFile savedFile(QDir::tempPath() + QLatin1String("/krita_XXXXXX") + QLatin1String(".exr"));
+    savedFile.setAutoRemove(true);
+    savedFile.open();
+
+    const QString savedFileName(savedFile.fileName());
+    const QByteArray mimeType(KisMimeDatabase::mimeTypeForFile(savedFileName, false).toLatin1());
+
+    doc1->setFileBatchMode(true);
+    QVERIFY(doc1->exportDocumentSync(savedFileName, mimeType));
+
+    QScopedPointer<KisDocument> doc2(KisPart::instance()->createDocument());
+    doc2->setFileBatchMode(true);
+    QVERIFY(doc2->importDocument(savedFileName));
+    QVERIFY(doc2->image());
+
+    for (int i = 0; i < numLayers; i++) {
+        const QString name = QString("layer%1").arg(i);
+
+        KisNodeSP srcNode = KisLayerUtils::findNodeByName(image->root(), name);
+        KisNodeSP dstNode = KisLayerUtils::findNodeByName(doc2->image()->root(), name);
+        QVERIFY(srcNode);
+        QVERIFY(dstNode);
+
+        QByteArray srcBytes(imageRect.width() * imageRect.height() * cs->pixelSize(), 0);
+        QByteArray dstBytes(srcBytes.size(), 0);
+
+        srcNode->paintDevice()->readBytes(reinterpret_cast<quint8*>(srcBytes.data()), imageRect);
+        dstNode->paintDevice()->readBytes(reinterpret_cast<quint8*>(dstBytes.data()), imageRect);
+
+        QVERIFY(srcBytes == dstBytes);
+    }
+}
+
 KISTEST_MAIN(KisExrTest)
 
 
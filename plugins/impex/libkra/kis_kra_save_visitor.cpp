@@ -11,6 +11,11 @@
 
 #include <QBuffer>
 #include <QByteArray>
+#include <QFileInfo>
+
+#include <functional>
+#include <limits>
+#include <zlib.h>
 
 #include <KoColorProfile.h>
 #include <KoStore.h>
@@ -47,6 +52,8 @@
 #include "flake/kis_shape_selection.h"
 
 #include "kis_raster_keyframe_channel.h"
+#include "kis_datamanager.h"
+#include "tiles3/KisTiledDataSnapshot.h"
 #include "kis_paint_device_frames_interface.h"
 
 #include "lazybrush/kis_lazy_fill_tools.h"
@@ -57,6 +64,133 @@
 
 using namespace KRA;
 
+namespace {
+
+quint32 updateChecksum(quint32 checksum, const char *data, qint64 length)
+{
+    const Bytef *ptr = reinterpret_cast<const Bytef*>(data);
+
+    while (length > 0) {
+        const uInt chunk = uInt(qMin(length, qint64(std::numeric_limits<uInt>::max())));
+        checksum = crc32(checksum, ptr, chunk);
+        ptr += chunk;
+        length -= chunk;
+    }
+
+    return checksum;
+}
+
+/**
+ * Passes the data to the underlying writer and calculates
+ * the checksum of the data on the fly
+ */
+class ChecksumPaintDeviceWriter : public KisPaintDeviceWriter
+{
+public:
+    ChecksumPaintDeviceWriter(KisPaintDeviceWriter &writer)
+        : m_writer(writer),
+          m_checksum(crc32(0L, Z_NULL, 0))
+    {
+    }
+
+    bool write(const QByteArray &data) override {
+        return write(data.constData(), data.size());
+    }
+
+    bool write(const char *data, qint64 length) override {
+        m_checksum = updateChecksum(m_checksum, data, length);
+        m_size += length;
+        return m_writer.write(data, length);
+    }
+
+    quint32 checksum() const {
+        return m_checksum;
+    }
+
+    qint64 size() const {
+        return m_size;
+    }
+
+private:
+    KisPaintDeviceWriter &m_writer;
+    quint32 m_checksum;
+    qint64 m_size = 0;
+};
+
+}
+
+struct KisKraSaveVisitor::IncrementalSaving
+{
+    IncrementalSaving(KisIncrementalSaveCacheSP _cache, const QString &_previousFilePath)
+        : cache(_cache),
+          previousFilePath(_previousFilePath)
+    {
+    }
+
+    bool writeDevice(KisPaintDeviceSP dev, KisPaintDeviceWriter &store, const QString &location) {
+        /**
+         * The snapshot must be taken before writing: if the device is
+         * modified while being written, the snapshot will not match
+         * it anymore and the next saving will encode it anew
+         */
+        KisTiledDataSnapshot snapshot(dev->dataManager().data());
+        KisIncrementalSaveCache::Entry entry;
+        QByteArray data;
+
+        const bool copied =
+            cache->findEntry(snapshot, &entry) && readPreviousEntry(entry, &data);
+
+        if (copied) {
+            if (!store.write(data)) return false;
+        } else {
+            ChecksumPaintDeviceWriter writer(store);
+            if (!dev->write(writer)) return false;
+
+            entry.size = writer.size();
+            entry.checksum = writer.checksum();
+        }
+
+        entry.location = location;
+        cache->addEntry(snapshot, entry, copied);
+
+        return true;
+    }
+
+    /**
+     * Reads the entry from the previous file and checks that it
+     * is exactly the one we have written there last time. The
+     * file may have been changed or removed since then.
+     */
+    bool readPreviousEntry(const KisIncrementalSaveCache::Entry &entry, QByteArray *data) {
+        if (!previousStore && !previousStoreFailed) {
+            if (QFileInfo(previousFilePath).isFile()) {
+                previousStore.reset(KoStore::createStore(previousFilePath, KoStore::Read, "", KoStore::Zip));
+
+                if (previousStore && previousStore->bad()) {
+                    previousStore.reset();
+                }
+            }
+
+            previousStoreFailed = !previousStore;
+        }
+
+        if (!previousStore || !previousStore->open(entry.location)) {
+            return false;
+        }
+
+        *data = previousStore->read(previousStore->size());
+        previousStore->close();
+
+        return data->size() == entry.size &&
+            updateChecksum(crc32(0L, Z_NULL, 0), data->constData(), data->size()) == entry.checksum;
+    }
+
+    KisIncrementalSaveCacheSP cache;
+    QString previousFilePath;
+    QScopedPointer<KoStore> previousStore;
+    bool previousStoreFailed = false;
+};
+
 KisKraSaveVisitor::KisKraSaveVisitor(KoStore *store, const QString & name, QMap<const KisNode*, QString> nodeFileNames)
     : KisNodeVisitor()
     , m_store(store)
@@ -78,6 +212,11 @@ void KisKraSaveVisitor::setExternalUri(const QString &uri)
     m_uri = uri;
 }
 
+void KisKraSaveVisitor::setIncrementalSaveCache(KisIncrementalSaveCacheSP cache, const QString &previousFilePath)
+{
+    m_incrementalSaving.reset(new IncrementalSaving(cache, previousFilePath));
+}
+
 bool KisKraSaveVisitor::visit(KisExternalLayer * layer)
 {
     bool result = false;
@@ -318,6 +457,26 @@ struct SimpleDevicePolicy
     }
 };
 
+/**
+ * Writes the device the same way as SimpleDevicePolicy, but lets
+ * the incremental saving copy the data from the previous file
+ */
+struct IncrementalDevicePolicy : public SimpleDevicePolicy
+{
+    typedef std::function<bool(KisPaintDeviceSP, KisPaintDeviceWriter&)> WriteFunc;
+
+    IncrementalDevicePolicy(WriteFunc writeFunc)
+        : m_writeFunc(writeFunc)
+    {
+    }
+
+    bool write(KisPaintDeviceSP dev, KisPaintDeviceWriter &store) {
+        return m_writeFunc(dev, store);
+    }
+
+    WriteFunc m_writeFunc;
+};
+
 struct FramedDevicePolicy
 {
     FramedDevicePolicy(int frameId)
@@ -349,7 +508,16 @@ bool KisKraSaveVisitor::savePaintDevice(KisPaintDeviceSP device,
     }
 
     if (!frameInterface || frames.count() <= 1) {
-        savePaintDeviceFrame(device, location, SimpleDevicePolicy());
+        if (m_incrementalSaving) {
+            IncrementalSaving *saving = m_incrementalSaving.data();
+
+            savePaintDeviceFrame(device, location, IncrementalDevicePolicy(
+                [saving, location] (KisPaintDeviceSP dev, KisPaintDeviceWriter &store) {
+                    return saving->writeDevice(dev, store, location);
+                }));
+        } else {
+            savePaintDeviceFrame(device, location, SimpleDevicePolicy());
+        }
     } else {
         KisRasterKeyframeChannel *keyframeChannel = device->keyframeChannel();
 
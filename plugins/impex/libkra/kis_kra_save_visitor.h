@@ -8,12 +8,14 @@
 #ifndef KIS_KRA_SAVE_VISITOR_H_
 #define KIS_KRA_SAVE_VISITOR_H_
 
+#include <QScopedPointer>
 #include <QStringList>
 
 #include "kis_types.h"
 #include "kis_node_visitor.h"
 #include "kis_image.h"
 #include "kritalibkra_export.h"
+#include "KisIncrementalSaveCache.h"
 
 class KisPaintDeviceWriter;
 class KoStore;
@@ -28,6 +30,18 @@ public:
 public:
     void setExternalUri(const QString &uri);
 
+    /**
+     * Enable incremental saving: the paint devices which content
+     * has been written into \p previousFilePath during the previous
+     * saving are copied from that file instead of being encoded
+     * again. The content of all the saved devices is recorded
+     * in \p cache.
+     *
+     * The caller should call beginSaving() and endSaving() on the
+     * cache itself.
+     */
+    void setIncrementalSaveCache(KisIncrementalSaveCacheSP cache, const QString &previousFilePath);
+
     bool visit(KisNode*) override {
         return true;
     }
@@ -81,6 +95,9 @@ private:
     QMap<const KisNode*, QString> m_nodeFileNames;
     KisPaintDeviceWriter *m_writer;
     QStringList m_errorMessages;
+
+    struct IncrementalSaving;
+    QScopedPointer<IncrementalSaving> m_incrementalSaving;
 };
 
 #endif // KIS_KRA_SAVE_VISITOR_H_
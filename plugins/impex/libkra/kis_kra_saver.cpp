@@ -478,9 +478,24 @@ bool KisKraSaver::saveBinaryData(KoStore* store, KisImageSP image, const QString
     if (external)
         visitor.setExternalUri(uri);
 
+    KisIncrementalSaveCacheSP saveCache;
+    if (!external && !m_d->filename.isEmpty() && KisConfig(true).incrementalKraSaving()) {
+        saveCache = m_d->doc->incrementalSaveCache();
+    }
+
+    if (saveCache) {
+        saveCache->beginSaving(m_d->filename);
+        visitor.setIncrementalSaveCache(saveCache, m_d->filename);
+    }
+
     image->rootLayer()->accept(visitor);
 
     m_d->errorMessages.append(visitor.errorMessages());
+
+    if (saveCache) {
+        saveCache->endSaving(m_d->errorMessages.isEmpty());
+    }
+
     if (!m_d->errorMessages.isEmpty()) {
         return false;
     }
@@ -0,0 +1,174 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisKraSaveBenchmark.h"
+
+#include <QFile>
+#include <QFileInfo>
+
+#include <KoColorSpaceRegistry.h>
+#include <KisDocument.h>
+#include <KisPart.h>
+
+#include "kis_config.h"
+#include "kis_debug.h"
+
+#include "kis_image.h"
+#include "kis_group_layer.h"
+#include "kis_paint_layer.h"
+#include "kis_paint_device.h"
+#include "kis_sequential_iterator.h"
+
+#include <testui.h>
+#include <testing_benchmark_utils.h>
+
+namespace {
+
+/**
+ * Fills the device with a gradient sprinkled with some noise. Pure
+ * noise is incompressible and flat color compresses too well, the
+ * mixture is closer to what the real paintings look like.
+ */
+void fillLayerContent(KisPaintDeviceSP dev, const QRect &rc, int seed)
+{
+    TestUtil::TestingRandomSequence random(seed);
+
+    KisSequentialIterator it(dev, rc);
+    while (it.nextPixel()) {
+        const int x = it.x();
+        const int y = it.y();
+        const quint8 noise = random.nextByte() & 0x0f;
+
+        quint8 *pixel = it.rawData();
+        pixel[0] = quint8(x + seed) ^ noise;
+        pixel[1] = quint8(y * 2 + seed) ^ noise;
+        pixel[2] = quint8((x + y) / 4);
+        pixel[3] = quint8(255 - ((x * y + seed) & 0x3f));
+    }
+}
+
+/**
+ * Creates a document with KRITA_SAVE_BENCHMARK_LAYERS layers of
+ * KRITA_SAVE_BENCHMARK_SIZE pixels square
+ */
+KisDocument* createBenchmarkDocument()
+{
+    const int numLayers = TestUtil::benchmarkEnvValue("KRITA_SAVE_BENCHMARK_LAYERS", 100);
+    const int size = TestUtil::benchmarkEnvValue("KRITA_SAVE_BENCHMARK_SIZE", 1024);
+
+    const QRect imageRect(0, 0, size, size);
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    KisDocument *doc = KisPart::instance()->createDocument();
+
+    KisImageSP image = new KisImage(doc->createUndoStore(), size, size, cs, "save benchmark");
+    doc->setCurrentImage(image);
+
+    for (int i = 0; i < numLayers; i++) {
+        KisPaintLayerSP layer = new KisPaintLayer(image, QString("layer %1").arg(i), OPACITY_OPAQUE_U8, cs);
+        fillLayerContent(layer->paintDevice(), imageRect, i);
+        image->addNode(layer, image->root());
+    }
+
+    image->initialRefreshGraph();
+    image->waitForDone();
+
+    return doc;
+}
+
+const QString benchmarkFileName("save_benchmark.kra");
+
+/**
+ * QBENCHMARK reports only the time, so the size of the saved file
+ * is printed separately for every data row
+ */
+void reportFileSize()
+{
+    const qint64 fileSize = QFileInfo(benchmarkFileName).size();
+
+    qDebug() << qPrintable(QString("%1: file size: %2 bytes (%3 MiB)")
+                           .arg(QTest::currentDataTag())
+                           .arg(fileSize)
+                           .arg(qreal(fileSize) / (1024 * 1024), 0, 'f', 2));
+}
+
+}
+
+void KisKraSaveBenchmark::initTestCase()
+{
+    KoColorSpaceRegistry::instance();
+}
+
+void KisKraSaveBenchmark::benchmarkSave_data()
+{
+    QTest::addColumn<bool>("compressLayers");
+
+    QTest::newRow("stored") << false;
+    QTest::newRow("deflated") << true;
+}
+
+void KisKraSaveBenchmark::benchmarkSave()
+{
+    QFETCH(bool, compressLayers);
+
+    KisConfig cfg(false);
+    const bool oldCompressLayers = cfg.compressKra();
+    cfg.setCompressKra(compressLayers);
+
+    QScopedPointer<KisDocument> doc(createBenchmarkDocument());
+
+    bool result = true;
+
+    QBENCHMARK {
+        result &= doc->exportDocumentSync(benchmarkFileName, doc->mimeType());
+    }
+
+    cfg.setCompressKra(oldCompressLayers);
+
+    reportFileSize();
+    QFile::remove(benchmarkFileName);
+
+    QVERIFY(result);
+}
+
+void KisKraSaveBenchmark::benchmarkLoad_data()
+{
+    benchmarkSave_data();
+}
+
+void KisKraSaveBenchmark::benchmarkLoad()
+{
+    QFETCH(bool, compressLayers);
+
+    KisConfig cfg(false);
+    const bool oldCompressLayers = cfg.compressKra();
+    cfg.setCompressKra(compressLayers);
+
+    {
+        QScopedPointer<KisDocument> doc(createBenchmarkDocument());
+        QVERIFY(doc->exportDocumentSync(benchmarkFileName, doc->mimeType()));
+    }
+
+    cfg.setCompressKra(oldCompressLayers);
+    reportFileSize();
+
+    bool result = true;
+
+    QBENCHMARK {
+        QScopedPointer<KisDocument> doc(KisPart::instance()->createDocument());
+        result &= doc->loadNativeFormat(benchmarkFileName);
+
+        if (doc->image()) {
+            doc->image()->waitForDone();
+        }
+    }
+
+    QFile::remove(benchmarkFileName);
+
+    QVERIFY(result);
+}
+
+KISTEST_MAIN(KisKraSaveBenchmark)
@@ -0,0 +1,25 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISKRASAVEBENCHMARK_H
+#define KISKRASAVEBENCHMARK_H
+
+#include <simpletest.h>
+
+class KisKraSaveBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+
+    void benchmarkSave_data();
+    void benchmarkSave();
+
+    void benchmarkLoad_data();
+    void benchmarkLoad();
+};
+
+#endif // KISKRASAVEBENCHMARK_H
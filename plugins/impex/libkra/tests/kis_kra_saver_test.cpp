@@ -566,6 +566,69 @@ void KisKraSaverTest::testRoundTripStoryboard()
     QCOMPARE(doc2->getStoryboardItemList().count(), list.count());
 }
 
+void KisKraSaverTest::testIncrementalSave()
+{
+    const QString fileName("incremental_save_test.kra");
+    const QRect imageRect(0, 0, 300, 300);
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    QScopedPointer<KisDocument> doc(KisPart::instance()->createDocument());
+    KisImageSP image = new KisImage(doc->createUndoStore(), imageRect.width(), imageRect.height(), cs, "incremental save test");
+    doc->setCurrentImage(image);
+
+    KisPaintLayerSP layer1 = new KisPaintLayer(image, "layer1", OPACITY_OPAQUE_U8, cs);
+    KisPaintLayerSP layer2 = new KisPaintLayer(image, "layer2", OPACITY_OPAQUE_U8, cs);
+
+    layer1->paintDevice()->fill(imageRect, KoColor(Qt::red, cs));
+    layer2->paintDevice()->fill(QRect(0, 0, 100, 100), KoColor(Qt::blue, cs));
+
+    image->addNode(layer1, image->root());
+    image->addNode(layer2, image->root());
+    image->initialRefreshGraph();
+
+    QVERIFY(doc->exportDocumentSync(fileName, doc->mimeType()));
+    QCOMPARE(doc->incrementalSaveCache()->numCopiedEntries(), 0);
+
+    /**
+     * Change only one layer, the data of the other layer
+     * should be taken from the previous file
+     */
+    layer2->paintDevice()->fill(QRect(50, 50, 200, 200), KoColor(Qt::green, cs));
+    image->waitForDone();
+
+    QVERIFY(doc->exportDocumentSync(fileName, doc->mimeType()));
+    QCOMPARE(doc->incrementalSaveCache()->numCopiedEntries(), 1);
+
+    /**
+     * Replace the file behind the cache's back, the
+     * saver should notice that and write the data anew
+     */
+    {
+        QScopedPointer<KisDocument> otherDoc(createEmptyDocument());
+        QVERIFY(otherDoc->exportDocumentSync(fileName, otherDoc->mimeType()));
+    }
+
+    layer2->paintDevice()->fill(QRect(0, 0, 20, 20), KoColor(Qt::black, cs));
+    image->waitForDone();
+
+    QVERIFY(doc->exportDocumentSync(fileName, doc->mimeType()));
+    QCOMPARE(doc->incrementalSaveCache()->numCopiedEntries(), 0);
+
+    QScopedPointer<KisDocument> doc2(KisPart::instance()->createDocument());
+    QVERIFY(doc2->loadNativeFormat(fileName));
+
+    KisNodeSP loadedLayer1 = TestUtil::findNode(doc2->image()->root(), "layer1");
+    KisNodeSP loadedLayer2 = TestUtil::findNode(doc2->image()->root(), "layer2");
+    QVERIFY(loadedLayer1);
+    QVERIFY(loadedLayer2);
+
+    QPoint errorPoint;
+    QVERIFY(TestUtil::comparePaintDevices(errorPoint, layer1->paintDevice(), loadedLayer1->paintDevice()));
+    QVERIFY(TestUtil::comparePaintDevices(errorPoint, layer2->paintDevice(), loadedLayer2->paintDevice()));
+
+    QFile::remove(fileName);
+}
+
 void KisKraSaverTest::testExportToReadonly()
 {
     TestUtil::testExportToReadonly(KraMimetype);
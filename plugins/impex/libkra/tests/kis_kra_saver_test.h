@@ -35,6 +35,8 @@ private Q_SLOTS:
     void testRoundTripShapeSelection();
     void testRoundTripStoryboard();
 
+    void testIncrementalSave();
+
     void testExportToReadonly();
 
 };
@@ -53,6 +53,10 @@ KisImportExportErrorCode KisPNGExport::convert(KisDocument *document, QIODevice
     options.alpha = configuration->getBool("alpha", true);
     options.interlace = configuration->getBool("interlaced", false);
     options.compression = configuration->getInt("compression", 3);
+    options.encodingPreset = KisPNGOptions::EncodingPreset(
+        qBound(int(KisPNGOptions::SmallestFile),
+               configuration->getInt("encodingPreset", KisPNGOptions::SmallestFile),
+               int(KisPNGOptions::Fastest)));
     options.tryToSaveAsIndexed = configuration->getBool("indexed", false);
     KoColor c(KoColorSpaceRegistry::instance()->rgb8());
     c.fromQColor(Qt::white);
@@ -92,6 +96,7 @@ KisPropertiesConfigurationSP KisPNGExport::defaultConfiguration(const QByteArray
     cfg->setProperty("alpha", true);
     cfg->setProperty("indexed", false);
     cfg->setProperty("compression", 3);
+    cfg->setProperty("encodingPreset", int(KisPNGOptions::SmallestFile));
     cfg->setProperty("interlaced", false);
 
     KoColor fill_color(KoColorSpaceRegistry::instance()->rgb8());
@@ -163,6 +168,7 @@ void KisWdgOptionsPNG::setConfiguration(const KisPropertiesConfigurationSP cfg)
     interlacing->setChecked(cfg->getBool("interlaced", false));
     compressionLevel->setValue(cfg->getInt("compression", 3));
     compressionLevel->setRange(1, 9, 0);
+    cmbEncodingPreset->setCurrentIndex(cfg->getInt("encodingPreset", KisPNGOptions::SmallestFile));
 
     tryToSaveAsIndexed->setVisible(!isThereAlpha);
 
@@ -211,6 +217,7 @@ KisPropertiesConfigurationSP KisWdgOptionsPNG::configuration() const
     cfg->setProperty("alpha", alpha);
     cfg->setProperty("indexed", tryToSaveAsIndexed);
     cfg->setProperty("compression", compression);
+    cfg->setProperty("encodingPreset", cmbEncodingPreset->currentIndex());
     cfg->setProperty("interlaced", interlace);
     cfg->setProperty("transparencyFillcolor", transparencyFillcolor);
     cfg->setProperty("saveAsHDR", saveAsHDR);
@@ -0,0 +1,128 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisPngBenchmark.h"
+
+#include <QFile>
+
+#include <KoColorModelStandardIds.h>
+#include <KoColorSpaceRegistry.h>
+#include <KisDocument.h>
+#include <KisPart.h>
+
+#include "kis_image.h"
+#include "kis_group_layer.h"
+#include "kis_paint_layer.h"
+#include "kis_paint_device.h"
+#include "kis_properties_configuration.h"
+#include "kis_sequential_iterator.h"
+
+#include <testui.h>
+#include <testing_benchmark_utils.h>
+
+namespace {
+
+/**
+ * Fills the device with a smooth gradient with some noise, which is
+ * closer to a painting than both a flat color and pure noise
+ */
+void fillLayerContent(KisPaintDeviceSP dev, const QRect &rc)
+{
+    const KoColorSpace *cs = dev->colorSpace();
+    const bool is16Bit = cs->colorDepthId() == Integer16BitsColorDepthID;
+
+    TestUtil::TestingRandomSequence random(12345);
+
+    KisSequentialIterator it(dev, rc);
+    while (it.nextPixel()) {
+        const qreal noise = qreal(random.nextByte()) / 255.0 * 0.02;
+        const qreal values[4] = {
+            qreal(it.x()) / rc.width() + noise,
+            qreal(it.y()) / rc.height() + noise,
+            qreal(it.x() + it.y()) / (rc.width() + rc.height()),
+            1.0
+        };
+
+        for (int i = 0; i < 4; i++) {
+            const qreal value = qBound(0.0, values[i], 1.0);
+
+            if (is16Bit) {
+                reinterpret_cast<quint16*>(it.rawData())[i] = quint16(value * 0xffff);
+            } else {
+                it.rawData()[i] = quint8(value * 0xff);
+            }
+        }
+    }
+}
+
+}
+
+void KisPngBenchmark::initTestCase()
+{
+    KoColorSpaceRegistry::instance();
+}
+
+void KisPngBenchmark::benchmarkSave_data()
+{
+    QTest::addColumn<bool>("is16Bit");
+    QTest::addColumn<int>("encodingPreset");
+
+    // the values are indexes of the export dialog, see KisPNGOptions::EncodingPreset
+    QTest::newRow("rgba8-smallest") << false << 0;
+    QTest::newRow("rgba8-balanced") << false << 1;
+    QTest::newRow("rgba8-fastest") << false << 2;
+    QTest::newRow("rgba16-smallest") << true << 0;
+    QTest::newRow("rgba16-balanced") << true << 1;
+    QTest::newRow("rgba16-fastest") << true << 2;
+}
+
+void KisPngBenchmark::benchmarkSave()
+{
+    QFETCH(bool, is16Bit);
+    QFETCH(int, encodingPreset);
+
+    const int size = TestUtil::benchmarkEnvValue("KRITA_PNG_BENCHMARK_SIZE", 8192);
+    const int compression = TestUtil::benchmarkEnvValue("KRITA_PNG_BENCHMARK_COMPRESSION", 3);
+
+    const QRect imageRect(0, 0, size, size);
+    const KoID colorDepthId = is16Bit ? Integer16BitsColorDepthID : Integer8BitsColorDepthID;
+    const KoColorSpace *cs =
+        KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), colorDepthId.id(), QString());
+
+    const QString fileName("png_benchmark.png");
+
+    QScopedPointer<KisDocument> doc(KisPart::instance()->createDocument());
+
+    KisImageSP image = new KisImage(doc->createUndoStore(), size, size, cs, "png benchmark");
+    doc->setCurrentImage(image);
+
+    KisPaintLayerSP layer = new KisPaintLayer(image, "layer", OPACITY_OPAQUE_U8, cs);
+    fillLayerContent(layer->paintDevice(), imageRect);
+    image->addNode(layer, image->root());
+
+    image->initialRefreshGraph();
+    image->waitForDone();
+
+    doc->setFileBatchMode(true);
+
+    KisPropertiesConfigurationSP cfg = new KisPropertiesConfiguration();
+    cfg->setProperty("encodingPreset", encodingPreset);
+    cfg->setProperty("compression", compression);
+    cfg->setProperty("alpha", true);
+    cfg->setProperty("forceSRGB", false);
+
+    bool result = true;
+
+    QBENCHMARK {
+        result &= doc->exportDocumentSync(fileName, "image/png", cfg);
+    }
+
+    QFile::remove(fileName);
+
+    QVERIFY(result);
+}
+
+KISTEST_MAIN(KisPngBenchmark)
@@ -0,0 +1,22 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISPNGBENCHMARK_H
+#define KISPNGBENCHMARK_H
+
+#include <simpletest.h>
+
+class KisPngBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+
+    void benchmarkSave_data();
+    void benchmarkSave();
+};
+
+#endif // KISPNGBENCHMARK_H
@@ -12,7 +12,18 @@
 
 #include "filestest.h"
 
+#include <QTemporaryFile>
+
+#include <KoColorModelStandardIds.h>
+#include <KoColorSpaceRegistry.h>
+#include <KisDocument.h>
+#include <KisPart.h>
+#include <kis_image.h>
+#include <kis_paint_layer.h>
+#include <kis_properties_configuration.h>
+#include <kis_sequential_iterator.h>
 #include <testui.h>
+#include <testing_benchmark_utils.h>
 
 #ifndef FILES_DATA_DIR
 #error "FILES_DATA_DIR not set. A directory with the data used for testing the importing of files in krita"
@@ -165,5 +176,89 @@ void KisPngTest::testSaveHDR()
                     KoColorSpaceRegistry::instance()->p2020PQProfile()));
 }
 
+void KisPngTest::testRoundTripPresets_data()
+{
+    QTest::addColumn<int>("encodingPreset");
+    QTest::addColumn<bool>("is16Bit");
+    QTest::addColumn<bool>("interlaced");
+
+    // the values are indexes of the export dialog, see KisPNGOptions::EncodingPreset
+    QTest::newRow("smallest-8") << 0 << false << false;
+    QTest::newRow("smallest-16") << 0 << true << false;
+    QTest::newRow("balanced-8") << 1 << false << false;
+    QTest::newRow("balanced-16") << 1 << true << false;
+    QTest::newRow("fastest-8") << 2 << false << false;
+    QTest::newRow("fastest-16") << 2 << true << false;
+    QTest::newRow("fastest-16-interlaced") << 2 << true << true;
+}
+
+void KisPngTest::testRoundTripPresets()
+{
+    QFETCH(int, encodingPreset);
+    QFETCH(bool, is16Bit);
+    QFETCH(bool, interlaced);
+
+    /**
+     * The image is large enough to be split into several bands
+     * by the parallel encoder
+     */
+    const QRect imageRect(0, 0, 777, 1030);
+    const KoID colorDepthId = is16Bit ? Integer16BitsColorDepthID : Integer8BitsColorDepthID;
+    const KoColorSpace *cs =
+        KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), colorDepthId.id(), QString());
+
+    QScopedPointer<KisDocument> doc1(KisPart::instance()->createDocument());
+    KisImageSP image = new KisImage(doc1->createUndoStore(), imageRect.width(), imageRect.height(), cs, "png presets test");
+    doc1->setCurrentImage(image);
+
+    KisPaintLayerSP layer = new KisPaintLayer(image, "layer1", OPACITY_OPAQUE_U8, cs);
+
+    TestUtil::TestingRandomSequence random(12345);
+    KisSequentialIterator it(layer->paintDevice(), imageRect);
+    while (it.nextPixel()) {
+        quint8 *pixel = it.rawData();
+        for (quint32 i = 0; i < cs->pixelSize(); i++) {
+            pixel[i] = static_cast<quint8>(it.x() + it.y() * i + (random.next() >> 29));
+        }
+    }
+
+    image->addNode(layer, image->root());
+    image->initialRefreshGraph();
+    image->waitForDone();
+
+    KisPropertiesConfigurationSP cfg = new KisPropertiesConfiguration();
+    cfg->setProperty("encodingPreset", encodingPreset);
+    cfg->setProperty("interlaced", interlaced);
+    cfg->setProperty("alpha", true);
+    cfg->setProperty("forceSRGB", false);
+    cfg->setProperty("saveSRGBProfile", true);
+
+    QTemporaryFile savedFile(QDir::tempPath() + QLatin1String("/krita_XXXXXX") + QLatin1String(".png"));
+    savedFile.setAutoRemove(true);
+    savedFile.open();
+
+    const QString savedFileName(savedFile.fileName());
+
+    doc1->setFileBatchMode(true);
+    QVERIFY(doc1->exportDocumentSync(savedFileName, PngMimetype.toLatin1(), cfg));
+
+    QScopedPointer<KisDocument> doc2(KisPart::instance()->createDocument());
+    doc2->setFileBatchMode(true);
+    QVERIFY(doc2->importDocument(savedFileName));
+    QVERIFY(doc2->image());
+
+    KisNodeSP loadedNode = doc2->image()->root()->firstChild();
+    QVERIFY(loadedNode);
+    QCOMPARE(loadedNode->paintDevice()->colorSpace()->colorDepthId(), colorDepthId);
+
+    QByteArray srcBytes(imageRect.width() * imageRect.height() * cs->pixelSize(), 0);
+    QByteArray dstBytes(srcBytes.size(), 0);
+
+    layer->paintDevice()->readBytes(reinterpret_cast<quint8 *>(srcBytes.data()), imageRect);
+    loadedNode->paintDevice()->readBytes(reinterpret_cast<quint8 *>(dstBytes.data()), imageRect);
+
+    QVERIFY(srcBytes == dstBytes);
+}
+
 KISTEST_MAIN(KisPngTest)
 
@@ -0,0 +1,182 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisPsdBenchmark.h"
+
+#include <QFile>
+
+#include <KoColorSpaceRegistry.h>
+#include <KisDocument.h>
+#include <KisImportExportManager.h>
+#include <KisPart.h>
+
+#include "kis_image.h"
+#include "kis_group_layer.h"
+#include "kis_paint_layer.h"
+#include "kis_paint_device.h"
+#include "kis_sequential_iterator.h"
+
+#include <testui.h>
+#include <testing_benchmark_utils.h>
+
+namespace {
+
+/**
+ * Fills the device with a gradient sprinkled with some noise, so
+ * that RLE compression has something to do
+ */
+void fillLayerContent(KisPaintDeviceSP dev, const QRect &rc, int seed)
+{
+    TestUtil::TestingRandomSequence random(seed);
+
+    KisSequentialIterator it(dev, rc);
+    while (it.nextPixel()) {
+        const int x = it.x();
+        const int y = it.y();
+        const quint8 noise = random.nextByte() & 0x03;
+
+        quint8 *pixel = it.rawData();
+        pixel[0] = quint8(x / 4 + seed) ^ noise;
+        pixel[1] = quint8(y / 2 + seed);
+        pixel[2] = quint8((x + y) / 8);
+        pixel[3] = 255;
+    }
+}
+
+/**
+ * Resets the peak resident memory of the process ("VmHWM"), so that
+ * it reports the peak of the measured operation only. Supported on
+ * Linux only.
+ */
+void resetPeakMemory()
+{
+#ifdef Q_OS_LINUX
+    QFile file("/proc/self/clear_refs");
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write("5");
+    }
+#endif
+}
+
+/**
+ * Reads a memory usage value, e.g. "VmRSS", from the status of the
+ * process, returns -1 if not available
+ */
+qint64 processMemoryKiB(const QByteArray &key)
+{
+#ifdef Q_OS_LINUX
+    QFile file("/proc/self/status");
+    if (file.open(QIODevice::ReadOnly)) {
+        const QList<QByteArray> lines = file.readAll().split('\n');
+        Q_FOREACH (const QByteArray &line, lines) {
+            if (line.startsWith(key + ':')) {
+                return line.mid(key.size() + 1).trimmed().split(' ').first().toLongLong();
+            }
+        }
+    }
+#else
+    Q_UNUSED(key);
+#endif
+    return -1;
+}
+
+/**
+ * Creates a document with KRITA_PSD_BENCHMARK_LAYERS layers of
+ * KRITA_PSD_BENCHMARK_SIZE pixels square
+ */
+KisDocument* createBenchmarkDocument()
+{
+    const int numLayers = TestUtil::benchmarkEnvValue("KRITA_PSD_BENCHMARK_LAYERS", 20);
+    const int size = TestUtil::benchmarkEnvValue("KRITA_PSD_BENCHMARK_SIZE", 2048);
+
+    const QRect imageRect(0, 0, size, size);
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    KisDocument *doc = KisPart::instance()->createDocument();
+
+    KisImageSP image = new KisImage(doc->createUndoStore(), size, size, cs, "psd benchmark");
+    doc->setCurrentImage(image);
+
+    for (int i = 0; i < numLayers; i++) {
+        KisPaintLayerSP layer = new KisPaintLayer(image, QString("layer %1").arg(i), OPACITY_OPAQUE_U8, cs);
+        fillLayerContent(layer->paintDevice(), imageRect, i);
+        image->addNode(layer, image->root());
+    }
+
+    image->initialRefreshGraph();
+    image->waitForDone();
+
+    doc->setFileBatchMode(true);
+
+    return doc;
+}
+
+const QString benchmarkFileName("psd_benchmark.psd");
+const QByteArray benchmarkMimeType("image/vnd.adobe.photoshop");
+
+}
+
+void KisPsdBenchmark::initTestCase()
+{
+    KoColorSpaceRegistry::instance();
+}
+
+void KisPsdBenchmark::benchmarkSave()
+{
+    QScopedPointer<KisDocument> doc(createBenchmarkDocument());
+
+    const qint64 baseMemory = processMemoryKiB("VmRSS");
+    resetPeakMemory();
+
+    bool result = true;
+
+    QBENCHMARK {
+        result &= doc->exportDocumentSync(benchmarkFileName, benchmarkMimeType);
+    }
+
+    const qint64 peakMemory = processMemoryKiB("VmHWM");
+    QFile::remove(benchmarkFileName);
+
+    QVERIFY(result);
+
+    qDebug() << qPrintable(QString("Peak memory over the image data: %1 MiB")
+                           .arg((peakMemory - baseMemory) / 1024.0, 0, 'f', 1));
+}
+
+void KisPsdBenchmark::benchmarkLoad()
+{
+    {
+        QScopedPointer<KisDocument> doc(createBenchmarkDocument());
+        QVERIFY(doc->exportDocumentSync(benchmarkFileName, benchmarkMimeType));
+    }
+
+    const qint64 baseMemory = processMemoryKiB("VmRSS");
+    resetPeakMemory();
+
+    bool result = true;
+
+    QBENCHMARK {
+        QScopedPointer<KisDocument> doc(KisPart::instance()->createDocument());
+        doc->setFileBatchMode(true);
+
+        KisImportExportManager manager(doc.data());
+        result &= manager.importDocument(benchmarkFileName, QString()).isOk();
+
+        if (doc->image()) {
+            doc->image()->waitForDone();
+        }
+    }
+
+    const qint64 peakMemory = processMemoryKiB("VmHWM");
+    QFile::remove(benchmarkFileName);
+
+    QVERIFY(result);
+
+    qDebug() << qPrintable(QString("Peak memory: %1 MiB")
+                           .arg((peakMemory - baseMemory) / 1024.0, 0, 'f', 1));
+}
+
+KISTEST_MAIN(KisPsdBenchmark)
@@ -0,0 +1,22 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISPSDBENCHMARK_H
+#define KISPSDBENCHMARK_H
+
+#include <simpletest.h>
+
+class KisPsdBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+
+    void benchmarkSave();
+    void benchmarkLoad();
+};
+
+#endif // KISPSDBENCHMARK_H
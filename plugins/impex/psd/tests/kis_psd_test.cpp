@@ -26,6 +26,8 @@
 #include <kis_generator_layer.h>
 #include <kis_filter_configuration.h>
 #include <KisGlobalResourcesInterface.h>
+#include <kis_paint_layer.h>
+#include <kis_sequential_iterator.h>
 
 
 
@@ -508,6 +510,70 @@ void KisPSDTest::testSavingAllFormats()
 
 
 
+void KisPSDTest::testSaveLayersNotAlignedToTiles()
+{
+    /**
+     * The pixel data is read and written in bands of tile height,
+     * check that the layers crossing the bands' boundaries in all
+     * possible ways survive the roundtrip
+     */
+
+    const QRect imageRect(0, 0, 300, 250);
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    QSharedPointer<KisDocument> doc(KisPart::instance()->createDocument());
+    KisImageSP image = new KisImage(doc->createUndoStore(), imageRect.width(), imageRect.height(), cs, "psd bands test");
+    doc->setCurrentImage(image);
+
+    const QVector<QRect> layerRects({QRect(37, 13, 201, 170), QRect(0, 64, 300, 64), QRect(5, 127, 20, 2)});
+
+    for (int i = 0; i < layerRects.size(); i++) {
+        KisPaintLayerSP layer = new KisPaintLayer(image, QString("layer %1").arg(i), OPACITY_OPAQUE_U8, cs);
+
+        KisSequentialIterator it(layer->paintDevice(), layerRects[i]);
+        while (it.nextPixel()) {
+            quint8 *pixel = it.rawData();
+            pixel[0] = quint8(it.x() * 3 + i);
+            pixel[1] = quint8(it.y() * 5);
+            pixel[2] = quint8((it.x() / 7) & 0x1 ? 0 : 255);
+            pixel[3] = quint8(64 + (it.x() + it.y()) % 192);
+        }
+
+        image->addNode(layer, image->root());
+    }
+
+    image->initialRefreshGraph();
+    image->waitForDone();
+
+    doc->setFileBatchMode(true);
+    doc->setMimeType("image/vnd.adobe.photoshop");
+
+    QFileInfo dstFileInfo(QDir::currentPath() + '/' + "test_bands.psd");
+    QVERIFY(doc->exportDocumentSync(dstFileInfo.absoluteFilePath(), "image/vnd.adobe.photoshop"));
+
+    QSharedPointer<KisDocument> doc2 = openPsdDocument(dstFileInfo);
+    QVERIFY(doc2->image());
+
+    KisNodeSP srcNode = image->root()->firstChild();
+    KisNodeSP dstNode = doc2->image()->root()->firstChild();
+
+    for (int i = 0; i < layerRects.size(); i++) {
+        QVERIFY(srcNode);
+        QVERIFY(dstNode);
+
+        QByteArray srcBytes(imageRect.width() * imageRect.height() * cs->pixelSize(), 0);
+        QByteArray dstBytes(srcBytes.size(), 0);
+
+        srcNode->paintDevice()->readBytes(reinterpret_cast<quint8*>(srcBytes.data()), imageRect);
+        dstNode->paintDevice()->readBytes(reinterpret_cast<quint8*>(dstBytes.data()), imageRect);
+
+        QVERIFY(srcBytes == dstBytes);
+
+        srcNode = srcNode->nextSibling();
+        dstNode = dstNode->nextSibling();
+    }
+}
+
 void KisPSDTest::testImportFromWriteonly()
 {
     TestUtil::testImportFromWriteonly(PSDMimetype);
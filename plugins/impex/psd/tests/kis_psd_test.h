@@ -27,6 +27,8 @@ private Q_SLOTS:
 
     void testSaveLayerStylesWithPatternMulti();
 
+    void testSaveLayersNotAlignedToTiles();
+
     void testOpeningFromOpenCanvas();
     void testOpeningAllFormats();
     void testSavingAllFormats();
@@ -83,6 +83,7 @@ void KisTIFFOptionsWidget::setConfiguration(const KisPropertiesConfigurationSP c
     compressionLevelDeflate->setValue(cfg->getInt("deflate", 6));
     compressionLevelPixarLog->setValue(cfg->getInt("pixarlog", 6));
     chkSaveProfile->setChecked(cfg->getBool("saveProfile", true));
+    chkTiled->setChecked(cfg->getBool("tiled", false));
 
     {
         const QString colorDepthId =
@@ -127,6 +128,7 @@ KisPropertiesConfigurationSP KisTIFFOptionsWidget::configuration() const
     cfg->setProperty("deflate", compressionLevelDeflate->value());
     cfg->setProperty("pixarlog", compressionLevelPixarLog->value());
     cfg->setProperty("saveProfile", chkSaveProfile->isChecked());
+    cfg->setProperty("tiled", chkTiled->isChecked());
 
     return cfg;
 }
@@ -5,15 +5,279 @@
  *  SPDX-License-Identifier: GPL-2.0-or-later
  */
 
+#include <QAtomicInt>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
 #include <KoColorModelStandardIdsUtils.h>
 #include <KoColorSpace.h>
 #include <KoColorSpaceRegistry.h>
 #include <KoID.h>
+#include <kis_assert.h>
+#include <kis_debug.h>
 #include <kis_iterator_ng.h>
+#include <kis_paint_device.h>
+#include <krita_utils.h>
 
 #include "kis_tiff_base_writer.h"
 #include "kis_tiff_converter.h"
 
+namespace
+{
+
+/**
+ * The number of rows per strip requested for the striped files. Strips
+ * of this height compress well and there are still enough of them to
+ * keep all the threads busy. libtiff adjusts the value if the codec has
+ * any requirements for the strip height (JPEG).
+ */
+const uint32_t requestedRowsPerStrip = 64;
+
+/**
+ * The size of the tiles of the tiled files, it should be a multiple of 16
+ */
+const uint32_t tiffTileSize = 256;
+
+/**
+ * The maximum amount of memory used for buffering the blocks of pixel
+ * data between converting and writing them
+ */
+const tmsize_t maxBatchBytes = 64 * 1024 * 1024;
+
+/**
+ * The codecs that compress every strip (or tile) independently of the
+ * others and keep no state in the directory, so the blocks can be
+ * compressed by separate libtiff handles and copied into the file as
+ * they are. JPEG is not on the list, because it shares the tables
+ * between the blocks.
+ */
+bool canEncodeInParallel(quint16 compressionType)
+{
+    return compressionType == COMPRESSION_LZW || compressionType == COMPRESSION_ADOBE_DEFLATE
+        || compressionType == COMPRESSION_DEFLATE || compressionType == COMPRESSION_PACKBITS
+        || compressionType == COMPRESSION_PIXARLOG;
+}
+
+/**
+ * The backend of a write-only in-memory libtiff handle. The compressed
+ * block is taken out with takeData() right after it has been written,
+ * so only one block is kept in memory at a time. Everything libtiff
+ * writes before the taken data (the header and its updates) is dropped.
+ */
+struct TiffMemorySink {
+    QByteArray data;
+    toff_t base = 0;
+    toff_t pos = 0;
+    toff_t size = 0;
+
+    QByteArray takeData()
+    {
+        QByteArray result;
+        std::swap(result, data);
+        base = size;
+        return result;
+    }
+
+    static tmsize_t read(thandle_t, void *, tmsize_t)
+    {
+        return 0;
+    }
+
+    static tmsize_t write(thandle_t handle, void *buf, tmsize_t count)
+    {
+        TiffMemorySink *sink = static_cast<TiffMemorySink *>(handle);
+        const toff_t end = sink->pos + static_cast<toff_t>(count);
+
+        if (end > sink->base) {
+            const toff_t skipped = sink->pos < sink->base ? sink->base - sink->pos : 0;
+            const toff_t offset = sink->pos + skipped - sink->base;
+            const toff_t copied = static_cast<toff_t>(count) - skipped;
+
+            if (offset + copied > static_cast<toff_t>(sink->data.size())) {
+                sink->data.resize(static_cast<int>(offset + copied));
+            }
+            std::memcpy(sink->data.data() + offset, static_cast<const char *>(buf) + skipped, copied);
+        }
+
+        sink->pos = end;
+        sink->size = qMax(sink->size, end);
+        return count;
+    }
+
+    static toff_t seek(thandle_t handle, toff_t offset, int whence)
+    {
+        TiffMemorySink *sink = static_cast<TiffMemorySink *>(handle);
+
+        switch (whence) {
+        case SEEK_SET:
+            sink->pos = offset;
+            break;
+        case SEEK_CUR:
+            sink->pos += offset;
+            break;
+        case SEEK_END:
+            sink->pos = sink->size + offset;
+            break;
+        }
+
+        return sink->pos;
+    }
+
+    static int close(thandle_t)
+    {
+        return 0;
+    }
+
+    static toff_t fileSize(thandle_t handle)
+    {
+        return static_cast<TiffMemorySink *>(handle)->size;
+    }
+
+    static int map(thandle_t, void **, toff_t *)
+    {
+        return 0;
+    }
+
+    static void unmap(thandle_t, void *, toff_t)
+    {
+    }
+};
+
+/**
+ * A private libtiff handle for compressing the blocks of the image in
+ * a worker thread. It has the same layout and compression settings as
+ * the destination file, so the compressed blocks can be written into the
+ * file with TIFFWriteRawStrip()/TIFFWriteRawTile().
+ */
+class TiffBlockEncoder
+{
+public:
+    bool init(TIFF *image, const KisTIFFOptions *options)
+    {
+        m_tiff.reset(TIFFClientOpen("memory",
+                                    "w",
+                                    &m_sink,
+                                    &TiffMemorySink::read,
+                                    &TiffMemorySink::write,
+                                    &TiffMemorySink::seek,
+                                    &TiffMemorySink::close,
+                                    &TiffMemorySink::fileSize,
+                                    &TiffMemorySink::map,
+                                    &TiffMemorySink::unmap));
+        if (!m_tiff) return false;
+
+        // drop the header
+        m_sink.takeData();
+
+        m_isTiled = TIFFIsTiled(image);
+
+        for (ttag_t tag : {TIFFTAG_IMAGEWIDTH, TIFFTAG_IMAGELENGTH}) {
+            uint32_t value = 0;
+            TIFFGetField(image, tag, &value);
+            TIFFSetField(m_tiff.get(), tag, value);
+        }
+
+        for (ttag_t tag : {TIFFTAG_BITSPERSAMPLE,
+                           TIFFTAG_SAMPLESPERPIXEL,
+                           TIFFTAG_PHOTOMETRIC,
+                           TIFFTAG_SAMPLEFORMAT,
+                           TIFFTAG_PLANARCONFIG}) {
+            uint16_t value = 0;
+            TIFFGetFieldDefaulted(image, tag, &value);
+            TIFFSetField(m_tiff.get(), tag, value);
+        }
+
+        uint16_t photometric = 0;
+        if (TIFFGetField(image, TIFFTAG_PHOTOMETRIC, &photometric) && photometric == PHOTOMETRIC_YCBCR) {
+            // the subsampling affects the size of the blocks
+            uint16_t hsubsampling = 1;
+            uint16_t vsubsampling = 1;
+            TIFFGetFieldDefaulted(image, TIFFTAG_YCBCRSUBSAMPLING, &hsubsampling, &vsubsampling);
+            TIFFSetField(m_tiff.get(), TIFFTAG_YCBCRSUBSAMPLING, hsubsampling, vsubsampling);
+        }
+
+        if (m_isTiled) {
+            for (ttag_t tag : {TIFFTAG_TILEWIDTH, TIFFTAG_TILELENGTH}) {
+                uint32_t value = 0;
+                TIFFGetField(image, tag, &value);
+                TIFFSetField(m_tiff.get(), tag, value);
+            }
+        } else {
+            uint32_t rowsPerStrip = 0;
+            TIFFGetField(image, TIFFTAG_ROWSPERSTRIP, &rowsPerStrip);
+            TIFFSetField(m_tiff.get(), TIFFTAG_ROWSPERSTRIP, rowsPerStrip);
+        }
+
+        KisTIFFBaseWriter::writeCompressionOptions(m_tiff.get(), options);
+
+        return true;
+    }
+
+    /**
+     * Compresses the block and returns the compressed data, an empty
+     * array is returned in case of an error
+     */
+    QByteArray encode(uint32_t block, quint8 *data, tmsize_t size)
+    {
+        const tmsize_t result = m_isTiled ? TIFFWriteEncodedTile(m_tiff.get(), block, data, size)
+                                          : TIFFWriteEncodedStrip(m_tiff.get(), block, data, size);
+
+        if (result < 0) {
+            m_sink.takeData();
+            return QByteArray();
+        }
+
+        return m_sink.takeData();
+    }
+
+private:
+    TiffMemorySink m_sink;
+    std::unique_ptr<TIFF, decltype(&TIFFClose)> m_tiff{nullptr, &TIFFClose};
+    bool m_isTiled = false;
+};
+
+/**
+ * Returns the number of color samples and their positions in the pixel
+ * for the color type of the file
+ */
+bool colorSamplesLayout(uint16_t color_type,
+                        uint16_t sample_format,
+                        uint8_t &nbcolorssamples,
+                        std::array<quint8, 5> &poses)
+{
+    switch (color_type) {
+    case PHOTOMETRIC_MINISBLACK:
+        nbcolorssamples = 1;
+        poses = {0, 1};
+        return true;
+    case PHOTOMETRIC_RGB:
+        nbcolorssamples = 3;
+        if (sample_format == SAMPLEFORMAT_IEEEFP) {
+            poses = {0, 1, 2, 3};
+        } else {
+            poses = {2, 1, 0, 3};
+        }
+        return true;
+    case PHOTOMETRIC_SEPARATED:
+        nbcolorssamples = 4;
+        poses = {0, 1, 2, 3, 4};
+        return true;
+    case PHOTOMETRIC_ICCLAB:
+    case PHOTOMETRIC_YCBCR:
+        nbcolorssamples = 3;
+        poses = {0, 1, 2, 3};
+        return true;
+    default:
+        return false;
+    }
+}
+
+} // namespace
+
 KisTIFFBaseWriter::KisTIFFBaseWriter(TIFF *image, KisTIFFOptions *options)
     : m_image(image)
     , m_options(options)
@@ -151,3 +415,165 @@ bool KisTIFFBaseWriter::copyDataToStrips(KisHLineConstIteratorSP it,
     }
     return false;
 }
+
+void KisTIFFBaseWriter::writeCompressionOptions(TIFF *image, const KisTIFFOptions *options)
+{
+    TIFFSetField(image, TIFFTAG_COMPRESSION, options->compressionType);
+    if (options->compressionType == COMPRESSION_JPEG) {
+        TIFFSetField(image, TIFFTAG_JPEGQUALITY, options->jpegQuality);
+    } else if (options->compressionType == COMPRESSION_ADOBE_DEFLATE) {
+        TIFFSetField(image, TIFFTAG_ZIPQUALITY, options->deflateCompress);
+    } else if (options->compressionType == COMPRESSION_PIXARLOG) {
+        TIFFSetField(image, TIFFTAG_PIXARLOGQUALITY, options->pixarLogCompress);
+    }
+
+    // Set the predictor
+    if (options->compressionType == COMPRESSION_LZW || options->compressionType == COMPRESSION_ADOBE_DEFLATE)
+        TIFFSetField(image, TIFFTAG_PREDICTOR, options->predictor);
+}
+
+bool KisTIFFBaseWriter::writePixelData(KisPaintDeviceSP dev,
+                                       uint32_t width,
+                                       uint32_t height,
+                                       uint32_t depth,
+                                       uint16_t sample_format,
+                                       uint16_t color_type)
+{
+    uint8_t nbcolorssamples = 0;
+    std::array<quint8, 5> poses;
+    if (!colorSamplesLayout(color_type, sample_format, nbcolorssamples, poses)) {
+        return false;
+    }
+
+    const bool isTiled = m_options->tiled;
+
+    uint32_t blockWidth = width;
+    uint32_t blockHeight = 0;
+
+    if (isTiled) {
+        blockWidth = tiffTileSize;
+        blockHeight = tiffTileSize;
+        TIFFSetField(image(), TIFFTAG_TILEWIDTH, blockWidth);
+        TIFFSetField(image(), TIFFTAG_TILELENGTH, blockHeight);
+    } else {
+        blockHeight = TIFFDefaultStripSize(image(), requestedRowsPerStrip);
+        TIFFSetField(image(), TIFFTAG_ROWSPERSTRIP, blockHeight);
+    }
+
+    const uint32_t numBlocks = isTiled ? TIFFNumberOfTiles(image()) : TIFFNumberOfStrips(image());
+    const tmsize_t blockSize = isTiled ? TIFFTileSize(image()) : TIFFStripSize(image());
+    const tmsize_t rowSize = isTiled ? TIFFTileRowSize(image()) : TIFFScanlineSize(image());
+
+    KIS_ASSERT_RECOVER_RETURN_VALUE(blockSize > 0 && rowSize > 0, false);
+
+    const uint32_t blocksPerRow = (width + blockWidth - 1) / blockWidth;
+
+    /**
+     * The blocks are converted (and compressed, if the codec allows that)
+     * in parallel in batches, and then written into the file serially in
+     * their natural order.
+     */
+    const bool encodeInParallel = canEncodeInParallel(m_options->compressionType);
+    const int batchSize =
+        static_cast<int>(qBound<tmsize_t>(1, maxBatchBytes / blockSize, 2 * KritaUtils::parallelForMaxThreads()));
+
+    QVector<QByteArray> blocks(batchSize);
+    QByteArray *blocksData = blocks.data();
+
+    /**
+     * Every thread needs its own encoder, they are created beforehand,
+     * because libtiff handles should not be accessed concurrently
+     */
+    QMutex encodersLock;
+    std::vector<std::unique_ptr<TiffBlockEncoder>> freeEncoders;
+
+    if (encodeInParallel) {
+        const int numEncoders = qMin(batchSize, KritaUtils::parallelForMaxThreads());
+
+        for (int i = 0; i < numEncoders; i++) {
+            std::unique_ptr<TiffBlockEncoder> encoder(new TiffBlockEncoder());
+            if (!encoder->init(image(), m_options)) {
+                warnFile << "Failed to initialize a TIFF encoder";
+                return false;
+            }
+            freeEncoders.push_back(std::move(encoder));
+        }
+    }
+
+    QAtomicInt failed(0);
+
+    for (uint32_t batchStart = 0; batchStart < numBlocks; batchStart += static_cast<uint32_t>(batchSize)) {
+        const int numItems = static_cast<int>(qMin(static_cast<uint32_t>(batchSize), numBlocks - batchStart));
+
+        KritaUtils::parallelFor(numItems, [&](int item) {
+            const uint32_t block = batchStart + static_cast<uint32_t>(item);
+            const uint32_t left = (block % blocksPerRow) * blockWidth;
+            const uint32_t top = (block / blocksPerRow) * blockHeight;
+            const uint32_t realWidth = qMin(blockWidth, width - left);
+            const uint32_t realHeight = qMin(blockHeight, height - top);
+
+            QByteArray &data = blocksData[item];
+
+            // tiles are always written in full, so pad them with zeros
+            data.fill(0, static_cast<int>(isTiled ? blockSize : realHeight * rowSize));
+            quint8 *dst = reinterpret_cast<quint8 *>(data.data());
+
+            for (uint32_t row = 0; row < realHeight; row++) {
+                KisHLineConstIteratorSP it = dev->createHLineConstIteratorNG(static_cast<int>(left),
+                                                                              static_cast<int>(top + row),
+                                                                              static_cast<int>(realWidth));
+                if (!copyDataToStrips(it, dst + row * rowSize, depth, sample_format, nbcolorssamples, poses)) {
+                    failed.storeRelease(1);
+                    return;
+                }
+            }
+
+            if (!encodeInParallel) return;
+
+            std::unique_ptr<TiffBlockEncoder> encoder;
+
+            {
+                QMutexLocker l(&encodersLock);
+                KIS_SAFE_ASSERT_RECOVER(!freeEncoders.empty()) {
+                    failed.storeRelease(1);
+                    return;
+                }
+                encoder = std::move(freeEncoders.back());
+                freeEncoders.pop_back();
+            }
+
+            data = encoder->encode(block, dst, data.size());
+            if (data.isEmpty()) {
+                failed.storeRelease(1);
+            }
+
+            QMutexLocker l(&encodersLock);
+            freeEncoders.push_back(std::move(encoder));
+        });
+
+        if (failed.loadAcquire()) {
+            return false;
+        }
+
+        for (int item = 0; item < numItems; item++) {
+            const uint32_t block = batchStart + static_cast<uint32_t>(item);
+            QByteArray &data = blocks[item];
+
+            tmsize_t result = 0;
+
+            if (encodeInParallel) {
+                result = isTiled ? TIFFWriteRawTile(image(), block, data.data(), data.size())
+                                 : TIFFWriteRawStrip(image(), block, data.data(), data.size());
+            } else {
+                result = isTiled ? TIFFWriteEncodedTile(image(), block, data.data(), data.size())
+                                 : TIFFWriteEncodedStrip(image(), block, data.data(), data.size());
+            }
+
+            if (result < 0) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
@@ -19,6 +19,13 @@ class KoColorSpace;
 
 class KisTIFFBaseWriter
 {
+public:
+    /**
+     * Sets the compression and the codec options of \p image according
+     * to \p options
+     */
+    static void writeCompressionOptions(TIFF *image, const KisTIFFOptions *options);
+
 protected:
     KisTIFFBaseWriter(TIFF*image, KisTIFFOptions* options);
     ~KisTIFFBaseWriter() = default;
@@ -42,6 +49,21 @@ protected:
                           uint8_t nbcolorssamples,
                           const std::array<quint8, 5> &poses);
 
+    /**
+     * Writes the pixels of \p dev into the current directory of the
+     * file. The layout (strips or tiles) is chosen according to the
+     * options, all the other fields should already be set.
+     *
+     * The pixel data is converted and compressed in several threads,
+     * the blocks are written into the file in their natural order.
+     */
+    bool writePixelData(KisPaintDeviceSP dev,
+                        uint32_t width,
+                        uint32_t height,
+                        uint32_t depth,
+                        uint16_t sample_format,
+                        uint16_t color_type);
+
     TIFF *m_image;
     KisTIFFOptions *m_options;
 };
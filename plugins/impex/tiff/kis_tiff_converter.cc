@@ -39,6 +39,7 @@ KisPropertiesConfigurationSP KisTIFFOptions::toProperties() const
     cfg->setProperty("deflate", deflateCompress);
     cfg->setProperty("pixarlog", pixarLogCompress);
     cfg->setProperty("saveProfile", saveProfile);
+    cfg->setProperty("tiled", tiled);
 
     return cfg;
 }
@@ -75,4 +76,5 @@ void KisTIFFOptions::fromProperties(KisPropertiesConfigurationSP cfg)
     deflateCompress = static_cast<quint16>(cfg->getInt("deflate", 6));
     pixarLogCompress = static_cast<quint16>(cfg->getInt("pixarlog", 6));
     saveProfile = cfg->getBool("saveProfile", true);
+    tiled = cfg->getBool("tiled", false);
 }
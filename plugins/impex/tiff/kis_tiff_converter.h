@@ -23,6 +23,7 @@ struct KisTIFFOptions {
     quint16 deflateCompress = 6;
     quint16 pixarLogCompress = 6;
     bool saveProfile = true;
+    bool tiled = false;
 
     KisPropertiesConfigurationSP toProperties() const;
     void fromProperties(KisPropertiesConfigurationSP cfg);
@@ -9,7 +9,9 @@
 #include "KisImportExportErrorCode.h"
 #include "kis_assert.h"
 
+#include <QAtomicInt>
 #include <QBuffer>
+#include <QFile>
 #include <QPair>
 #include <QSharedPointer>
 #include <QStack>
@@ -37,6 +39,7 @@
 #include <kis_paint_layer.h>
 #include <kis_transform_worker.h>
 #include <kis_transparency_mask.h>
+#include <krita_utils.h>
 
 #ifdef TIFF_HAS_PSD_TAGS
 #include <psd_resource_block.h>
@@ -312,6 +315,180 @@ makePostProcessor(uint32_t nbsamples, const QPair<QString, QString> &id)
     }
 }
 
+namespace
+{
+
+/**
+ * The minimal height of the bands the image is split into when reading
+ * it in parallel. The height of the bands is always aligned to the tiles
+ * of the paint device, so that different threads never write into the
+ * same tile.
+ */
+const uint32_t minBandHeight = 256;
+const uint32_t deviceTileSize = 64;
+
+/**
+ * A separate libtiff handle for the file, positioned at the same
+ * directory as the main one. libtiff handles cannot be shared between
+ * threads, so every decoding thread gets one of its own.
+ */
+struct TiffWorkerHandle {
+    QScopedPointer<QFile> file;
+    std::unique_ptr<TIFF, decltype(&TIFFCleanup)> tiff{nullptr, &TIFFCleanup};
+
+    bool open(const QString &fileName, tdir_t directory)
+    {
+        file.reset(new QFile(fileName));
+        if (!file->open(QFile::ReadOnly)) {
+            return false;
+        }
+
+        const QByteArray encodedFilename = QFile::encodeName(fileName);
+
+#ifdef Q_OS_WIN
+        const intptr_t handle = _get_osfhandle(file->handle());
+#else
+        const int handle = file->handle();
+#endif
+
+        tiff.reset(TIFFFdOpen(handle, encodedFilename.data(), "r"));
+        return tiff && TIFFSetDirectory(tiff.get(), directory);
+    }
+};
+
+/**
+ * Reads the pixel data of the current directory of \p image using several
+ * threads. The image is split into horizontal bands, and every thread
+ * decodes the strips (or tiles) of its band with its own libtiff handle
+ * and converts them into the paint device.
+ *
+ * A strip crossing the border of two bands is decoded by both of them,
+ * so the bands are made a few strips tall.
+ *
+ * Returns false if the image cannot be read this way, then nothing has
+ * been written into the device and the image should be read serially.
+ */
+bool readPixelDataInParallel(const QString &fileName,
+                             TIFF *image,
+                             KisTIFFReaderBase *tiffReader,
+                             uint32_t width,
+                             uint32_t height,
+                             uint16_t depth,
+                             uint16_t nbchannels,
+                             uint16_t planarconfig,
+                             const QVector<uint16_t> &lineSizeCoeffs)
+{
+    const bool isTiled = TIFFIsTiled(image);
+
+    uint32_t blockWidth = width;
+    uint32_t blockHeight = 0;
+
+    if (isTiled) {
+        TIFFGetField(image, TIFFTAG_TILEWIDTH, &blockWidth);
+        TIFFGetField(image, TIFFTAG_TILELENGTH, &blockHeight);
+    } else {
+        TIFFGetFieldDefaulted(image, TIFFTAG_ROWSPERSTRIP, &blockHeight);
+        blockHeight = qMin(blockHeight, height);
+    }
+
+    if (!blockWidth || !blockHeight) return false;
+
+    const tmsize_t blockSize = isTiled ? TIFFTileSize(image) : TIFFStripSize(image);
+    if (blockSize <= 0) return false;
+
+    const uint32_t bandHeight =
+        (qMax(minBandHeight, 4 * blockHeight) + deviceTileSize - 1) / deviceTileSize * deviceTileSize;
+    const int numBands = static_cast<int>((height + bandHeight - 1) / bandHeight);
+
+    const int numWorkers = qMin(numBands, KritaUtils::parallelForMaxThreads());
+    if (numWorkers < 2) return false;
+
+    QVector<QSharedPointer<TiffWorkerHandle>> handles;
+    for (int i = 0; i < numWorkers; i++) {
+        QSharedPointer<TiffWorkerHandle> handle(new TiffWorkerHandle());
+        if (!handle->open(fileName, TIFFCurrentDirectory(image))) {
+            dbgFile << "Failed to open a separate TIFF handle, reading the image serially";
+            return false;
+        }
+        handles.append(handle);
+    }
+
+    const int numPlanes = planarconfig == PLANARCONFIG_CONTIG ? 1 : nbchannels;
+    const tsize_t lineSize = blockSize / blockHeight;
+
+    QAtomicInt nextBand(0);
+
+    KritaUtils::parallelFor(numWorkers, [&](int worker) {
+        TIFF *tiff = handles[worker]->tiff.get();
+
+        QVector<QByteArray> planes(numPlanes);
+        QVector<uint8_t *> planePointers(numPlanes);
+        for (int i = 0; i < numPlanes; i++) {
+            planes[i].resize(static_cast<int>(blockSize));
+            planePointers[i] = reinterpret_cast<uint8_t *>(planes[i].data());
+        }
+
+        QSharedPointer<KisBufferStreamBase> tiffstream;
+
+        if (planarconfig == PLANARCONFIG_CONTIG) {
+            if (depth < 16) {
+                tiffstream = QSharedPointer<KisBufferStreamContigBelow16>::create(planePointers[0], depth, lineSize);
+            } else if (depth < 32) {
+                tiffstream = QSharedPointer<KisBufferStreamContigBelow32>::create(planePointers[0], depth, lineSize);
+            } else {
+                tiffstream = QSharedPointer<KisBufferStreamContigAbove32>::create(planePointers[0], depth, lineSize);
+            }
+        } else {
+            QVector<tsize_t> lineSizes(nbchannels);
+            for (uint16_t i = 0; i < nbchannels; i++) {
+                lineSizes[i] = lineSize / lineSizeCoeffs[i];
+            }
+            tiffstream = QSharedPointer<KisBufferStreamSeparate>::create(planePointers.data(),
+                                                                         nbchannels,
+                                                                         depth,
+                                                                         lineSizes.data());
+        }
+
+        int band = 0;
+        while ((band = nextBand.fetchAndAddOrdered(1)) < numBands) {
+            const uint32_t bandTop = static_cast<uint32_t>(band) * bandHeight;
+            const uint32_t bandBottom = qMin(bandTop + bandHeight, height);
+
+            for (uint32_t blockY = bandTop / blockHeight * blockHeight; blockY < bandBottom; blockY += blockHeight) {
+                const uint32_t firstRow = qMax(blockY, bandTop);
+                const uint32_t lastRow = qMin(blockY + blockHeight, bandBottom);
+
+                for (uint32_t x = 0; x < width; x += blockWidth) {
+                    for (int i = 0; i < numPlanes; i++) {
+                        if (isTiled) {
+                            const tsample_t sample =
+                                planarconfig == PLANARCONFIG_CONTIG ? (tsample_t)-1 : static_cast<tsample_t>(i);
+                            TIFFReadTile(tiff, planePointers[i], x, blockY, 0, sample);
+                        } else {
+                            TIFFReadEncodedStrip(tiff,
+                                                 TIFFComputeStrip(tiff, blockY, static_cast<tsample_t>(i)),
+                                                 planePointers[i],
+                                                 (tsize_t)-1);
+                        }
+                    }
+
+                    const uint32_t realBlockWidth = qMin(blockWidth, width - x);
+
+                    for (uint32_t y = firstRow; y < lastRow; y++) {
+                        tiffstream->moveToLine(y - blockY);
+                        tiffReader->copyDataToChannels(x, y, realBlockWidth, tiffstream);
+                    }
+                    tiffstream->restart();
+                }
+            }
+        }
+    });
+
+    return true;
+}
+
+} // namespace
+
 KisTIFFImport::KisTIFFImport(QObject *parent, const QVariantList &)
     : KisImportExportFilter(parent)
     , m_image(nullptr)
@@ -1051,7 +1228,21 @@ KisTIFFImport::readImageFromTiff(KisDocument *m_doc,
     }
 #endif
 
-    if (TIFFIsTiled(image)) {
+    const bool canReadInParallel = color_type != PHOTOMETRIC_YCBCR && !transform
+        && (planarconfig == PLANARCONFIG_CONTIG || planarconfig == PLANARCONFIG_SEPARATE);
+
+    if (canReadInParallel
+        && readPixelDataInParallel(filename(),
+                                   image,
+                                   tiffReader.data(),
+                                   width,
+                                   height,
+                                   depth,
+                                   nbchannels,
+                                   planarconfig,
+                                   lineSizeCoeffs)) {
+        dbgFile << "image data has been read in parallel";
+    } else if (TIFFIsTiled(image)) {
         dbgFile << "tiled image";
         uint32_t tileWidth = 0;
         uint32_t tileHeight = 0;
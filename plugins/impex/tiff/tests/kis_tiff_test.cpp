@@ -16,8 +16,17 @@
 #include <KoColor.h>
 
 #include <KoColorModelStandardIdsUtils.h>
+#include <KoColorSpaceRegistry.h>
+#include <KisDocument.h>
+#include <KisPart.h>
+#include <kis_image.h>
+#include <kis_layer_utils.h>
 #include <kis_meta_data_backend_registry.h>
+#include <kis_paint_layer.h>
+#include <kis_properties_configuration.h>
+#include <kis_sequential_iterator.h>
 #include <testui.h>
+#include <testing_benchmark_utils.h>
 
 #include <config-jpeg.h>
 
@@ -120,6 +129,90 @@ void KisTiffTest::testSaveTiffYCbCrAColorSpace()
                            profile);
 }
 
+void KisTiffTest::testRoundTripLayouts_data()
+{
+    QTest::addColumn<int>("compressionType");
+    QTest::addColumn<int>("predictor");
+    QTest::addColumn<bool>("tiled");
+
+    // the values are indexes of the export dialog, see KisTIFFOptions::fromProperties()
+    QTest::newRow("strips-none") << 0 << 0 << false;
+    QTest::newRow("strips-deflate") << 2 << 1 << false;
+    QTest::newRow("strips-lzw") << 3 << 1 << false;
+    QTest::newRow("tiles-none") << 0 << 0 << true;
+    QTest::newRow("tiles-deflate") << 2 << 1 << true;
+    QTest::newRow("tiles-lzw") << 3 << 0 << true;
+}
+
+void KisTiffTest::testRoundTripLayouts()
+{
+    QFETCH(int, compressionType);
+    QFETCH(int, predictor);
+    QFETCH(bool, tiled);
+
+    /**
+     * The image is large enough to be split into several bands
+     * and blocks, and its size is aligned neither to the strips
+     * nor to the tiles
+     */
+    const QRect imageRect(0, 0, 777, 1030);
+    const KoColorSpace *cs =
+        KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), Integer16BitsColorDepthID.id(), QString());
+
+    QScopedPointer<KisDocument> doc1(KisPart::instance()->createDocument());
+    KisImageSP image = new KisImage(doc1->createUndoStore(), imageRect.width(), imageRect.height(), cs, "tiff layout test");
+    doc1->setCurrentImage(image);
+
+    KisPaintLayerSP layer = new KisPaintLayer(image, "layer1", OPACITY_OPAQUE_U8, cs);
+
+    TestUtil::TestingRandomSequence random(12345);
+    KisSequentialIterator it(layer->paintDevice(), imageRect);
+    while (it.nextPixel()) {
+        quint16 *pixel = reinterpret_cast<quint16 *>(it.rawData());
+        pixel[0] = static_cast<quint16>(it.x() * 80);
+        pixel[1] = static_cast<quint16>(it.y() * 60);
+        pixel[2] = static_cast<quint16>(random.next() >> 16);
+        pixel[3] = 0xffff;
+    }
+
+    image->addNode(layer, image->root());
+    image->initialRefreshGraph();
+    image->waitForDone();
+
+    KisPropertiesConfigurationSP cfg = new KisPropertiesConfiguration();
+    cfg->setProperty("compressiontype", compressionType);
+    cfg->setProperty("predictor", predictor);
+    cfg->setProperty("alpha", true);
+    cfg->setProperty("flatten", true);
+    cfg->setProperty("tiled", tiled);
+
+    QTemporaryFile savedFile(QDir::tempPath() + QLatin1String("/krita_XXXXXX") + QLatin1String(".tif"));
+    savedFile.setAutoRemove(true);
+    savedFile.open();
+
+    const QString savedFileName(savedFile.fileName());
+
+    doc1->setFileBatchMode(true);
+    QVERIFY(doc1->exportDocumentSync(savedFileName, TiffMimetype.toLatin1(), cfg));
+
+    QScopedPointer<KisDocument> doc2(KisPart::instance()->createDocument());
+    doc2->setFileBatchMode(true);
+    QVERIFY(doc2->importDocument(savedFileName));
+    QVERIFY(doc2->image());
+
+    KisNodeSP loadedNode = doc2->image()->root()->firstChild();
+    QVERIFY(loadedNode);
+    QCOMPARE(loadedNode->paintDevice()->colorSpace()->colorDepthId(), Integer16BitsColorDepthID);
+
+    QByteArray srcBytes(imageRect.width() * imageRect.height() * cs->pixelSize(), 0);
+    QByteArray dstBytes(srcBytes.size(), 0);
+
+    layer->paintDevice()->readBytes(reinterpret_cast<quint8 *>(srcBytes.data()), imageRect);
+    loadedNode->paintDevice()->readBytes(reinterpret_cast<quint8 *>(dstBytes.data()), imageRect);
+
+    QVERIFY(srcBytes == dstBytes);
+}
+
 void KisTiffTest::testImportFromWriteonly()
 {
     TestUtil::testImportFromWriteonly(TiffMimetype);
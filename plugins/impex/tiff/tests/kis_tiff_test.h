@@ -22,6 +22,9 @@ private Q_SLOTS:
     void testSaveTiffLabColorSpace();
     void testSaveTiffYCbCrAColorSpace();
 
+    void testRoundTripLayouts_data();
+    void testRoundTripLayouts();
+
     void testImportFromWriteonly();
     void testExportToReadonly();
     void testImportIncorrectFormat();
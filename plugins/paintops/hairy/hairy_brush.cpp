@@ -93,7 +93,7 @@ void HairyBrush::fromDabWithDensity(KisFixedPaintDeviceSP dab, qreal density)
 }
 
 
-void HairyBrush::paintLine(KisPaintDeviceSP dab, KisPaintDeviceSP layer, const KisPaintInformation &pi1, const KisPaintInformation &pi2, qreal scale, qreal rotation)
+void HairyBrush::paintLine(KisPaintDeviceSP dab, KisFixedPaintDeviceSP batchDab, KisPaintDeviceSP layer, const KisPaintInformation &pi1, const KisPaintInformation &pi2, qreal scale, qreal rotation)
 {
     m_counter++;
 
@@ -126,6 +126,7 @@ void HairyBrush::paintLine(KisPaintDeviceSP dab, KisPaintDeviceSP layer, const K
     m_dabAccessor = dab->createRandomAccessorNG();
 
     m_dab = dab;
+    m_batchDab = batchDab;
 
     // initialization block
     if (firstStroke()) {
@@ -155,6 +156,16 @@ void HairyBrush::paintLine(KisPaintDeviceSP dab, KisPaintDeviceSP layer, const K
     int bristleCount = m_bristles.size();
     int bristlePathSize;
     qreal threshold = 1.0 - pi2.pressure();
+
+    /**
+     * First pass: move the bristles and collect the segments they
+     * should paint. It lets us know the bounds of the line before
+     * painting anything, so all the bristles can be painted into a
+     * single plain buffer instead of the dab's random accessor.
+     */
+    m_segments.clear();
+    QRectF segmentsBounds;
+
     for (int i = 0; i < bristleCount; i++) {
 
         if (!m_bristles.at(i)->enabled()) continue;
@@ -195,8 +206,22 @@ void HairyBrush::paintLine(KisPaintDeviceSP dab, KisPaintDeviceSP layer, const K
         fy2 += y2;
 
         if (m_properties->threshold && (bristle->length() < threshold)) continue;
+
+        const QPointF start(fx1, fy1);
+        const QPointF end(fx2, fy2);
+
+        m_segments.append({bristle, start, end});
+        segmentsBounds |= QRectF(start, end).normalized();
+    }
+
+    prepareBatchBuffer(segmentsBounds);
+
+    // Second pass: paint the collected segments
+    Q_FOREACH (const BristleSegment &segment, m_segments) {
+        bristle = segment.bristle;
+
         // paint between first and last dab
-        const QVector<QPointF> bristlePath = m_trajectory.getLinearTrajectory(QPointF(fx1, fy1), QPointF(fx2, fy2), 1.0);
+        const QVector<QPointF> bristlePath = m_trajectory.getLinearTrajectory(segment.start, segment.end, 1.0);
         bristlePathSize = m_trajectory.size();
 
         // avoid overlapping bristle caps with antialias on
@@ -231,10 +256,72 @@ void HairyBrush::paintLine(KisPaintDeviceSP dab, KisPaintDeviceSP layer, const K
         }
 
     }
+    m_segments.clear();
+    m_batchData = nullptr;
+    m_batchDab = nullptr;
     m_dab = nullptr;
     m_dabAccessor = nullptr;
 }
 
+void HairyBrush::prepareBatchBuffer(const QRectF &segmentsBounds)
+{
+    /**
+     * The trajectory may overshoot the end point a bit and the
+     * antialiased particles occupy one extra pixel to the right
+     * and to the bottom, so add some margins. If we still miss
+     * some pixel, it will be painted into the dab directly.
+     */
+    const int margin = 2;
+
+    /**
+     * Very long lines (e.g. when the stylus jumps over the canvas)
+     * are painted into the dab directly, we don't want to allocate
+     * huge buffers for a few thin bristle lines.
+     */
+    const qint64 maxBatchArea = 2048 * 2048;
+
+    m_batchRect = QRect();
+    m_batchData = nullptr;
+
+    if (!m_batchDab || m_segments.isEmpty()) {
+        if (m_batchDab) {
+            m_batchDab->setRect(QRect());
+        }
+        return;
+    }
+
+    const QRect rect = segmentsBounds.toAlignedRect().adjusted(-margin, -margin, margin, margin);
+
+    if (qint64(rect.width()) * rect.height() > maxBatchArea) {
+        m_batchDab->setRect(QRect());
+        return;
+    }
+
+    /**
+     * The batch dab is kept at the origin, because KisPainter::renderMirrorMask()
+     * reads the mirrored dab starting from (0,0). The position on the canvas is
+     * stored in m_batchRect.
+     */
+    const QRect dabRect(QPoint(), rect.size());
+    m_batchDab->setRect(dabRect);
+    m_batchDab->lazyGrowBufferWithoutInitialization();
+    m_batchDab->fill(dabRect, KoColor::createTransparent(m_batchDab->colorSpace()));
+
+    m_batchRect = rect;
+    m_batchData = m_batchDab->data();
+}
+
+inline quint8* HairyBrush::pixelPtr(int x, int y)
+{
+    if (m_batchRect.contains(x, y)) {
+        return m_batchData +
+            (qint64(y - m_batchRect.y()) * m_batchRect.width() + (x - m_batchRect.x())) * m_pixelSize;
+    }
+
+    m_dabAccessor->moveTo(x, y);
+    return m_dabAccessor->rawData();
+}
+
 
 inline qreal HairyBrush::fetchInkDepletion(Bristle* bristle, int inkDepletionSize)
 {
@@ -333,25 +420,17 @@ void HairyBrush::paintParticle(QPointF pos, const KoColor& color, qreal weight)
 
     const KoColorSpace * cs = m_dab->colorSpace();
 
-    m_dabAccessor->moveTo(ipx  , ipy);
-    btl = quint8(kisBoundFast<quint16>(OPACITY_TRANSPARENT_U8, btl + cs->opacityU8(m_dabAccessor->rawData()), OPACITY_OPAQUE_U8));
-    memcpy(m_dabAccessor->rawData(), color.data(), cs->pixelSize());
-    cs->setOpacity(m_dabAccessor->rawData(), btl, 1);
-
-    m_dabAccessor->moveTo(ipx + 1, ipy);
-    btr =  quint8(kisBoundFast<quint16>(OPACITY_TRANSPARENT_U8, btr + cs->opacityU8(m_dabAccessor->rawData()), OPACITY_OPAQUE_U8));
-    memcpy(m_dabAccessor->rawData(), color.data(), cs->pixelSize());
-    cs->setOpacity(m_dabAccessor->rawData(), btr, 1);
-
-    m_dabAccessor->moveTo(ipx, ipy + 1);
-    bbl = quint8(kisBoundFast<quint16>(OPACITY_TRANSPARENT_U8, bbl + cs->opacityU8(m_dabAccessor->rawData()), OPACITY_OPAQUE_U8));
-    memcpy(m_dabAccessor->rawData(), color.data(), cs->pixelSize());
-    cs->setOpacity(m_dabAccessor->rawData(), bbl, 1);
-
-    m_dabAccessor->moveTo(ipx + 1, ipy + 1);
-    bbr = quint8(kisBoundFast<quint16>(OPACITY_TRANSPARENT_U8, bbr + cs->opacityU8(m_dabAccessor->rawData()), OPACITY_OPAQUE_U8));
-    memcpy(m_dabAccessor->rawData(), color.data(), cs->pixelSize());
-    cs->setOpacity(m_dabAccessor->rawData(), bbr, 1);
+    auto addOpacity = [&] (int x, int y, quint8 value) {
+        quint8 *pixel = pixelPtr(x, y);
+        value = quint8(kisBoundFast<quint16>(OPACITY_TRANSPARENT_U8, value + cs->opacityU8(pixel), OPACITY_OPAQUE_U8));
+        memcpy(pixel, color.data(), m_pixelSize);
+        cs->setOpacity(pixel, value, 1);
+    };
+
+    addOpacity(ipx, ipy, btl);
+    addOpacity(ipx + 1, ipy, btr);
+    addOpacity(ipx, ipy + 1, bbl);
+    addOpacity(ipx + 1, ipy + 1, bbr);
 }
 
 void HairyBrush::paintParticle(QPointF pos, const KoColor& color)
@@ -386,15 +465,14 @@ void HairyBrush::paintParticle(QPointF pos, const KoColor& color)
 
 inline void HairyBrush::plotPixel(int wx, int wy, const KoColor &color)
 {
-    m_dabAccessor->moveTo(wx, wy);
-    m_compositeOp->composite(m_dabAccessor->rawData(), m_pixelSize, color.data() , m_pixelSize, 0, 0, 1, 1, OPACITY_OPAQUE_F);
+    m_compositeOp->composite(pixelPtr(wx, wy), m_pixelSize, color.data() , m_pixelSize, 0, 0, 1, 1, OPACITY_OPAQUE_F);
 }
 
 inline void HairyBrush::darkenPixel(int wx, int wy, const KoColor &color)
 {
-    m_dabAccessor->moveTo(wx, wy);
-    if (m_dab->colorSpace()->opacityU8(m_dabAccessor->rawData()) < color.opacityU8()) {
-        memcpy(m_dabAccessor->rawData(), color.data(), m_pixelSize);
+    quint8 *pixel = pixelPtr(wx, wy);
+    if (m_dab->colorSpace()->opacityU8(pixel) < color.opacityU8()) {
+        memcpy(pixel, color.data(), m_pixelSize);
     }
 }
 
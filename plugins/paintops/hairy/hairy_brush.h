@@ -16,6 +16,7 @@
 #include "bristle.h"
 
 #include <kis_paint_device.h>
+#include <kis_fixed_paint_device.h>
 #include <brushengine/kis_paint_information.h>
 #include <kis_random_accessor_ng.h>
 
@@ -60,7 +61,31 @@ public:
     HairyBrush();
     ~HairyBrush();
 
-    void paintLine(KisPaintDeviceSP dab, KisPaintDeviceSP layer, const KisPaintInformation &pi1, const KisPaintInformation &pi2, qreal scale, qreal rotation);
+    /**
+     * Paints the bristles moving from \p pi1 to \p pi2. The bristles are
+     * rendered into \p batchDab, which is resized to cover all the bristle
+     * segments of the line, so the caller should composite it into the layer
+     * with a single bltFixed() call. The batch dab always starts at the origin
+     * (as KisPainter::renderMirrorMask() expects), its position on the canvas
+     * is returned by batchRect(). The pixels that fall outside the batch
+     * buffer (or all of them, if the line is too long to be cached) are
+     * painted into \p dab, the caller should composite its extent as well.
+     *
+     * The bristles are plotted pixel by pixel with the color mixing of the
+     * ink depletion, so the batch buffer is filled with scalar code. Only
+     * the final composition of the buffer goes through the vectorized
+     * composite ops.
+     */
+    void paintLine(KisPaintDeviceSP dab, KisFixedPaintDeviceSP batchDab, KisPaintDeviceSP layer, const KisPaintInformation &pi1, const KisPaintInformation &pi2, qreal scale, qreal rotation);
+
+    /**
+     * \return the rect of the canvas covered by the batch dab of the last
+     * paintLine() call or an empty rect if the batch dab hasn't been used
+     */
+    QRect batchRect() const {
+        return m_batchRect;
+    }
+
     /// set ink color for the whole bristle shape
     void setInkColor(const KoColor &color) {
         m_color = color;
@@ -73,6 +98,18 @@ public:
     void fromDabWithDensity(KisFixedPaintDeviceSP dab, qreal density);
 
 private:
+    /// a part of the bristle path painted in the current paintLine() call
+    struct BristleSegment {
+        Bristle *bristle;
+        QPointF start;
+        QPointF end;
+    };
+
+    /// allocates the batch buffer covering all the segments or leaves it empty
+    void prepareBatchBuffer(const QRectF &segmentsBounds);
+    /// returns the pointer to the pixel either in the batch buffer or in the dab
+    quint8* pixelPtr(int x, int y);
+
     /// paints single bristle
     void addBristleInk(Bristle *bristle,const QPointF &pos, const KoColor &color);
     /// composite single pixel to dab
@@ -111,6 +148,12 @@ private:
     // temporary device
     KisPaintDeviceSP m_dab;
     KisRandomAccessorSP m_dabAccessor;
+
+    // local buffer where all the bristles of the current line are painted
+    KisFixedPaintDeviceSP m_batchDab;
+    quint8 *m_batchData {nullptr};
+    QRect m_batchRect;
+    QVector<BristleSegment> m_segments;
     const KoCompositeOp * m_compositeOp {nullptr};
     quint32 m_pixelSize {0};
 
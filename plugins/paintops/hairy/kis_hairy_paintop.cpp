@@ -120,6 +120,7 @@ void KisHairyPaintOp::paintLine(const KisPaintInformation &pi1, const KisPaintIn
 
     if (!m_dab) {
         m_dab = source()->createCompositionSourceDevice();
+        m_batchDab = new KisFixedPaintDevice(m_dab->colorSpace());
     }
     else {
         m_dab->clear();
@@ -147,12 +148,25 @@ void KisHairyPaintOp::paintLine(const KisPaintInformation &pi1, const KisPaintIn
     // during initialization), so we should just skip the distance info
     // update
 
-    m_brush.paintLine(m_dab, m_dev, pi1, pi, scale * m_hairyBristleOption.scaleFactor, mirrorFlip ? -rotation : rotation);
+    m_brush.paintLine(m_dab, m_batchDab, m_dev, pi1, pi, scale * m_hairyBristleOption.scaleFactor, mirrorFlip ? -rotation : rotation);
+
+    /**
+     * Most of the bristles are painted into the batch buffer, the dab
+     * contains only the pixels that didn't fit into it. The two sets
+     * of pixels never overlap, so the order of blitting doesn't matter.
+     */
+    const QRect batchRect = m_brush.batchRect();
+    if (!batchRect.isEmpty()) {
+        painter()->bltFixed(batchRect.topLeft(), m_batchDab, m_batchDab->bounds());
+        painter()->renderMirrorMask(batchRect, m_batchDab);
+    }
 
     //QRect rc = m_dab->exactBounds();
     QRect rc = m_dab->extent();
-    painter()->bitBlt(rc.topLeft(), m_dab, rc);
-    painter()->renderMirrorMask(rc, m_dab);
+    if (!rc.isEmpty()) {
+        painter()->bitBlt(rc.topLeft(), m_dab, rc);
+        painter()->renderMirrorMask(rc, m_dab);
+    }
 
     // we don't use spacing in hairy brush, but history is
     // still important for us
@@ -45,6 +45,7 @@ private:
     KisHairyInkOptionData m_hairyInkOption;
 
     KisPaintDeviceSP m_dab;
+    KisFixedPaintDeviceSP m_batchDab;
     KisPaintDeviceSP m_dev;
     HairyBrush m_brush;
     KisOpacityOption m_opacityOption;
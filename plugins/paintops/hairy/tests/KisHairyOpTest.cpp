@@ -0,0 +1,76 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisHairyOpTest.h"
+
+#include "kistest.h"
+
+#include <stroke_testing_utils.h>
+#include <brushengine/kis_paint_information.h>
+#include <kis_distance_information.h>
+#include <kis_canvas_resource_provider.h>
+#include <kis_resources_snapshot.h>
+#include <kis_image.h>
+#include <kis_paint_layer.h>
+#include <kis_painter.h>
+#include <KoCanvasResourcesIds.h>
+#include <KoColorSpaceRegistry.h>
+
+void KisHairyOpTest::testMirroring_data()
+{
+    QTest::addColumn<bool>("mirrorHorizontally");
+    QTest::addColumn<bool>("mirrorVertically");
+
+    QTest::addRow("horizontal") << true << false;
+    QTest::addRow("vertical") << false << true;
+    QTest::addRow("both") << true << true;
+}
+
+void KisHairyOpTest::testMirroring()
+{
+    QFETCH(bool, mirrorHorizontally);
+    QFETCH(bool, mirrorVertically);
+
+    const QRect imageRect(0, 0, 200, 200);
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "hairy mirroring test");
+    KisPaintLayerSP layer = new KisPaintLayer(image, "paint1", OPACITY_OPAQUE_U8);
+    image->addNode(layer);
+
+    QScopedPointer<KoCanvasResourceProvider> manager(
+        utils::createResourceManager(image, layer, "testing_hairy_100_bristles.kpp"));
+
+    KisResourcesSnapshotSP resources =
+        new KisResourcesSnapshot(image, layer, manager.data());
+
+    KisPainter gc(layer->paintDevice());
+    resources->setupPainter(&gc);
+    gc.setMirrorInformation(QPointF(100, 100), mirrorHorizontally, mirrorVertically);
+
+    /**
+     * The stroke stays in the top-left quadrant of the image, so the
+     * mirrored copies never overlap with it
+     */
+    KisDistanceInformation dist;
+    gc.paintLine(KisPaintInformation(QPointF(45, 45), 1.0),
+                 KisPaintInformation(QPointF(55, 55), 1.0),
+                 &dist);
+
+    QVERIFY(!layer->paintDevice()->exactBounds().isEmpty());
+
+    const QImage result = layer->paintDevice()->convertToQImage(0, imageRect);
+
+    if (mirrorHorizontally) {
+        QCOMPARE(result, result.mirrored(true, false));
+    }
+
+    if (mirrorVertically) {
+        QCOMPARE(result, result.mirrored(false, true));
+    }
+}
+
+KISTEST_MAIN(KisHairyOpTest)
@@ -0,0 +1,21 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISHAIRYOPTEST_H
+#define KISHAIRYOPTEST_H
+
+#include <QTest>
+
+class KisHairyOpTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+
+    void testMirroring();
+    void testMirroring_data();
+};
+
+#endif // KISHAIRYOPTEST_H
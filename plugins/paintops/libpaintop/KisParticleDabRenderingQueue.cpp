@@ -0,0 +1,158 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisParticleDabRenderingQueue.h"
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSharedPointer>
+
+#include <kis_paint_device.h>
+#include <kis_painter.h>
+#include <kis_default_bounds_base.h>
+#include <kis_image_config.h>
+#include <brushengine/kis_paintop_utils.h>
+
+#include <KisRunnableStrokeJobData.h>
+#include <KisRunnableStrokeJobUtils.h>
+
+
+struct KisParticleDabRenderingQueue::Private
+{
+    struct Dab {
+        QRect bounds;
+        qreal opacity = 1.0;
+        RenderFunc renderFunc;
+    };
+
+    struct UpdateSharedState {
+        QVector<Dab> dabs;
+        KisPaintDeviceSP device;
+        QElapsedTimer renderingTimer;
+    };
+    using UpdateSharedStateSP = QSharedPointer<UpdateSharedState>;
+
+    Private(KisPainter *_painter)
+        : painter(_painter),
+          idealNumRects(KisImageConfig(true).maxNumberOfThreads())
+    {
+    }
+
+    KisPainter *painter = 0;
+    const int idealNumRects;
+
+    const int minUpdatePeriod = 10;
+    const int maxUpdatePeriod = 100;
+    int currentUpdatePeriod = minUpdatePeriod;
+
+    mutable QMutex mutex;
+    QVector<Dab> dabsQueue;
+
+    UpdateSharedStateSP updateSharedState;
+};
+
+KisParticleDabRenderingQueue::KisParticleDabRenderingQueue(KisPainter *painter)
+    : m_d(new Private(painter))
+{
+}
+
+KisParticleDabRenderingQueue::~KisParticleDabRenderingQueue()
+{
+}
+
+void KisParticleDabRenderingQueue::addDab(const QRect &bounds, qreal opacity, RenderFunc func)
+{
+    if (bounds.isEmpty()) return;
+
+    QMutexLocker l(&m_d->mutex);
+    m_d->dabsQueue.append({bounds, opacity, func});
+}
+
+bool KisParticleDabRenderingQueue::hasDabs() const
+{
+    QMutexLocker l(&m_d->mutex);
+    return !m_d->dabsQueue.isEmpty();
+}
+
+std::pair<int, bool> KisParticleDabRenderingQueue::doAsynchronousUpdate(QVector<KisRunnableStrokeJobData*> &jobs)
+{
+    /**
+     * The previous update has not been completed yet, just
+     * wait for it to finish
+     */
+    if (m_d->updateSharedState) {
+        return std::make_pair(m_d->currentUpdatePeriod, hasDabs());
+    }
+
+    Private::UpdateSharedStateSP state(new Private::UpdateSharedState());
+
+    {
+        QMutexLocker l(&m_d->mutex);
+        std::swap(state->dabs, m_d->dabsQueue);
+    }
+
+    if (state->dabs.isEmpty()) {
+        return std::make_pair(m_d->currentUpdatePeriod, false);
+    }
+
+    m_d->updateSharedState = state;
+
+    KisPainter *painter = m_d->painter;
+    state->device = painter->device()->createCompositionSourceDevice();
+    state->renderingTimer.start();
+
+    /**
+     * In wraparound mode different patches may be mapped onto the same
+     * area of the device, so we cannot render them in parallel.
+     */
+    const bool canSplitDabs = !painter->device()->defaultBounds()->wrapAroundMode();
+
+    for (int i = 0; i < state->dabs.size(); i++) {
+        const QRect dabBounds = state->dabs[i].bounds;
+
+        const QVector<QRect> patches =
+            canSplitDabs ?
+                KisPaintOpUtils::splitParticlesIntoRects(dabBounds, m_d->idealNumRects) :
+                QVector<QRect>({dabBounds});
+
+        Q_FOREACH (const QRect &rc, patches) {
+            KritaUtils::addJobConcurrent(jobs,
+                [state, i, rc] () {
+                    state->dabs[i].renderFunc(state->device, rc);
+                }
+            );
+        }
+
+        KritaUtils::addJobSequential(jobs,
+            [state, i, painter] () {
+                const QRect rc = state->device->extent();
+
+                const qreal oldOpacity = painter->opacityF();
+                painter->setOpacityF(state->dabs[i].opacity);
+                painter->bitBlt(rc.topLeft(), state->device, rc);
+                painter->renderMirrorMask(rc, state->device);
+                painter->setOpacityF(oldOpacity);
+
+                state->device->clear();
+            }
+        );
+    }
+
+    KritaUtils::addJobSequential(jobs,
+        [this, state] () {
+            const int updateRenderingTime = state->renderingTimer.elapsed();
+
+            m_d->currentUpdatePeriod =
+                qBound(m_d->minUpdatePeriod, int(1.5 * updateRenderingTime), m_d->maxUpdatePeriod);
+
+            // release the particles and the device
+            m_d->updateSharedState.clear();
+        }
+    );
+
+    return std::make_pair(m_d->currentUpdatePeriod, false);
+}
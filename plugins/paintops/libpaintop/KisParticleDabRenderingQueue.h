@@ -0,0 +1,72 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISPARTICLEDABRENDERINGQUEUE_H
+#define KISPARTICLEDABRENDERINGQUEUE_H
+
+#include <QRect>
+#include <QScopedPointer>
+#include <QVector>
+
+#include <functional>
+
+#include "kis_types.h"
+#include "kritapaintop_export.h"
+
+class KisPainter;
+class KisRunnableStrokeJobData;
+
+/**
+ * A queue of dabs for the paintops that paint a lot of small independent
+ * particles per dab (spray, particle).
+ *
+ * In paintAt() the paintop only generates the particles and queues a
+ * rendering function for them with addDab(). The generation is cheap and
+ * happens serially, so the random sequence stays exactly the same as it
+ * would be in the single-threaded case.
+ *
+ * The actual rendering happens in doAsynchronousUpdate(): every queued dab
+ * is split into tile-aligned patches, which are rendered concurrently into
+ * a temporary device, and then the dab is composited onto the painter's
+ * device in a sequential job. The dabs are composited in the order they
+ * were added, so the result doesn't depend on the number of threads.
+ *
+ * NOTE: the rendering function is called concurrently for different patches
+ *       of the same dab, so it must never write outside the requested patch.
+ */
+class PAINTOP_EXPORT KisParticleDabRenderingQueue
+{
+public:
+    /**
+     * Renders the part of the dab that falls inside \p patchRect into \p dst
+     */
+    using RenderFunc = std::function<void(KisPaintDeviceSP dst, const QRect &patchRect)>;
+
+public:
+    KisParticleDabRenderingQueue(KisPainter *painter);
+    ~KisParticleDabRenderingQueue();
+
+    /**
+     * Queue a dab covering \p bounds for rendering. The dab will be
+     * composited onto the painter's device with \p opacity
+     */
+    void addDab(const QRect &bounds, qreal opacity, RenderFunc func);
+
+    bool hasDabs() const;
+
+    /**
+     * Generates the jobs for rendering all the queued dabs. See
+     * KisPaintOp::doAsynchronousUpdate() for the meaning of the
+     * return value.
+     */
+    std::pair<int, bool> doAsynchronousUpdate(QVector<KisRunnableStrokeJobData*> &jobs);
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISPARTICLEDABRENDERINGQUEUE_H
@@ -18,6 +18,7 @@
 
 #include <kis_global.h>
 #include <kis_paint_device.h>
+#include <kis_default_bounds_base.h>
 #include <kis_painter.h>
 #include <kis_lod_transform.h>
 #include <kis_types.h>
@@ -26,6 +27,7 @@
 #include <brushengine/kis_paint_information.h>
 
 #include "KisParticleOpOptionData.h"
+#include <KisParticleDabRenderingQueue.h>
 
 #include "particle_brush.h"
 
@@ -33,6 +35,7 @@ KisParticlePaintOp::KisParticlePaintOp(const KisPaintOpSettingsSP settings, KisP
     : KisPaintOp(painter)
     , m_rateOption(settings.data())
     , m_first(true)
+    , m_renderingQueue(new KisParticleDabRenderingQueue(painter))
 {
     Q_UNUSED(image);
     Q_UNUSED(node);
@@ -83,22 +86,32 @@ void KisParticlePaintOp::doPaintLine(const KisPaintInformation &pi1, const KisPa
 {
     if (!painter()) return;
 
-    if (!m_dab) {
-        m_dab = source()->createCompositionSourceDevice();
-    }
-    else {
-        m_dab->clear();
-    }
-
-
     if (m_first) {
         m_particleBrush.setInitialPosition(pi1.pos());
         m_first = false;
     }
 
-    m_particleBrush.draw(m_dab, painter()->paintColor(), pi2.pos());
-    QRect rc = m_dab->extent();
+    QRect boundingRect;
 
-    painter()->bitBlt(rc.x(), rc.y(), m_dab, rc.x(), rc.y(), rc.width(), rc.height());
-    painter()->renderMirrorMask(rc, m_dab);
+    if (m_particleOpData.particleScaleX < 0 || m_particleOpData.particleScaleY < 0 || m_particleOpData.particleGravity < 0) {
+        boundingRect = source()->defaultBounds()->bounds();
+    }
+
+    /**
+     * The particles are moved serially, but painted in parallel
+     * patches in doAsynchronousUpdate()
+     */
+    const QVector<QPointF> positions = m_particleBrush.move(pi2.pos(), boundingRect);
+    const KoColor color = painter()->paintColor();
+    const qreal weight = m_particleOpData.particleWeight;
+
+    m_renderingQueue->addDab(ParticleBrush::particlesBounds(positions), painter()->opacityF(),
+        [positions, color, weight] (KisPaintDeviceSP dst, const QRect &patchRect) {
+            ParticleBrush::paintParticles(dst, positions, color, weight, patchRect);
+        });
+}
+
+std::pair<int, bool> KisParticlePaintOp::doAsynchronousUpdate(QVector<KisRunnableStrokeJobData *> &jobs)
+{
+    return m_renderingQueue->doAsynchronousUpdate(jobs);
 }
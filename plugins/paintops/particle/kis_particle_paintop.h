@@ -7,6 +7,8 @@
 #ifndef KIS_PARTICLE_PAINTOP_H_
 #define KIS_PARTICLE_PAINTOP_H_
 
+#include <QScopedPointer>
+
 #include <brushengine/kis_paintop.h>
 #include <kis_types.h>
 #include <KisAirbrushOptionData.h>
@@ -17,6 +19,8 @@
 
 class KisPainter;
 class KisPaintInformation;
+class KisParticleDabRenderingQueue;
+class KisRunnableStrokeJobData;
 
 class KisParticlePaintOp : public KisPaintOp
 {
@@ -28,6 +32,8 @@ public:
 
     void paintLine(const KisPaintInformation &pi1, const KisPaintInformation &pi2, KisDistanceInformation *currentDistance) override;
 
+    std::pair<int, bool> doAsynchronousUpdate(QVector<KisRunnableStrokeJobData *> &jobs) override;
+
 protected:
     KisSpacingInformation paintAt(const KisPaintInformation& info) override;
 
@@ -40,11 +46,11 @@ private:
 
 private:
     KisParticleOpOptionData m_particleOpData;
-    KisPaintDeviceSP m_dab;
     ParticleBrush m_particleBrush;
     KisAirbrushOptionData m_airbrushData;
     KisRateOption m_rateOption;
     bool m_first;
+    QScopedPointer<KisParticleDabRenderingQueue> m_renderingQueue;
 };
 
 #endif // KIS_PARTICLE_PAINTOP_H_
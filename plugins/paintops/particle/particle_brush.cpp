@@ -45,7 +45,7 @@ void ParticleBrush::setInitialPosition(const QPointF &pos)
 }
 
 
-void ParticleBrush::paintParticle(KisRandomAccessorSP accWrite, const KoColorSpace * cs, const QPointF &pos, const KoColor& color, qreal weight, bool respectOpacity)
+void ParticleBrush::paintParticle(KisRandomAccessorSP accWrite, const KoColorSpace * cs, const QPointF &pos, const KoColor& color, qreal weight, bool respectOpacity, const QRect &patchRect)
 {
     // opacity top left, right, bottom left, right
     KoColor myColor(color);
@@ -61,36 +61,27 @@ void ParticleBrush::paintParticle(KisRandomAccessorSP accWrite, const KoColorSpa
     quint8 bbl = qRound((1.0 - fx) * (fy)  * opacity * weight);
     quint8 bbr = qRound((fx)  * (fy)  * opacity * weight);
 
-    accWrite->moveTo(ipx  , ipy);
-    myColor.setOpacity(quint8(kisBoundFast<quint16>(OPACITY_TRANSPARENT_U8, btl + cs->opacityU8(accWrite->rawData()), OPACITY_OPAQUE_U8)));
-    memcpy(accWrite->rawData(), myColor.data(), cs->pixelSize());
+    auto addOpacity = [&] (int x, int y, quint8 opacity) {
+        if (!patchRect.isEmpty() && !patchRect.contains(x, y)) return;
 
-    accWrite->moveTo(ipx + 1, ipy);
-    myColor.setOpacity(quint8(kisBoundFast<quint16>(OPACITY_TRANSPARENT_U8, btr + cs->opacityU8(accWrite->rawData()), OPACITY_OPAQUE_U8)));
-    memcpy(accWrite->rawData(), myColor.data(), cs->pixelSize());
+        accWrite->moveTo(x, y);
+        myColor.setOpacity(quint8(kisBoundFast<quint16>(OPACITY_TRANSPARENT_U8, opacity + cs->opacityU8(accWrite->rawData()), OPACITY_OPAQUE_U8)));
+        memcpy(accWrite->rawData(), myColor.data(), cs->pixelSize());
+    };
 
-    accWrite->moveTo(ipx, ipy + 1);
-    myColor.setOpacity(quint8(kisBoundFast<quint16>(OPACITY_TRANSPARENT_U8, bbl + cs->opacityU8(accWrite->rawData()), OPACITY_OPAQUE_U8)));
-    memcpy(accWrite->rawData(), myColor.data(), cs->pixelSize());
-
-    accWrite->moveTo(ipx + 1, ipy + 1);
-    myColor.setOpacity(quint8(kisBoundFast<quint16>(OPACITY_TRANSPARENT_U8, bbr + cs->opacityU8(accWrite->rawData()), OPACITY_OPAQUE_U8)));
-    memcpy(accWrite->rawData(), myColor.data(), cs->pixelSize());
+    addOpacity(ipx, ipy, btl);
+    addOpacity(ipx + 1, ipy, btr);
+    addOpacity(ipx, ipy + 1, bbl);
+    addOpacity(ipx + 1, ipy + 1, bbr);
 }
 
 
 
 
-void ParticleBrush::draw(KisPaintDeviceSP dab, const KoColor& color, const QPointF &pos)
+QVector<QPointF> ParticleBrush::move(const QPointF &pos, const QRect &boundingRect)
 {
-    KisRandomAccessorSP accessor = dab->createRandomAccessorNG();
-    const KoColorSpace * cs = dab->colorSpace();
-
-    QRect boundingRect;
-
-    if (m_properties->particleScaleX < 0 || m_properties->particleScaleY < 0 || m_properties->particleGravity < 0) {
-        boundingRect = dab->defaultBounds()->bounds();
-    }
+    QVector<QPointF> positions;
+    positions.reserve(m_properties->particleIterations * m_properties->particleCount);
 
     for (int i = 0; i < m_properties->particleIterations; i++) {
         for (int j = 0; j < m_properties->particleCount; j++) {
@@ -134,6 +125,11 @@ void ParticleBrush::draw(KisPaintDeviceSP dab, const KoColor& color, const QPoin
             //  and then it will be passed to the lockless hashtable
             //  and then it will crash.
             // Hence better to catch infinity here and just not paint anything.
+            //
+            // The points near infinity are skipped even when there is no
+            // bounding rect. They cannot be converted into integer pixel
+            // coordinates, and they would blow up particlesBounds(), which
+            // defines the patches the particles are rendered in.
             QPointF pointF = m_particlePos[j];
 
             const qint32 max = 2147483600;
@@ -141,12 +137,43 @@ void ParticleBrush::draw(KisPaintDeviceSP dab, const KoColor& color, const QPoin
             bool nearInfinity = pointF.x() < min || pointF.x () > max || pointF.y() < min || pointF.y() > max;
             bool inside = boundingRect.contains(m_particlePos[j].toPoint());
 
-            if (boundingRect.isEmpty() || (inside && !nearInfinity)) {
-                paintParticle(accessor, cs, m_particlePos[j], color, m_properties->particleWeight, true);
+            if (!nearInfinity && (boundingRect.isEmpty() || inside)) {
+                positions.append(m_particlePos[j]);
             }
 
         }//for j
     }//for i
+
+    return positions;
+}
+
+void ParticleBrush::paintParticles(KisPaintDeviceSP dab, const QVector<QPointF> &positions,
+                                   const KoColor& color, qreal weight,
+                                   const QRect &patchRect)
+{
+    KisRandomAccessorSP accessor = dab->createRandomAccessorNG();
+    const KoColorSpace * cs = dab->colorSpace();
+
+    Q_FOREACH (const QPointF &pos, positions) {
+        if (!patchRect.isEmpty() &&
+            !QRect(int(floor(pos.x())), int(floor(pos.y())), 2, 2).intersects(patchRect)) {
+
+            continue;
+        }
+
+        paintParticle(accessor, cs, pos, color, weight, true, patchRect);
+    }
+}
+
+QRect ParticleBrush::particlesBounds(const QVector<QPointF> &positions)
+{
+    QRect bounds;
+
+    Q_FOREACH (const QPointF &pos, positions) {
+        bounds |= QRect(int(floor(pos.x())), int(floor(pos.y())), 2, 2);
+    }
+
+    return bounds;
 }
 
 
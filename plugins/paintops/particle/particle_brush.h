@@ -37,7 +37,33 @@ public:
     ParticleBrush();
     ~ParticleBrush();
     void initParticles();
-    void draw(KisPaintDeviceSP dab, const KoColor& color, const QPointF &pos);
+
+    /**
+     * Moves the particles towards \p pos and returns the positions where the
+     * particles should be painted, in the order of painting. When
+     * \p boundingRect is not empty, the positions outside it are skipped.
+     * The positions that went out of the integer range (which may happen
+     * with negative scale or gravity) are always skipped.
+     */
+    QVector<QPointF> move(const QPointF &pos, const QRect &boundingRect);
+
+    /**
+     * Paints the particles at \p positions. Only the pixels inside
+     * \p patchRect are touched (if it is not empty), so different
+     * patches of the same dab can be painted concurrently.
+     *
+     * The particles accumulate the opacity of the destination pixel, which
+     * is a commutative operation, so the result doesn't depend on the
+     * order of patches.
+     */
+    static void paintParticles(KisPaintDeviceSP dab, const QVector<QPointF> &positions,
+                               const KoColor& color, qreal weight,
+                               const QRect &patchRect = QRect());
+
+    /**
+     * The bounding rect of the pixels touched by the particles at \p positions
+     */
+    static QRect particlesBounds(const QVector<QPointF> &positions);
 
     void setInitialPosition(const QPointF &pos);
     void setProperties(KisParticleOpOptionData * properties) {
@@ -47,7 +73,7 @@ public:
 private:
     /// paints wu particle, similar to spray version but you can turn on respecting opacity of the tool and add weight to opacity
     /// also the particle respects opacity in the destination pixel buffer
-    void paintParticle(KisRandomAccessorSP writeAccessor, const KoColorSpace *cs,const QPointF &pos, const KoColor& color, qreal weight, bool respectOpacity);
+    static void paintParticle(KisRandomAccessorSP writeAccessor, const KoColorSpace *cs,const QPointF &pos, const KoColor& color, qreal weight, bool respectOpacity, const QRect &patchRect);
 
     QVector<QPointF> m_particlePos;
     QVector<QPointF> m_particleNextPos;
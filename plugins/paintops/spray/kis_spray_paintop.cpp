@@ -22,6 +22,7 @@
 #include <kis_lod_transform.h>
 #include <kis_paintop_plugin_utils.h>
 #include <KoResourceLoadResult.h>
+#include <KisParticleDabRenderingQueue.h>
 
 
 KisSprayPaintOp::KisSprayPaintOp(const KisPaintOpSettingsSP settings, KisPainter *painter, KisNodeSP node, KisImageSP image)
@@ -63,6 +64,14 @@ KisSprayPaintOp::KisSprayPaintOp(const KisPaintOpSettingsSP settings, KisPainter
 
     m_sprayBrush.setFixedDab(cachedDab());
 
+    /**
+     * Simple particles are rendered in parallel patches in
+     * doAsynchronousUpdate(), see KisSprayPaintOpSettings::needsAsynchronousUpdates()
+     */
+    if (m_isPresetValid && SprayBrush::supportsDeferredRendering(m_shapeProperties, m_colorProperties)) {
+        m_renderingQueue.reset(new KisParticleDabRenderingQueue(painter));
+    }
+
     // spacing
     if ((m_sprayOpOption.data.diameter * 0.5) > 1) {
         m_ySpacing = m_xSpacing = m_sprayOpOption.data.diameter * 0.5 * m_sprayOpOption.data.spacing;
@@ -92,7 +101,12 @@ KisSpacingInformation KisSprayPaintOp::paintAt(const KisPaintInformation& info)
     if (!m_dab) {
         m_dab = source()->createCompositionSourceDevice();
     }
-    else {
+    else if (!m_renderingQueue) {
+        /**
+         * The deferred particles are rendered by the queue, so the
+         * dab stays empty and only gives the brush its color space.
+         * There is no need to clear it on every paintAt().
+         */
         m_dab->clear();
     }
 
@@ -103,6 +117,25 @@ KisSpacingInformation KisSprayPaintOp::paintAt(const KisPaintInformation& info)
     const qreal scale = m_sizeOption.apply(info);
     const qreal lodScale = KisLodTransform::lodToScale(painter()->device());
 
+    if (m_renderingQueue) {
+        QSharedPointer<SprayParticleDab> particles(new SprayParticleDab());
+
+        m_sprayBrush.paint(m_dab,
+                           m_node->paintDevice(),
+                           info,
+                           rotation,
+                           scale, lodScale,
+                           painter()->paintColor(),
+                           painter()->backgroundColor(),
+                           particles.data());
+
+        m_renderingQueue->addDab(particles->bounds, painter()->opacityF(),
+            [particles] (KisPaintDeviceSP dst, const QRect &patchRect) {
+                SprayBrush::renderParticles(*particles, dst, patchRect);
+            });
+
+        return computeSpacing(info, lodScale);
+    }
 
     m_sprayBrush.paint(m_dab,
                        m_node->paintDevice(),
@@ -119,6 +152,13 @@ KisSpacingInformation KisSprayPaintOp::paintAt(const KisPaintInformation& info)
     return computeSpacing(info, lodScale);
 }
 
+std::pair<int, bool> KisSprayPaintOp::doAsynchronousUpdate(QVector<KisRunnableStrokeJobData *> &jobs)
+{
+    return m_renderingQueue ?
+        m_renderingQueue->doAsynchronousUpdate(jobs) :
+        KisPaintOp::doAsynchronousUpdate(jobs);
+}
+
 KisSpacingInformation KisSprayPaintOp::updateSpacingImpl(const KisPaintInformation &info) const
 {
     return computeSpacing(info, KisLodTransform::lodToScale(painter()->device()));
@@ -7,6 +7,8 @@
 #ifndef KIS_SPRAY_PAINTOP_H_
 #define KIS_SPRAY_PAINTOP_H_
 
+#include <QScopedPointer>
+
 #include <brushengine/kis_paintop.h>
 #include <kis_types.h>
 
@@ -22,6 +24,8 @@
 
 
 class KisPainter;
+class KisParticleDabRenderingQueue;
+class KisRunnableStrokeJobData;
 
 
 class KisSprayPaintOp : public KisPaintOp
@@ -34,6 +38,8 @@ public:
 
     static QList<KoResourceLoadResult> prepareLinkedResources(const KisPaintOpSettingsSP settings, KisResourcesInterfaceSP resourcesInterface);
 
+    std::pair<int, bool> doAsynchronousUpdate(QVector<KisRunnableStrokeJobData *> &jobs) override;
+
 protected:
 
     KisSpacingInformation paintAt(const KisPaintInformation& info) override;
@@ -63,6 +69,8 @@ private:
     KisOpacityOption m_opacityOption;
     KisRateOption m_rateOption;
     KisNodeSP m_node;
+
+    QScopedPointer<KisParticleDabRenderingQueue> m_renderingQueue;
 };
 
 #endif // KIS_SPRAY_PAINTOP_H_
@@ -28,6 +28,7 @@
 #include <brushengine/kis_paint_information.h>
 #include <kis_fixed_paint_device.h>
 #include <kis_cross_device_color_sampler.h>
+#include <kis_assert.h>
 
 #include "kis_spray_paintop_settings.h"
 
@@ -36,6 +37,50 @@
 
 #include <QtGlobal>
 
+namespace {
+
+QRect particleBounds(const QPointF &center, qreal radius)
+{
+    return QRectF(center.x() - radius, center.y() - radius,
+                  2.0 * radius, 2.0 * radius).toAlignedRect().adjusted(-1, -1, 1, 1);
+}
+
+template <typename PixelWriter>
+void paintWuParticle(const KoColor &color, qreal rx, qreal ry, PixelWriter writePixel)
+{
+    // opacity top left, right, bottom left, right
+    KoColor pcolor(color);
+    //int opacity = pcolor.opacityU8();
+
+    int ipx = int (rx);
+    int ipy = int (ry);
+    qreal fx = rx - ipx;
+    qreal fy = ry - ipy;
+
+    qreal btl = (1 - fx) * (1 - fy);
+    qreal btr = (fx)  * (1 - fy);
+    qreal bbl = (1 - fx) * (fy);
+    qreal bbr = (fx)  * (fy);
+
+    // this version overwrite pixels, e.g. when it sprays two particle next
+    // to each other, the pixel with lower opacity can override other pixel.
+    // Maybe some kind of compositing using here would be cool
+
+    pcolor.setOpacity(btl);
+    writePixel(ipx, ipy, pcolor);
+
+    pcolor.setOpacity(btr);
+    writePixel(ipx + 1, ipy, pcolor);
+
+    pcolor.setOpacity(bbl);
+    writePixel(ipx, ipy + 1, pcolor);
+
+    pcolor.setOpacity(bbr);
+    writePixel(ipx + 1, ipy + 1, pcolor);
+}
+
+}
+
 SprayBrush::SprayBrush()
 {
     m_painter = nullptr;
@@ -93,15 +138,28 @@ void SprayBrush::paint(KisPaintDeviceSP dab, KisPaintDeviceSP source,
                        const KisPaintInformation& info,
                        qreal rotation, qreal scale,
                        qreal additionalScale,
-                       const KoColor &color, const KoColor &bgColor)
+                       const KoColor &color, const KoColor &bgColor,
+                       SprayParticleDab *deferredDab)
 {
+    KIS_SAFE_ASSERT_RECOVER(!deferredDab || supportsDeferredRendering(*m_shapeProperties, *m_colorProperties)) {
+        deferredDab = nullptr;
+    }
+
     if (m_sprayOpOption->data.angularDistributionType == KisSprayOpOptionData::ParticleDistribution_Uniform) {
-        paintImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor, m_sprayOpOption->m_uniformDistribution);
+        paintImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor, deferredDab, m_sprayOpOption->m_uniformDistribution);
     } else {
-        paintImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor, m_sprayOpOption->m_angularCurveBasedDistribution);
+        paintImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor, deferredDab, m_sprayOpOption->m_angularCurveBasedDistribution);
     }
 }
 
+bool SprayBrush::supportsDeferredRendering(const KisSprayShapeOptionData &shapeProperties,
+                                           const KisColorOptionData &colorProperties)
+{
+    return shapeProperties.enabled &&
+        shapeProperties.shape <= 3 &&
+        !colorProperties.sampleInputColor;
+}
+
 template <typename AngularDistribution>
 void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
                            const KisPaintInformation& info,
@@ -109,29 +167,30 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
                            qreal additionalScale,
                            const KoColor &color,
                            const KoColor &bgColor,
+                           SprayParticleDab *deferredDab,
                            const AngularDistribution &angularDistribution)
 {
     if (m_sprayOpOption->data.radialDistributionType == KisSprayOpOptionData::ParticleDistribution_Uniform) {
         if (m_sprayOpOption->data.radialDistributionCenterBiased) {
-            paintImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor,
+            paintImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor, deferredDab,
                       angularDistribution, m_sprayOpOption->m_uniformDistribution);
         } else {
-            paintImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor,
+            paintImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor, deferredDab,
                       angularDistribution, m_sprayOpOption->m_uniformDistributionPolarDistance);
         }
     } else if (m_sprayOpOption->data.radialDistributionType == KisSprayOpOptionData::ParticleDistribution_Gaussian) {
         if (m_sprayOpOption->data.radialDistributionCenterBiased) {
-            paintImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor,
+            paintImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor, deferredDab,
                       angularDistribution, m_sprayOpOption->m_normalDistribution);
         } else {
-            paintImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor,
+            paintImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor, deferredDab,
                       angularDistribution, m_sprayOpOption->m_normalDistributionPolarDistance);
         }
     } else if (m_sprayOpOption->data.radialDistributionType == KisSprayOpOptionData::ParticleDistribution_ClusterBased) {
-        paintImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor,
+        paintImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor, deferredDab,
                   angularDistribution, m_sprayOpOption->m_clusterBasedDistributionPolarDistance);
     } else {
-        paintImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor,
+        paintImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor, deferredDab,
                   angularDistribution, m_sprayOpOption->m_radialCurveBasedDistributionPolarDistance);
     }
 }
@@ -143,6 +202,7 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
                            qreal additionalScale,
                            const KoColor &color,
                            const KoColor &bgColor,
+                           SprayParticleDab *deferredDab,
                            const AngularDistribution &angularDistribution,
                            const RadialDistribution &radialDistribution)
 {
@@ -199,6 +259,27 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
         m_particlesCount = m_sprayOpOption->data.particleCount;
     }
 
+    if (deferredDab) {
+        deferredDab->shape = m_shapeProperties->shape;
+        deferredDab->isCircle = effectiveSize.width() == effectiveSize.height();
+        deferredDab->maskImageSize = effectiveSize;
+        deferredDab->particles.reserve(m_particlesCount);
+    }
+
+    auto deferParticle = [&] (const QPointF &pos, qreal width, qreal height, qreal angle, const QRect &bounds) {
+        SprayParticleDab::Particle particle;
+        particle.pos = pos;
+        particle.width = width;
+        particle.height = height;
+        particle.rotation = angle;
+        particle.color = m_inkColor;
+        particle.opacity = m_painter->opacityF();
+        particle.bounds = bounds;
+
+        deferredDab->particles.append(particle);
+        deferredDab->bounds |= bounds;
+    };
+
     QHash<QString, QVariant> params;
     qreal nx, ny;
     int ix, iy;
@@ -211,7 +292,17 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
     bool shouldColor = true;
     if (m_colorProperties->fillBackground) {
         m_painter->setPaintColor(bgColor);
-        paintCircle(m_painter, x, y, m_radius);
+
+        if (deferredDab) {
+            deferredDab->fillBackground = true;
+            deferredDab->center = QPointF(x, y);
+            deferredDab->radius = m_radius;
+            deferredDab->backgroundColor = bgColor;
+            deferredDab->backgroundOpacity = m_painter->opacityF();
+            deferredDab->bounds |= particleBounds(deferredDab->center, m_radius);
+        } else {
+            paintCircle(m_painter, x, y, m_radius);
+        }
     }
 
     QTransform m;
@@ -310,7 +401,13 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
             // ellipse
             case 0:
             {
-                if (effectiveSize.width() == effectiveSize.height()){
+                if (deferredDab) {
+                    const qreal a = jitteredWidth * 0.5;
+                    const qreal b = deferredDab->isCircle ? a : jitteredHeight * 0.5;
+                    const QPointF pos(nx + x, ny + y);
+                    deferParticle(pos, a, b, rotationZ, particleBounds(pos, qMax(a, b)));
+                }
+                else if (effectiveSize.width() == effectiveSize.height()){
                     paintCircle(m_painter, nx + x, ny + y, jitteredWidth * 0.5);
                 }
                 else {
@@ -321,20 +418,38 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
             // rectangle
             case 1:
             {
-                paintRectangle(m_painter, nx + x, ny + y, qRound(jitteredWidth) , qRound(jitteredHeight), rotationZ);
+                if (deferredDab) {
+                    const qreal width = qRound(jitteredWidth);
+                    const qreal height = qRound(jitteredHeight);
+                    const QPointF pos(nx + x, ny + y);
+                    deferParticle(pos, width, height, rotationZ,
+                                  particleBounds(pos, 0.5 * std::sqrt(pow2(width) + pow2(height))));
+                } else {
+                    paintRectangle(m_painter, nx + x, ny + y, qRound(jitteredWidth) , qRound(jitteredHeight), rotationZ);
+                }
                 break;
             }
             // wu-particle
             case 2: {
-                paintParticle(accessor, m_inkColor, nx + x, ny + y);
+                if (deferredDab) {
+                    const QPointF pos(nx + x, ny + y);
+                    deferParticle(pos, 0.0, 0.0, 0.0, QRect(int(pos.x()), int(pos.y()), 2, 2));
+                } else {
+                    paintParticle(accessor, m_inkColor, nx + x, ny + y);
+                }
                 break;
             }
             // pixel
             case 3: {
                 ix = qRound(nx + x);
                 iy = qRound(ny + y);
-                accessor->moveTo(ix, iy);
-                memcpy(accessor->rawData(), m_inkColor.data(), m_dabPixelSize);
+
+                if (deferredDab) {
+                    deferParticle(QPointF(nx + x, ny + y), 0.0, 0.0, 0.0, QRect(ix, iy, 1, 1));
+                } else {
+                    accessor->moveTo(ix, iy);
+                    memcpy(accessor->rawData(), m_inkColor.data(), m_dabPixelSize);
+                }
                 break;
             }
             case 4: {
@@ -416,52 +531,80 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
 
 
 
-void SprayBrush::paintParticle(KisRandomAccessorSP &writeAccessor, const KoColor &color, qreal rx, qreal ry)
+void SprayBrush::renderParticles(const SprayParticleDab &dab, KisPaintDeviceSP dst, const QRect &patchRect)
 {
-    // opacity top left, right, bottom left, right
-    KoColor pcolor(color);
-    //int opacity = pcolor.opacityU8();
+    KisPainter painter(dst);
+    painter.setFillStyle(KisPainter::FillStyleForegroundColor);
+    painter.setMaskImageSize(dab.maskImageSize.width(), dab.maskImageSize.height());
+
+    if (dab.fillBackground) {
+        painter.setPaintColor(dab.backgroundColor);
+        painter.setOpacityF(dab.backgroundOpacity);
+        paintCircle(&painter, dab.center.x(), dab.center.y(), dab.radius, patchRect);
+    }
 
-    int ipx = int (rx);
-    int ipy = int (ry);
-    qreal fx = rx - ipx;
-    qreal fy = ry - ipy;
+    KisRandomAccessorSP accessor = dst->createRandomAccessorNG();
+    const int pixelSize = dst->pixelSize();
 
-    qreal btl = (1 - fx) * (1 - fy);
-    qreal btr = (fx)  * (1 - fy);
-    qreal bbl = (1 - fx) * (fy);
-    qreal bbr = (fx)  * (fy);
+    auto writePixel = [&] (int x, int y, const KoColor &color) {
+        if (!patchRect.contains(x, y)) return;
 
-    // this version overwrite pixels, e.g. when it sprays two particle next
-    // to each other, the pixel with lower opacity can override other pixel.
-    // Maybe some kind of compositing using here would be cool
+        accessor->moveTo(x, y);
+        memcpy(accessor->rawData(), color.data(), pixelSize);
+    };
 
-    pcolor.setOpacity(btl);
-    writeAccessor->moveTo(ipx  , ipy);
-    memcpy(writeAccessor->rawData(), pcolor.data(), m_dabPixelSize);
+    for (const SprayParticleDab::Particle &particle : dab.particles) {
+        if (!particle.bounds.intersects(patchRect)) continue;
 
-    pcolor.setOpacity(btr);
-    writeAccessor->moveTo(ipx + 1, ipy);
-    memcpy(writeAccessor->rawData(), pcolor.data(), m_dabPixelSize);
+        switch (dab.shape) {
+        case 0:
+            painter.setPaintColor(particle.color);
+            painter.setOpacityF(particle.opacity);
 
-    pcolor.setOpacity(bbl);
-    writeAccessor->moveTo(ipx, ipy + 1);
-    memcpy(writeAccessor->rawData(), pcolor.data(), m_dabPixelSize);
+            if (dab.isCircle) {
+                paintCircle(&painter, particle.pos.x(), particle.pos.y(), particle.width, patchRect);
+            } else {
+                paintEllipse(&painter, particle.pos.x(), particle.pos.y(),
+                             particle.width, particle.height, particle.rotation, patchRect);
+            }
+            break;
+        case 1:
+            painter.setPaintColor(particle.color);
+            painter.setOpacityF(particle.opacity);
+
+            paintRectangle(&painter, particle.pos.x(), particle.pos.y(),
+                           particle.width, particle.height, particle.rotation, patchRect);
+            break;
+        case 2:
+            paintWuParticle(particle.color, particle.pos.x(), particle.pos.y(), writePixel);
+            break;
+        case 3:
+            writePixel(qRound(particle.pos.x()), qRound(particle.pos.y()), particle.color);
+            break;
+        default:
+            break;
+        }
+    }
+}
 
-    pcolor.setOpacity(bbr);
-    writeAccessor->moveTo(ipx + 1, ipy + 1);
-    memcpy(writeAccessor->rawData(), pcolor.data(), m_dabPixelSize);
+void SprayBrush::paintParticle(KisRandomAccessorSP &writeAccessor, const KoColor &color, qreal rx, qreal ry)
+{
+    paintWuParticle(color, rx, ry,
+        [&] (int x, int y, const KoColor &pcolor) {
+            writeAccessor->moveTo(x, y);
+            memcpy(writeAccessor->rawData(), pcolor.data(), m_dabPixelSize);
+        });
 }
 
-void SprayBrush::paintCircle(KisPainter* painter, qreal x, qreal y, qreal radius)
+void SprayBrush::paintCircle(KisPainter* painter, qreal x, qreal y, qreal radius, const QRect &requestedRect)
 {
     QPainterPath path;
     path.addEllipse(QPointF(x,y),radius,radius);
-    painter->fillPainterPath(path);
+    painter->fillPainterPath(path, requestedRect);
 }
 
 
-void SprayBrush::paintEllipse(KisPainter* painter, qreal x, qreal y, qreal a, qreal b, qreal angle)
+void SprayBrush::paintEllipse(KisPainter* painter, qreal x, qreal y, qreal a, qreal b, qreal angle, const QRect &requestedRect)
 {
     QPainterPath path;
     path.addEllipse(QPointF(), a, b);
@@ -469,10 +612,10 @@ void SprayBrush::paintEllipse(KisPainter* painter, qreal x, qreal y, qreal a, qr
     t.translate(x, y);
     t.rotateRadians(angle);
     path = t.map(path);
-    painter->fillPainterPath(path);
+    painter->fillPainterPath(path, requestedRect);
 }
 
-void SprayBrush::paintRectangle(KisPainter* painter, qreal x, qreal y, qreal width, qreal height, qreal angle)
+void SprayBrush::paintRectangle(KisPainter* painter, qreal x, qreal y, qreal width, qreal height, qreal angle, const QRect &requestedRect)
 {
     QPainterPath path;
     path.addRect(QRectF(-0.5 * width, -0.5 * height, width, height));
@@ -480,7 +623,7 @@ void SprayBrush::paintRectangle(KisPainter* painter, qreal x, qreal y, qreal wid
     t.translate(x, y);
     t.rotateRadians(angle);
     path = t.map(path);
-    painter->fillPainterPath(path);
+    painter->fillPainterPath(path, requestedRect);
 }
 
 
@@ -28,6 +28,38 @@
 
 class KisPaintInformation;
 
+/**
+ * The particles of a single spray dab, generated by SprayBrush::paint()
+ * for deferred rendering. Every particle keeps the color and the opacity
+ * that were active when it was generated, so the dab can be rendered in
+ * patches in any order (see KisParticleDabRenderingQueue).
+ */
+struct SprayParticleDab
+{
+    struct Particle {
+        QPointF pos;
+        qreal width {0.0};
+        qreal height {0.0};
+        qreal rotation {0.0};
+        KoColor color;
+        qreal opacity {1.0};
+        QRect bounds;
+    };
+
+    quint8 shape {0};
+    bool isCircle {false};
+    QSize maskImageSize;
+
+    bool fillBackground {false};
+    QPointF center;
+    qreal radius {0.0};
+    KoColor backgroundColor;
+    qreal backgroundOpacity {1.0};
+
+    QVector<Particle> particles;
+    QRect bounds;
+};
+
 class SprayBrush
 {
 
@@ -35,6 +67,12 @@ public:
     SprayBrush();
     ~SprayBrush();
 
+    /**
+     * Paints the dab. If \p deferredDab is not null and the dab can be
+     * rendered deferred (see supportsDeferredRendering()), the particles
+     * are only generated and saved into \p deferredDab; the random source
+     * is consumed exactly in the same way as in the immediate mode.
+     */
     void paint(KisPaintDeviceSP dab,
                KisPaintDeviceSP source,
                const KisPaintInformation& info,
@@ -42,7 +80,22 @@ public:
                qreal scale,
                qreal additionalScale,
                const KoColor &color,
-               const KoColor &bgColor);
+               const KoColor &bgColor,
+               SprayParticleDab *deferredDab = nullptr);
+
+    /**
+     * Only simple shapes (ellipse, rectangle, anti-aliased pixel and pixel)
+     * that don't sample the color of the layer can be rendered deferred
+     */
+    static bool supportsDeferredRendering(const KisSprayShapeOptionData &shapeProperties,
+                                          const KisColorOptionData &colorProperties);
+
+    /**
+     * Renders the part of a deferred dab that falls inside \p patchRect.
+     * Never touches the pixels outside \p patchRect, so different patches
+     * of the same dab can be rendered concurrently.
+     */
+    static void renderParticles(const SprayParticleDab &dab, KisPaintDeviceSP dst, const QRect &patchRect);
     void setProperties(KisSprayOpOptionData * properties,
                        KisColorOptionData * colorProperties,
                        KisSprayShapeOptionData * shapeProperties,
@@ -84,6 +137,7 @@ private:
                    qreal additionalScale,
                    const KoColor &color,
                    const KoColor &bgColor,
+                   SprayParticleDab *deferredDab,
                    const AngularDistribution &angularDistribution);
     template <typename AngularDistribution, typename RadialDistribution>
     void paintImpl(KisPaintDeviceSP dab,
@@ -94,15 +148,16 @@ private:
                    qreal additionalScale,
                    const KoColor &color,
                    const KoColor &bgColor,
+                   SprayParticleDab *deferredDab,
                    const AngularDistribution &angularDistribution,
                    const RadialDistribution &radialDistribution);
     /// rotation in radians according the settings (gauss distribution, uniform distribution or fixed angle)
     qreal rotationAngle(KisRandomSourceSP randomSource);
     /// Paints Wu Particle
     void paintParticle(KisRandomAccessorSP &writeAccessor, const KoColor &color, qreal rx, qreal ry);
-    void paintCircle(KisPainter * painter, qreal x, qreal y, qreal radius);
-    void paintEllipse(KisPainter * painter, qreal x, qreal y, qreal a, qreal b, qreal angle);
-    void paintRectangle(KisPainter * painter, qreal x, qreal y, qreal width, qreal height, qreal angle);
+    static void paintCircle(KisPainter * painter, qreal x, qreal y, qreal radius, const QRect &requestedRect = QRect());
+    static void paintEllipse(KisPainter * painter, qreal x, qreal y, qreal a, qreal b, qreal angle, const QRect &requestedRect = QRect());
+    static void paintRectangle(KisPainter * painter, qreal x, qreal y, qreal width, qreal height, qreal angle, const QRect &requestedRect = QRect());
 
     void paintOutline(KisPaintDeviceSP dev, const KoColor& painterColor, qreal posX, qreal posY, qreal radius);
 
@@ -0,0 +1,58 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef TESTING_BENCHMARK_UTILS_H
+#define TESTING_BENCHMARK_UTILS_H
+
+#include <QtGlobal>
+
+namespace TestUtil
+{
+
+/**
+ * \return the positive integer value of the environment variable \p name
+ * or \p defaultValue if it is not set. The benchmarks use it to let the
+ * size of the synthetic documents be changed without recompiling.
+ */
+inline int benchmarkEnvValue(const char *name, int defaultValue)
+{
+    bool ok = false;
+    const int value = qEnvironmentVariableIntValue(name, &ok);
+    return ok && value > 0 ? value : defaultValue;
+}
+
+/**
+ * A linear congruential generator for filling the synthetic test data
+ * with noise. Unlike QRandomGenerator, it generates the same sequence
+ * on every platform, so the results of the tests are reproducible.
+ */
+class TestingRandomSequence
+{
+public:
+    explicit TestingRandomSequence(quint32 seed = 1)
+        : m_state(seed)
+    {
+    }
+
+    quint32 next() {
+        m_state = 1664525u * m_state + 1013904223u;
+        return m_state;
+    }
+
+    /**
+     * \return the highest (and the most random) byte of the next value
+     */
+    quint8 nextByte() {
+        return quint8(next() >> 24);
+    }
+
+private:
+    quint32 m_state;
+};
+
+}
+
+#endif // TESTING_BENCHMARK_UTILS_H
@@ -9,6 +9,8 @@
 #define __TESTING_TIMED_DEFAULT_BOUNDS_H
 
 #include "kis_default_bounds_base.h"
+#include "kis_paint_device.h"
+#include <KoColor.h>
 
 
 namespace TestUtil {
@@ -17,6 +19,7 @@ struct TestingTimedDefaultBounds : public KisDefaultBoundsBase {
     TestingTimedDefaultBounds(const QRect &bounds = QRect(0,0,100,100))
         : m_time(0),
           m_lod(0),
+          m_wrapAroundMode(false),
           m_bounds(bounds)
     {
     }
@@ -26,7 +29,7 @@ struct TestingTimedDefaultBounds : public KisDefaultBoundsBase {
     }
 
     bool wrapAroundMode() const override {
-        return false;
+        return m_wrapAroundMode;
     }
 
     WrapAroundAxis wrapAroundModeAxis() const override {
@@ -53,6 +56,10 @@ struct TestingTimedDefaultBounds : public KisDefaultBoundsBase {
         m_lod = lod;
     }
 
+    void testingSetWrapAroundMode(bool value) {
+        m_wrapAroundMode = value;
+    }
+
     void * sourceCookie() const override {
         return 0;
     }
@@ -60,9 +67,27 @@ struct TestingTimedDefaultBounds : public KisDefaultBoundsBase {
 private:
     int m_time;
     int m_lod;
+    bool m_wrapAroundMode;
     QRect m_bounds;
 };
 
+/**
+ * Creates a device in wraparound mode with \p wrapRect filled
+ * with \p color
+ */
+inline KisPaintDeviceSP createWrapAroundDevice(const KoColorSpace *cs, const QRect &wrapRect, const KoColor &color)
+{
+    TestingTimedDefaultBounds *bounds = new TestingTimedDefaultBounds(wrapRect);
+    bounds->testingSetWrapAroundMode(true);
+
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    dev->setDefaultBounds(bounds);
+    dev->setSupportsWraparoundMode(true);
+    dev->fill(wrapRect, color);
+
+    return dev;
+}
+
 }
 
 #endif /* __TESTING_TIMED_DEFAULT_BOUNDS_H */